@@ -1,17 +1,36 @@
+#include "CloudStatistics.hpp"
+#include "LASIndex.hpp"
 #include "LASProcessor.hpp"
 #include "PCDProcessor.hpp"
 #include "PointCloudTypes.hpp"
+#include "filters/PointFilters.hpp"
+#include "io/AsyncFile.hpp"
+#include "io/LoadFilter.hpp"
+#include "io/PointStream.hpp"
+#include "io/Tiler.hpp"
+#include "spatial/Morton.hpp"
+#include "tooling/Arena.hpp"
 #include "tooling/Logger.hpp"
+#include "tooling/Profiler.hpp"
+#include "tooling/ThreadPool.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <format>
 #include <fstream>
-#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <print>
+#include <set>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <CLI/CLI.hpp>
 
@@ -22,7 +41,7 @@ using namespace scanforge::tooling;
 /**
  * @brief Detect file format based on extension
  * @param filename File path to analyze
- * @return String indicating format ("pcd", "las", or "unknown")
+ * @return String indicating format ("pcd", "las", or "unknown"); LAZ files read as "las"
  */
 std::string detectFileFormat(const std::string& filename) {
     fs::path filePath(filename);
@@ -32,7 +51,7 @@ std::string detectFileFormat(const std::string& filename) {
 
     if (extension == ".pcd") {
         return "pcd";
-    } else if (extension == ".las") {
+    } else if (extension == ".las" || extension == ".laz") {
         return "las";
     } else {
         return "unknown";
@@ -50,8 +69,74 @@ struct AppConfig {
     bool showInfo = false;
     bool showStats = false;
     bool verbose = false;
+    bool memoryMap = false;
+    bool stream = false;
+    unsigned threads = 0;
+    float voxelSize = 0;          // 0 disables voxel downsampling
+    size_t outlierNeighbors = 0;  // 0 disables statistical outlier removal
+    double outlierStddev = 1.0;
+    std::string sortOrder = "none";
+    double tileSize = 0;  // 0 writes a single output file
+    size_t maxOpenFiles = 64;
+    bool buildIndex = false;
+    std::vector<double> cropBox;  // minX minY maxX maxY, empty keeps every point
+    uint64_t every = 1;           // Keep every Nth point of the file
+    uint64_t sampleSize = 0;      // 0 keeps every point
+    std::vector<unsigned> classes;
+    std::vector<std::string> batchInputs;  // Directories and file name patterns to convert
+    unsigned ioJobs = 2;                   // Files read or written at once in batch mode
+    std::string ioBackend = "auto";        // Backend of the --stream and --tile readers and writers
+    bool profile = false;
+    std::string profileJson;  // Empty writes no JSON report
+
+    bool profiling() const { return profile || !profileJson.empty(); }
+
+    bool filtering() const { return voxelSize > 0 || outlierNeighbors > 0; }
+    bool reordering() const { return sortOrder != "none"; }
+    bool cropping() const { return !cropBox.empty(); }
+    bool batch() const { return !batchInputs.empty(); }
+    bool selecting() const { return cropping() || every > 1 || sampleSize > 0 || !classes.empty(); }
+    LASIndex::Box crop() const { return {cropBox[0], cropBox[1], cropBox[2], cropBox[3]}; }
+
+    io::AsyncOptions asyncOptions() const {
+        io::AsyncOptions options;
+        options.backend = ioBackend == "threads" ? io::IOBackend::Threads
+                          : ioBackend == "io_uring" ? io::IOBackend::IoUring
+                          : ioBackend == "overlapped" ? io::IOBackend::Overlapped
+                                                      : io::IOBackend::Auto;
+        return options;
+    }
+
+    // The crop, decimation and class selection, evaluated while the input is decoded
+    io::LoadFilter loadFilter() const {
+        io::LoadFilter filter;
+        filter.stride = every;
+        filter.sampleSize = sampleSize;
+        if (cropping()) {
+            filter.box = io::LoadFilter::Box{.minX = cropBox[0], .minY = cropBox[1], .maxX = cropBox[2], .maxY = cropBox[3]};
+        }
+        if (!classes.empty()) {
+            std::vector<uint8_t> wanted;
+            for (unsigned c : classes) {
+                wanted.push_back(static_cast<uint8_t>(c));
+            }
+            filter.predicate = io::classificationIn(wanted);
+        }
+        return filter;
+    }
 };
 
+/**
+ * @brief Create the header of a LAS or LAZ output file
+ * @param outputFormat "las" or "laz"
+ * @return Point format 3 header, LAZ compressed for "laz"
+ */
+LASProcessor::LASHeader createOutputLASHeader(const std::string& outputFormat) {
+    auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+    header.compressed = outputFormat == "laz";
+    return header;
+}
+
 /**
  * @brief Print file information from LAS header
  * @param header The LAS header containing file metadata
@@ -65,15 +150,30 @@ Version:      {}
 Points:       {}
 Dimensions:   {} x {}
 Point Format: {}
+Compression:  {}
 Has XYZ:      Yes
 Has RGB:      {}
 Has GPS Time: {}
 Bounding Box: ({:.3f}, {:.3f}, {:.3f}) to ({:.3f}, {:.3f}, {:.3f})
 Scale Factor: ({:.6f}, {:.6f}, {:.6f})
+Returns:      {}
 Software:     {}
 )",
-                 filename, header.getVersion(), header.getTotalPointCount(), header.width, header.height, static_cast<int>(header.pointDataRecordFormat), header.hasRGB() ? "Yes" : "No",
+                 filename, header.getVersion(), header.getTotalPointCount(), header.width, header.height, static_cast<int>(header.pointDataRecordFormat), header.compressed ? "LAZ" : "None", header.hasRGB() ? "Yes" : "No",
                  header.hasGPSTime() ? "Yes" : "No", header.minX, header.minY, header.minZ, header.maxX, header.maxY, header.maxZ, header.xScaleFactor, header.yScaleFactor, header.zScaleFactor,
+                 [&]() {
+                     // Counted by the writer into the header, so no point needs decoding
+                     std::string returns;
+                     const bool extended = header.versionMajor == 1 && header.versionMinor >= 4;
+                     const size_t slots = extended ? header.numberOfPointsByReturn.size() : header.legacyNumberOfPointsByReturn.size();
+                     for (size_t i = 0; i < slots; ++i) {
+                         const uint64_t count = extended ? header.numberOfPointsByReturn[i] : header.legacyNumberOfPointsByReturn[i];
+                         if (count > 0) {
+                             returns += std::format("{}{}: {}", returns.empty() ? "" : ", ", i + 1, count);
+                         }
+                     }
+                     return returns.empty() ? std::string("Not recorded") : returns;
+                 }(),
                  std::string(header.generatingSoftware.begin(), header.generatingSoftware.end()));
 }
 
@@ -109,26 +209,31 @@ Has RGB:    {}
         header.viewpoint.empty() ? "Not specified" : header.viewpoint, header.hasXYZ() ? "Yes" : "No", header.hasRGB() ? "Yes" : "No");
 }
 
+/** @brief Name of an ASPRS classification code, empty for the reserved and user-defined ones */
+std::string_view className(size_t code) {
+    static constexpr std::array<std::string_view, 19> NAMES = {
+        "Created, never classified", "Unclassified", "Ground", "Low vegetation", "Medium vegetation", "High vegetation", "Building", "Low point (noise)", "Model key-point",
+        "Water", "Rail", "Road surface", "Overlap", "Wire - guard", "Wire - conductor", "Transmission tower", "Wire-structure connector", "Bridge deck", "High noise",
+    };
+    return code < NAMES.size() ? NAMES[code] : std::string_view{};
+}
+
 /**
  * @brief Print detailed statistics about the point cloud
- * @param cloud The point cloud to analyze
+ * @param stats Statistics of the points
+ * @param showColor Whether the input stores colors; without them every point reads as white
  */
-void printStatistics(const PointCloudXYZRGB& cloud) {
-    if (cloud.empty()) {
+void printStatistics(const CloudStatistics& stats, bool showColor) {
+    if (stats.empty()) {
         std::println("No points to analyze.");
         return;
     }
 
-    auto [minPt, maxPt] = cloud.getBoundingBox();
+    auto [minPt, maxPt] = stats.bounds();
     Point3D center = (minPt + maxPt) * 0.5f;
     Point3D size = maxPt - minPt;
-
-    // Calculate centroid
-    Point3D centroid{0, 0, 0};
-    for (const auto& point : cloud.points) {
-        centroid = centroid + point.position;
-    }
-    centroid = centroid * (1.0f / static_cast<float>(cloud.size()));
+    const Point3D centroid = stats.centroid();
+    const Point3D deviation = stats.standardDeviation();
 
     std::println(R"(
 Point Cloud Statistics
@@ -143,161 +248,728 @@ Bounding Box:
   Size:          ({:.3f}, {:.3f}, {:.3f})
 
 Centroid:        ({:.3f}, {:.3f}, {:.3f})
-)",
-                 cloud.size(), cloud.is_dense ? "Yes" : "No", minPt.x, minPt.y, minPt.z, maxPt.x, maxPt.y, maxPt.z, center.x, center.y, center.z, size.x, size.y, size.z, centroid.x, centroid.y,
-                 centroid.z);
+Std Deviation:   ({:.3f}, {:.3f}, {:.3f})
+Density:         {:.3f} points per unit of XY area)",
+                 stats.count(), stats.nonFinite() == 0 ? "Yes" : "No", minPt.x, minPt.y, minPt.z, maxPt.x, maxPt.y, maxPt.z, center.x, center.y, center.z, size.x, size.y, size.z, centroid.x,
+                 centroid.y, centroid.z, deviation.x, deviation.y, deviation.z, stats.density());
+
+    const double total = static_cast<double>(stats.count());
+    if (showColor && stats.hasColor()) {
+        const auto mean = stats.meanColor();
+        std::println("\nMean Color:      ({:.1f}, {:.1f}, {:.1f})", mean[0], mean[1], mean[2]);
+        std::println("Color Histogram: % of points per 32 values");
+        for (size_t channel = 0; channel < 3; ++channel) {
+            std::string row;
+            const auto& histogram = stats.colorHistogram(channel);
+            for (size_t bin = 0; bin < histogram.size(); bin += 32) {
+                uint64_t count = 0;
+                for (size_t value = bin; value < bin + 32; ++value) {
+                    count += histogram[value];
+                }
+                row += std::format(" {:5.1f}", 100.0 * static_cast<double>(count) / total);
+            }
+            std::println("  {}:{}", "RGB"[channel], row);
+        }
+    }
+    if (stats.hasClasses()) {
+        std::println("\nClasses:");
+        const auto& classes = stats.classCounts();
+        for (size_t code = 0; code < classes.size(); ++code) {
+            if (classes[code] > 0) {
+                std::println("  {:>3} {:<26} {:>12} ({:.1f}%)", code, className(code), classes[code], 100.0 * static_cast<double>(classes[code]) / total);
+            }
+        }
+    }
+    if (stats.hasReturns()) {
+        std::println("\nReturns:");
+        const auto& returns = stats.returnCounts();
+        for (size_t number = 0; number < returns.size(); ++number) {
+            if (returns[number] > 0) {
+                std::println("  {:>3} {:>12} ({:.1f}%)", number, returns[number], 100.0 * static_cast<double>(returns[number]) / total);
+            }
+        }
+    }
+    std::println("");
 }
 
-int main(int argc, char* argv[]) {
-    CLI::App app{"ScanForge CLI Tool v1.0.0 - Modern C++23 Point Cloud Processing"};
+/**
+ * @brief Run the filters selected on the command line, outlier removal before downsampling
+ * @return False if a filter rejected its parameters
+ */
+bool applyFilters(const AppConfig& config, PointCloudXYZRGB& cloud) {
+    auto filterStart = std::chrono::high_resolution_clock::now();
+    const size_t loaded = cloud.size();
 
-    AppConfig config;
+    if (config.outlierNeighbors > 0 && !filters::removeStatisticalOutliers(cloud, cloud, config.outlierNeighbors, config.outlierStddev, config.threads)) {
+        Log::error("Statistical outlier removal failed");
+        return false;
+    }
+    if (config.voxelSize > 0 && !filters::voxelDownsample(cloud, cloud, config.voxelSize, config.threads)) {
+        Log::error("Voxel downsampling failed");
+        return false;
+    }
 
-    // Required positional argument
-    app.add_option("input", config.inputFile, "Input file path (PCD or LAS format)")->required()->check(CLI::ExistingFile);
+    auto filterDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - filterStart);
+    Log::info("Filtered {} points to {} in {} ms", loaded, cloud.size(), filterDuration.count());
+    return true;
+}
 
-    // Optional arguments
-    app.add_option("-o,--output", config.outputFile, "Output file path");
-    app.add_option("-f,--format", config.outputFormat, "Output format")->check(CLI::IsMember({"pcd", "las"}))->default_val("pcd");
-    app.add_option("--variant", config.pcdVariant, "PCD variant (only used when format is 'pcd')")->check(CLI::IsMember({"ascii", "binary", "compressed"}))->default_val("ascii");
+/**
+ * @brief Map the --variant option to a PCD DATA type
+ * @param variant "ascii", "binary", "compressed" or "chunked"
+ * @return The matching PCD data type
+ */
+std::string pcdDataType(const std::string& variant) {
+    if (variant == "compressed") {
+        return "binary_compressed";
+    }
+    return variant == "chunked" ? "binary_compressed_chunked" : variant;
+}
 
-    // Flags
-    app.add_flag("-i,--info", config.showInfo, "Show file information");
-    app.add_flag("-s,--stats", config.showStats, "Show detailed statistics");
-    app.add_flag("-v,--verbose", config.verbose, "Enable verbose logging");
+/**
+ * @brief Open a chunked reader for the input file, printing its header with --info
+ * @param config Application configuration
+ * @param fileFormat Detected input format
+ * @return The reader, or nullptr after logging the failure
+ */
+std::unique_ptr<io::PointReader> openReader(const AppConfig& config, const std::string& fileFormat) {
+    if (fileFormat == "pcd") {
+        auto pcdReader = std::make_unique<PCDReader>(config.inputFile, config.asyncOptions());
+        if (!pcdReader->is_open()) {
+            Log::error("Failed to load PCD file or invalid header");
+            return nullptr;
+        }
+        if (config.showInfo) {
+            printFileInfo(pcdReader->header(), config.inputFile);
+        }
+        return pcdReader;
+    }
+    if (fileFormat == "las") {
+        auto lasReader = std::make_unique<LASReader>(config.inputFile, config.asyncOptions());
+        if (!lasReader->is_open()) {
+            Log::error("Failed to load LAS file or invalid header");
+            return nullptr;
+        }
+        if (config.showInfo) {
+            printFileInfo(lasReader->header(), config.inputFile);
+        }
+        return lasReader;
+    }
+    Log::error("Unsupported file format: {}. Supported formats: PCD, LAS, LAZ", fileFormat);
+    return nullptr;
+}
 
-    // Parse command line
-    try {
-        app.parse(argc, argv);
-    } catch (const CLI::ParseError& e) {
-        return app.exit(e);
+/**
+ * @brief Create a chunked writer in the configured output format
+ * @param config Application configuration
+ * @param path File to create
+ * @param options Write-behind of the file
+ * @return The writer, or nullptr after logging the failure
+ */
+std::unique_ptr<io::PointWriter> openWriter(const AppConfig& config, const fs::path& path, const io::AsyncOptions& options) {
+    if (config.outputFormat == "las" || config.outputFormat == "laz") {
+        auto lasWriter = std::make_unique<LASWriter>(path, createOutputLASHeader(config.outputFormat), options);
+        if (!lasWriter->is_open()) {
+            return nullptr;
+        }
+        return lasWriter;
+    }
+    auto pcdWriter = std::make_unique<PCDWriter>(path, PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, pcdDataType(config.pcdVariant)), codec::LZFCodec::Level::Normal, options);
+    if (!pcdWriter->is_open()) {
+        return nullptr;
     }
+    return pcdWriter;
+}
 
-    // Configure logging
-    if (config.verbose) {
-        Logger::getInstance().setLevel(LogLevel::DEBUG);
+/**
+ * @brief Convert input to output in constant memory, reading and writing concurrently
+ * @param config Application configuration, outputFile must be set
+ * @param fileFormat Detected input format
+ * @return Process exit code
+ */
+int streamConvert(const AppConfig& config, const std::string& fileFormat) {
+    auto reader = openReader(config, fileFormat);
+    if (!reader) {
+        return 1;
     }
 
-    Log::info("ScanForge CLI Tool starting...");
+    fs::path outputPath(config.outputFile);
+    if (outputPath.has_parent_path()) {
+        fs::create_directories(outputPath.parent_path());
+    }
+
+    auto writer = openWriter(config, outputPath, config.asyncOptions());
+    if (!writer) {
+        return 1;
+    }
 
+    Log::info("Streaming {} points from {} to {}", reader->size(), config.inputFile, config.outputFile);
+    if (!io::pipePoints(*reader, *writer)) {
+        Log::error("Failed to stream point cloud to: {}", config.outputFile);
+        return 1;
+    }
+
+    auto inputSize = fs::file_size(config.inputFile);
+    auto outputSize = fs::file_size(config.outputFile);
+    Log::info("File size: {} bytes -> {} bytes ({:.1f}%)", inputSize, outputSize, (static_cast<double>(outputSize) / static_cast<double>(inputSize)) * 100.0);
+    return 0;
+}
+
+/**
+ * @brief Answer --info and --stats without loading the file
+ *
+ * --info reads the header alone. --stats reduces the points one chunk at a time, so files
+ * larger than memory can be inspected; LAS and LAZ chunks carry the classes and return
+ * numbers too.
+ *
+ * @param config Application configuration, with no output, filter or selection
+ * @param fileFormat Detected input format
+ * @return Process exit code
+ */
+int inspectFile(const AppConfig& config, const std::string& fileFormat) {
+    auto reader = openReader(config, fileFormat);
+    if (!reader || !config.showStats) {
+        return reader ? 0 : 1;
+    }
+
+    std::optional<CloudStatistics> stats;
+    bool hasColor = false;
+    if (fileFormat == "las") {
+        auto& lasReader = static_cast<LASReader&>(*reader);
+        stats = CloudStatistics::compute<PointWith<field::Color, field::Classification, field::Returns>>(lasReader, config.threads);
+        hasColor = lasReader.header().hasRGB();
+    } else {
+        stats = CloudStatistics::compute(*reader, config.threads);
+        hasColor = static_cast<PCDReader&>(*reader).header().hasRGB();
+    }
+    if (!stats) {
+        Log::error("Failed to read the points of: {}", config.inputFile);
+        return 1;
+    }
+    printStatistics(*stats, hasColor);
+    return 0;
+}
+
+/**
+ * @brief Build the spatial index of a LAS or LAZ file and save it next to the file
+ * @param config Application configuration
+ * @param fileFormat Detected input format
+ * @return Process exit code
+ */
+int indexFile(const AppConfig& config, const std::string& fileFormat) {
+    if (fileFormat != "las") {
+        Log::error("--index needs LAS or LAZ input");
+        return 1;
+    }
+    LASReader reader(config.inputFile);
+    LASIndex index;
+    if (!reader.is_open() || !index.build(reader)) {
+        Log::error("Failed to index: {}", config.inputFile);
+        return 1;
+    }
+    const auto indexPath = LASIndex::sidecarPath(config.inputFile);
+    if (!index.save(indexPath)) {
+        return 1;
+    }
+    Log::info("Indexed {} points in {} cells ({} runs) into {}", reader.size(), index.cellCount(), index.intervalCount(), indexPath.string());
+    return 0;
+}
+
+/**
+ * @brief Cut the input into square tiles written to the output directory, reading it once
+ * @param config Application configuration, outputFile names the tile directory
+ * @param fileFormat Detected input format
+ * @return Process exit code
+ */
+int tileConvert(const AppConfig& config, const std::string& fileFormat) {
+    auto reader = openReader(config, fileFormat);
+    if (!reader) {
+        return 1;
+    }
+
+    io::Tiler::Options options;
+    options.tileSize = config.tileSize;
+    options.maxOpenFiles = config.maxOpenFiles;
+    options.extension = config.outputFormat;
+    options.threads = config.threads;
+    if (const auto* lasReader = dynamic_cast<const LASReader*>(reader.get())) {
+        const auto& header = lasReader->header();
+        options.bounds = io::Tiler::Bounds{header.minX, header.minY, header.maxX, header.maxY};
+    }
+
+    // Up to --tile-files writers are open at once, so each keeps less in flight
+    auto tileIO = config.asyncOptions();
+    tileIO.blockSize = size_t{256} << 10;
+    tileIO.depth = 2;
+    io::Tiler tiler(options, [&config, &tileIO](const fs::path& path) { return openWriter(config, path, tileIO); });
+    Log::info("Tiling {} points from {} into {} tiles of {}", reader->size(), config.inputFile, config.outputFile, config.tileSize);
+    if (!tiler.run(*reader, config.outputFile)) {
+        Log::error("Failed to tile point cloud into: {}", config.outputFile);
+        return 1;
+    }
+
+    const auto tiles = tiler.tiles();
+    RateLimit tileLines(32, std::chrono::hours(1));
+    for (const auto& tile : tiles) {
+        Log::debug(tileLines, "Tile {}: {} points", tile.path.string(), tile.points);
+    }
+    if (tileLines.suppressed() > 0) {
+        Log::debug("... and {} more tiles", tileLines.suppressed());
+    }
+    Log::info("Wrote {} tiles to {}", tiles.size(), config.outputFile);
+    return 0;
+}
+
+/**
+ * @brief Timings and sizes of one converted file, for the batch summary
+ */
+struct FileReport {
+    std::string input;
+    size_t points = 0;  // Points written, after filtering
+    std::chrono::milliseconds load{0};
+    std::chrono::milliseconds process{0};
+    std::chrono::milliseconds save{0};
+    uintmax_t inputBytes = 0;
+    uintmax_t outputBytes = 0;
+    bool ok = false;
+};
+
+/**
+ * @brief Load one file, filter and sort it, show it and save it as configured
+ * @param config Application configuration naming the input and output files
+ * @param fileFormat Detected input format
+ * @param io Limit on the files read or written at once, nullptr for none
+ * @param report Filled with the timings and sizes of the file
+ * @param resource Memory resource the cloud and the decode buffers allocate from
+ * @return Process exit code
+ */
+int convertFile(const AppConfig& config, const std::string& fileFormat, ConcurrencyLimit* io, FileReport& report,
+                std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    report.input = config.inputFile;
+    report.inputBytes = fs::file_size(config.inputFile);
+
+    // Load the point cloud based on format
+    Log::info("Loading point cloud from: {}", config.inputFile);
+
+    PointCloudXYZRGB cloud(resource);
+    PCDProcessor::PCDHeader pcdHeader;
+    LASProcessor::LASHeader lasHeader;
+    bool isLAS = false;
+
+    std::optional<ConcurrencyLimit::Slot> ioSlot;
+    if (io) {
+        ioSlot.emplace(io->acquire());
+    }
+    // Timed from here, so the load time leaves out the wait for an I/O slot like the save time does
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    try {
-        // Detect file format
-        std::string fileFormat = detectFileFormat(config.inputFile);
-        Log::info("Detected file format: {}", fileFormat);
+    if (fileFormat == "pcd") {
+        PCDProcessor processor(resource);
+        auto [header, loadedCloud] =
+            processor.loadPCD(config.inputFile, config.loadFilter(), config.memoryMap ? PCDProcessor::LoadMode::MemoryMapped : PCDProcessor::LoadMode::Stream, config.threads);
+        pcdHeader = header;
+        cloud = std::move(loadedCloud);
+
+        if (!header.isValid()) {
+            Log::error("Failed to load PCD file or invalid header");
+            return 1;
+        }
+    } else if (fileFormat == "las") {
+        // A plain crop reads only the indexed region when the file has an index; any other selection decodes the whole file through the filter
+        LASProcessor processor(resource);
+        const bool cropOnly = config.cropping() && config.every == 1 && config.sampleSize == 0 && config.classes.empty();
+        auto [header, loadedCloud] = cropOnly ? LASIndex::loadBox(config.inputFile, config.crop(), config.threads, resource) : processor.loadLAS(config.inputFile, config.loadFilter(), config.threads);
+        lasHeader = header;
+        cloud = std::move(loadedCloud);
+        isLAS = true;
 
-        // Load the point cloud based on format
-        Log::info("Loading point cloud from: {}", config.inputFile);
+        if (!header.isValid()) {
+            Log::error("Failed to load LAS file or invalid header");
+            return 1;
+        }
+    } else {
+        Log::error("Unsupported file format: {}. Supported formats: PCD, LAS, LAZ", fileFormat);
+        return 1;
+    }
 
-        PointCloudXYZRGB cloud;
-        PCDProcessor::PCDHeader pcdHeader;
-        LASProcessor::LASHeader lasHeader;
-        bool isLAS = false;
+    ioSlot.reset();
+    auto loadTime = std::chrono::high_resolution_clock::now();
+    auto loadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(loadTime - startTime);
+    report.load = loadDuration;
 
-        if (fileFormat == "pcd") {
-            PCDProcessor processor;
-            auto [header, loadedCloud] = processor.loadPCD(config.inputFile);
-            pcdHeader = header;
-            cloud = loadedCloud;
+    Log::info("Successfully loaded {} points in {} ms", cloud.size(), loadDuration.count());
 
-            if (!header.isValid()) {
-                Log::error("Failed to load PCD file or invalid header");
-                return 1;
-            }
-        } else if (fileFormat == "las") {
-            LASProcessor processor;
-            auto [header, loadedCloud] = processor.loadLAS(config.inputFile);
-            lasHeader = header;
-            cloud = loadedCloud;
-            isLAS = true;
-
-            if (!header.isValid()) {
-                Log::error("Failed to load LAS file or invalid header");
+    if (config.filtering() && !applyFilters(config, cloud)) {
+        return 1;
+    }
+    if (config.reordering()) {
+        auto sortStart = std::chrono::high_resolution_clock::now();
+        if (!spatial::sortMorton(cloud, config.threads)) {
+            return 1;
+        }
+        auto sortDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - sortStart);
+        Log::info("Sorted {} points in Morton order in {} ms", cloud.size(), sortDuration.count());
+    }
+
+    auto processTime = std::chrono::high_resolution_clock::now();
+    report.process = std::chrono::duration_cast<std::chrono::milliseconds>(processTime - loadTime);
+    report.points = cloud.size();
+
+    // Show file information
+    if (config.showInfo) {
+        if (isLAS) {
+            printFileInfo(lasHeader, config.inputFile);
+        } else {
+            printFileInfo(pcdHeader, config.inputFile);
+        }
+    }
+
+    // Show statistics
+    if (config.showStats) {
+        printStatistics(CloudStatistics::compute(cloud, config.threads), isLAS ? lasHeader.hasRGB() : pcdHeader.hasRGB());
+    }
+
+    // Convert and save if output file is specified
+    if (!config.outputFile.empty()) {
+        std::string actualFormat = config.outputFormat;
+        if (actualFormat == "pcd") {
+            actualFormat = config.pcdVariant;  // Use the specified PCD variant
+        }
+        Log::info("Converting to format: {} {}", config.outputFormat, 
+                 config.outputFormat == "pcd" ? "(" + config.pcdVariant + ")" : "");
+        Log::info("Saving to: {}", config.outputFile);
+
+        // Create output directory if it doesn't exist
+        fs::path outputPath(config.outputFile);
+        if (outputPath.has_parent_path()) {
+            fs::create_directories(outputPath.parent_path());
+        }
+
+        if (io) {
+            ioSlot.emplace(io->acquire());
+        }
+        auto saveStartTime = std::chrono::high_resolution_clock::now();
+        bool saveResult = false;
+
+        if (config.outputFormat == "las" || config.outputFormat == "laz") {
+            // Save as LAS, LAZ compressed for "laz"
+            LASProcessor lasProcessor;
+            auto outputHeader = createOutputLASHeader(config.outputFormat);
+            saveResult = lasProcessor.saveLAS(config.outputFile, outputHeader, cloud, config.threads);
+        } else if (config.outputFormat == "pcd") {
+            // Save as PCD with specified variant
+            PCDProcessor pcdProcessor;
+            auto outputHeader = PCDProcessor::createXYZRGBHeader(cloud, config.pcdVariant);
+
+            if (config.pcdVariant == "ascii") {
+                saveResult = pcdProcessor.savePCD_ASCII(config.outputFile, outputHeader, cloud);
+            } else if (config.pcdVariant == "binary") {
+                saveResult = pcdProcessor.savePCD_Binary(config.outputFile, outputHeader, cloud);
+            } else if (config.pcdVariant == "compressed") {
+                saveResult = pcdProcessor.savePCD_BinaryCompressed(config.outputFile, outputHeader, cloud);
+            } else if (config.pcdVariant == "chunked") {
+                saveResult = pcdProcessor.savePCD_BinaryCompressedChunked(config.outputFile, outputHeader, cloud, config.threads);
+            } else {
+                Log::error("Unsupported PCD variant: {}", config.pcdVariant);
                 return 1;
             }
         } else {
-            Log::error("Unsupported file format: {}. Supported formats: PCD, LAS", fileFormat);
+            Log::error("Unsupported output format: {}", config.outputFormat);
             return 1;
         }
 
-        auto loadTime = std::chrono::high_resolution_clock::now();
-        auto loadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(loadTime - startTime);
+        ioSlot.reset();
+        auto saveEndTime = std::chrono::high_resolution_clock::now();
+        auto saveDuration = std::chrono::duration_cast<std::chrono::milliseconds>(saveEndTime - saveStartTime);
+        report.save = saveDuration;
 
-        Log::info("Successfully loaded {} points in {} ms", cloud.size(), loadDuration.count());
+        if (saveResult) {
+            Log::info("Successfully saved {} points to {} format in {} ms", cloud.size(), actualFormat, saveDuration.count());
 
-        // Show file information
-        if (config.showInfo) {
-            if (isLAS) {
-                printFileInfo(lasHeader, config.inputFile);
-            } else {
-                printFileInfo(pcdHeader, config.inputFile);
-            }
+            // Show file size comparison
+            auto inputSize = fs::file_size(config.inputFile);
+            auto outputSize = fs::file_size(config.outputFile);
+            report.outputBytes = outputSize;
+            Log::info("File size: {} bytes -> {} bytes ({:.1f}%)", inputSize, outputSize, (static_cast<double>(outputSize) / static_cast<double>(inputSize)) * 100.0);
+        } else {
+            Log::error("Failed to save point cloud to: {}", config.outputFile);
+            return 1;
         }
+    }
+
+    report.ok = true;
+    return 0;
+}
 
-        // Show statistics
-        if (config.showStats) {
-            printStatistics(cloud);
+/**
+ * @brief Match a file name against a pattern where '*' stands for any run of characters and '?' for one
+ */
+bool matchesPattern(std::string_view name, std::string_view pattern) {
+    size_t n = 0, p = 0;
+    size_t starP = std::string_view::npos, starN = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != std::string_view::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else {
+            return false;
         }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
 
-        // Convert and save if output file is specified
-        if (!config.outputFile.empty()) {
-            std::string actualFormat = config.outputFormat;
-            if (actualFormat == "pcd") {
-                actualFormat = config.pcdVariant;  // Use the specified PCD variant
+/**
+ * @brief Expand the --batch arguments into input files, sorted and without duplicates
+ * @param inputs Directories, standing for the PCD, LAS and LAZ files they hold, and paths
+ *               whose file name may hold '*' and '?', such as scans/tile_*.laz
+ * @return The files, empty after logging an argument that matched nothing
+ */
+std::vector<fs::path> listBatchInputs(const std::vector<std::string>& inputs) {
+    std::set<fs::path> files;
+    for (const auto& input : inputs) {
+        const fs::path path(input);
+        std::error_code error;
+        const bool directory = fs::is_directory(path, error);
+        const auto pattern = directory ? std::string() : path.filename().string();
+        const auto parent = directory ? path : path.has_parent_path() ? path.parent_path() : fs::path(".");
+
+        size_t matched = 0;
+        if (!directory && pattern.find_first_of("*?") == std::string::npos) {
+            if (fs::is_regular_file(path, error)) {
+                files.insert(path);
+                ++matched;
             }
-            Log::info("Converting to format: {} {}", config.outputFormat, 
-                     config.outputFormat == "pcd" ? "(" + config.pcdVariant + ")" : "");
-            Log::info("Saving to: {}", config.outputFile);
-
-            // Create output directory if it doesn't exist
-            fs::path outputPath(config.outputFile);
-            if (outputPath.has_parent_path()) {
-                fs::create_directories(outputPath.parent_path());
+        } else {
+            for (const auto& entry : fs::directory_iterator(parent, error)) {
+                const auto name = entry.path().filename().string();
+                if (entry.is_regular_file(error) && detectFileFormat(name) != "unknown" && (directory || matchesPattern(name, pattern))) {
+                    files.insert(entry.path());
+                    ++matched;
+                }
+            }
+        }
+        if (matched == 0) {
+            Log::error("No PCD, LAS or LAZ files found for: {}", input);
+            return {};
+        }
+    }
+    return {files.begin(), files.end()};
+}
+
+/**
+ * @brief Print the per-file timings of a batch and its throughput
+ * @param reports One report per input file
+ * @param elapsed Wall-clock time of the whole batch
+ */
+void printBatchSummary(const std::vector<FileReport>& reports, std::chrono::milliseconds elapsed) {
+    std::println(R"(
+Batch Summary
+=============
+{:<40} {:>12} {:>9} {:>11} {:>9}  {})",
+                 "File", "Points", "Load ms", "Process ms", "Save ms", "Status");
+
+    size_t converted = 0, points = 0;
+    uintmax_t read = 0, written = 0;
+    for (const auto& report : reports) {
+        std::println("{:<40} {:>12} {:>9} {:>11} {:>9}  {}", fs::path(report.input).filename().string(), report.points, report.load.count(), report.process.count(), report.save.count(),
+                     report.ok ? "OK" : "FAILED");
+        if (report.ok) {
+            ++converted;
+            points += report.points;
+            read += report.inputBytes;
+            written += report.outputBytes;
+        }
+    }
+
+    const double seconds = std::max(1e-3, std::chrono::duration<double>(elapsed).count());
+    std::println(R"(
+Converted {} of {} files in {} ms
+Throughput: {:.0f} points/s, {:.1f} MB/s read, {:.1f} MB/s written
+)",
+                 converted, reports.size(), elapsed.count(), static_cast<double>(points) / seconds, static_cast<double>(read) / 1e6 / seconds, static_cast<double>(written) / 1e6 / seconds);
+}
+
+/**
+ * @brief Convert every file of a batch into the output directory, several files at once
+ *
+ * Files are tasks of one work-stealing pool of --threads workers, and the decoders, filters
+ * and encoders within a file split their work into tasks of the same pool, so a few large
+ * files and many small ones alike keep every core busy without starting more threads than
+ * cores. At most --io-jobs files are read or written at once.
+ *
+ * @param config Application configuration, outputFile names the output directory
+ * @return Process exit code
+ */
+int batchConvert(const AppConfig& config) {
+    const auto inputs = listBatchInputs(config.batchInputs);
+    if (inputs.empty()) {
+        return 1;
+    }
+
+    std::vector<std::string> outputs(inputs.size());
+    if (!config.outputFile.empty()) {
+        std::set<fs::path> taken;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const auto output = fs::path(config.outputFile) / (inputs[i].stem().string() + "." + config.outputFormat);
+            if (!taken.insert(output).second) {
+                Log::error("Batch inputs {} and another file would both be written to {}", inputs[i].string(), output.string());
+                return 1;
             }
+            outputs[i] = output.string();
+        }
+        fs::create_directories(config.outputFile);
+    }
+
+    ThreadPool pool(config.threads);
+    ConcurrencyLimit io(pool, config.ioJobs);
+    Log::info("Converting {} files with {} threads, {} files read or written at once", inputs.size(), pool.size(), config.ioJobs);
+    // Workers hand their messages to a background writer instead of taking turns on stdout
+    Log::startAsync();
 
-            auto saveStartTime = std::chrono::high_resolution_clock::now();
-            bool saveResult = false;
-
-            if (config.outputFormat == "las") {
-                // Save as LAS
-                LASProcessor lasProcessor;
-                auto outputHeader = LASProcessor::createLASHeader(cloud, LASProcessor::PointFormat::FORMAT_3);
-                saveResult = lasProcessor.saveLAS(config.outputFile, outputHeader, cloud);
-            } else if (config.outputFormat == "pcd") {
-                // Save as PCD with specified variant
-                PCDProcessor pcdProcessor;
-                auto outputHeader = PCDProcessor::createXYZRGBHeader(cloud, config.pcdVariant);
-
-                if (config.pcdVariant == "ascii") {
-                    saveResult = pcdProcessor.savePCD_ASCII(config.outputFile, outputHeader, cloud);
-                } else if (config.pcdVariant == "binary") {
-                    saveResult = pcdProcessor.savePCD_Binary(config.outputFile, outputHeader, cloud);
-                } else if (config.pcdVariant == "compressed") {
-                    saveResult = pcdProcessor.savePCD_BinaryCompressed(config.outputFile, outputHeader, cloud);
-                } else {
-                    Log::error("Unsupported PCD variant: {}", config.pcdVariant);
-                    return 1;
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<FileReport> reports(inputs.size());
+    {
+        TaskGroup files(pool);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            files.run([&, i] {
+                AppConfig fileConfig = config;
+                fileConfig.inputFile = inputs[i].string();
+                fileConfig.outputFile = outputs[i];
+                fileConfig.threads = 0;  // Every thread of the pool
+                reports[i].input = fileConfig.inputFile;
+                // Each worker keeps one arena for all its files: once it has grown to the largest, loading allocates nothing
+                thread_local Arena arena;
+                try {
+                    convertFile(fileConfig, detectFileFormat(fileConfig.inputFile), &io, reports[i], &arena);
+                } catch (const std::exception& e) {
+                    Log::error("Exception occurred converting {}: {}", fileConfig.inputFile, e.what());
                 }
-            } else {
-                Log::error("Unsupported output format: {}", config.outputFormat);
+                arena.reset();
+            });
+        }
+        files.wait();
+    }
+    Log::stopAsync();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+
+    printBatchSummary(reports, elapsed);
+    return std::all_of(reports.begin(), reports.end(), [](const FileReport& report) { return report.ok; }) ? 0 : 1;
+}
+
+/**
+ * @brief Print the --profile table and write the --profile-json report of the whole run
+ * @return False if the JSON file could not be written
+ */
+bool reportProfile(const AppConfig& config) {
+    const auto report = Profiler::instance().report();
+    if (config.profile) {
+        std::ostringstream table;
+        report.printTable(table);
+        std::print("\nProfile (stage times summed over threads, nested stages included):\n{}", table.str());
+    }
+    if (!config.profileJson.empty()) {
+        std::ofstream file(config.profileJson);
+        report.writeJSON(file);
+        if (!file.good()) {
+            Log::error("Failed to write profile to: {}", config.profileJson);
+            return false;
+        }
+        Log::info("Wrote profile to: {}", config.profileJson);
+    }
+    return true;
+}
+
+/**
+ * @brief Run the command the options select
+ * @return Process exit code
+ */
+int run(const AppConfig& config) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    try {
+        if (config.cropping() && (config.cropBox.size() != 4 || !(config.cropBox[0] <= config.cropBox[2] && config.cropBox[1] <= config.cropBox[3]))) {
+            Log::error("--crop takes minX minY maxX maxY with min <= max");
+            return 1;
+        }
+
+        if (config.batch()) {
+            if (!config.inputFile.empty()) {
+                Log::error("--batch takes the place of the input file");
                 return 1;
             }
+            if (config.showInfo || config.showStats || config.stream || config.tileSize > 0 || config.buildIndex) {
+                Log::error("--batch cannot be combined with --info, --stats, --stream, --tile or --index");
+                return 1;
+            }
+            return batchConvert(config);
+        }
+        if (config.inputFile.empty()) {
+            Log::error("An input file or --batch is required");
+            return 1;
+        }
 
-            auto saveEndTime = std::chrono::high_resolution_clock::now();
-            auto saveDuration = std::chrono::duration_cast<std::chrono::milliseconds>(saveEndTime - saveStartTime);
+        // Detect file format
+        std::string fileFormat = detectFileFormat(config.inputFile);
+        Log::info("Detected file format: {}", fileFormat);
+        if (config.buildIndex) {
+            const int result = indexFile(config, fileFormat);
+            if (result != 0 || (config.outputFile.empty() && !config.showInfo && !config.showStats && !config.cropping())) {
+                return result;
+            }
+        }
 
-            if (saveResult) {
-                Log::info("Successfully saved {} points to {} format in {} ms", cloud.size(), actualFormat, saveDuration.count());
+        if (config.tileSize > 0) {
+            if (config.outputFile.empty()) {
+                Log::error("--tile requires an output directory");
+                return 1;
+            }
+            if (config.filtering() || config.reordering() || config.selecting() || config.showStats) {
+                Log::error("--tile streams the input and cannot be combined with --stats, --crop, --every, --sample, --class, --outliers, --voxel or --sort");
+                return 1;
+            }
+            const int result = tileConvert(config, fileFormat);
+            auto tileDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+            Log::info("Total processing time: {} ms", tileDuration.count());
+            return result;
+        }
 
-                // Show file size comparison
-                auto inputSize = fs::file_size(config.inputFile);
-                auto outputSize = fs::file_size(config.outputFile);
-                Log::info("File size: {} bytes -> {} bytes ({:.1f}%)", inputSize, outputSize, (static_cast<double>(outputSize) / static_cast<double>(inputSize)) * 100.0);
-            } else {
-                Log::error("Failed to save point cloud to: {}", config.outputFile);
+        if (config.stream) {
+            if (config.outputFile.empty()) {
+                Log::error("--stream requires an output file");
+                return 1;
+            }
+            if (config.showStats) {
+                Log::warning("--stats is not available in streaming mode");
+            }
+            if (config.filtering() || config.reordering() || config.selecting()) {
+                Log::error("--crop, --every, --sample, --class, --outliers, --voxel and --sort are not available in streaming mode");
                 return 1;
             }
+            const int result = streamConvert(config, fileFormat);
+            auto streamDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+            Log::info("Total processing time: {} ms", streamDuration.count());
+            return result;
+        }
+
+        if ((config.showInfo || config.showStats) && config.outputFile.empty() && !config.filtering() && !config.reordering() && !config.selecting()) {
+            const int result = inspectFile(config, fileFormat);
+            auto inspectDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+            Log::info("Total processing time: {} ms", inspectDuration.count());
+            return result;
+        }
+
+        FileReport report;
+        if (const int result = convertFile(config, fileFormat, nullptr, report); result != 0) {
+            return result;
         }
 
         auto endTime = std::chrono::high_resolution_clock::now();
@@ -310,6 +982,77 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    Log::info("ScanForge CLI Tool completed successfully");
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"ScanForge CLI Tool v1.0.0 - Modern C++23 Point Cloud Processing"};
+
+    AppConfig config;
+
+    // Positional input, or --batch
+    app.add_option("input", config.inputFile, "Input file path (PCD, LAS or LAZ format)")->check(CLI::ExistingFile);
+
+    // Optional arguments
+    app.add_option("-o,--output", config.outputFile, "Output file path");
+    app.add_option("-f,--format", config.outputFormat, "Output format")->check(CLI::IsMember({"pcd", "las", "laz"}))->default_val("pcd");
+    app.add_option("--variant", config.pcdVariant, "PCD variant (only used when format is 'pcd'); 'chunked' compresses in parallel blocks PCL cannot read")->check(CLI::IsMember({"ascii", "binary", "compressed", "chunked"}))->default_val("ascii");
+
+    // Flags
+    app.add_flag("-i,--info", config.showInfo, "Show file information");
+    app.add_flag("-s,--stats", config.showStats, "Show detailed statistics");
+    app.add_flag("-v,--verbose", config.verbose, "Enable debug messages (compiled in unless NDEBUG is set or MIN_LOG_LEVEL is raised)");
+    app.add_flag("--mmap", config.memoryMap, "Memory-map PCD input instead of buffered reads");
+    app.add_option("-j,--threads", config.threads, "Threads used to decode and encode LAS, to parse ASCII PCD and to code chunked compressed PCD (0 = all hardware threads)")->default_val(0);
+    app.add_flag("--stream", config.stream, "Convert chunk by chunk in constant memory (requires --output)");
+    app.add_option("--tile", config.tileSize, "Stream the input into square XY tiles of this size, written to the --output directory")->check(CLI::PositiveNumber);
+    app.add_option("--tile-files", config.maxOpenFiles, "Files kept open at once, tile and spill files together; further tiles are buffered on disk and written at the end")->check(CLI::PositiveNumber)->default_val(64);
+
+    // Filters, applied after loading in this order
+    app.add_option("--outliers", config.outlierNeighbors, "Remove statistical outliers judged on the mean distance to this many neighbours");
+    app.add_option("--outlier-stddev", config.outlierStddev, "Keep points up to this many standard deviations above the mean neighbour distance")->default_val(1.0);
+    app.add_option("--voxel", config.voxelSize, "Downsample to one centroid per voxel of this size")->check(CLI::PositiveNumber);
+    app.add_flag("--index", config.buildIndex, "Write a spatial index next to LAS/LAZ input, so that --crop reads only the points it needs");
+    app.add_option("--crop", config.cropBox, "Keep the points inside the XY box minX minY maxX maxY; indexed LAS/LAZ files read only that region")->expected(4);
+    app.add_option("--every", config.every, "Keep every Nth point of the input, skipping the others while decoding")->check(CLI::PositiveNumber)->default_val(1);
+    app.add_option("--sample", config.sampleSize, "Keep a uniform random sample of this many points, drawn while decoding")->check(CLI::PositiveNumber);
+    app.add_option("--class", config.classes, "Keep only points of these classification codes (LAS classification, PCD label)")->check(CLI::Range(0, 255));
+    app.add_option("--batch", config.batchInputs, "Convert every PCD, LAS and LAZ file of these directories or name patterns ('scans/*.laz') into the --output directory");
+    app.add_option("--io-jobs", config.ioJobs, "Files read or written at once in batch mode")->check(CLI::PositiveNumber)->default_val(2);
+    app.add_option("--io-backend", config.ioBackend, "Asynchronous I/O of --stream and --tile; 'auto' picks io_uring on Linux and overlapped I/O on Windows")->check(CLI::IsMember({"auto", "threads", "io_uring", "overlapped"}))->default_val("auto");
+    app.add_flag("--profile", config.profile, "Print time per stage (header, read, decompress, decode, format, write), point and byte counters and busy time per thread");
+    app.add_option("--profile-json", config.profileJson, "Write the --profile report as JSON to this file");
+    app.add_option("--sort", config.sortOrder, "Reorder points before writing; 'morton' keeps spatial neighbours together")->check(CLI::IsMember({"none", "morton"}))->default_val("none");
+
+    // Parse command line
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        return app.exit(e);
+    }
+
+    // Configure logging
+    if (config.verbose) {
+        Logger::getInstance().setLevel(LogLevel::DEBUG);
+        if constexpr (Logger::MIN_LEVEL > LogLevel::DEBUG) {
+            Log::warning("This build has debug messages compiled out (MIN_LOG_LEVEL), --verbose adds nothing");
+        }
+    }
+
+    Log::info("ScanForge CLI Tool starting...");
+    if (config.profiling()) {
+        if (!Profiler::COMPILED_IN) {
+            Log::warning("This build has profiling compiled out (ENABLE_PROFILING=OFF), the report will be empty");
+        }
+        Profiler::instance().enable(true);
+    }
+
+    const int result = run(config);
+    if (config.profiling() && !reportProfile(config) && result == 0) {
+        return 1;
+    }
+    if (result == 0) {
+        Log::info("ScanForge CLI Tool completed successfully");
+    }
+    return result;
+}
@@ -80,6 +80,21 @@ function(display_status)
     else()
         message(STATUS "  Testing:            Disabled")
     endif()
+    if(ENABLE_AVX2)
+        message(STATUS "  AVX2 kernels:       Enabled")
+    else()
+        message(STATUS "  AVX2 kernels:       Disabled")
+    endif()
+    if(ENABLE_PROFILING)
+        message(STATUS "  Profiling:          Enabled")
+    else()
+        message(STATUS "  Profiling:          Disabled")
+    endif()
+    if(MIN_LOG_LEVEL)
+        message(STATUS "  Min log level:      ${MIN_LOG_LEVEL}")
+    else()
+        message(STATUS "  Min log level:      INFO in NDEBUG builds, DEBUG otherwise")
+    endif()
     if(Doxygen_FOUND)
         message(STATUS "  Documentation:      Enabled")
     else()
@@ -18,6 +18,11 @@ endif()
 set(CMAKE_EXPORT_COMPILE_COMMANDS ON CACHE INTERNAL "Generate compile_commands.json for clang based tools")
 set(CMAKE_POSITION_INDEPENDENT_CODE ON)
 option(ENABLE_IPO "Enable Interprocedural Optimization, aka Link Time Optimization (LTO)" OFF)
+option(ENABLE_AVX2 "Build SIMD kernels with AVX2 (x86-64 only, SSE2/NEON are always used)" OFF)
+# ON in every build type, Release included; the timers stay off at runtime until --profile
+option(ENABLE_PROFILING "Compile in the stage timers and counters reported by --profile (off at runtime until enabled)" ON)
+set(MIN_LOG_LEVEL "" CACHE STRING "Lowest log level compiled in (DEBUG, INFO, WARNING or ERROR; empty: INFO in NDEBUG builds, DEBUG otherwise)")
+set_property(CACHE MIN_LOG_LEVEL PROPERTY STRINGS "" "DEBUG" "INFO" "WARNING" "ERROR")
 
 if(ENABLE_IPO)
   include(CheckIPOSupported)
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "simd/Simd.hpp"
+#include "spatial/Geometry.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace scanforge {
+
+/**
+ * @brief Statistics of a set of points, computed in one pass and mergeable
+ *
+ * add() reads its points once. It gathers the coordinates of each block of BLOCK_POINTS
+ * finite points into columns, and runs the SIMD min/max, sum and squared-deviation
+ * kernels over them. Each block then joins the running totals through the pairwise update
+ * of Chan et al. That update is also what merge() uses, so statistics of slices, chunks
+ * or files combine exactly like the statistics of their union: compute() gives each thread
+ * its own slice, and a chunked reader adds one chunk at a time in constant memory.
+ *
+ * Colors, classes and returns are counted when the point type has them (see HasColor,
+ * HasClassification, HasReturns). Non-finite points are counted, and nothing else is
+ * taken from them.
+ *
+ * @code
+ * LASReader reader("scan.laz");
+ * auto stats = CloudStatistics::compute<PointWith<field::Classification, field::Returns>>(reader, 0);
+ * std::println("{} ground points", stats->classCounts()[2]);
+ * @endcode
+ */
+class CloudStatistics {
+   public:
+    using Histogram = std::array<uint64_t, 256>;
+
+    static constexpr size_t BLOCK_POINTS = 1024;             // Points gathered into columns per kernel call
+    static constexpr size_t CHUNK_POINTS = size_t{1} << 20;  // Points a reader decodes per chunk
+    static constexpr size_t MIN_POINTS_PER_THREAD = 65536;   // Smaller slices are not worth a thread
+
+    /**
+     * @brief Add points to the statistics
+     * @param points Points of any type; non-finite positions are only counted
+     */
+    template <typename PointT>
+    void add(std::span<const PointT> points) {
+        SCANFORGE_PROFILE_SCOPE("stats.reduce");
+        std::array<std::array<float, BLOCK_POINTS>, 3> columns;
+        hasColor_ = hasColor_ || HasColor<PointT>;
+        hasClasses_ = hasClasses_ || HasClassification<PointT>;
+        hasReturns_ = hasReturns_ || HasReturns<PointT>;
+
+        for (size_t first = 0; first < points.size(); first += BLOCK_POINTS) {
+            const size_t n = std::min(BLOCK_POINTS, points.size() - first);
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const PointT& point = points[first + i];
+                const Point3D& p = getPosition(point);
+                if (!spatial::isFinite(p)) {
+                    ++nonFinite_;
+                    continue;
+                }
+                columns[0][kept] = p.x;
+                columns[1][kept] = p.y;
+                columns[2][kept] = p.z;
+                ++kept;
+                if constexpr (HasColor<PointT>) {
+                    ++color_[0][point.color.r];
+                    ++color_[1][point.color.g];
+                    ++color_[2][point.color.b];
+                }
+                if constexpr (HasClassification<PointT>) {
+                    ++classes_[point.classification];
+                }
+                if constexpr (HasReturns<PointT>) {
+                    ++returns_[point.returnNumber & 0x0F];
+                }
+            }
+            if (kept == 0) {
+                continue;
+            }
+
+            Moments block;
+            block.count = kept;
+            for (size_t axis = 0; axis < 3; ++axis) {
+                float lo, hi;
+                simd::minMax(columns[axis].data(), kept, lo, hi);
+                block.min[axis] = lo;
+                block.max[axis] = hi;
+                block.mean[axis] = simd::sum(columns[axis].data(), kept) / static_cast<double>(kept);
+                block.m2[axis] = simd::sumSquaredDeviations(columns[axis].data(), kept, block.mean[axis]);
+            }
+            moments_.merge(block);
+        }
+    }
+
+    /** @brief Combine with the statistics of other points, as if they had been added here */
+    void merge(const CloudStatistics& other) {
+        moments_.merge(other.moments_);
+        nonFinite_ += other.nonFinite_;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            addCounts(color_[channel], other.color_[channel]);
+        }
+        addCounts(classes_, other.classes_);
+        addCounts(returns_, other.returns_);
+        hasColor_ = hasColor_ || other.hasColor_;
+        hasClasses_ = hasClasses_ || other.hasClasses_;
+        hasReturns_ = hasReturns_ || other.hasReturns_;
+    }
+
+    /**
+     * @brief Statistics of points, computed by slices on up to threads threads and merged
+     * @param threadCount Thread count, 0 uses every available thread
+     */
+    template <typename PointT>
+    static CloudStatistics compute(std::span<const PointT> points, unsigned threadCount = 1) {
+        const unsigned threads = tooling::workerThreads(points.size(), threadCount, MIN_POINTS_PER_THREAD);
+        if (threads <= 1) {
+            CloudStatistics stats;
+            stats.add(points);
+            return stats;
+        }
+
+        const size_t slice = (points.size() + threads - 1) / threads;
+        std::vector<CloudStatistics> parts(threads);
+        tooling::parallelSlices(points.size(), threads, [&](size_t first, size_t count) { parts[first / slice].add(points.subspan(first, count)); });
+        for (size_t i = 1; i < parts.size(); ++i) {
+            parts[0].merge(parts[i]);
+        }
+        return parts[0];
+    }
+
+    template <typename PointT>
+    static CloudStatistics compute(const PointCloud<PointT>& cloud, unsigned threadCount = 1) {
+        return compute(std::span<const PointT>(cloud.points), threadCount);
+    }
+
+    /**
+     * @brief Statistics of every remaining point of a chunked reader, in constant memory
+     *
+     * One chunk of chunkSize points is decoded at a time and reduced on up to threads threads.
+     * PointXYZRGB chunks come from next(); other point types need a reader with read<PointT>(),
+     * such as LASReader.
+     *
+     * @param reader io::PointReader, or a reader with read<PointT>()
+     * @param threads Thread count of each chunk's reduction, 0 uses every available thread
+     * @param chunkSize Points per chunk
+     * @return The statistics, or nullopt if the reader failed
+     */
+    template <typename PointT = PointXYZRGB, typename Reader>
+        requires requires(const Reader& r) { { r.good() } -> std::convertible_to<bool>; }
+    static std::optional<CloudStatistics> compute(Reader& reader, unsigned threads = 1, size_t chunkSize = CHUNK_POINTS) {
+        std::vector<PointT> chunk(std::max<size_t>(1, chunkSize));
+        CloudStatistics stats;
+        for (;;) {
+            size_t count = 0;
+            if constexpr (std::same_as<PointT, PointXYZRGB>) {
+                count = reader.next(std::span<PointXYZRGB>(chunk));
+            } else {
+                count = reader.template read<PointT>(std::span<PointT>(chunk));
+            }
+            if (count == 0) {
+                break;
+            }
+            stats.merge(compute(std::span<const PointT>(chunk.data(), count), threads));
+        }
+        if (!reader.good()) {
+            return std::nullopt;
+        }
+        return stats;
+    }
+
+    /** @brief Finite points added */
+    uint64_t count() const { return moments_.count; }
+    /** @brief Points skipped for a NaN or infinite coordinate */
+    uint64_t nonFinite() const { return nonFinite_; }
+    bool empty() const { return moments_.count == 0; }
+
+    /** @brief Bounds of the finite points, {0,0,0} twice when there are none */
+    std::pair<Point3D, Point3D> bounds() const {
+        if (empty()) {
+            return {
+                {0, 0, 0},
+                {0, 0, 0}
+            };
+        }
+        return {toPoint(moments_.min), toPoint(moments_.max)};
+    }
+
+    /** @brief Mean position, accumulated in double precision; {0,0,0} when empty */
+    Point3D centroid() const { return toPoint(moments_.mean); }
+
+    /** @brief Population variance per axis */
+    Point3D variance() const {
+        if (empty()) {
+            return {0, 0, 0};
+        }
+        const double n = static_cast<double>(moments_.count);
+        return {static_cast<float>(moments_.m2[0] / n), static_cast<float>(moments_.m2[1] / n), static_cast<float>(moments_.m2[2] / n)};
+    }
+
+    /** @brief Standard deviation per axis */
+    Point3D standardDeviation() const {
+        const Point3D v = variance();
+        return {std::sqrt(v.x), std::sqrt(v.y), std::sqrt(v.z)};
+    }
+
+    /** @brief Points per unit of area of the XY bounds; 0 when the bounds have no area */
+    double density() const {
+        const double area = (moments_.max[0] - moments_.min[0]) * (moments_.max[1] - moments_.min[1]);
+        return empty() || !(area > 0) ? 0.0 : static_cast<double>(moments_.count) / area;
+    }
+
+    /** @brief Whether the points carried colors, classes, return numbers */
+    bool hasColor() const { return hasColor_; }
+    bool hasClasses() const { return hasClasses_; }
+    bool hasReturns() const { return hasReturns_; }
+
+    /** @brief Points per 8-bit value of a channel: 0 red, 1 green, 2 blue */
+    const Histogram& colorHistogram(size_t channel) const { return color_[channel]; }
+
+    /** @brief Mean of each color channel */
+    std::array<double, 3> meanColor() const {
+        std::array<double, 3> mean{};
+        for (size_t channel = 0; channel < 3 && !empty(); ++channel) {
+            double total = 0;
+            for (size_t value = 0; value < color_[channel].size(); ++value) {
+                total += static_cast<double>(value) * static_cast<double>(color_[channel][value]);
+            }
+            mean[channel] = total / static_cast<double>(moments_.count);
+        }
+        return mean;
+    }
+
+    /** @brief Points per classification code */
+    const Histogram& classCounts() const { return classes_; }
+
+    /** @brief Points per return number, 0 to 15 */
+    const std::array<uint64_t, 16>& returnCounts() const { return returns_; }
+
+   private:
+    // Count, bounds, mean and sum of squared deviations of each axis
+    struct Moments {
+        uint64_t count = 0;
+        std::array<double, 3> min{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+        std::array<double, 3> max{-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+        std::array<double, 3> mean{};
+        std::array<double, 3> m2{};
+
+        // Pairwise update: exact for the union of both sets, whatever their sizes
+        void merge(const Moments& other) {
+            if (other.count == 0) {
+                return;
+            }
+            if (count == 0) {
+                *this = other;
+                return;
+            }
+            const double n = static_cast<double>(count);
+            const double m = static_cast<double>(other.count);
+            const double total = n + m;
+            for (size_t axis = 0; axis < 3; ++axis) {
+                const double delta = other.mean[axis] - mean[axis];
+                mean[axis] += delta * (m / total);
+                m2[axis] += other.m2[axis] + delta * delta * (n * m / total);
+                min[axis] = std::min(min[axis], other.min[axis]);
+                max[axis] = std::max(max[axis], other.max[axis]);
+            }
+            count += other.count;
+        }
+    };
+
+    template <size_t N>
+    static void addCounts(std::array<uint64_t, N>& into, const std::array<uint64_t, N>& from) {
+        for (size_t i = 0; i < N; ++i) {
+            into[i] += from[i];
+        }
+    }
+
+    static Point3D toPoint(const std::array<double, 3>& v) { return {static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2])}; }
+
+    Moments moments_;
+    uint64_t nonFinite_ = 0;
+    std::array<Histogram, 3> color_{};
+    Histogram classes_{};
+    std::array<uint64_t, 16> returns_{};
+    bool hasColor_ = false;
+    bool hasClasses_ = false;
+    bool hasReturns_ = false;
+};
+
+}  // namespace scanforge
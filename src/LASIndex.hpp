@@ -0,0 +1,435 @@
+#pragma once
+
+#include "LASProcessor.hpp"
+#include "PointCloudTypes.hpp"
+#include "io/LoadFilter.hpp"
+#include "tooling/Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace scanforge {
+
+/**
+ * @brief Sidecar spatial index of a LAS or LAZ file, in the spirit of LAStools' LAX files
+ *
+ * The XY extent of the header is divided into a square grid of 2^levels by 2^levels cells,
+ * the leaves of a quadtree. For every occupied cell the index lists the runs of consecutive
+ * point records falling into it; runs closer than mergeGap records are joined, trading a few
+ * extra records for fewer seeks. A box query then reads only the runs of the cells it touches
+ * and tests those points exactly, so the result equals a full scan of the file. Points
+ * outside the header bounds are kept in the border cells; non-finite points are not indexed.
+ *
+ * The index is built in one streaming pass and saved next to the file (sidecarPath()). It
+ * records the point count and bounds of the header it was built from and refuses to load
+ * against a different file. Files written in scan or tile order get few runs per cell;
+ * sorting a file spatially first (--sort morton) makes the index far more selective.
+ *
+ * @code
+ * LASReader reader("city.laz");
+ * LASIndex index;
+ * if (!index.load(LASIndex::sidecarPath("city.laz"), reader.header())) {
+ *     index.build(reader);
+ *     index.save(LASIndex::sidecarPath("city.laz"));
+ * }
+ * PointCloudXYZRGB block;
+ * index.read(reader, {1000, 2000, 1100, 2100}, block);
+ * @endcode
+ */
+class LASIndex {
+   public:
+    /** @brief Inclusive XY rectangle in file coordinates */
+    struct Box {
+        double minX = 0;
+        double minY = 0;
+        double maxX = 0;
+        double maxY = 0;
+
+        bool contains(const Point3D& p) const {
+            const auto x = static_cast<double>(p.x);
+            const auto y = static_cast<double>(p.y);
+            return x >= minX && x <= maxX && y >= minY && y <= maxY;
+        }
+    };
+
+    /** @brief Run of consecutive point records [first, first + count) */
+    struct Interval {
+        uint64_t first = 0;
+        uint64_t count = 0;
+    };
+
+    struct Options {
+        unsigned levels = 0;    // Quadtree depth, at most MAX_LEVELS; 0 picks one for about TARGET_CELL_POINTS points per cell
+        uint64_t mergeGap = 0;  // Join runs this close; 0 uses the LAZ chunk size, or 64 KiB of records for LAS
+    };
+
+    static constexpr unsigned MAX_LEVELS = 16;
+    static constexpr uint64_t TARGET_CELL_POINTS = 50000;
+    static constexpr std::string_view EXTENSION = ".sfi";
+
+    /** @brief Where the index of a LAS file is kept: the file name with EXTENSION appended */
+    static std::filesystem::path sidecarPath(const std::filesystem::path& lasFile) {
+        auto path = lasFile;
+        path += EXTENSION;
+        return path;
+    }
+
+    /**
+     * @brief Index a file in one pass over its points, replacing the previous content
+     * @param reader Open reader; it is rewound first and left at the end of the file
+     * @param options Grid depth and run merging
+     * @return False if the reader fails
+     */
+    bool build(LASReader& reader, const Options& options) {
+        cells_.clear();
+        intervals_.clear();
+        if (!reader.seek(0)) {
+            Log::error("Cannot index a LAS file that is not open");
+            return false;
+        }
+
+        const auto& header = reader.header();
+        pointCount_ = reader.size();
+        setBounds(header);
+        levels_ = options.levels != 0 ? std::min(options.levels, MAX_LEVELS) : levelsFor(pointCount_);
+        mergeGap_ = options.mergeGap != 0 ? options.mergeGap : reader.chunkSize() != 0 ? reader.chunkSize() : std::max<uint64_t>(1, MERGE_BYTES / header.pointDataRecordLength);
+        setGrid();
+
+        std::unordered_map<uint32_t, std::vector<Interval>> runs;
+        std::vector<PointXYZRGB> chunk(CHUNK_POINTS);
+        uint64_t point = 0;
+        uint32_t lastKey = 0;
+        std::vector<Interval>* last = nullptr;
+        while (const size_t n = reader.next(chunk)) {
+            for (size_t i = 0; i < n; ++i, ++point) {
+                const Point3D& p = chunk[i].position;
+                if (!std::isfinite(p.x) || !std::isfinite(p.y)) {
+                    continue;
+                }
+                const uint32_t key = cellKey(column(static_cast<double>(p.x)), row(static_cast<double>(p.y)));
+                if (last == nullptr || key != lastKey) {
+                    last = &runs[key];
+                    lastKey = key;
+                }
+                if (!last->empty() && point - (last->back().first + last->back().count) <= mergeGap_) {
+                    last->back().count = point + 1 - last->back().first;
+                } else {
+                    last->push_back({point, 1});
+                }
+            }
+        }
+        if (!reader.good() || point != pointCount_) {
+            Log::error("Failed to read the points to index after {} of {}", point, pointCount_);
+            return false;
+        }
+
+        // Cells sorted by key, so that a query finds the cells of one grid row by binary search
+        cells_.reserve(runs.size());
+        for (const auto& [key, cellRuns] : runs) {
+            cells_.push_back({key, static_cast<uint32_t>(cellRuns.size()), 0, 0});
+        }
+        std::sort(cells_.begin(), cells_.end(), [](const Cell& a, const Cell& b) { return a.key < b.key; });
+        for (Cell& cell : cells_) {
+            const auto& cellRuns = runs[cell.key];
+            cell.firstInterval = intervals_.size();
+            for (const Interval& run : cellRuns) {
+                cell.points += run.count;
+            }
+            intervals_.insert(intervals_.end(), cellRuns.begin(), cellRuns.end());
+        }
+
+        Log::debug("Indexed {} points in {} cells of a {}-level grid with {} runs", pointCount_, cells_.size(), levels_, intervals_.size());
+        return true;
+    }
+
+    bool build(LASReader& reader) { return build(reader, Options{}); }
+
+    /**
+     * @brief Write the index to a file
+     * @return False if the file cannot be written
+     */
+    bool save(const std::filesystem::path& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            Log::error("Failed to create LAS index: {}", filename.string());
+            return false;
+        }
+
+        const FileHeader header{MAGIC, VERSION, levels_, static_cast<uint32_t>(cells_.size()), pointCount_, mergeGap_, intervals_.size(), bounds_};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(cells_.data()), static_cast<std::streamsize>(cells_.size() * sizeof(Cell)));
+        file.write(reinterpret_cast<const char*>(intervals_.data()), static_cast<std::streamsize>(intervals_.size() * sizeof(Interval)));
+        if (!file.good()) {
+            Log::error("Failed to write LAS index: {}", filename.string());
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read an index written by save()
+     * @param filename Index file
+     * @param header Header of the LAS file the index should belong to
+     * @return False if the file is missing, corrupt or was built for another file
+     */
+    bool load(const std::filesystem::path& filename, const LASProcessor::LASHeader& header) {
+        cells_.clear();
+        intervals_.clear();
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        FileHeader stored{};
+        file.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+        if (!file.good() || stored.magic != MAGIC || stored.version != VERSION || stored.levels > MAX_LEVELS) {
+            Log::error("Not a LAS index: {}", filename.string());
+            return false;
+        }
+        if (stored.points != header.getTotalPointCount() || stored.bounds != std::array{header.minX, header.minY, header.maxX, header.maxY}) {
+            Log::warning("LAS index {} was built for another version of the file and is ignored", filename.string());
+            return false;
+        }
+
+        // The counts come off disk: check them against the file size before allocating for them
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(filename, error);
+        const uintmax_t payload = error || fileSize < sizeof(stored) ? 0 : fileSize - sizeof(stored);
+        if (stored.cells > payload / sizeof(Cell) || stored.intervals > (payload - stored.cells * sizeof(Cell)) / sizeof(Interval)) {
+            Log::error("LAS index {} lists {} cells and {} runs, more than its {} bytes can hold", filename.string(), stored.cells, stored.intervals, fileSize);
+            return false;
+        }
+
+        std::vector<Cell> cells(stored.cells);
+        std::vector<Interval> intervals(static_cast<size_t>(stored.intervals));
+        file.read(reinterpret_cast<char*>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(Cell)));
+        file.read(reinterpret_cast<char*>(intervals.data()), static_cast<std::streamsize>(intervals.size() * sizeof(Interval)));
+        if (!file.good() || !consistent(cells, intervals, stored)) {
+            Log::error("LAS index is truncated or corrupt: {}", filename.string());
+            return false;
+        }
+
+        pointCount_ = stored.points;
+        bounds_ = stored.bounds;
+        levels_ = stored.levels;
+        mergeGap_ = stored.mergeGap;
+        setGrid();
+        cells_ = std::move(cells);
+        intervals_ = std::move(intervals);
+        return true;
+    }
+
+    bool empty() const { return cells_.empty(); }
+
+    /** @brief Occupied cells */
+    size_t cellCount() const { return cells_.size(); }
+
+    /** @brief Runs over all cells */
+    size_t intervalCount() const { return intervals_.size(); }
+
+    unsigned levels() const { return levels_; }
+
+    /**
+     * @brief Record runs that may hold points inside a box
+     * @return Sorted, disjoint runs; their points are a superset of the points in the box
+     */
+    std::vector<Interval> query(const Box& box) const {
+        std::vector<Interval> found;
+        if (cells_.empty() || !(box.minX <= box.maxX && box.minY <= box.maxY)) {
+            return found;
+        }
+
+        const uint32_t firstColumn = column(box.minX), lastColumn = column(box.maxX);
+        for (uint32_t y = row(box.minY), lastRow = row(box.maxY); y <= lastRow; ++y) {
+            auto cell = std::lower_bound(cells_.begin(), cells_.end(), cellKey(firstColumn, y), [](const Cell& c, uint32_t key) { return c.key < key; });
+            for (; cell != cells_.end() && cell->key <= cellKey(lastColumn, y); ++cell) {
+                const auto runs = std::span(intervals_).subspan(static_cast<size_t>(cell->firstInterval), cell->intervalCount);
+                found.insert(found.end(), runs.begin(), runs.end());
+            }
+        }
+
+        // Runs of neighbouring cells interleave; join those that overlap or lie within mergeGap
+        std::sort(found.begin(), found.end(), [](const Interval& a, const Interval& b) { return a.first < b.first; });
+        size_t merged = 0;
+        for (size_t i = 1; i < found.size(); ++i) {
+            Interval& current = found[merged];
+            const uint64_t end = current.first + current.count;
+            if (found[i].first <= end + mergeGap_) {
+                current.count = std::max(end, found[i].first + found[i].count) - current.first;
+            } else {
+                found[++merged] = found[i];
+            }
+        }
+        found.resize(found.empty() ? 0 : merged + 1);
+        return found;
+    }
+
+    /**
+     * @brief Read the points inside a box, seeking only to the runs the index lists
+     * @param reader Open reader of the indexed file; its position is changed
+     * @param box Inclusive XY rectangle
+     * @param out Receives the points inside the box, in file order
+     * @return False if the index does not belong to the reader's file or a read fails
+     */
+    bool read(LASReader& reader, const Box& box, PointCloudXYZRGB& out) const {
+        out.clear();
+        if (reader.size() != pointCount_) {
+            Log::error("LAS index of {} points does not match a file of {}", pointCount_, reader.size());
+            return false;
+        }
+
+        std::vector<PointXYZRGB> chunk(CHUNK_POINTS);
+        uint64_t scanned = 0;
+        const auto runs = query(box);
+        for (const Interval& run : runs) {
+            if (!reader.seek(run.first)) {
+                return false;
+            }
+            for (uint64_t left = run.count; left > 0;) {
+                const auto want = static_cast<size_t>(std::min<uint64_t>(left, chunk.size()));
+                if (reader.next(std::span(chunk).first(want)) != want) {
+                    Log::error("Failed to read points {} to {}", run.first, run.first + run.count);
+                    return false;
+                }
+                for (size_t i = 0; i < want; ++i) {
+                    if (box.contains(chunk[i].position)) {
+                        out.push_back(chunk[i]);
+                    }
+                }
+                left -= want;
+            }
+            scanned += run.count;
+        }
+
+        out.width = static_cast<uint32_t>(out.size());
+        out.height = 1;
+        Log::debug("Box query read {} of {} points in {} runs and kept {}", scanned, pointCount_, runs.size(), out.size());
+        return true;
+    }
+
+    /**
+     * @brief Load the points of a LAS file inside a box
+     *
+     * Uses the sidecar index when one matching the file exists, and otherwise decodes the whole
+     * file with the box pushed into the decode loop, so memory stays proportional to the result
+     * either way.
+     *
+     * @param filename LAS or LAZ file
+     * @param box Inclusive XY rectangle
+     * @param threadCount Threads decoding the file when there is no index; 0 uses every hardware thread
+     * @param resource Memory resource the points and decode buffers allocate from
+     * @return Header of the file and the points inside the box; an invalid header on error
+     */
+    static std::tuple<LASProcessor::LASHeader, PointCloudXYZRGB> loadBox(const std::filesystem::path& filename, const Box& box, unsigned threadCount = 1,
+                                                                         std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        {
+            LASReader reader(filename);
+            if (!reader.is_open()) {
+                return {LASProcessor::LASHeader{}, PointCloudXYZRGB{}};
+            }
+
+            LASIndex index;
+            if (index.load(sidecarPath(filename), reader.header())) {
+                PointCloudXYZRGB cloud(resource);
+                if (!index.read(reader, box, cloud)) {
+                    return {LASProcessor::LASHeader{}, PointCloudXYZRGB{}};
+                }
+                return {reader.header(), std::move(cloud)};
+            }
+        }
+
+        Log::debug("No index for {}, scanning every point", filename.string());
+        io::LoadFilter filter;
+        filter.box = io::LoadFilter::Box{.minX = box.minX, .minY = box.minY, .maxX = box.maxX, .maxY = box.maxY};
+        LASProcessor processor(resource);
+        return processor.loadLAS(filename, filter, threadCount);
+    }
+
+   private:
+    static constexpr std::array<char, 4> MAGIC{'S', 'F', 'I', 'X'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t CHUNK_POINTS = 65536;
+    static constexpr uint64_t MERGE_BYTES = uint64_t{64} << 10;  // Reading this much is cheaper than a seek
+
+    // Cells store their runs as intervals_[firstInterval, firstInterval + intervalCount)
+    struct Cell {
+        uint32_t key;  // row << levels | column
+        uint32_t intervalCount;
+        uint64_t firstInterval;
+        uint64_t points;
+    };
+
+    // On-disk layout: this header, the cells, then the runs, all little endian
+    struct FileHeader {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t levels;
+        uint32_t cells;
+        uint64_t points;
+        uint64_t mergeGap;
+        uint64_t intervals;
+        std::array<double, 4> bounds;  // minX, minY, maxX, maxY of the LAS header
+    };
+    static_assert(sizeof(Cell) == 24 && sizeof(Interval) == 16 && sizeof(FileHeader) == 72);
+
+    static unsigned levelsFor(uint64_t points) {
+        unsigned levels = 0;
+        while (levels < MAX_LEVELS && (points >> (2 * levels)) > TARGET_CELL_POINTS) {
+            ++levels;
+        }
+        return levels;
+    }
+
+    void setBounds(const LASProcessor::LASHeader& header) { bounds_ = {header.minX, header.minY, header.maxX, header.maxY}; }
+
+    // Square cells covering the larger side of the header bounds
+    void setGrid() {
+        cellsPerSide_ = uint32_t{1} << levels_;
+        const double extent = std::max(bounds_[2] - bounds_[0], bounds_[3] - bounds_[1]);
+        cellSize_ = extent > 0 ? extent / cellsPerSide_ : 1.0;
+    }
+
+    // Coordinates outside the bounds fall into the border cells
+    uint32_t cellOf(double coordinate, double origin) const {
+        const double cell = std::floor((coordinate - origin) / cellSize_);
+        return static_cast<uint32_t>(std::clamp(cell, 0.0, static_cast<double>(cellsPerSide_ - 1)));
+    }
+    uint32_t column(double x) const { return cellOf(x, bounds_[0]); }
+    uint32_t row(double y) const { return cellOf(y, bounds_[1]); }
+    uint32_t cellKey(uint32_t column, uint32_t row) const { return row << levels_ | column; }
+
+    static bool consistent(std::span<const Cell> cells, std::span<const Interval> intervals, const FileHeader& header) {
+        uint64_t next = 0;
+        for (size_t c = 0; c < cells.size(); ++c) {
+            if (cells[c].firstInterval != next || (c > 0 && cells[c].key <= cells[c - 1].key) || uint64_t{cells[c].key} >> (2 * header.levels) != 0) {
+                return false;
+            }
+            next += cells[c].intervalCount;
+        }
+        return next == intervals.size() && std::ranges::all_of(intervals, [&](const Interval& run) { return run.count <= header.points && run.first <= header.points - run.count; });
+    }
+
+    std::vector<Cell> cells_;
+    std::vector<Interval> intervals_;
+    std::array<double, 4> bounds_{};  // minX, minY, maxX, maxY
+    uint64_t pointCount_ = 0;
+    uint64_t mergeGap_ = 0;
+    unsigned levels_ = 0;
+    uint32_t cellsPerSide_ = 1;
+    double cellSize_ = 1.0;
+};
+
+}  // namespace scanforge
@@ -1,21 +1,35 @@
 #pragma once
 
+#include "PointCloudSoA.hpp"
 #include "PointCloudTypes.hpp"
+#include "codec/LAZCodec.hpp"
+#include "io/AsyncFile.hpp"
+#include "io/LoadFilter.hpp"
+#include "io/MappedFile.hpp"
+#include "io/PointStream.hpp"
+#include "simd/Simd.hpp"
+#include "tooling/Arena.hpp"
 #include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Profiler.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace scanforge {
@@ -24,11 +38,14 @@ using Log = scanforge::tooling::Log;
 
 /**
  * @brief LAS (LASer) file processor supporting LAS 1.2/1.3/1.4 formats
- * Handles both loading and saving of LAS files
+ * Handles both loading and saving of LAS files, and of LASzip-compressed LAZ files in point formats 0-3 and 6-8
  * Based on ASPRS LAS specification
  * Reference: https://www.asprs.org/divisions-committees/lidar-division/laser-las-file-format-exchange-activities
  */
 class LASProcessor {
+    friend class LASReader;
+    friend class LASWriter;
+
    public:
     // LAS Point Data Record Formats
     enum class PointFormat : uint8_t {
@@ -72,6 +89,9 @@ class LASProcessor {
         uint64_t numberOfPointRecords{0};                      // LAS 1.4+
         std::array<uint64_t, 15> numberOfPointsByReturn{};     // LAS 1.4+
 
+        // LAZ: point records are LASzip-compressed, flagged by bit 7 of the point format byte
+        bool compressed{false};
+
         // Additional fields for compatibility with PCD-style usage
         uint32_t width{0};
         uint32_t height{1};
@@ -128,62 +148,232 @@ class LASProcessor {
         }
     };
 
+    /**
+     * @brief Byte layout of one point data record, compiled once per file from its header
+     *
+     * The stride is the header's pointDataRecordLength, so records carrying extra bytes
+     * beyond the standard format are stepped over correctly. Intensity (byte 12), return
+     * numbers (byte 14) and classification are present in every format; their packing
+     * differs between the legacy formats 0-5 and the extended formats 6-10.
+     */
+    struct RecordLayout {
+        size_t stride = 0;
+        std::optional<size_t> rgbOffset;      // Red; green and blue follow as uint16
+        std::optional<size_t> gpsTimeOffset;  // double
+        std::optional<size_t> nirOffset;      // uint16 near infrared
+        bool extended = false;                // Formats 6-10
+
+        bool isValid() const { return stride != 0; }
+    };
+
+    /**
+     * @brief Compile the record layout of a LAS point format
+     * @param header LAS header providing format and record length
+     * @return Layout, invalid when the format is unknown or the record length too short
+     */
+    static RecordLayout createRecordLayout(const LASHeader& header) {
+        const auto format = static_cast<uint8_t>(header.pointDataRecordFormat);
+        if (format > static_cast<uint8_t>(PointFormat::FORMAT_10) || header.pointDataRecordLength < getPointRecordLength(header.pointDataRecordFormat)) {
+            return {};
+        }
+
+        RecordLayout layout;
+        layout.stride = header.pointDataRecordLength;
+        layout.extended = format >= 6;
+        if (header.hasRGB()) {
+            // Formats 0-5 share a 20-byte core, 6-10 a 30-byte core that already holds GPS time
+            layout.rgbOffset = format >= 6 ? 30 : (header.hasGPSTime() ? 28 : 20);
+        }
+        if (header.hasGPSTime()) {
+            layout.gpsTimeOffset = format >= 6 ? 22 : 20;
+        }
+        if (header.pointDataRecordFormat == PointFormat::FORMAT_8 || header.pointDataRecordFormat == PointFormat::FORMAT_10) {
+            layout.nirOffset = 36;
+        }
+        return layout;
+    }
+
+    /**
+     * @param resource Resource the loaded clouds and the buffers of a load allocate from; a
+     *                 tooling::Arena reused from file to file keeps loads off the global heap
+     */
+    explicit LASProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : resource_(resource) {}
+
+    /** @brief Resource loaded clouds allocate from */
+    std::pmr::memory_resource* memoryResource() const { return resource_; }
+
     /**
      * @brief Load point cloud from LAS file
+     *
+     * With more than one thread the file is memory-mapped and the fixed-size records are split
+     * into contiguous slices, each decoded by its own thread straight into the output cloud.
+     * LAZ files are always mapped; their chunks are decompressed by the threads in parallel.
+     *
+     * The point type selects what is decoded: positions always, and each attribute of
+     * PointT (see field::Color, field::Intensity, ...) from the record; the other bytes of a
+     * record are skipped. Attributes the point format lacks keep their defaults.
+     *
+     * @tparam PointT Point3D, PointXYZRGB or a PointWith<...> composition
      * @param filename Path to LAS file
+     * @param threadCount Number of decoding threads, 0 uses every hardware thread
      * @return Tuple of header and point cloud
      */
-    std::tuple<LASHeader, PointCloudXYZRGB> loadLAS(const std::filesystem::path& filename) {
+    template <typename PointT = PointXYZRGB>
+    std::tuple<LASHeader, PointCloud<PointT>> loadLAS(const std::filesystem::path& filename, unsigned threadCount = 1) {
+        return loadLAS<PointT>(filename, io::LoadFilter{}, threadCount);
+    }
+
+    /**
+     * @brief Load the points of a LAS file that pass a filter
+     *
+     * The filter runs inside the decode loop, so rejected points are never stored: records the
+     * stride skips are not decoded, and the attributes a predicate needs are read only for
+     * points inside the box. The file is memory-mapped as for a parallel loadLAS(). The cloud
+     * is unorganized and in file order.
+     *
+     * @param filter Points to keep (see io::LoadFilter)
+     * @return Tuple of header and the kept points; an empty cloud if the filter is invalid
+     */
+    template <typename PointT = PointXYZRGB>
+    std::tuple<LASHeader, PointCloud<PointT>> loadLAS(const std::filesystem::path& filename, const io::LoadFilter& filter, unsigned threadCount = 1) {
+        if (!filter.isValid()) {
+            return {LASHeader{}, PointCloud<PointT>{}};
+        }
+
         std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             Log::error("Failed to open LAS file: {}", filename.string());
-            return {LASHeader{}, PointCloudXYZRGB{}};
+            return {LASHeader{}, PointCloud<PointT>{}};
         }
 
         LASHeader header;
         if (!parseHeader(file, header)) {
             Log::error("Failed to parse LAS header from file: {}", filename.string());
-            return {LASHeader{}, PointCloudXYZRGB{}};
+            return {LASHeader{}, PointCloud<PointT>{}};
         }
 
         if (!header.isValid()) {
             Log::error("Invalid LAS header in file: {}", filename.string());
-            return {header, PointCloudXYZRGB{}};
+            return {header, PointCloud<PointT>{}};
         }
 
-        PointCloudXYZRGB pointCloud;
-        if (!loadPointData(file, header, pointCloud)) {
+        PointCloud<PointT> pointCloud(resource_);
+        const unsigned threads = decoderThreads(header, threadCount);
+        bool loaded = false;
+        if (filter.active()) {
+            loaded = loadSelectedPointData(filename, header, filter, pointCloud, threads);
+        } else {
+            loaded = threads > 1 || header.compressed ? loadPointDataParallel(filename, header, pointCloud, threads) : loadPointData(file, header, pointCloud);
+        }
+        if (!loaded) {
             Log::error("Failed to load point data from LAS file: {}", filename.string());
-            return {header, PointCloudXYZRGB{}};
+            return {header, PointCloud<PointT>{}};
         }
 
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, pointCloud.size());
         Log::debug("Successfully loaded {} points from LAS file: {}", pointCloud.size(), filename.string());
-        return {header, pointCloud};
+        return {header, std::move(pointCloud)};
+    }
+
+    /**
+     * @brief Load a LAS file straight into a column-oriented cloud
+     *
+     * Coordinates are dequantized directly into the x/y/z columns, with no interleaved
+     * intermediate cloud. The file is memory-mapped and split across threads as in loadLAS().
+     *
+     * @param filename Path to LAS file
+     * @param threadCount Decoder threads; 0 uses every hardware thread
+     * @return Tuple containing LAS header and columns; the columns are empty on error
+     */
+    std::tuple<LASHeader, PointCloudSoA> loadLASColumns(const std::filesystem::path& filename, unsigned threadCount = 1) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            Log::error("Failed to open LAS file: {}", filename.string());
+            return {LASHeader{}, PointCloudSoA{}};
+        }
+
+        LASHeader header;
+        if (!parseHeader(file, header) || !header.isValid()) {
+            Log::error("Failed to parse LAS header from file: {}", filename.string());
+            return {header, PointCloudSoA{}};
+        }
+        file.close();
+
+        PointCloudSoA columns;
+        const bool loaded = decodeMapped(filename, header, decoderThreads(header, threadCount), [&columns](size_t numPoints) { columns.resize(numPoints); },
+                                         [&header, &columns](const uint8_t* records, size_t first, size_t count, const RecordLayout& layout) {
+                                             decodeColumns(records, count, header, layout, columns, first);
+                                         });
+        if (!loaded) {
+            Log::error("Failed to load point data from LAS file: {}", filename.string());
+            return {header, PointCloudSoA{}};
+        }
+
+        columns.width = static_cast<uint32_t>(columns.size());
+        columns.height = 1;
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, columns.size());
+        Log::debug("Successfully loaded {} points from LAS file: {}", columns.size(), filename.string());
+        return {header, std::move(columns)};
     }
 
     /**
      * @brief Save point cloud to LAS file
+     *
+     * Records are encoded block by block, with several threads filling consecutive blocks in
+     * parallel before they are written in file order. Point counts and the bounding box in the
+     * written header come from that same encoding pass, whatever the given header holds.
+     * When header.compressed is set a LAZ file is written instead, each thread compressing
+     * whole LASzip chunks.
+     *
      * @param filename Path to output LAS file
-     * @param header LAS header information
+     * @param header LAS header information providing point format, scale, offset and compression
      * @param pointCloud Point cloud data to save
+     * @param threadCount Number of encoding threads, 0 uses every hardware thread
      * @return True if save was successful, false otherwise
      */
-    bool saveLAS(const std::filesystem::path& filename, const LASHeader& header, const PointCloudXYZRGB& pointCloud) {
+    bool saveLAS(const std::filesystem::path& filename, const LASHeader& header, const PointCloudXYZRGB& pointCloud, unsigned threadCount = 1) {
+        if (!holdsPointCount(header, pointCloud.size())) {
+            Log::error("{} points exceed the LAS 1.3 point count field", pointCloud.size());
+            return false;
+        }
+
         std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             Log::error("Failed to create LAS file: {}", filename.string());
             return false;
         }
 
-        if (!writeHeader(file, header)) {
+        LASHeader written = header;
+        const auto laz = written.compressed ? prepareCompressedHeader(written) : std::nullopt;
+        if ((written.compressed && !laz) || !writeHeader(file, written)) {
             Log::error("Failed to write LAS header to file: {}", filename.string());
             return false;
         }
 
-        if (!writePointData(file, header, pointCloud)) {
+        CoordinateBounds bounds;
+        const unsigned threads = encoderThreads(pointCloud.size(), threadCount);
+        bool pointsWritten;
+        if (laz) {
+            ChunkState chunks;
+            pointsWritten = beginChunks(file) && writeChunks(file, written, *laz, pointCloud.points, threads, bounds, chunks) && finishChunks(file, written, chunks);
+        } else {
+            std::vector<std::vector<uint8_t>> blocks;
+            pointsWritten = writePointData(file, written, pointCloud.points, threads, bounds, blocks);
+        }
+        if (!pointsWritten) {
             Log::error("Failed to write point data to LAS file: {}", filename.string());
             return false;
         }
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, pointCloud.size());
+
+        // Patch counts and bounds gathered while encoding
+        setPointCounts(written, pointCloud.size());
+        bounds.applyTo(written);
+        file.seekp(0);
+        if (!writeHeader(file, written)) {
+            Log::error("Failed to write LAS header to file: {}", filename.string());
+            return false;
+        }
 
         return true;
     }
@@ -195,46 +385,64 @@ class LASProcessor {
      * @return LASHeader configured for the point cloud
      */
     static LASHeader createLASHeader(const PointCloudXYZRGB& pointCloud, PointFormat format = PointFormat::FORMAT_3) {
+        LASHeader header = createLASHeader(format);
+        header.legacyNumberOfPointRecords = static_cast<uint32_t>(pointCloud.size());
+        header.width = static_cast<uint32_t>(pointCloud.size());
+
+        // Calculate bounding box
+        if (!pointCloud.empty()) {
+            auto [minPt, maxPt] = pointCloud.getBoundingBox();
+
+            header.minX = minPt.x;
+            header.maxX = maxPt.x;
+            header.minY = minPt.y;
+            header.maxY = maxPt.y;
+            header.minZ = minPt.z;
+            header.maxZ = maxPt.z;
+        }
+
+        return header;
+    }
+
+    /**
+     * @brief Create a LAS header template without counts or bounds
+     *
+     * saveLAS() and LASWriter fill counts and bounds while encoding, so this avoids the extra
+     * pass over the cloud that the overload taking a point cloud makes.
+     *
+     * @param format Point data record format
+     * @return LASHeader with format, scale, offset and file metadata set
+     */
+    static LASHeader createLASHeader(PointFormat format) {
         LASHeader header{};
 
         // File signature
         header.fileSignature = {'L', 'A', 'S', 'F'};
 
-        // Version
+        // Version: LAS 1.3 by default, LAS 1.4 for the formats it introduced
+        const bool extended = format >= PointFormat::FORMAT_6;
         header.versionMajor = 1;
-        header.versionMinor = 3;  // Use LAS 1.3 by default
+        header.versionMinor = extended ? 4 : 3;
 
         // Basic info
         header.fileSourceID = 0;
         header.globalEncoding = 0;
-        header.headerSize = 235;  // Standard LAS 1.3 header size
+        header.headerSize = extended ? 375 : 235;  // Standard LAS 1.4 or 1.3 header size
         header.offsetToPointData = header.headerSize;
         header.numberOfVariableLengthRecords = 0;
         header.pointDataRecordFormat = format;
 
         // Point record length based on format
         header.pointDataRecordLength = getPointRecordLength(format);
-        header.legacyNumberOfPointRecords = static_cast<uint32_t>(pointCloud.size());
+        header.legacyNumberOfPointRecords = 0;
 
         // Set width/height for compatibility
-        header.width = static_cast<uint32_t>(pointCloud.size());
+        header.width = 0;
         header.height = 1;
 
-        // Calculate bounding box and scale factors
-        if (!pointCloud.empty()) {
-            auto [minPt, maxPt] = pointCloud.getBoundingBox();
-
-            header.minX = minPt.x;
-            header.maxX = maxPt.x;
-            header.minY = minPt.y;
-            header.maxY = maxPt.y;
-            header.minZ = minPt.z;
-            header.maxZ = maxPt.z;
-
-            // Use appropriate scale factors (typically 0.01 for meter precision)
-            header.xScaleFactor = header.yScaleFactor = header.zScaleFactor = 0.01;
-            header.xOffset = header.yOffset = header.zOffset = 0.0;
-        }
+        // Use appropriate scale factors (typically 0.01 for meter precision)
+        header.xScaleFactor = header.yScaleFactor = header.zScaleFactor = 0.01;
+        header.xOffset = header.yOffset = header.zOffset = 0.0;
 
         // Software identifier
         std::string software = "ScanForge v1.0.0";
@@ -292,9 +500,43 @@ class LASProcessor {
     }
 
    private:
+    static constexpr size_t READ_BLOCK_SIZE = size_t{2} << 20;  // Bytes of point records read per call
+    static constexpr uint64_t MIN_POINTS_PER_THREAD = 16384;     // Below this a thread costs more than it decodes
+    static constexpr size_t WRITE_BLOCK_SIZE = size_t{2} << 20;  // Bytes of point records encoded per block and write call
+    static constexpr uint32_t VLR_HEADER_SIZE = 54;
+
+    // Compressed sizes of the LAZ chunks written so far, and buffers reused between writeChunks() calls
+    struct ChunkState {
+        std::vector<uint64_t> bytes;
+        std::vector<std::vector<uint8_t>> records;
+        std::vector<std::vector<uint8_t>> compressed;
+    };
+
+    // Running bounds of the coordinates encoded so far; NaN coordinates are ignored
+    struct CoordinateBounds {
+        Point3D min{std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+        Point3D max{-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+
+        void merge(const CoordinateBounds& other) {
+            min = Point3D(std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z));
+            max = Point3D(std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z));
+        }
+
+        // Store into the header, zeros when nothing was encoded
+        void applyTo(LASHeader& header) const {
+            const bool empty = !(min.x <= max.x && min.y <= max.y && min.z <= max.z);
+            header.minX = empty ? 0.0 : static_cast<double>(min.x);
+            header.minY = empty ? 0.0 : static_cast<double>(min.y);
+            header.minZ = empty ? 0.0 : static_cast<double>(min.z);
+            header.maxX = empty ? 0.0 : static_cast<double>(max.x);
+            header.maxY = empty ? 0.0 : static_cast<double>(max.y);
+            header.maxZ = empty ? 0.0 : static_cast<double>(max.z);
+        }
+    };
+
     // Modern file I/O helper using RAII and C++23 features
     template <typename T>
-    bool readBinary(std::ifstream& file, T& value)
+    bool readBinary(std::istream& file, T& value)
         requires std::is_trivially_copyable_v<T>
     {
         file.read(reinterpret_cast<char*>(&value), sizeof(T));
@@ -302,14 +544,15 @@ class LASProcessor {
     }
 
     template <typename T>
-    bool writeBinary(std::ofstream& file, const T& value)
+    bool writeBinary(std::ostream& file, const T& value)
         requires std::is_trivially_copyable_v<T>
     {
         file.write(reinterpret_cast<const char*>(&value), sizeof(T));
         return file.good();
     }
 
-    bool parseHeader(std::ifstream& file, LASHeader& header) {
+    bool parseHeader(std::istream& file, LASHeader& header) {
+        SCANFORGE_PROFILE_SCOPE("las.header");
         // Read file signature
         if (!readBinary(file, header.fileSignature))
             return false;
@@ -340,7 +583,8 @@ class LASProcessor {
         uint8_t formatByte;
         if (!readBinary(file, formatByte))
             return false;
-        header.pointDataRecordFormat = static_cast<PointFormat>(formatByte);
+        header.compressed = (formatByte & 0x80) != 0;
+        header.pointDataRecordFormat = static_cast<PointFormat>(formatByte & 0x3F);  // Bit 6 is set by some older LAZ writers
 
         if (!readBinary(file, header.pointDataRecordLength) || !readBinary(file, header.legacyNumberOfPointRecords)) {
             return false;
@@ -387,7 +631,8 @@ class LASProcessor {
         return true;
     }
 
-    bool loadPointData(std::ifstream& file, const LASHeader& header, PointCloudXYZRGB& pointCloud) {
+    template <typename PointT>
+    bool loadPointData(std::ifstream& file, const LASHeader& header, PointCloud<PointT>& pointCloud) {
         // Seek to point data
         file.seekg(header.offsetToPointData);
         if (file.fail()) {
@@ -395,72 +640,383 @@ class LASProcessor {
             return false;
         }
 
-        uint64_t numPoints = header.getTotalPointCount();
-        pointCloud.points.reserve(numPoints);
+        const auto layout = createRecordLayout(header);
+        if (!layout.isValid()) {
+            Log::error("Unsupported point format {} with record length {}", static_cast<int>(header.pointDataRecordFormat), header.pointDataRecordLength);
+            return false;
+        }
+
+        const auto numPoints = static_cast<size_t>(header.getTotalPointCount());
+        pointCloud.points.resize(numPoints);
         pointCloud.width = static_cast<uint32_t>(numPoints);
         pointCloud.height = 1;
         pointCloud.is_dense = true;
 
-        // Read points based on format
-        for (uint64_t i = 0; i < numPoints; ++i) {
-            LASPoint lasPoint;
-            if (!readPointRecord(file, header, lasPoint)) {
-                Log::error("Failed to read point {} of {}", i, numPoints);
+        ByteBuffer block(resource_);
+        return readRecords(file, header, layout, std::span(pointCloud.points), block);
+    }
+
+    // Read out.size() records in blocks of READ_BLOCK_SIZE bytes and decode them from memory
+    template <typename PointT>
+    static bool readRecords(std::istream& file, const LASHeader& header, const RecordLayout& layout, std::span<PointT> out, ByteBuffer& block) {
+        const size_t pointsPerBlock = std::max<size_t>(1, READ_BLOCK_SIZE / layout.stride);
+        block.resize(std::min(pointsPerBlock, out.size()) * layout.stride);
+        for (size_t first = 0; first < out.size(); first += pointsPerBlock) {
+            const size_t count = std::min(pointsPerBlock, out.size() - first);
+            {
+                SCANFORGE_PROFILE_SCOPE("las.read");
+                file.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(count * layout.stride));
+            }
+            if (static_cast<size_t>(file.gcount()) != count * layout.stride) {
+                Log::error("Point data is truncated after {} of {} records", first + static_cast<size_t>(file.gcount()) / layout.stride, out.size());
                 return false;
             }
+            SCANFORGE_PROFILE_COUNT(BytesRead, count * layout.stride);
+            decodeRecords(block.data(), count, header, layout, out.subspan(first, count));
+        }
+        return true;
+    }
 
-            // Convert to PointXYZRGB
-            PointXYZRGB point(lasPoint.position, lasPoint.color);
-            pointCloud.push_back(point);
+    template <typename PointT>
+    bool loadPointDataParallel(const std::filesystem::path& filename, const LASHeader& header, PointCloud<PointT>& pointCloud, unsigned threads) {
+        return decodeMapped(
+            filename, header, threads,
+            [&pointCloud](size_t numPoints) {
+                pointCloud.points.resize(numPoints);
+                pointCloud.width = static_cast<uint32_t>(numPoints);
+                pointCloud.height = 1;
+                pointCloud.is_dense = true;
+            },
+            [&header, &pointCloud](const uint8_t* records, size_t first, size_t count, const RecordLayout& layout) {
+                decodeRecords(records, count, header, layout, std::span(pointCloud.points).subspan(first, count));
+            });
+    }
+
+    template <typename PointT>
+    bool loadSelectedPointData(const std::filesystem::path& filename, const LASHeader& header, const io::LoadFilter& filter, PointCloud<PointT>& pointCloud, unsigned threads) {
+        const std::pair<Point3D, Point3D> bounds{Point3D(static_cast<float>(header.minX), static_cast<float>(header.minY), static_cast<float>(header.minZ)),
+                                                 Point3D(static_cast<float>(header.maxX), static_cast<float>(header.maxY), static_cast<float>(header.maxZ))};
+        io::PointSelection<PointT> selection(filter, bounds);
+        const bool decoded = decodeMapped(filename, header, threads, [](size_t) {},
+                                          [&header, &selection](const uint8_t* records, size_t first, size_t count, const RecordLayout& layout) {
+                                              auto part = selection.part(first, count);
+                                              selectRecords(records, first, count, header, layout, selection, part);
+                                              selection.commit(std::move(part));
+                                          });
+        if (!decoded) {
+            return false;
         }
 
+        pointCloud.points = selection.finish(resource_);
+        pointCloud.width = static_cast<uint32_t>(pointCloud.size());
+        pointCloud.height = 1;
+        pointCloud.is_dense = true;
+        Log::debug("Kept {} of {} points", pointCloud.size(), header.getTotalPointCount());
         return true;
     }
 
-    bool readPointRecord(std::ifstream& file, const LASHeader& header, LASPoint& point) {
-        // Read base point data (common to all formats)
-        int32_t x, y, z;
-        if (!readBinary(file, x) || !readBinary(file, y) || !readBinary(file, z)) {
+    // Map the file, let prepare(numPoints) size the destination, then run decode(records, first, count, layout) on one slice per thread
+    template <typename Prepare, typename Decode>
+    static bool decodeMapped(const std::filesystem::path& filename, const LASHeader& header, unsigned threads, Prepare&& prepare, Decode&& decode) {
+        const auto layout = createRecordLayout(header);
+        if (!layout.isValid()) {
+            Log::error("Unsupported point format {} with record length {}", static_cast<int>(header.pointDataRecordFormat), header.pointDataRecordLength);
             return false;
         }
 
-        // Apply scale and offset
-        point.position.x = static_cast<float>(x * header.xScaleFactor + header.xOffset);
-        point.position.y = static_cast<float>(y * header.yScaleFactor + header.yOffset);
-        point.position.z = static_cast<float>(z * header.zScaleFactor + header.zOffset);
+        io::MappedFile mapping(filename);
+        if (!mapping.is_open()) {
+            return false;
+        }
 
-        // Read intensity, return info, classification, etc.
-        if (!readBinary(file, point.intensity) || !readBinary(file, point.returnInfo) || !readBinary(file, point.classification) || !readBinary(file, point.scanAngle) ||
-            !readBinary(file, point.userData) || !readBinary(file, point.pointSourceID)) {
+        const auto numPoints = static_cast<size_t>(header.getTotalPointCount());
+        const auto bytes = mapping.data();
+        SCANFORGE_PROFILE_COUNT(BytesRead, bytes.size());
+        if (header.compressed) {
+            return decodeChunks(bytes, header, layout, threads, prepare, decode);
+        }
+        if (bytes.size() < header.offsetToPointData || (bytes.size() - header.offsetToPointData) / layout.stride < numPoints) {
+            Log::error("Point data is truncated: expected {} records of {} bytes", numPoints, layout.stride);
             return false;
         }
+        prepare(numPoints);
 
-        // Read GPS time if present
-        if (header.hasGPSTime()) {
-            if (!readBinary(file, point.gpsTime))
-                return false;
+        // Records are fixed-size, so each thread owns one contiguous slice of the file and of the cloud
+        const uint8_t* records = bytes.data() + header.offsetToPointData;
+        threads = std::max(1u, threads);
+        tooling::parallelSlices(numPoints, threads, [&decode, &layout, records](size_t first, size_t count) { decode(records + first * layout.stride, first, count, layout); });
+
+        Log::debug("Decoded {} points with {} threads", numPoints, threads);
+        return true;
+    }
+
+    // Threads worth starting for a file: small clouds are not split below MIN_POINTS_PER_THREAD
+    static unsigned decoderThreads(const LASHeader& header, unsigned requested) {
+        const unsigned available = tooling::availableThreads(requested);
+        const uint64_t useful = std::max<uint64_t>(1, header.getTotalPointCount() / MIN_POINTS_PER_THREAD);
+        return static_cast<unsigned>(std::min<uint64_t>(available, useful));
+    }
+
+    // Where a LAZ file keeps its point records: compression parameters and the chunks in file order
+    struct CompressedLayout {
+        codec::LAZCodec::Parameters parameters;
+        std::vector<codec::LAZCodec::Chunk> chunks;
+    };
+
+    /**
+     * Read the LASzip VLR and the chunk table of a LAZ file
+     * @param readAt Callable (offset, size) returning those bytes of the file, fewer when past its end
+     */
+    template <typename ReadAt>
+    static std::optional<CompressedLayout> readCompressedLayout(const LASHeader& header, uint64_t fileSize, ReadAt&& readAt) {
+        if (header.offsetToPointData < header.headerSize || fileSize < uint64_t{header.offsetToPointData} + 8) {
+            Log::error("LAZ file is truncated before its point data");
+            return std::nullopt;
         }
 
-        // Read RGB if present
-        if (header.hasRGB()) {
-            uint16_t r, g, b;
-            if (!readBinary(file, r) || !readBinary(file, g) || !readBinary(file, b)) {
-                return false;
+        // Find the LASzip VLR among the variable length records
+        std::optional<codec::LAZCodec::Parameters> parameters;
+        const auto records = readAt(header.headerSize, header.offsetToPointData - header.headerSize);
+        for (size_t at = 0, i = 0; i < header.numberOfVariableLengthRecords && at + VLR_HEADER_SIZE <= records.size(); ++i) {
+            std::string_view userID(reinterpret_cast<const char*>(records.data() + at + 2), 16);
+            userID = userID.substr(0, userID.find('\0'));
+            uint16_t recordID;
+            uint16_t length;
+            std::memcpy(&recordID, records.data() + at + 18, sizeof(recordID));
+            std::memcpy(&length, records.data() + at + 20, sizeof(length));
+            const size_t payload = at + VLR_HEADER_SIZE;
+            if (userID == codec::LAZCodec::VLR_USER_ID && recordID == codec::LAZCodec::VLR_RECORD_ID && payload + length <= records.size()) {
+                parameters = codec::LAZCodec::Parameters::parse(std::span(records).subspan(payload, length));
+                break;
             }
-            // Convert from 16-bit to 8-bit
-            point.color = RGB(static_cast<uint8_t>(r >> 8), static_cast<uint8_t>(g >> 8), static_cast<uint8_t>(b >> 8));
+            at = payload + length;
+        }
+        if (!parameters) {
+            Log::error("LAZ file has no valid LASzip VLR");
+            return std::nullopt;
+        }
+        if (!parameters->isSupported() || parameters->recordLength() != header.pointDataRecordLength) {
+            Log::error("Unsupported LAZ compression (compressor {}, {} items) for point format {}; LAZ decoding supports point formats 0-3 and 6-8", parameters->compressor,
+                       parameters->items.size(), static_cast<int>(header.pointDataRecordFormat));
+            return std::nullopt;
         }
 
-        // Read NIR if present (Format 8 and 10)
-        if (static_cast<uint8_t>(header.pointDataRecordFormat) == 8 || static_cast<uint8_t>(header.pointDataRecordFormat) == 10) {
-            if (!readBinary(file, point.nearInfrared))
-                return false;
+        // The point data starts with the offset of the chunk table, -1 when it was appended as the last 8 bytes instead
+        int64_t tableOffset = -1;
+        const auto pointer = readAt(header.offsetToPointData, 8);
+        if (pointer.size() == sizeof(tableOffset)) {
+            std::memcpy(&tableOffset, pointer.data(), sizeof(tableOffset));
+        }
+        if (const auto trailer = tableOffset == -1 ? readAt(fileSize - 8, 8) : std::vector<uint8_t>{}; trailer.size() == sizeof(tableOffset)) {
+            std::memcpy(&tableOffset, trailer.data(), sizeof(tableOffset));
+        }
+        const uint64_t firstChunk = uint64_t{header.offsetToPointData} + 8;
+        if (tableOffset < static_cast<int64_t>(firstChunk) || static_cast<uint64_t>(tableOffset) >= fileSize) {
+            Log::error("LAZ chunk table offset {} is outside the file", tableOffset);
+            return std::nullopt;
+        }
+
+        const auto table = readAt(static_cast<uint64_t>(tableOffset), fileSize - static_cast<uint64_t>(tableOffset));
+        auto chunks = codec::LAZCodec::readChunkTable(table, *parameters, header.getTotalPointCount(), firstChunk);
+        if (!chunks || (!chunks->empty() && chunks->back().offset + chunks->back().bytes > static_cast<uint64_t>(tableOffset))) {
+            Log::error("LAZ chunk table is corrupt or does not match the point count");
+            return std::nullopt;
+        }
+        return CompressedLayout{std::move(*parameters), std::move(*chunks)};
+    }
+
+    // Decompress the chunks of a mapped LAZ file, up to `threads` at a time, handing each to decode(records, first, count, layout)
+    template <typename Prepare, typename Decode>
+    static bool decodeChunks(std::span<const uint8_t> bytes, const LASHeader& header, const RecordLayout& layout, unsigned threads, Prepare& prepare, Decode& decode) {
+        const auto compressed = readCompressedLayout(header, bytes.size(), [bytes](uint64_t offset, uint64_t size) {
+            const auto available = bytes.subspan(static_cast<size_t>(std::min<uint64_t>(offset, bytes.size())));
+            const auto wanted = available.first(static_cast<size_t>(std::min<uint64_t>(size, available.size())));
+            return std::vector<uint8_t>(wanted.begin(), wanted.end());
+        });
+        if (!compressed) {
+            return false;
         }
+        prepare(static_cast<size_t>(header.getTotalPointCount()));
+
+        // Chunks vary in compressed size, so threads take the next one as they finish
+        const auto& chunks = compressed->chunks;
+        std::atomic<size_t> nextChunk = 0;
+        std::atomic<bool> ok = true;
+        auto work = [&] {
+            std::vector<uint8_t> records;
+            for (size_t c = nextChunk++; c < chunks.size() && ok; c = nextChunk++) {
+                const auto& chunk = chunks[c];
+                records.resize(static_cast<size_t>(chunk.points) * layout.stride);
+                {
+                    SCANFORGE_PROFILE_SCOPE("laz.decompress");
+                    if (!codec::LAZCodec::decompressChunk(bytes.subspan(static_cast<size_t>(chunk.offset), static_cast<size_t>(chunk.bytes)), compressed->parameters, records)) {
+                        ok = false;
+                        break;
+                    }
+                }
+                SCANFORGE_PROFILE_COUNT(CompressedBytes, chunk.bytes);
+                SCANFORGE_PROFILE_COUNT(UncompressedBytes, records.size());
+                decode(records.data(), static_cast<size_t>(chunk.firstPoint), static_cast<size_t>(chunk.points), layout);
+            }
+        };
 
+        threads = static_cast<unsigned>(std::clamp<size_t>(threads, 1, std::max<size_t>(1, chunks.size())));
+        tooling::runWorkers(threads, work);
+
+        if (!ok) {
+            Log::error("LAZ point data is corrupt");
+            return false;
+        }
+        Log::debug("Decompressed {} points in {} chunks with {} threads", header.getTotalPointCount(), chunks.size(), threads);
         return true;
     }
 
-    bool writeHeader(std::ofstream& file, const LASHeader& header) {
+    // Decode raw records in batches: gather the quantized coordinates, dequantize them with SIMD, then scatter the position and the attributes PointT has
+    template <typename PointT>
+    static void decodeRecords(const uint8_t* records, size_t count, const LASHeader& header, const RecordLayout& layout, std::span<PointT> out) {
+        SCANFORGE_PROFILE_SCOPE("las.decode");
+        constexpr size_t BATCH = 256;
+        std::array<int32_t, BATCH> xi, yi, zi;
+        std::array<float, BATCH> xf, yf, zf;
+
+        for (size_t first = 0; first < count; first += BATCH) {
+            const size_t n = std::min(BATCH, count - first);
+            const uint8_t* batch = records + first * layout.stride;
+            for (size_t i = 0; i < n; ++i) {
+                const uint8_t* record = batch + i * layout.stride;
+                std::memcpy(&xi[i], record, sizeof(int32_t));
+                std::memcpy(&yi[i], record + 4, sizeof(int32_t));
+                std::memcpy(&zi[i], record + 8, sizeof(int32_t));
+            }
+            simd::scaleOffsetToFloat(xi.data(), n, header.xScaleFactor, header.xOffset, xf.data());
+            simd::scaleOffsetToFloat(yi.data(), n, header.yScaleFactor, header.yOffset, yf.data());
+            simd::scaleOffsetToFloat(zi.data(), n, header.zScaleFactor, header.zOffset, zf.data());
+
+            for (size_t i = 0; i < n; ++i) {
+                PointT& point = out[first + i];
+                getPosition(point) = Point3D(xf[i], yf[i], zf[i]);
+                if constexpr (!std::is_same_v<PointT, Point3D>) {
+                    decodeAttributes(batch + i * layout.stride, layout, point);
+                }
+            }
+        }
+    }
+
+    // decodeRecords() for the records the stride keeps, offered to a selection; the position is tested against the box before anything else is read
+    template <typename PointT>
+    static void selectRecords(const uint8_t* records, size_t first, size_t count, const LASHeader& header, const RecordLayout& layout, io::PointSelection<PointT>& selection,
+                              typename io::PointSelection<PointT>::Part& part) {
+        SCANFORGE_PROFILE_SCOPE("las.decode");
+        constexpr size_t BATCH = 256;
+        std::array<size_t, BATCH> offsets;
+        std::array<int32_t, BATCH> xi, yi, zi;
+        std::array<float, BATCH> xf, yf, zf;
+
+        const uint64_t stride = selection.filter().stride;
+        const uint64_t end = uint64_t{first} + count;
+        uint64_t next = (first + stride - 1) / stride * stride;  // First record index the stride keeps
+        while (next < end) {
+            size_t n = 0;
+            for (; n < BATCH && next < end; ++n) {
+                offsets[n] = static_cast<size_t>(next - first) * layout.stride;
+                const uint8_t* record = records + offsets[n];
+                std::memcpy(&xi[n], record, sizeof(int32_t));
+                std::memcpy(&yi[n], record + 4, sizeof(int32_t));
+                std::memcpy(&zi[n], record + 8, sizeof(int32_t));
+                next += std::min(stride, end - next);
+            }
+            simd::scaleOffsetToFloat(xi.data(), n, header.xScaleFactor, header.xOffset, xf.data());
+            simd::scaleOffsetToFloat(yi.data(), n, header.yScaleFactor, header.yOffset, yf.data());
+            simd::scaleOffsetToFloat(zi.data(), n, header.zScaleFactor, header.zOffset, zf.data());
+
+            for (size_t i = 0; i < n; ++i) {
+                const Point3D position(xf[i], yf[i], zf[i]);
+                if (!selection.filter().contains(position)) {
+                    continue;
+                }
+                const uint8_t* record = records + offsets[i];
+                selection.offer(part, first + offsets[i] / layout.stride, [&](auto& point) {
+                    getPosition(point) = position;
+                    if constexpr (!std::is_same_v<std::remove_cvref_t<decltype(point)>, Point3D>) {
+                        decodeAttributes(record, layout, point);
+                    }
+                    return true;
+                });
+            }
+        }
+    }
+
+    // Fill the attributes PointT carries from one record
+    template <typename PointT>
+    static void decodeAttributes(const uint8_t* record, const RecordLayout& layout, PointT& point) {
+        if constexpr (HasColor<PointT>) {
+            if (layout.rgbOffset) {
+                // Keep the high byte of the 16-bit channels
+                const uint8_t* rgb = record + *layout.rgbOffset;
+                point.color = RGB(rgb[1], rgb[3], rgb[5]);
+            } else {
+                point.color = RGB(255, 255, 255);
+            }
+        }
+        if constexpr (HasIntensity<PointT>) {
+            uint16_t intensity;
+            std::memcpy(&intensity, record + 12, sizeof(intensity));
+            point.intensity = intensity;
+        }
+        if constexpr (HasReturns<PointT>) {
+            const uint8_t returns = record[14];
+            point.returnNumber = static_cast<uint8_t>(layout.extended ? returns & 0x0F : returns & 0x07);
+            point.numberOfReturns = static_cast<uint8_t>(layout.extended ? returns >> 4 : (returns >> 3) & 0x07);
+        }
+        if constexpr (HasClassification<PointT>) {
+            // Formats 0-5 keep the synthetic, key-point and withheld flags in the top 3 bits
+            point.classification = layout.extended ? record[16] : static_cast<uint8_t>(record[15] & 0x1F);
+        }
+        if constexpr (HasGpsTime<PointT>) {
+            point.gpsTime = 0;
+            if (layout.gpsTimeOffset) {
+                std::memcpy(&point.gpsTime, record + *layout.gpsTimeOffset, sizeof(double));
+            }
+        }
+        if constexpr (HasNearInfrared<PointT>) {
+            point.nearInfrared = 0;
+            if (layout.nirOffset) {
+                std::memcpy(&point.nearInfrared, record + *layout.nirOffset, sizeof(uint16_t));
+            }
+        }
+    }
+
+    // Same as decodeRecords, but dequantizes straight into columns [first, first + count)
+    static void decodeColumns(const uint8_t* records, size_t count, const LASHeader& header, const RecordLayout& layout, PointCloudSoA& out, size_t first) {
+        SCANFORGE_PROFILE_SCOPE("las.decode");
+        constexpr size_t BATCH = 256;
+        std::array<int32_t, BATCH> xi, yi, zi;
+
+        for (size_t done = 0; done < count; done += BATCH) {
+            const size_t n = std::min(BATCH, count - done);
+            const size_t at = first + done;
+            const uint8_t* batch = records + done * layout.stride;
+            for (size_t i = 0; i < n; ++i) {
+                const uint8_t* record = batch + i * layout.stride;
+                std::memcpy(&xi[i], record, sizeof(int32_t));
+                std::memcpy(&yi[i], record + 4, sizeof(int32_t));
+                std::memcpy(&zi[i], record + 8, sizeof(int32_t));
+                if (layout.rgbOffset) {
+                    const uint8_t* rgb = record + *layout.rgbOffset;
+                    out.r[at + i] = rgb[1];
+                    out.g[at + i] = rgb[3];
+                    out.b[at + i] = rgb[5];
+                } else {
+                    out.r[at + i] = out.g[at + i] = out.b[at + i] = 255;
+                }
+            }
+            simd::scaleOffsetToFloat(xi.data(), n, header.xScaleFactor, header.xOffset, out.x.data() + at);
+            simd::scaleOffsetToFloat(yi.data(), n, header.yScaleFactor, header.yOffset, out.y.data() + at);
+            simd::scaleOffsetToFloat(zi.data(), n, header.zScaleFactor, header.zOffset, out.z.data() + at);
+        }
+    }
+
+    bool writeHeader(std::ostream& file, const LASHeader& header) {
         // Write all header fields in order
         if (!writeBinary(file, header.fileSignature) || !writeBinary(file, header.fileSourceID) || !writeBinary(file, header.globalEncoding) || !writeBinary(file, header.projectID1) ||
             !writeBinary(file, header.projectID2) || !writeBinary(file, header.projectID3) || !writeBinary(file, header.projectID4) || !writeBinary(file, header.versionMajor) ||
@@ -474,7 +1030,8 @@ class LASProcessor {
 
         // Continue with remaining header fields...
         if (!writeBinary(file, header.creationDayOfYear) || !writeBinary(file, header.creationYear) || !writeBinary(file, header.headerSize) || !writeBinary(file, header.offsetToPointData) ||
-            !writeBinary(file, header.numberOfVariableLengthRecords) || !writeBinary(file, static_cast<uint8_t>(header.pointDataRecordFormat)) || !writeBinary(file, header.pointDataRecordLength) ||
+            !writeBinary(file, header.numberOfVariableLengthRecords) || !writeBinary(file, static_cast<uint8_t>(static_cast<uint8_t>(header.pointDataRecordFormat) | (header.compressed ? 0x80 : 0))) ||
+            !writeBinary(file, header.pointDataRecordLength) ||
             !writeBinary(file, header.legacyNumberOfPointRecords)) {
             return false;
         }
@@ -499,63 +1056,563 @@ class LASProcessor {
             }
         }
 
+        // Write LAS 1.4+ extended fields
+        if (header.versionMajor == 1 && header.versionMinor >= 4) {
+            if (!writeBinary(file, header.startOfFirstExtendedVariableLengthRecord) || !writeBinary(file, header.numberOfExtendedVariableLengthRecords) ||
+                !writeBinary(file, header.numberOfPointRecords)) {
+                return false;
+            }
+
+            for (const auto& count : header.numberOfPointsByReturn) {
+                if (!writeBinary(file, count))
+                    return false;
+            }
+        }
+
+        return !header.compressed || writeLAZRecord(file, header);
+    }
+
+    // Append the LASzip VLR describing the compressed records; prepareCompressedHeader() reserved its room
+    bool writeLAZRecord(std::ostream& file, const LASHeader& header) {
+        const auto laz = codec::LAZCodec::Parameters::forPointFormat(static_cast<uint8_t>(header.pointDataRecordFormat), header.pointDataRecordLength);
+        if (!laz) {
+            return false;
+        }
+        const auto payload = laz->serialize();
+        std::array<char, 16> userID{};
+        std::array<char, 32> description{};
+        std::ranges::copy(codec::LAZCodec::VLR_USER_ID, userID.begin());
+        std::ranges::copy(std::string_view("ScanForge LAZ"), description.begin());
+        if (!writeBinary(file, uint16_t{0}) || !writeBinary(file, userID) || !writeBinary(file, codec::LAZCodec::VLR_RECORD_ID) ||
+            !writeBinary(file, static_cast<uint16_t>(payload.size())) || !writeBinary(file, description)) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        return file.good();
+    }
+
+    // Encode points in WRITE_BLOCK_SIZE blocks, `threads` consecutive blocks at a time, and write each block in one call
+    bool writePointData(std::ostream& file, const LASHeader& header, std::span<const PointXYZRGB> points, unsigned threads, CoordinateBounds& bounds,
+                        std::vector<std::vector<uint8_t>>& blocks) {
+        const auto layout = createRecordLayout(header);
+        if (!layout.isValid()) {
+            Log::error("Unsupported point format {} with record length {}", static_cast<int>(header.pointDataRecordFormat), header.pointDataRecordLength);
+            return false;
+        }
+
+        const auto prototype = createRecordPrototype(layout);
+        const size_t pointsPerBlock = std::max<size_t>(1, WRITE_BLOCK_SIZE / layout.stride);
+        threads = std::max(1u, threads);
+        blocks.resize(threads);
+        std::vector<CoordinateBounds> blockBounds(threads);
+
+        for (size_t first = 0; first < points.size(); first += pointsPerBlock * threads) {
+            auto encode = [&](size_t b) {
+                const size_t begin = first + b * pointsPerBlock;
+                const auto block = points.subspan(begin, std::min(pointsPerBlock, points.size() - begin));
+                blocks[b].resize(block.size() * layout.stride);
+                blockBounds[b] = CoordinateBounds{};
+                encodeRecords(block, header, layout, prototype, blocks[b].data(), blockBounds[b]);
+            };
+
+            const size_t count = std::min<size_t>(threads, (points.size() - first + pointsPerBlock - 1) / pointsPerBlock);
+            tooling::parallelFor(count, encode);
+
+            SCANFORGE_PROFILE_SCOPE("las.write");
+            for (size_t b = 0; b < count; ++b) {
+                SCANFORGE_PROFILE_COUNT(BytesWritten, blocks[b].size());
+                file.write(reinterpret_cast<const char*>(blocks[b].data()), static_cast<std::streamsize>(blocks[b].size()));
+                bounds.merge(blockBounds[b]);
+            }
+            if (!file.good()) {
+                return false;
+            }
+        }
         return true;
     }
 
-    bool writePointData(std::ofstream& file, const LASHeader& header, const PointCloudXYZRGB& pointCloud) {
-        for (const auto& point : pointCloud.points) {
-            if (!writePointRecord(file, header, point)) {
+    // Threads worth starting to encode a cloud: small clouds are not split below MIN_POINTS_PER_THREAD
+    static unsigned encoderThreads(size_t points, unsigned requested) {
+        const unsigned available = tooling::availableThreads(requested);
+        const size_t useful = std::max<size_t>(1, points / MIN_POINTS_PER_THREAD);
+        return static_cast<unsigned>(std::min<size_t>(available, useful));
+    }
+
+    // LAS 1.4 counts points in 64 bits, earlier versions in 32
+    static bool holdsPointCount(const LASHeader& header, uint64_t count) { return (header.versionMajor == 1 && header.versionMinor >= 4) || count <= UINT32_MAX; }
+
+    // Record count points, each written as return 1 of 1, in the count fields of the header's
+    // version. LAS 1.4 leaves the legacy fields zero for formats 6-10 and counts above 32 bits
+    static void setPointCounts(LASHeader& header, uint64_t count) {
+        const bool extended = header.versionMajor == 1 && header.versionMinor >= 4;
+        const bool legacy = !extended || (header.pointDataRecordFormat < PointFormat::FORMAT_6 && count <= UINT32_MAX);
+        header.legacyNumberOfPointRecords = legacy ? static_cast<uint32_t>(count) : 0;
+        header.legacyNumberOfPointsByReturn = {header.legacyNumberOfPointRecords, 0, 0, 0, 0};
+        header.numberOfPointRecords = extended ? count : 0;
+        header.numberOfPointsByReturn = {};
+        header.numberOfPointsByReturn[0] = header.numberOfPointRecords;
+        header.width = static_cast<uint32_t>(std::min<uint64_t>(count, UINT32_MAX));
+        header.height = 1;
+    }
+
+    // Mark a header for LAZ output and point it past the LASzip VLR that writeHeader() appends
+    static std::optional<codec::LAZCodec::Parameters> prepareCompressedHeader(LASHeader& header) {
+        auto laz = codec::LAZCodec::Parameters::forPointFormat(static_cast<uint8_t>(header.pointDataRecordFormat), header.pointDataRecordLength);
+        if (!laz) {
+            Log::error("LAZ compression supports point formats 0-3 and 6-8, not format {}; write the wave packet formats uncompressed", static_cast<int>(header.pointDataRecordFormat));
+            return std::nullopt;
+        }
+        header.compressed = true;
+        header.numberOfVariableLengthRecords = 1;
+        header.offsetToPointData = header.headerSize + VLR_HEADER_SIZE + static_cast<uint32_t>(laz->serialize().size());
+        return laz;
+    }
+
+    // Reserve the chunk table offset that starts the LAZ point data; -1 until finishChunks() patches it
+    bool beginChunks(std::ostream& file) { return writeBinary(file, int64_t{-1}); }
+
+    // Compress points as consecutive LASzip chunks, `threads` chunks at a time; only the last call may end on a partial chunk
+    bool writeChunks(std::ostream& file, const LASHeader& header, const codec::LAZCodec::Parameters& laz, std::span<const PointXYZRGB> points, unsigned threads,
+                     CoordinateBounds& bounds, ChunkState& state) {
+        const auto layout = createRecordLayout(header);
+        if (!layout.isValid() || laz.chunkSize == 0) {
+            return false;
+        }
+        const auto prototype = createRecordPrototype(layout);
+        const size_t chunkSize = laz.chunkSize;
+        threads = std::max(1u, threads);
+        state.records.resize(threads);
+        state.compressed.resize(threads);
+        std::vector<CoordinateBounds> chunkBounds(threads);
+
+        for (size_t first = 0; first < points.size(); first += chunkSize * threads) {
+            auto compress = [&](size_t c) {
+                const size_t begin = first + c * chunkSize;
+                const auto chunk = points.subspan(begin, std::min(chunkSize, points.size() - begin));
+                state.records[c].resize(chunk.size() * layout.stride);
+                chunkBounds[c] = CoordinateBounds{};
+                encodeRecords(chunk, header, layout, prototype, state.records[c].data(), chunkBounds[c]);
+                SCANFORGE_PROFILE_SCOPE("laz.compress");
+                codec::LAZCodec::compressChunk(state.records[c], laz, state.compressed[c]);
+                SCANFORGE_PROFILE_COUNT(CompressedBytes, state.compressed[c].size());
+                SCANFORGE_PROFILE_COUNT(UncompressedBytes, state.records[c].size());
+            };
+
+            const size_t count = std::min<size_t>(threads, (points.size() - first + chunkSize - 1) / chunkSize);
+            tooling::parallelFor(count, compress);
+
+            SCANFORGE_PROFILE_SCOPE("las.write");
+            for (size_t c = 0; c < count; ++c) {
+                SCANFORGE_PROFILE_COUNT(BytesWritten, state.compressed[c].size());
+                file.write(reinterpret_cast<const char*>(state.compressed[c].data()), static_cast<std::streamsize>(state.compressed[c].size()));
+                state.bytes.push_back(state.compressed[c].size());
+                bounds.merge(chunkBounds[c]);
+            }
+            if (!file.good()) {
                 return false;
             }
         }
         return true;
     }
 
-    bool writePointRecord(std::ofstream& file, const LASHeader& header, const PointXYZRGB& point) {
-        // Convert coordinates to scaled integers
-        int32_t x = static_cast<int32_t>((static_cast<double>(point.position.x) - header.xOffset) / header.xScaleFactor);
-        int32_t y = static_cast<int32_t>((static_cast<double>(point.position.y) - header.yOffset) / header.yScaleFactor);
-        int32_t z = static_cast<int32_t>((static_cast<double>(point.position.z) - header.zOffset) / header.zScaleFactor);
+    // Append the chunk table after the last chunk and patch its offset at the start of the point data
+    bool finishChunks(std::ostream& file, const LASHeader& header, const ChunkState& state) {
+        const auto tableOffset = static_cast<int64_t>(file.tellp());
+        std::vector<uint8_t> table;
+        codec::LAZCodec::writeChunkTable(state.bytes, {}, table);
+        file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+        file.seekp(header.offsetToPointData);
+        return writeBinary(file, tableOffset);
+    }
+
+    // One record holding the defaults every written point shares: return 1 of 1, class 1 (unclassified), zeros elsewhere
+    static std::vector<uint8_t> createRecordPrototype(const RecordLayout& layout) {
+        std::vector<uint8_t> record(layout.stride, 0);
+        if (layout.extended) {
+            record[14] = 0x11;  // Return and count in one nibble each
+            record[16] = 1;     // Byte 15 holds the classification flags in formats 6-10
+        } else {
+            record[14] = 0x09;  // Return in bits 0-2, count in bits 3-5
+            record[15] = 1;
+        }
+        return record;
+    }
+
+    // Encode points into consecutive records, quantizing with SIMD in batches and growing bounds
+    static void encodeRecords(std::span<const PointXYZRGB> points, const LASHeader& header, const RecordLayout& layout, std::span<const uint8_t> prototype, uint8_t* records,
+                              CoordinateBounds& bounds) {
+        SCANFORGE_PROFILE_SCOPE("las.encode");
+        constexpr size_t BATCH = 256;
+        std::array<float, BATCH> xf, yf, zf;
+        std::array<int32_t, BATCH> xi, yi, zi;
+        const double xInverse = 1.0 / header.xScaleFactor;
+        const double yInverse = 1.0 / header.yScaleFactor;
+        const double zInverse = 1.0 / header.zScaleFactor;
+
+        for (size_t first = 0; first < points.size(); first += BATCH) {
+            const size_t n = std::min(BATCH, points.size() - first);
+            for (size_t i = 0; i < n; ++i) {
+                const Point3D& p = points[first + i].position;
+                xf[i] = p.x;
+                yf[i] = p.y;
+                zf[i] = p.z;
+            }
+            simd::quantizeToInt32(xf.data(), n, header.xOffset, xInverse, xi.data());
+            simd::quantizeToInt32(yf.data(), n, header.yOffset, yInverse, yi.data());
+            simd::quantizeToInt32(zf.data(), n, header.zOffset, zInverse, zi.data());
+
+            CoordinateBounds batch;
+            simd::minMax(xf.data(), n, batch.min.x, batch.max.x);
+            simd::minMax(yf.data(), n, batch.min.y, batch.max.y);
+            simd::minMax(zf.data(), n, batch.min.z, batch.max.z);
+            bounds.merge(batch);
+
+            for (size_t i = 0; i < n; ++i) {
+                uint8_t* record = records + (first + i) * layout.stride;
+                std::memcpy(record, prototype.data(), layout.stride);
+                std::memcpy(record, &xi[i], sizeof(int32_t));
+                std::memcpy(record + 4, &yi[i], sizeof(int32_t));
+                std::memcpy(record + 8, &zi[i], sizeof(int32_t));
+                if (layout.rgbOffset) {
+                    // Convert from 8-bit to 16-bit
+                    const RGB& color = points[first + i].color;
+                    const std::array<uint16_t, 3> rgb{static_cast<uint16_t>(color.r << 8), static_cast<uint16_t>(color.g << 8), static_cast<uint16_t>(color.b << 8)};
+                    std::memcpy(record + *layout.rgbOffset, rgb.data(), sizeof(rgb));
+                }
+            }
+        }
+    }
+
+    std::pmr::memory_resource* resource_;
+};
+
+/**
+ * @brief Chunked LAS reader decoding a window of points per call, in constant memory
+ *
+ * LAZ files are decompressed one LASzip chunk at a time as the window moves through them.
+ * seek() moves the window to any record, which is how LASIndex reads only part of a file.
+ *
+ * @code
+ * LASReader reader("tile.las");
+ * std::vector<PointXYZRGB> chunk(65536);
+ * while (size_t n = reader.next(chunk)) { ... }
+ * @endcode
+ */
+class LASReader final : public io::PointReader {
+   public:
+    LASReader() = default;
+    explicit LASReader(const std::filesystem::path& filename, const io::AsyncOptions& options = {}) { open(filename, options); }
 
-        // Write base point data
-        if (!writeBinary(file, x) || !writeBinary(file, y) || !writeBinary(file, z)) {
+    /**
+     * @brief Open a LAS file and position the reader on its first point record
+     * @param filename Path to LAS file
+     * @param options Read-ahead of the file: blocks kept in flight and the I/O backend
+     * @return True if the header is valid and its point format supported
+     */
+    bool open(const std::filesystem::path& filename, const io::AsyncOptions& options = {}) {
+        good_ = false;
+        remaining_ = 0;
+        if (!file_.open(filename, options)) {
+            Log::error("Failed to open LAS file: {}", filename.string());
             return false;
         }
 
-        // Write default values for other fields
-        uint16_t intensity = 0;
-        uint8_t returnInfo = 0x11;   // Return 1 of 1
-        uint8_t classification = 1;  // Unclassified
-        int8_t scanAngle = 0;
-        uint8_t userData = 0;
-        uint16_t pointSourceID = 0;
+        header_ = LASProcessor::LASHeader{};
+        if (!processor_.parseHeader(file_, header_) || !header_.isValid()) {
+            Log::error("Failed to parse LAS header from file: {}", filename.string());
+            return false;
+        }
 
-        if (!writeBinary(file, intensity) || !writeBinary(file, returnInfo) || !writeBinary(file, classification) || !writeBinary(file, scanAngle) || !writeBinary(file, userData) ||
-            !writeBinary(file, pointSourceID)) {
+        layout_ = LASProcessor::createRecordLayout(header_);
+        if (!layout_.isValid()) {
+            Log::error("Unsupported point format {} with record length {}", static_cast<int>(header_.pointDataRecordFormat), header_.pointDataRecordLength);
             return false;
         }
 
-        // Write GPS time if required
-        if (header.hasGPSTime()) {
-            double gpsTime = 0.0;
-            if (!writeBinary(file, gpsTime))
+        compressed_.reset();
+        if (header_.compressed) {
+            std::error_code error;
+            const auto fileSize = std::filesystem::file_size(filename, error);
+            compressed_ = LASProcessor::readCompressedLayout(header_, error ? 0 : fileSize, [this](uint64_t offset, uint64_t size) {
+                std::vector<uint8_t> bytes(static_cast<size_t>(size));
+                file_.clear();
+                file_.seekg(static_cast<std::streamoff>(offset));
+                file_.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+                bytes.resize(static_cast<size_t>(std::max<std::streamsize>(0, file_.gcount())));
+                return bytes;
+            });
+            if (!compressed_) {
                 return false;
+            }
+            file_.clear();
+            nextChunk_ = 0;
+            chunkRecords_.clear();
+            chunkPosition_ = 0;
+        } else {
+            file_.seekg(header_.offsetToPointData);
+            if (file_.fail()) {
+                Log::error("Failed to seek to point data section");
+                return false;
+            }
         }
 
-        // Write RGB if required
-        if (header.hasRGB()) {
-            // Convert from 8-bit to 16-bit
-            uint16_t r = static_cast<uint16_t>(point.color.r) << 8;
-            uint16_t g = static_cast<uint16_t>(point.color.g) << 8;
-            uint16_t b = static_cast<uint16_t>(point.color.b) << 8;
+        remaining_ = header_.getTotalPointCount();
+        good_ = true;
+        return true;
+    }
+
+    bool is_open() const { return file_.is_open() && good_; }
+    const LASProcessor::LASHeader& header() const { return header_; }
+
+    uint64_t size() const override { return header_.getTotalPointCount(); }
+
+    size_t next(std::span<PointXYZRGB> out) override { return read(out); }
+
+    /**
+     * @brief Decode the next points into out, with the attributes of any point type
+     *
+     * next() for PointXYZRGB; other types decode what loadLAS<PointT> would, so a reader of
+     * PointWith<field::Classification> walks the classes of a file in constant memory.
+     *
+     * @return Number of points written, 0 once the file is exhausted or after an error
+     */
+    template <typename PointT>
+    size_t read(std::span<PointT> out) {
+        if (!good_ || remaining_ == 0) {
+            return 0;
+        }
+        const auto count = static_cast<size_t>(std::min<uint64_t>(remaining_, out.size()));
+        if (compressed_ ? !readCompressed(out.first(count)) : !LASProcessor::readRecords(file_, header_, layout_, out.first(count), block_)) {
+            good_ = false;
+            return 0;
+        }
+        remaining_ -= count;
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, count);
+        return count;
+    }
 
-            if (!writeBinary(file, r) || !writeBinary(file, g) || !writeBinary(file, b)) {
+    bool good() const override { return good_; }
+
+    /**
+     * @brief Position the reader on a point record, so that next() continues from there
+     *
+     * Uncompressed files seek straight to the record. LAZ files decompress the chunk holding
+     * it, unless that chunk is the one already decompressed, so nearby seeks stay cheap.
+     *
+     * @param point Index of the record, up to size() which leaves nothing to read
+     * @return False if the reader is not open, the index is out of range or the chunk is corrupt
+     */
+    bool seek(uint64_t point) {
+        if (!good_) {
+            return false;
+        }
+        if (point > size()) {
+            Log::error("Cannot seek to point {} of a file with {} points", point, size());
+            return false;
+        }
+
+        if (point == size()) {
+            remaining_ = 0;
+            return true;
+        }
+        if (compressed_) {
+            const auto& chunks = compressed_->chunks;
+            const auto after = std::upper_bound(chunks.begin(), chunks.end(), point, [](uint64_t p, const codec::LAZCodec::Chunk& chunk) { return p < chunk.firstPoint; });
+            const auto chunk = static_cast<size_t>(after - chunks.begin()) - 1;
+            const bool loaded = nextChunk_ == chunk + 1 && chunkRecords_.size() == chunks[chunk].points * layout_.stride;
+            if (!loaded && !loadChunk(chunk)) {
+                good_ = false;
+                return false;
+            }
+            chunkPosition_ = static_cast<size_t>(point - chunks[chunk].firstPoint) * layout_.stride;
+        } else {
+            file_.clear();
+            file_.seekg(static_cast<std::streamoff>(header_.offsetToPointData + point * layout_.stride));
+            if (file_.fail()) {
+                Log::error("Failed to seek to point {}", point);
+                good_ = false;
                 return false;
             }
         }
+        remaining_ = size() - point;
+        return true;
+    }
+
+    /** @brief Points per LASzip chunk, 0 for uncompressed files */
+    uint64_t chunkSize() const { return compressed_ ? compressed_->parameters.chunkSize : 0; }
 
+   private:
+    // Read and decompress one chunk into chunkRecords_, positioned on its first record
+    bool loadChunk(size_t index) {
+        const auto& chunk = compressed_->chunks[index];
+        nextChunk_ = index + 1;
+        block_.resize(static_cast<size_t>(chunk.bytes));
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(chunk.offset));
+        {
+            SCANFORGE_PROFILE_SCOPE("las.read");
+            file_.read(reinterpret_cast<char*>(block_.data()), static_cast<std::streamsize>(block_.size()));
+        }
+        SCANFORGE_PROFILE_COUNT(BytesRead, file_.gcount());
+        chunkRecords_.resize(static_cast<size_t>(chunk.points) * layout_.stride);
+        chunkPosition_ = 0;
+        bool decompressed = static_cast<size_t>(file_.gcount()) == block_.size();
+        if (decompressed) {
+            SCANFORGE_PROFILE_SCOPE("laz.decompress");
+            decompressed = codec::LAZCodec::decompressChunk(block_, compressed_->parameters, chunkRecords_);
+        }
+        if (!decompressed) {
+            Log::error("LAZ chunk {} of {} is truncated or corrupt", nextChunk_, compressed_->chunks.size());
+            chunkRecords_.clear();
+            return false;
+        }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, block_.size());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, chunkRecords_.size());
         return true;
     }
+
+    // Fill out from the decompressed chunk, decompressing the next chunk whenever it is used up
+    template <typename PointT>
+    bool readCompressed(std::span<PointT> out) {
+        size_t done = 0;
+        while (done < out.size()) {
+            if (chunkPosition_ == chunkRecords_.size()) {
+                if (nextChunk_ == compressed_->chunks.size() || !loadChunk(nextChunk_)) {
+                    return false;
+                }
+            }
+
+            const size_t count = std::min(out.size() - done, (chunkRecords_.size() - chunkPosition_) / layout_.stride);
+            LASProcessor::decodeRecords(chunkRecords_.data() + chunkPosition_, count, header_, layout_, out.subspan(done, count));
+            chunkPosition_ += count * layout_.stride;
+            done += count;
+        }
+        return true;
+    }
+
+    io::AsyncInputStream file_;
+    LASProcessor processor_;
+    LASProcessor::LASHeader header_{};
+    LASProcessor::RecordLayout layout_;
+    ByteBuffer block_;
+    std::optional<LASProcessor::CompressedLayout> compressed_;  // Set for LAZ files
+    std::vector<uint8_t> chunkRecords_;                         // Decompressed records of the current LAZ chunk
+    size_t chunkPosition_ = 0;                                  // Bytes of chunkRecords_ already handed out
+    size_t nextChunk_ = 0;
+    uint64_t remaining_ = 0;
+    bool good_ = false;
+};
+
+/**
+ * @brief Chunked LAS writer; point count and bounding box are patched into the header on close()
+ *
+ * With header.compressed set it writes LAZ, holding points back until a whole LASzip chunk
+ * can be compressed; close() flushes the last partial chunk and appends the chunk table.
+ */
+class LASWriter final : public io::PointWriter {
+   public:
+    LASWriter() = default;
+    LASWriter(const std::filesystem::path& filename, const LASProcessor::LASHeader& header, const io::AsyncOptions& options = {}) { open(filename, header, options); }
+    ~LASWriter() override {
+        if (file_.is_open()) {
+            close();
+        }
+    }
+
+    LASWriter(const LASWriter&) = delete;
+    LASWriter& operator=(const LASWriter&) = delete;
+
+    /**
+     * @brief Create a LAS file and write a provisional header
+     * @param filename Path to output LAS file
+     * @param header Template providing point format, scale and offset; counts and bounds are ignored
+     * @param options Write-behind of the file: blocks kept in flight and the I/O backend
+     * @return True if the file was created
+     */
+    bool open(const std::filesystem::path& filename, const LASProcessor::LASHeader& header, const io::AsyncOptions& options = {}) {
+        header_ = header;
+        bounds_ = LASProcessor::CoordinateBounds{};
+        chunks_ = LASProcessor::ChunkState{};
+        pending_.clear();
+        count_ = 0;
+        good_ = false;
+        if (header_.xScaleFactor == 0.0 || header_.yScaleFactor == 0.0 || header_.zScaleFactor == 0.0) {
+            Log::error("LAS header needs non-zero scale factors to quantize points");
+            return false;
+        }
+
+        laz_.reset();
+        if (header_.compressed && !(laz_ = LASProcessor::prepareCompressedHeader(header_))) {
+            return false;
+        }
+
+        if (!file_.open(filename, options)) {
+            Log::error("Failed to create LAS file: {}", filename.string());
+            return false;
+        }
+        good_ = processor_.writeHeader(file_, header_) && (!laz_ || processor_.beginChunks(file_));
+        return good_;
+    }
+
+    bool is_open() const { return file_.is_open() && good_; }
+
+    /** @brief Number of points written so far */
+    uint64_t count() const { return count_; }
+
+    bool write(std::span<const PointXYZRGB> points) override {
+        if (!good_) {
+            return false;
+        }
+        count_ += points.size();
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, points.size());
+        if (!laz_) {
+            good_ = processor_.writePointData(file_, header_, points, 1, bounds_, blocks_);
+            return good_;
+        }
+
+        // Compress whole chunks only, keeping the remainder for the next call
+        pending_.insert(pending_.end(), points.begin(), points.end());
+        const size_t full = pending_.size() / laz_->chunkSize * laz_->chunkSize;
+        if (full > 0) {
+            good_ = processor_.writeChunks(file_, header_, *laz_, std::span<const PointXYZRGB>(pending_).first(full), 1, bounds_, chunks_);
+            pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(full));
+        }
+        return good_;
+    }
+
+    bool close() override {
+        if (!file_.is_open()) {
+            return good_;
+        }
+        if (good_ && !LASProcessor::holdsPointCount(header_, count_)) {
+            Log::error("{} points exceed the LAS 1.3 point count field", count_);
+            good_ = false;
+        }
+        if (good_ && laz_) {
+            good_ = processor_.writeChunks(file_, header_, *laz_, pending_, 1, bounds_, chunks_) && processor_.finishChunks(file_, header_, chunks_);
+            pending_.clear();
+        }
+        if (good_) {
+            LASProcessor::setPointCounts(header_, count_);
+            bounds_.applyTo(header_);
+            file_.seekp(0);
+            good_ = processor_.writeHeader(file_, header_);
+        }
+        file_.close();
+        return good_ && !file_.fail();
+    }
+
+   private:
+    io::AsyncOutputStream file_;
+    LASProcessor processor_;
+    LASProcessor::LASHeader header_{};
+    LASProcessor::CoordinateBounds bounds_;
+    std::vector<std::vector<uint8_t>> blocks_;  // Reused encoding buffer
+    std::optional<codec::LAZCodec::Parameters> laz_;  // Set when writing LAZ
+    LASProcessor::ChunkState chunks_;
+    std::vector<PointXYZRGB> pending_;  // Points waiting for a full LAZ chunk
+    uint64_t count_ = 0;
+    bool good_ = false;
 };
 
-}  // namespace scanforge
\ No newline at end of file
+}  // namespace scanforge
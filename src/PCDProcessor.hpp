@@ -1,20 +1,36 @@
 #pragma once
 
 #include "codec/LZFCodec.hpp"
+#include "io/AsyncFile.hpp"
+#include "io/LineReader.hpp"
+#include "io/LoadFilter.hpp"
+#include "io/MappedFile.hpp"
+#include "io/PointStream.hpp"
 #include "PointCloudTypes.hpp"
+#include "simd/Simd.hpp"
+#include "tooling/Arena.hpp"
 #include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Profiler.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <ranges>
 #include <span>
+#include <spanstream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <tuple>
 #include <vector>
 
@@ -25,8 +41,18 @@ using Log = scanforge::tooling::Log;
 /**
  * @brief PCD (Point Cloud Data) file processor supporting all PCD formats
  * Handles both loading and saving of PCD files (ASCII, binary, binary compressed)
+ *
+ * binary_compressed_chunked is a ScanForge extension of binary_compressed that PCL cannot
+ * read: the points are split into blocks of column-major fields, each its own LZF stream, so
+ * blocks are compressed and decompressed in parallel and streamed one at a time. Its payload is
+ * a uint64 offset from the payload start to the block index, the blocks back to back, then the
+ * index itself: uint32 points per block, uint32 block count and the uint32 compressed size of
+ * every block.
  */
 class PCDProcessor {
+    friend class PCDReader;
+    friend class PCDWriter;
+
    public:
     struct PCDHeader {
         std::string version;
@@ -53,58 +79,364 @@ class PCDProcessor {
             auto it = std::find(fields.begin(), fields.end(), field);
             return (it != fields.end()) ? static_cast<size_t>(it - fields.begin()) : SIZE_MAX;
         }
+
+        /** @brief Size in bytes of one binary point record */
+        size_t getPointSize() const {
+            return std::ranges::fold_left(std::views::zip(sizes, counts), 0uz, [](size_t sum, const auto& size_count) {
+                const auto& [size, count] = size_count;
+                return sum + size * count;
+            });
+        }
+
+        /** @brief Byte offset of a field inside a binary point record */
+        size_t getFieldOffset(size_t fieldIndex) const {
+            size_t offset = 0;
+            for (size_t i = 0; i < fieldIndex && i < fields.size(); ++i) {
+                offset += sizes[i] * counts[i];
+            }
+            return offset;
+        }
+    };
+
+    /**
+     * @brief Record layout compiled once from a header for binary decoding
+     *
+     * Field offsets are resolved up front so the per-point loop never walks the header.
+     * The common PCL layouts get dedicated loops with compile-time offsets.
+     */
+    struct DecodePlan {
+        enum class Layout : uint8_t {
+            Generic,  // Arbitrary field order and extra fields, runtime offsets
+            XYZ,      // x y z, 12-byte stride
+            XYZRGB    // x y z rgb, 16-byte stride
+        };
+
+        Layout layout = Layout::Generic;
+        size_t stride = 0;
+        size_t xOffset = 0;
+        size_t yOffset = 0;
+        size_t zOffset = 0;
+        std::optional<size_t> rgbOffset;
+
+        // Numeric fields decoded only for point types with the matching attribute
+        struct Field {
+            size_t offset = 0;
+            char type = 'F';
+            uint32_t size = 4;
+        };
+        std::optional<Field> intensity;
+        std::optional<Field> classification;
+        std::optional<Field> gpsTime;
+
+        bool isValid() const { return stride > 0; }
+    };
+
+    /**
+     * @brief Compile the binary decode plan for a header
+     * @param header Parsed PCD header
+     * @return Plan, invalid if x/y/z are missing or are not 4-byte fields
+     */
+    static DecodePlan createDecodePlan(const PCDHeader& header) {
+        DecodePlan plan;
+        const size_t xIdx = header.getFieldIndex("x");
+        const size_t yIdx = header.getFieldIndex("y");
+        const size_t zIdx = header.getFieldIndex("z");
+        const size_t rgbIdx = header.getFieldIndex("rgb");
+        if (xIdx == SIZE_MAX || yIdx == SIZE_MAX || zIdx == SIZE_MAX || header.sizes.size() != header.fields.size() || header.counts.size() != header.fields.size()) {
+            return plan;
+        }
+        if (header.sizes[xIdx] != sizeof(float) || header.sizes[yIdx] != sizeof(float) || header.sizes[zIdx] != sizeof(float)) {
+            return plan;
+        }
+
+        plan.xOffset = header.getFieldOffset(xIdx);
+        plan.yOffset = header.getFieldOffset(yIdx);
+        plan.zOffset = header.getFieldOffset(zIdx);
+        if (rgbIdx != SIZE_MAX && header.sizes[rgbIdx] == sizeof(uint32_t)) {
+            plan.rgbOffset = header.getFieldOffset(rgbIdx);
+        }
+        plan.intensity = numericField(header, header.getFieldIndex("intensity"));
+        plan.classification = numericField(header, classificationField(header));
+        plan.gpsTime = numericField(header, header.getFieldIndex("gps_time"));
+        plan.stride = header.getPointSize();
+
+        const bool xyzPacked = plan.xOffset == 0 && plan.yOffset == 4 && plan.zOffset == 8;
+        if (xyzPacked && plan.stride == 16 && plan.rgbOffset == 12u) {
+            plan.layout = DecodePlan::Layout::XYZRGB;
+        } else if (xyzPacked && plan.stride == 12) {
+            plan.layout = DecodePlan::Layout::XYZ;
+        }
+        return plan;
+    }
+
+    // Offset and type of a scalar field, nullopt when missing or of a size its type does not have
+    static std::optional<DecodePlan::Field> numericField(const PCDHeader& header, size_t index) {
+        if (index == SIZE_MAX || index >= header.types.size()) {
+            return std::nullopt;
+        }
+        const char type = header.types[index];
+        const uint32_t size = header.sizes[index];
+        const bool valid = type == 'F' ? size == 4 || size == 8 : (type == 'U' || type == 'I') && (size == 1 || size == 2 || size == 4 || size == 8);
+        if (!valid) {
+            return std::nullopt;
+        }
+        return DecodePlan::Field{header.getFieldOffset(index), type, size};
+    }
+
+    // Value of a scalar field of a record, converted to double
+    static double readNumber(const uint8_t* record, const DecodePlan::Field& field) {
+        auto read = [&]<typename T>(T value) {
+            std::memcpy(&value, record + field.offset, sizeof(T));
+            return static_cast<double>(value);
+        };
+        if (field.type == 'F') {
+            return field.size == 4 ? read(float{}) : read(double{});
+        }
+        if (field.type == 'U') {
+            return field.size == 1 ? read(uint8_t{}) : field.size == 2 ? read(uint16_t{}) : field.size == 4 ? read(uint32_t{}) : read(uint64_t{});
+        }
+        return field.size == 1 ? read(int8_t{}) : field.size == 2 ? read(int16_t{}) : field.size == 4 ? read(int32_t{}) : read(int64_t{});
+    }
+
+    /**
+     * @param resource Resource the loaded clouds and the buffers of a load allocate from; a
+     *                 tooling::Arena reused from file to file keeps loads off the global heap
+     */
+    explicit PCDProcessor(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : resource_(resource) {}
+
+    /** @brief Resource loaded clouds allocate from */
+    std::pmr::memory_resource* memoryResource() const { return resource_; }
+
+    /** @brief How loadPCD() reaches the file contents */
+    enum class LoadMode : uint8_t {
+        Stream,       // Buffered std::ifstream reads into a temporary payload buffer
+        MemoryMapped  // Decode straight from mapped pages, no intermediate payload copy
+    };
+
+    /**
+     * @brief Read-only view over the binary records of a memory-mapped PCD file
+     *
+     * Gives access to header and raw point records without building a PointCloud.
+     * Records of a binary file are the mapped pages themselves; a binary_compressed
+     * payload is decompressed once into a buffer owned by the view.
+     *
+     * @code
+     * PCDProcessor processor;
+     * if (auto view = processor.mapPCD("archive.pcd")) {
+     *     auto [minPt, maxPt] = view->getBoundingBox();
+     *     float firstX = view->field<float>(0, view->header().getFieldIndex("x"));
+     * }
+     * @endcode
+     */
+    class PCDView {
+       public:
+        const PCDHeader& header() const { return header_; }
+
+        /** @brief Number of point records */
+        size_t size() const { return stride_ > 0 ? records_.size() / stride_ : 0; }
+        bool empty() const { return records_.empty(); }
+
+        /** @brief Size in bytes of one record */
+        size_t stride() const { return stride_; }
+
+        /** @brief All records, stride() bytes each, in file field order */
+        std::span<const uint8_t> records() const { return records_; }
+
+        std::span<const uint8_t> record(size_t index) const { return records_.subspan(index * stride_, stride_); }
+
+        /**
+         * @brief Read one field element of a record
+         * @tparam T Trivially copyable type matching the field's SIZE
+         * @param index Record index
+         * @param fieldIndex Index into header().fields
+         * @param element Element index for fields with COUNT > 1
+         */
+        template <typename T>
+        T field(size_t index, size_t fieldIndex, size_t element = 0) const
+            requires std::is_trivially_copyable_v<T>
+        {
+            T value;
+            std::memcpy(&value, records_.data() + index * stride_ + header_.getFieldOffset(fieldIndex) + element * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        /** @brief Bounding box of the finite XYZ records, computed directly on the mapping */
+        std::pair<Point3D, Point3D> getBoundingBox() const {
+            const DecodePlan plan = createDecodePlan(header_);
+
+            Point3D minPt{0, 0, 0};
+            Point3D maxPt{0, 0, 0};
+            bool first = true;
+            for (size_t i = 0; i < size(); ++i) {
+                const uint8_t* rec = records_.data() + i * stride_;
+                Point3D pos;
+                std::memcpy(&pos.x, rec + plan.xOffset, sizeof(float));
+                std::memcpy(&pos.y, rec + plan.yOffset, sizeof(float));
+                std::memcpy(&pos.z, rec + plan.zOffset, sizeof(float));
+                if (!std::isfinite(pos.x) || !std::isfinite(pos.y) || !std::isfinite(pos.z)) {
+                    continue;
+                }
+                if (first) {
+                    minPt = maxPt = pos;
+                    first = false;
+                    continue;
+                }
+                minPt.x = std::min(minPt.x, pos.x);
+                minPt.y = std::min(minPt.y, pos.y);
+                minPt.z = std::min(minPt.z, pos.z);
+                maxPt.x = std::max(maxPt.x, pos.x);
+                maxPt.y = std::max(maxPt.y, pos.y);
+                maxPt.z = std::max(maxPt.z, pos.z);
+            }
+            return {minPt, maxPt};
+        }
+
+       private:
+        friend class PCDProcessor;
+
+        io::MappedFile file_;
+        PCDHeader header_;
+        ByteBuffer decoded_;  // Only used for binary_compressed and binary_compressed_chunked payloads
+        std::span<const uint8_t> records_;
+        size_t stride_ = 0;
     };
 
     /**
      * @brief Load point cloud from PCD file
      * @param filename Path to PCD file
+     * @param mode Stream through std::ifstream or decode from a memory mapping
+     * @param threadCount Threads parsing an ascii payload or decompressing binary_compressed_chunked blocks;
+     *                    0 uses every hardware thread
+     * @tparam PointT Point3D, PointXYZRGB or a PointWith<...> composition. Besides x/y/z and rgb,
+     *                the fields intensity, label (or classification) and gps_time fill the
+     *                matching attributes; fields PointT does not have are not decoded
      * @return Tuple of header and point cloud
      */
-    std::tuple<PCDHeader, PointCloudXYZRGB> loadPCD(const std::string& filename) {
+    template <typename PointT = PointXYZRGB>
+    std::tuple<PCDHeader, PointCloud<PointT>> loadPCD(const std::string& filename, LoadMode mode = LoadMode::Stream, unsigned threadCount = 1) {
+        return loadPCD<PointT>(filename, io::LoadFilter{}, mode, threadCount);
+    }
+
+    /**
+     * @brief Load the points of a PCD file that pass a filter
+     *
+     * The filter runs as records are decoded, so rejected points are never stored and records
+     * the stride skips are not parsed. Record indices count the lines of an ascii payload, so
+     * a stride or a sample picks the same points in either mode and on any number of threads.
+     * Non-finite points are dropped; the cloud is dense, unorganized and in file order.
+     *
+     * @param filter Points to keep (see io::LoadFilter); the predicate sees intensity,
+     *               classification and GPS time when the file has them
+     * @return Tuple of header and the kept points; an empty cloud if the filter is invalid
+     */
+    template <typename PointT = PointXYZRGB>
+    std::tuple<PCDHeader, PointCloud<PointT>> loadPCD(const std::string& filename, const io::LoadFilter& filter, LoadMode mode = LoadMode::Stream, unsigned threadCount = 1) {
+        if (!filter.isValid()) {
+            return {PCDHeader{}, PointCloud<PointT>{}};
+        }
+        if (mode == LoadMode::MemoryMapped) {
+            return loadPCDMapped<PointT>(filename, filter, threadCount);
+        }
+
         std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             Log::error("Failed to open file: {}", filename);
-            return {PCDHeader{}, PointCloudXYZRGB{}};
+            return {PCDHeader{}, PointCloud<PointT>{}};
         }
 
         PCDHeader header;
         if (!parseHeader(file, header)) {
             Log::error("Failed to parse header from file: {}", filename);
-            return {PCDHeader{}, PointCloudXYZRGB{}};
+            return {PCDHeader{}, PointCloud<PointT>{}};
         }
 
         if (!header.isValid() || !header.hasXYZ()) {
             Log::error("Invalid header or missing XYZ fields in file: {}", filename);
-            return {header, PointCloudXYZRGB{}};
+            return {header, PointCloud<PointT>{}};
         }
 
-        PointCloudXYZRGB pointCloud;
-        pointCloud.points.reserve(header.points);
+        PointCloud<PointT> pointCloud(resource_);
+        if (!filter.active()) {
+            pointCloud.points.reserve(header.points);
+        }
         pointCloud.width = header.width;
         pointCloud.height = header.height;
 
         if (header.dataType == "binary_compressed") {
-            if (!loadBinaryCompressed(file, header, pointCloud)) {
+            if (!loadBinaryCompressed(file, header, pointCloud, filter)) {
                 Log::error("Failed to load binary compressed data from file: {}", filename);
-                return {header, PointCloudXYZRGB{}};
+                return {header, PointCloud<PointT>{}};
+            }
+        } else if (header.dataType == "binary_compressed_chunked") {
+            if (!loadChunked(file, header, pointCloud, filter, threadCount)) {
+                Log::error("Failed to load chunked binary compressed data from file: {}", filename);
+                return {header, PointCloud<PointT>{}};
             }
         } else if (header.dataType == "binary") {
-            if (!loadBinary(file, header, pointCloud)) {
+            if (!loadBinary(file, header, pointCloud, filter)) {
                 Log::error("Failed to load binary data from file: {}", filename);
-                return {header, PointCloudXYZRGB{}};
+                return {header, PointCloud<PointT>{}};
             }
         } else if (header.dataType == "ascii") {
-            if (!loadASCII(file, header, pointCloud)) {
+            if (!loadASCII(file, header, pointCloud, threadCount, filter)) {
                 Log::error("Failed to load ASCII data from file: {}", filename);
-                return {header, PointCloudXYZRGB{}};
+                return {header, PointCloud<PointT>{}};
             }
         } else {
             Log::error("Unsupported data type '{}' in file: {}", header.dataType, filename);
-            return {header, PointCloudXYZRGB{}};
+            return {header, PointCloud<PointT>{}};
         }
 
+        finishSelection(filter, pointCloud);
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, pointCloud.size());
         Log::debug("Successfully loaded {} points from file: {}", pointCloud.size(), filename);
-        return {header, pointCloud};
+        return {header, std::move(pointCloud)};
+    }
+
+    /**
+     * @brief Map a binary or binary_compressed PCD file without building a point cloud
+     * @param filename Path to PCD file
+     * @return View over header and records, or std::nullopt on failure (ASCII files included)
+     */
+    std::optional<PCDView> mapPCD(const std::string& filename) {
+        PCDView view;
+        if (!view.file_.open(filename)) {
+            return std::nullopt;
+        }
+
+        size_t dataOffset = 0;
+        if (!parseMappedHeader(view.file_.data(), view.header_, dataOffset)) {
+            Log::error("Failed to parse header from file: {}", filename);
+            return std::nullopt;
+        }
+
+        if (!view.header_.isValid() || !createDecodePlan(view.header_).isValid()) {
+            Log::error("Invalid header or missing XYZ fields in file: {}", filename);
+            return std::nullopt;
+        }
+
+        auto payload = view.file_.data().subspan(dataOffset);
+        view.stride_ = view.header_.getPointSize();
+        const size_t totalSize = view.stride_ * view.header_.points;
+
+        if (view.header_.dataType == "binary") {
+            if (payload.size() < totalSize) {
+                Log::error("Failed to read expected amount of binary data");
+                return std::nullopt;
+            }
+            view.records_ = payload.first(totalSize);
+        } else if (view.header_.dataType == "binary_compressed" || view.header_.dataType == "binary_compressed_chunked") {
+            view.decoded_ = view.header_.dataType == "binary_compressed" ? decodeCompressedPayload(payload, view.header_) : decodeChunkedPayload(payload, view.header_, 1, resource_);
+            if (view.decoded_.size() < totalSize) {
+                return std::nullopt;
+            }
+            view.records_ = std::span<const uint8_t>(view.decoded_).first(totalSize);
+        } else {
+            Log::error("Memory mapping is only supported for binary PCD data, not '{}': {}", view.header_.dataType, filename);
+            return std::nullopt;
+        }
+
+        return view;
     }
 
     /**
@@ -126,7 +458,9 @@ class PCDProcessor {
             return false;
         }
 
-        return writeASCII(file, header, pointCloud);
+        std::vector<char> buffer;
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, pointCloud.size());
+        return writeASCII(file, header, pointCloud.points, buffer);
     }
 
     /**
@@ -148,7 +482,9 @@ class PCDProcessor {
             return false;
         }
 
-        return writeBinary(file, header, pointCloud);
+        std::vector<uint8_t> buffer;
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, pointCloud.size());
+        return writeBinary(file, header, pointCloud.points, buffer);
     }
 
     /**
@@ -156,9 +492,11 @@ class PCDProcessor {
      * @param filename Path to output PCD file
      * @param header PCD header information
      * @param pointCloud Point cloud data to save
+     * @param level LZF compression level
      * @return True if save was successful, false otherwise
      */
-    bool savePCD_BinaryCompressed(const std::string& filename, const PCDHeader& header, const PointCloudXYZRGB& pointCloud) {
+    bool savePCD_BinaryCompressed(const std::string& filename, const PCDHeader& header, const PointCloudXYZRGB& pointCloud,
+                                  codec::LZFCodec::Level level = codec::LZFCodec::Level::Normal) {
         std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             Log::error("Failed to create file: {}", filename);
@@ -170,7 +508,48 @@ class PCDProcessor {
             return false;
         }
 
-        return writeBinaryCompressed(file, header, pointCloud);
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, pointCloud.size());
+        return writeBinaryCompressed(file, header, pointCloud, level);
+    }
+
+    /**
+     * @brief Save point cloud to PCD file in the chunked binary compressed format
+     *
+     * Blocks of blockPoints points are compressed independently across threads. PCL cannot
+     * read the result; use savePCD_BinaryCompressed() for files meant for PCL.
+     *
+     * @param filename Path to output PCD file
+     * @param header PCD header information
+     * @param pointCloud Point cloud data to save
+     * @param threadCount Threads compressing blocks; 0 uses every hardware thread
+     * @param level LZF compression level
+     * @param blockPoints Points per compressed block
+     * @return True if save was successful, false otherwise
+     */
+    bool savePCD_BinaryCompressedChunked(const std::string& filename, const PCDHeader& header, const PointCloudXYZRGB& pointCloud, unsigned threadCount = 1,
+                                         codec::LZFCodec::Level level = codec::LZFCodec::Level::Normal, uint32_t blockPoints = COMPRESSED_BLOCK_POINTS) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            Log::error("Failed to create file: {}", filename);
+            return false;
+        }
+
+        if (!writeHeader(file, header, "binary_compressed_chunked")) {
+            Log::error("Failed to write header to file: {}", filename);
+            return false;
+        }
+
+        if (pointCloud.empty() || blockPoints == 0) {
+            Log::error("Cannot compress an empty point cloud");
+            return false;
+        }
+
+        std::vector<uint8_t> records;
+        std::vector<uint32_t> blockSizes;
+        const auto payloadStart = file.tellp();
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, pointCloud.size());
+        return serializeRecords(header, pointCloud.points, records) && beginBlocks(file) &&
+               writeCompressedBlocks(file, header, records, blockPoints, blockSizes, threadCount, level) && finishBlocks(file, payloadStart, blockPoints, blockSizes);
     }
 
     /**
@@ -187,6 +566,8 @@ class PCDProcessor {
             return savePCD_Binary(filename, header, pointCloud);
         } else if (header.dataType == "binary_compressed") {
             return savePCD_BinaryCompressed(filename, header, pointCloud);
+        } else if (header.dataType == "binary_compressed_chunked") {
+            return savePCD_BinaryCompressedChunked(filename, header, pointCloud);
         } else {
             Log::error("Unsupported data type '{}' for saving", header.dataType);
             return false;
@@ -196,7 +577,7 @@ class PCDProcessor {
     /**
      * @brief Create a standard PCD header for XYZRGB point clouds
      * @param pointCloud Point cloud to create header for
-     * @param dataType Format type ("ascii", "binary", or "binary_compressed")
+     * @param dataType Format type ("ascii", "binary", "binary_compressed" or "binary_compressed_chunked")
      * @return PCDHeader configured for the point cloud
      */
     static PCDHeader createXYZRGBHeader(const PointCloudXYZRGB& pointCloud, const std::string& dataType = "ascii") {
@@ -214,7 +595,16 @@ class PCDProcessor {
         return header;
     }
 
+    /** @brief Points per block of a binary_compressed_chunked payload, 1 MB of XYZRGB records */
+    static constexpr uint32_t COMPRESSED_BLOCK_POINTS = uint32_t{1} << 16;
+
    private:
+    static constexpr size_t MIN_ASCII_BYTES_PER_THREAD = size_t{1} << 20;  // Below this a thread costs more than it parses
+    static constexpr size_t READ_BLOCK_SIZE = size_t{2} << 20;             // Bytes of binary records read and decoded at a time
+    static constexpr size_t WRITE_BLOCK_SIZE = size_t{1} << 20;            // Bytes serialized before each write to the stream
+    static constexpr size_t CHUNKED_READ_BYTES = size_t{16} << 20;         // Compressed blocks a stream load reads at once, at least one
+    static constexpr size_t GATHER_POINTS = 256;                           // Records interleaved at a time from a column-major block
+
     // Modern file I/O helper using RAII and C++23 features
     template <typename FileType>
     class FileHandle {
@@ -288,7 +678,8 @@ class PCDProcessor {
     using InputFile = FileHandle<std::ifstream>;
     using OutputFile = FileHandle<std::ofstream>;
 
-    bool parseHeader(std::ifstream& file, PCDHeader& header) {
+    bool parseHeader(std::istream& file, PCDHeader& header) {
+        SCANFORGE_PROFILE_SCOPE("pcd.header");
         std::string line;
 
         while (std::getline(file, line)) {
@@ -344,7 +735,18 @@ class PCDProcessor {
         return header.isValid();
     }
 
-    bool loadBinaryCompressed(std::ifstream& file, const PCDHeader& header, PointCloudXYZRGB& pointCloud) {
+    template <typename PointT>
+    bool loadBinaryCompressed(std::ifstream& file, const PCDHeader& header, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter) {
+        auto reorderedData = readCompressedRecords(file, header);
+        if (reorderedData.empty()) {
+            return false;
+        }
+
+        return parseBinaryData(reorderedData, header, pointCloud, filter);
+    }
+
+    // Read a binary_compressed payload from a stream and decode it to interleaved records
+    ByteBuffer readCompressedRecords(std::istream& file, const PCDHeader& header) {
         // Read compressed size using modern approach
         uint32_t compressedSize, uncompressedSize;
 
@@ -356,251 +758,1148 @@ class PCDProcessor {
 
         if (!readValue(compressedSize) || !readValue(uncompressedSize)) {
             Log::error("Failed to read compression header");
-            return false;
+            return {};
         }
 
-        std::vector<uint8_t> compressedData(compressedSize);
-        file.read(reinterpret_cast<char*>(compressedData.data()), static_cast<std::streamsize>(compressedSize));
-
+        ByteBuffer compressedData(compressedSize, resource_);
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.read");
+            file.read(reinterpret_cast<char*>(compressedData.data()), static_cast<std::streamsize>(compressedSize));
+        }
         if (file.fail()) {
             Log::error("Failed to read compressed data");
-            return false;
+            return {};
         }
+        SCANFORGE_PROFILE_COUNT(BytesRead, 2 * sizeof(uint32_t) + compressedSize);
 
-        auto uncompressedData = scanforge::codec::LZFCodec::decompress(compressedData, uncompressedSize);
-        if (uncompressedData.empty()) {
-            Log::error("Failed to decompress data");
-            return false;
+        return decompressFields(compressedData, uncompressedSize, header);
+    }
+
+    ByteBuffer decompressFields(std::span<const uint8_t> compressedData, uint32_t uncompressedSize, const PCDHeader& header) {
+        ByteBuffer uncompressedData(resource_);
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.decompress");
+            if (!scanforge::codec::LZFCodec::decompress(compressedData, uncompressedSize, uncompressedData) || uncompressedData.empty()) {
+                Log::error("Failed to decompress data");
+                return {};
+            }
         }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, compressedData.size());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, uncompressedData.size());
 
-        auto reorderedData = reorderFields(uncompressedData, header);
+        auto reorderedData = reorderFields(uncompressedData, header, resource_);
         if (reorderedData.empty()) {
             Log::error("Failed to reorder fields");
-            return false;
         }
-
-        return parseBinaryData(reorderedData, header, pointCloud);
+        return reorderedData;
     }
 
-    bool loadBinary(std::ifstream& file, const PCDHeader& header, PointCloudXYZRGB& pointCloud) {
-        // Calculate expected data size using ranges
-        auto pointSize = std::ranges::fold_left(std::views::zip(header.sizes, header.counts), 0uz, [](size_t sum, const auto& size_count) {
-            const auto& [size, count] = size_count;
-            return sum + size * count;
-        });
-
-        size_t totalSize = pointSize * header.points;
-        std::vector<uint8_t> binaryData(totalSize);
+    // Decode a mapped binary_compressed payload: size prefix, then one LZF stream
+    ByteBuffer decodeCompressedPayload(std::span<const uint8_t> payload, const PCDHeader& header) {
+        uint32_t compressedSize, uncompressedSize;
+        if (payload.size() < 2 * sizeof(uint32_t)) {
+            Log::error("Failed to read compression header");
+            return {};
+        }
+        std::memcpy(&compressedSize, payload.data(), sizeof(compressedSize));
+        std::memcpy(&uncompressedSize, payload.data() + sizeof(compressedSize), sizeof(uncompressedSize));
 
-        file.read(reinterpret_cast<char*>(binaryData.data()), static_cast<std::streamsize>(totalSize));
-        if (file.gcount() != static_cast<std::streamsize>(totalSize)) {
-            Log::error("Failed to read expected amount of binary data");
-            return false;
+        payload = payload.subspan(2 * sizeof(uint32_t));
+        if (payload.size() < compressedSize) {
+            Log::error("Failed to read compressed data");
+            return {};
         }
 
-        return parseBinaryData(binaryData, header, pointCloud);
+        return decompressFields(payload.first(compressedSize), uncompressedSize, header);
     }
 
-    bool loadASCII(std::ifstream& file, const PCDHeader& header, PointCloudXYZRGB& pointCloud) {
-        std::string line;
-        size_t xIdx = header.getFieldIndex("x");
-        size_t yIdx = header.getFieldIndex("y");
-        size_t zIdx = header.getFieldIndex("z");
-        size_t rgbIdx = header.getFieldIndex("rgb");
-
-        for (uint32_t i = 0; i < header.points && std::getline(file, line); ++i) {
-            std::istringstream iss(line);
-            std::vector<std::string> values;
-            std::string value;
-
-            while (iss >> value) {
-                values.push_back(value);
-            }
+    // Block index closing a binary_compressed_chunked payload
+    struct BlockIndex {
+        uint32_t blockPoints = 0;
+        std::vector<uint32_t> sizes;  // Compressed bytes of every block
+        uint64_t bytes = 0;           // Sum of sizes
 
-            if (values.size() < header.fields.size())
-                continue;
+        /** @brief Bytes of the index itself */
+        size_t indexSize() const { return 2 * sizeof(uint32_t) + sizes.size() * sizeof(uint32_t); }
+    };
 
-            Point3D position(std::stof(values[xIdx]), std::stof(values[yIdx]), std::stof(values[zIdx]));
+    /**
+     * Parse a block index and check it against the header
+     * @param bytes Bytes from the start of the index
+     * @param blocksBytes Bytes between the index offset and the index, which the blocks must fill exactly
+     */
+    static std::optional<BlockIndex> parseBlockIndex(std::span<const uint8_t> bytes, const PCDHeader& header, uint64_t blocksBytes) {
+        BlockIndex index;
+        uint32_t count = 0;
+        if (bytes.size() < 2 * sizeof(uint32_t)) {
+            Log::error("Compressed block index is truncated");
+            return std::nullopt;
+        }
+        std::memcpy(&index.blockPoints, bytes.data(), sizeof(uint32_t));
+        std::memcpy(&count, bytes.data() + sizeof(uint32_t), sizeof(uint32_t));
+        if (index.blockPoints == 0 || count != (uint64_t{header.points} + index.blockPoints - 1) / index.blockPoints ||
+            bytes.size() - 2 * sizeof(uint32_t) < uint64_t{count} * sizeof(uint32_t)) {
+            Log::error("Compressed block index does not match {} points", header.points);
+            return std::nullopt;
+        }
 
-            RGB color(255, 255, 255);  // Default white
-            if (rgbIdx != SIZE_MAX && rgbIdx < values.size()) {
-                uint32_t rgbPacked = static_cast<uint32_t>(std::stoul(values[rgbIdx]));
-                color = RGB(rgbPacked);
-            }
+        index.sizes.resize(count);
+        std::memcpy(index.sizes.data(), bytes.data() + 2 * sizeof(uint32_t), count * sizeof(uint32_t));
+        index.bytes = std::ranges::fold_left(index.sizes, uint64_t{0}, std::plus<>{});
+        if (index.bytes != blocksBytes) {
+            Log::error("Compressed blocks hold {} bytes, the index expects {}", blocksBytes, index.bytes);
+            return std::nullopt;
+        }
+        return index;
+    }
 
-            // Check for NaN/Inf values
-            bool isValid = std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z);
-            if (!isValid) {
-                pointCloud.is_dense = false;
-                continue;
+    // Decompress the blocks of a binary_compressed_chunked payload to interleaved records
+    static ByteBuffer decompressBlocks(std::span<const uint8_t> blocks, const BlockIndex& index, const PCDHeader& header, unsigned threadCount,
+                                       std::pmr::memory_resource* resource) {
+        const size_t stride = header.getPointSize();
+        ByteBuffer columns(stride * header.points, resource);
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.decompress");
+            if (columns.empty() || !codec::LZFCodec::decompressBlocks(blocks, index.sizes, columns, size_t{index.blockPoints} * stride, threadCount)) {
+                Log::error("Failed to decompress data");
+                return {};
             }
+        }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, blocks.size());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, columns.size());
+        return transposeBlocks<false>(columns, header, index.blockPoints, resource);
+    }
 
-            pointCloud.push_back(PointXYZRGB(position, color));
+    // Read the block index of a binary_compressed_chunked payload from a stream, then return to the first block
+    static std::optional<BlockIndex> readBlockIndex(std::istream& file, const PCDHeader& header) {
+        const auto payloadStart = file.tellg();
+        uint64_t indexOffset = 0;
+        file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+        file.seekg(0, std::ios::end);
+        const auto fileEnd = file.tellg();
+        if (!file.good() || payloadStart < 0 || indexOffset < sizeof(indexOffset) || indexOffset > static_cast<uint64_t>(fileEnd - payloadStart)) {
+            Log::error("Failed to read compressed block index");
+            return std::nullopt;
         }
 
-        return true;
+        std::vector<uint8_t> bytes(static_cast<size_t>(static_cast<uint64_t>(fileEnd - payloadStart) - indexOffset));
+        file.seekg(payloadStart + static_cast<std::streamoff>(indexOffset));
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        SCANFORGE_PROFILE_COUNT(BytesRead, sizeof(indexOffset) + bytes.size());
+        auto index = file.good() ? parseBlockIndex(bytes, header, indexOffset - sizeof(indexOffset)) : std::nullopt;
+        file.seekg(payloadStart + static_cast<std::streamoff>(sizeof(indexOffset)));
+        return index && file.good() ? index : std::nullopt;
     }
 
-    bool parseBinaryData(const std::vector<uint8_t>& data, const PCDHeader& header, PointCloudXYZRGB& pointCloud) {
-        // Find field indices using modern approach
-        auto findFieldIndex = [&header](const std::string& name) -> std::optional<size_t> {
-            auto it = std::ranges::find(header.fields, name);
-            return it != header.fields.end() ? std::optional{static_cast<size_t>(std::distance(header.fields.begin(), it))} : std::nullopt;
-        };
+    // Block index of a mapped binary_compressed_chunked payload; blocks receives the compressed blocks
+    static std::optional<BlockIndex> mappedBlockIndex(std::span<const uint8_t> payload, const PCDHeader& header, std::span<const uint8_t>& blocks) {
+        uint64_t indexOffset = 0;
+        if (payload.size() >= sizeof(indexOffset)) {
+            std::memcpy(&indexOffset, payload.data(), sizeof(indexOffset));
+        }
+        if (indexOffset < sizeof(indexOffset) || indexOffset > payload.size()) {
+            Log::error("Failed to read compressed block index");
+            return std::nullopt;
+        }
 
-        auto xIdx = findFieldIndex("x");
-        auto yIdx = findFieldIndex("y");
-        auto zIdx = findFieldIndex("z");
-        auto rgbIdx = findFieldIndex("rgb");
+        blocks = payload.subspan(sizeof(indexOffset), static_cast<size_t>(indexOffset) - sizeof(indexOffset));
+        return parseBlockIndex(payload.subspan(static_cast<size_t>(indexOffset)), header, blocks.size());
+    }
+
+    // Decode a mapped binary_compressed_chunked payload to interleaved records, for PCDView
+    static ByteBuffer decodeChunkedPayload(std::span<const uint8_t> payload, const PCDHeader& header, unsigned threadCount,
+                                           std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        std::span<const uint8_t> blocks;
+        const auto index = mappedBlockIndex(payload, header, blocks);
+        return index ? decompressBlocks(blocks, *index, header, threadCount, resource) : ByteBuffer{};
+    }
 
-        if (!xIdx || !yIdx || !zIdx) {
-            Log::error("Missing required XYZ fields");
+    // Load a binary_compressed_chunked payload from a stream, reading about CHUNKED_READ_BYTES of compressed blocks at a time
+    template <typename PointT>
+    bool loadChunked(std::istream& file, const PCDHeader& header, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter, unsigned threadCount) {
+        const DecodePlan plan = createDecodePlan(header);
+        if (!plan.isValid()) {
+            Log::error("Missing or unsupported XYZ fields");
+            return false;
+        }
+        const auto index = readBlockIndex(file, header);
+        if (!index) {
             return false;
         }
 
-        // Calculate point size using ranges
-        auto pointSize = std::ranges::fold_left(std::views::zip(header.sizes, header.counts), 0uz, [](size_t sum, const auto& size_count) {
-            const auto& [size, count] = size_count;
-            return sum + size * count;
-        });
-
-        for (uint32_t i = 0; i < header.points; ++i) {
-            size_t offset = i * pointSize;
-            if (offset + pointSize > data.size()) {
-                Log::error("Data size mismatch");
+        std::optional<io::PointSelection<PointT>> selection;
+        if (filter.active()) {
+            selection.emplace(filter);
+        }
+        ByteBuffer blocks(resource_);
+        for (size_t first = 0, count = 0; first < index->sizes.size(); first += count) {
+            uint64_t bytes = index->sizes[first];
+            for (count = 1; first + count < index->sizes.size() && bytes + index->sizes[first + count] <= CHUNKED_READ_BYTES; ++count) {
+                bytes += index->sizes[first + count];
+            }
+            blocks.resize(static_cast<size_t>(bytes));
+            {
+                SCANFORGE_PROFILE_SCOPE("pcd.read");
+                file.read(reinterpret_cast<char*>(blocks.data()), static_cast<std::streamsize>(bytes));
+            }
+            if (file.fail()) {
+                Log::error("Failed to read compressed data");
+                return false;
+            }
+            SCANFORGE_PROFILE_COUNT(BytesRead, bytes);
+            if (!decodeBlocks(blocks, *index, first, count, header, plan, threadCount, pointCloud, selection ? &*selection : nullptr)) {
                 return false;
             }
+        }
+
+        if (selection) {
+            appendSelection(*selection, pointCloud);
+        }
+        return true;
+    }
 
-            // Extract position using modern approach with span safety
-            Point3D position{0.0f, 0.0f, 0.0f};
-            size_t fieldOffset = 0;
+    // Load a mapped binary_compressed_chunked payload, decoding every block straight from the mapping
+    template <typename PointT>
+    static bool loadChunkedPayload(std::span<const uint8_t> payload, const PCDHeader& header, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter, unsigned threadCount) {
+        const DecodePlan plan = createDecodePlan(header);
+        if (!plan.isValid()) {
+            Log::error("Missing or unsupported XYZ fields");
+            return false;
+        }
+        std::span<const uint8_t> blocks;
+        const auto index = mappedBlockIndex(payload, header, blocks);
+        if (!index) {
+            return false;
+        }
 
-            for (size_t j = 0; j < header.fields.size(); ++j) {
-                if (j == *xIdx) {
-                    std::memcpy(&position.x, &data[offset + fieldOffset], sizeof(float));
-                } else if (j == *yIdx) {
-                    std::memcpy(&position.y, &data[offset + fieldOffset], sizeof(float));
-                } else if (j == *zIdx) {
-                    std::memcpy(&position.z, &data[offset + fieldOffset], sizeof(float));
-                }
-                fieldOffset += header.sizes[j] * header.counts[j];
-            }
-
-            // Extract color
-            RGB color(255, 255, 255);  // Default white
-            if (rgbIdx) {
-                fieldOffset = 0;
-                for (size_t j = 0; j <= *rgbIdx; ++j) {
-                    if (j == *rgbIdx) {
-                        uint32_t rgbPacked;
-                        std::memcpy(&rgbPacked, &data[offset + fieldOffset], sizeof(uint32_t));
-                        color = RGB(rgbPacked);
+        if (!filter.active()) {
+            return decodeBlocks(blocks, *index, 0, index->sizes.size(), header, plan, threadCount, pointCloud, static_cast<io::PointSelection<PointT>*>(nullptr));
+        }
+        io::PointSelection<PointT> selection(filter);
+        if (!decodeBlocks(blocks, *index, 0, index->sizes.size(), header, plan, threadCount, pointCloud, &selection)) {
+            return false;
+        }
+        appendSelection(selection, pointCloud);
+        return true;
+    }
+
+    /**
+     * Decode blocks [first, first + count) of a binary_compressed_chunked payload, blocks holding
+     * their compressed bytes back to back. Each worker decompresses one block at a time into a
+     * column buffer of its own and decodes the points straight from it, so beyond the points no
+     * buffer grows with the file. Without a selection the points are appended to pointCloud,
+     * with one they are offered to it.
+     */
+    template <typename PointT>
+    static bool decodeBlocks(std::span<const uint8_t> blocks, const BlockIndex& index, size_t first, size_t count, const PCDHeader& header, const DecodePlan& plan,
+                             unsigned threadCount, PointCloud<PointT>& pointCloud, io::PointSelection<PointT>* selection) {
+        std::vector<size_t> offsets(count + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            offsets[i + 1] = offsets[i] + index.sizes[first + i];
+        }
+        if (offsets.back() > blocks.size()) {
+            Log::error("Failed to read compressed data");
+            return false;
+        }
+
+        const size_t blockPoints = index.blockPoints;
+        const uint64_t firstPoint = uint64_t{first} * blockPoints;
+        const auto points = static_cast<size_t>(std::min<uint64_t>(uint64_t{count} * blockPoints, header.points - firstPoint));
+        const size_t base = pointCloud.points.size();
+        if (!selection) {
+            pointCloud.points.resize(base + points);
+        }
+        const std::span<PointT> out(pointCloud.points.data() + base, selection ? 0 : points);
+
+        // Blocks go to whichever worker is free; on a ThreadPool worker the workers are tasks of that pool
+        std::vector<size_t> kept(count, 0);
+        std::atomic<size_t> nextBlock = 0;
+        std::atomic<bool> ok = true;
+        tooling::runWorkers(static_cast<unsigned>(std::min<size_t>(tooling::availableThreads(threadCount), count)), [&] {
+            std::vector<uint8_t> columns;
+            for (size_t i = nextBlock++; i < count && ok; i = nextBlock++) {
+                const size_t blockFirst = i * blockPoints;
+                const size_t n = std::min(blockPoints, points - blockFirst);
+                columns.resize(n * plan.stride);
+                {
+                    SCANFORGE_PROFILE_SCOPE("pcd.decompress");
+                    if (codec::LZFCodec::decompress(blocks.subspan(offsets[i], offsets[i + 1] - offsets[i]), columns) != columns.size()) {
+                        ok = false;
                         break;
                     }
-                    fieldOffset += header.sizes[j] * header.counts[j];
+                }
+                if (selection) {
+                    selectColumns(columns.data(), n, header, plan, *selection, firstPoint + blockFirst);
+                } else {
+                    kept[i] = decodeColumns(columns.data(), n, header, plan, out.subspan(blockFirst, n));
                 }
             }
+        });
+        if (!ok) {
+            Log::error("Failed to decompress data");
+            pointCloud.points.resize(base);
+            return false;
+        }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, offsets.back());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, points * plan.stride);
+        if (selection) {
+            return true;
+        }
 
-            // Check for NaN/Inf values
-            bool isValid = std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z);
-            if (!isValid) {
-                pointCloud.is_dense = false;
-                continue;
+        // Close the gaps the dropped points of each block left
+        size_t written = kept[0];
+        for (size_t i = 1; i < count; ++i) {
+            const auto from = out.begin() + static_cast<std::ptrdiff_t>(i * blockPoints);
+            if (written != i * blockPoints) {
+                std::copy(from, from + static_cast<std::ptrdiff_t>(kept[i]), out.begin() + static_cast<std::ptrdiff_t>(written));
             }
-
-            pointCloud.push_back(PointXYZRGB(position, color));
+            written += kept[i];
+        }
+        pointCloud.points.resize(base + written);
+        if (written != points) {
+            pointCloud.is_dense = false;
         }
-
         return true;
     }
 
-    std::vector<uint8_t> reorderFields(const std::vector<uint8_t>& data, const PCDHeader& /* header */) {
-        // This is a simplified implementation
-        // In a real PCD loader, you would need to handle the proper field reordering
-        // based on the PCD specification for binary_compressed format
-
-        if (data.empty()) {
-            return {};
+    // Parse the text header at the start of a mapping; dataOffset receives the payload position
+    bool parseMappedHeader(std::span<const uint8_t> bytes, PCDHeader& header, size_t& dataOffset) {
+        // ispanstream only reads through the buffer, the const_cast never leads to a write
+        std::ispanstream stream(std::span<char>(const_cast<char*>(reinterpret_cast<const char*>(bytes.data())), bytes.size()));
+        if (!parseHeader(stream, header)) {
+            return false;
         }
-
-        // For now, return the data as-is
-        // TODO: Implement proper field reordering for binary_compressed format
-        return data;
+        auto pos = stream.tellg();
+        if (pos < 0) {
+            return false;
+        }
+        dataOffset = static_cast<size_t>(pos);
+        return true;
     }
 
-    bool writeHeader(std::ofstream& file, const PCDHeader& header, const std::string& dataType) {
-        file << "# .PCD v" << header.version << " - Point Cloud Data file format\n";
-        file << "VERSION " << header.version << "\n";
+    template <typename PointT>
+    std::tuple<PCDHeader, PointCloud<PointT>> loadPCDMapped(const std::string& filename, const io::LoadFilter& filter, unsigned threadCount) {
+        io::MappedFile file(filename);
+        if (!file.is_open()) {
+            return {PCDHeader{}, PointCloud<PointT>{}};
+        }
 
-        file << "FIELDS";
-        for (const auto& field : header.fields) {
-            file << " " << field;
+        PCDHeader header;
+        size_t dataOffset = 0;
+        if (!parseMappedHeader(file.data(), header, dataOffset)) {
+            Log::error("Failed to parse header from file: {}", filename);
+            return {PCDHeader{}, PointCloud<PointT>{}};
         }
-        file << "\n";
 
-        file << "SIZE";
-        for (const auto& size : header.sizes) {
-            file << " " << size;
+        if (!header.isValid() || !header.hasXYZ()) {
+            Log::error("Invalid header or missing XYZ fields in file: {}", filename);
+            return {header, PointCloud<PointT>{}};
         }
-        file << "\n";
 
-        file << "TYPE";
-        for (const auto& type : header.types) {
-            file << " " << type;
+        PointCloud<PointT> pointCloud(resource_);
+        if (!filter.active()) {
+            pointCloud.points.reserve(header.points);
         }
-        file << "\n";
+        pointCloud.width = header.width;
+        pointCloud.height = header.height;
 
-        file << "COUNT";
-        for (const auto& count : header.counts) {
-            file << " " << count;
+        auto payload = file.data().subspan(dataOffset);
+        SCANFORGE_PROFILE_COUNT(BytesRead, file.size());
+        bool loaded = false;
+        if (header.dataType == "binary_compressed") {
+            auto decoded = decodeCompressedPayload(payload, header);
+            loaded = !decoded.empty() && parseBinaryData(decoded, header, pointCloud, filter);
+        } else if (header.dataType == "binary_compressed_chunked") {
+            loaded = loadChunkedPayload(payload, header, pointCloud, filter, threadCount);
+        } else if (header.dataType == "binary") {
+            const size_t totalSize = header.getPointSize() * header.points;
+            if (payload.size() < totalSize) {
+                Log::error("Failed to read expected amount of binary data");
+            } else {
+                loaded = parseBinaryData(payload.first(totalSize), header, pointCloud, filter);
+            }
+        } else if (header.dataType == "ascii") {
+            const std::string_view text(reinterpret_cast<const char*>(payload.data()), payload.size());
+            parseASCIIPayload(text, header, parserThreads(text.size(), threadCount), pointCloud, filter);
+            loaded = true;
+        } else {
+            Log::error("Unsupported data type '{}' in file: {}", header.dataType, filename);
+            return {header, PointCloud<PointT>{}};
         }
-        file << "\n";
 
-        file << "WIDTH " << header.width << "\n";
-        file << "HEIGHT " << header.height << "\n";
-        file << "VIEWPOINT " << header.viewpoint << "\n";
-        file << "POINTS " << header.points << "\n";
-        file << "DATA " << dataType << "\n";
+        if (!loaded) {
+            Log::error("Failed to load {} data from file: {}", header.dataType, filename);
+            return {header, PointCloud<PointT>{}};
+        }
 
-        return file.good();
+        finishSelection(filter, pointCloud);
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, pointCloud.size());
+        Log::debug("Successfully loaded {} points from mapped file: {}", pointCloud.size(), filename);
+        return {header, std::move(pointCloud)};
     }
 
-    bool writeASCII(std::ofstream& file, const PCDHeader& header, const PointCloudXYZRGB& pointCloud) {
-        size_t xIdx = header.getFieldIndex("x");
-        size_t yIdx = header.getFieldIndex("y");
-        size_t zIdx = header.getFieldIndex("z");
-        size_t rgbIdx = header.getFieldIndex("rgb");
+    // Move the points a selection kept to the end of pointCloud, into its memory resource
+    template <typename PointT>
+    static void appendSelection(io::PointSelection<PointT>& selection, PointCloud<PointT>& pointCloud) {
+        if (pointCloud.points.empty()) {
+            pointCloud.points = selection.finish(pointCloud.memoryResource());
+            return;
+        }
+        auto kept = selection.finish();
+        pointCloud.points.insert(pointCloud.points.end(), kept.begin(), kept.end());
+    }
 
-        if (xIdx == SIZE_MAX || yIdx == SIZE_MAX || zIdx == SIZE_MAX) {
-            Log::error("Missing required XYZ fields in header");
+    // A filtered cloud holds finite points only and no longer has the grid of the file
+    template <typename PointT>
+    static void finishSelection(const io::LoadFilter& filter, PointCloud<PointT>& pointCloud) {
+        if (filter.active()) {
+            pointCloud.width = static_cast<uint32_t>(pointCloud.size());
+            pointCloud.height = 1;
+            pointCloud.is_dense = true;
+        }
+    }
+
+    // Read and decode the records READ_BLOCK_SIZE bytes at a time, so the payload is never held whole
+    template <typename PointT>
+    bool loadBinary(std::ifstream& file, const PCDHeader& header, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter) {
+        const DecodePlan plan = createDecodePlan(header);
+        if (!plan.isValid()) {
+            Log::error("Missing or unsupported XYZ fields");
             return false;
         }
 
-        for (const auto& point : pointCloud.points) {
-            // Write all fields in the order specified by the header
-            for (size_t i = 0; i < header.fields.size(); ++i) {
-                if (i > 0)
-                    file << " ";
+        std::optional<io::PointSelection<PointT>> selection;
+        if (filter.active()) {
+            selection.emplace(filter);
+        }
+        const size_t base = pointCloud.points.size();
+        if (!selection) {
+            pointCloud.points.resize(base + header.points);
+        }
+        const size_t blockPoints = std::max<size_t>(1, READ_BLOCK_SIZE / plan.stride);
+        ByteBuffer block(std::min<size_t>(blockPoints, header.points) * plan.stride, resource_);
+        size_t written = base;
+        for (size_t first = 0; first < header.points; first += blockPoints) {
+            const size_t count = std::min<size_t>(blockPoints, header.points - first);
+            const size_t bytes = count * plan.stride;
+            {
+                SCANFORGE_PROFILE_SCOPE("pcd.read");
+                file.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(bytes));
+            }
+            if (file.gcount() != static_cast<std::streamsize>(bytes)) {
+                Log::error("Failed to read expected amount of binary data");
+                pointCloud.points.resize(base);
+                return false;
+            }
+            SCANFORGE_PROFILE_COUNT(BytesRead, bytes);
 
-                if (i == xIdx) {
-                    file << point.position.x;
-                } else if (i == yIdx) {
-                    file << point.position.y;
-                } else if (i == zIdx) {
-                    file << point.position.z;
-                } else if (i == rgbIdx && rgbIdx != SIZE_MAX) {
-                    file << point.color.toPacked();
+            if (selection) {
+                auto part = selection->part(first, count);
+                selectRecords(block.data(), count, plan, *selection, part, first);
+                selection->commit(std::move(part));
+            } else {
+                written += decodeRecords(block.data(), count, plan, std::span(pointCloud.points).subspan(written, count));
+            }
+        }
+
+        if (selection) {
+            appendSelection(*selection, pointCloud);
+            return true;
+        }
+        if (written != base + header.points) {
+            pointCloud.is_dense = false;
+        }
+        pointCloud.points.resize(written);
+        return true;
+    }
+
+    template <typename PointT>
+    bool loadASCII(std::ifstream& file, const PCDHeader& header, PointCloud<PointT>& pointCloud, unsigned threadCount, const io::LoadFilter& filter) {
+        // Several threads need the whole payload in memory; a single one streams it line by line
+        const auto here = file.tellg();
+        file.seekg(0, std::ios::end);
+        const auto end = file.tellg();
+        file.seekg(here);
+        const unsigned threads = here >= 0 && end >= here ? parserThreads(static_cast<size_t>(end - here), threadCount) : 1;
+        if (threads > 1) {
+            std::pmr::string text(static_cast<size_t>(end - here), '\0', resource_);
+            {
+                SCANFORGE_PROFILE_SCOPE("pcd.read");
+                file.read(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            text.resize(static_cast<size_t>(file.gcount()));
+            SCANFORGE_PROFILE_COUNT(BytesRead, text.size());
+            parseASCIIPayload(text, header, threads, pointCloud, filter);
+            return true;
+        }
+
+        io::LineReader lines;
+        if (filter.active()) {
+            io::PointSelection<PointT> selection(filter);
+            auto part = selection.part(0, header.points);
+            selectASCIILines(file, lines, createASCIIColumns(header), header.points, selection, part);
+            selection.commit(std::move(part));
+            appendSelection(selection, pointCloud);
+            return true;
+        }
+
+        const size_t base = pointCloud.points.size();
+        pointCloud.points.resize(base + header.points);
+        bool dense = true;
+        const size_t written = readASCIIPoints(file, lines, createASCIIColumns(header), header.points, std::span(pointCloud.points).subspan(base), dense);
+        pointCloud.points.resize(base + written);
+        if (!dense) {
+            pointCloud.is_dense = false;
+        }
+        return true;
+    }
+
+    // Token positions of the fields an ascii record is decoded from
+    struct ASCIIColumns {
+        size_t x = SIZE_MAX;
+        size_t y = SIZE_MAX;
+        size_t z = SIZE_MAX;
+        size_t rgb = SIZE_MAX;
+        size_t fields = 0;  // Tokens a line needs to be accepted
+        size_t intensity = SIZE_MAX;
+        size_t classification = SIZE_MAX;
+        size_t gpsTime = SIZE_MAX;
+    };
+
+    enum class ASCIIRecord : uint8_t {
+        Point,      // Decoded into the output
+        NonFinite,  // Parsed, but dropped for a NaN/Inf coordinate
+        Malformed   // Too few tokens or an unparsable value, skipped
+    };
+
+    static ASCIIColumns createASCIIColumns(const PCDHeader& header) {
+        return {header.getFieldIndex("x"),        header.getFieldIndex("y"),           header.getFieldIndex("z"),
+                header.getFieldIndex("rgb"),      header.fields.size(),                header.getFieldIndex("intensity"),
+                classificationField(header),      header.getFieldIndex("gps_time")};
+    }
+
+    // PCL names the class of a point "label"; files converted from LAS may say "classification"
+    static size_t classificationField(const PCDHeader& header) {
+        const size_t classification = header.getFieldIndex("classification");
+        return classification != SIZE_MAX ? classification : header.getFieldIndex("label");
+    }
+
+    static uint8_t toClassification(double value) { return static_cast<uint8_t>(std::clamp(value, 0.0, 255.0)); }
+
+    static bool isASCIISpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+    // Parse the leading number of a token with from_chars: no allocation, no locale, optional '+'
+    template <typename T>
+    static bool parseASCIIValue(const char* first, const char* last, T& value) {
+        if (first != last && *first == '+') {
+            ++first;
+        }
+        return std::from_chars(first, last, value).ec == std::errc{};
+    }
+
+    // Split one line into whitespace separated tokens, decoding only the columns PointT has
+    template <typename PointT>
+    static ASCIIRecord parseASCIIRecord(std::string_view line, const ASCIIColumns& columns, PointT& point) {
+        const char* cursor = line.data();
+        const char* const end = cursor + line.size();
+        Point3D& position = getPosition(point);
+        uint32_t rgbPacked = 0xFFFFFF;  // Default white
+        double classification = 0;
+        bool ok = true;
+        if constexpr (HasIntensity<PointT>) {
+            point.intensity = 0;
+        }
+        if constexpr (HasGpsTime<PointT>) {
+            point.gpsTime = 0;
+        }
+
+        for (size_t token = 0; token < columns.fields; ++token) {
+            while (cursor != end && isASCIISpace(*cursor)) {
+                ++cursor;
+            }
+            if (cursor == end) {
+                return ASCIIRecord::Malformed;
+            }
+            const char* tokenEnd = cursor;
+            while (tokenEnd != end && !isASCIISpace(*tokenEnd)) {
+                ++tokenEnd;
+            }
+
+            if (token == columns.x) {
+                ok &= parseASCIIValue(cursor, tokenEnd, position.x);
+            } else if (token == columns.y) {
+                ok &= parseASCIIValue(cursor, tokenEnd, position.y);
+            } else if (token == columns.z) {
+                ok &= parseASCIIValue(cursor, tokenEnd, position.z);
+            } else if (HasColor<PointT> && token == columns.rgb) {
+                ok &= parseASCIIValue(cursor, tokenEnd, rgbPacked);
+            } else if (HasClassification<PointT> && token == columns.classification) {
+                ok &= parseASCIIValue(cursor, tokenEnd, classification);
+            } else if constexpr (HasIntensity<PointT> || HasGpsTime<PointT>) {
+                if constexpr (HasIntensity<PointT>) {
+                    if (token == columns.intensity) {
+                        ok &= parseASCIIValue(cursor, tokenEnd, point.intensity);
+                    }
+                }
+                if constexpr (HasGpsTime<PointT>) {
+                    if (token == columns.gpsTime) {
+                        ok &= parseASCIIValue(cursor, tokenEnd, point.gpsTime);
+                    }
+                }
+            }
+            cursor = tokenEnd;
+        }
+
+        if (!ok) {
+            return ASCIIRecord::Malformed;
+        }
+        if constexpr (HasColor<PointT>) {
+            point.color = RGB(rgbPacked);
+        }
+        if constexpr (HasClassification<PointT>) {
+            point.classification = toClassification(classification);
+        }
+        return std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z) ? ASCIIRecord::Point : ASCIIRecord::NonFinite;
+    }
+
+    // Parse up to `count` ascii lines from a stream into out; dense is cleared when non-finite points are dropped
+    template <typename PointT>
+    static size_t readASCIIPoints(std::istream& file, io::LineReader& lines, const ASCIIColumns& columns, size_t count, std::span<PointT> out, bool& dense) {
+        SCANFORGE_PROFILE_SCOPE("pcd.parse");
+        std::string_view line;
+        size_t written = 0;
+        size_t bytes = 0;
+        size_t dropped = 0;
+
+        for (size_t i = 0; i < count && written < out.size() && lines.next(file, line); ++i) {
+            bytes += line.size() + 1;
+            const auto record = parseASCIIRecord(line, columns, out[written]);
+            if (record == ASCIIRecord::Point) {
+                ++written;
+            } else if (record == ASCIIRecord::NonFinite) {
+                dense = false;
+                ++dropped;
+            }
+        }
+
+        SCANFORGE_PROFILE_COUNT(BytesRead, bytes);
+        SCANFORGE_PROFILE_COUNT(PointsDropped, dropped);
+        return written;
+    }
+
+    // Parse up to maxLines lines of in-memory text, appending points to out; returns the number of lines consumed
+    template <typename PointT>
+    static size_t parseASCIIText(std::string_view text, const ASCIIColumns& columns, size_t maxLines, std::vector<PointT>& out, bool& dense) {
+        SCANFORGE_PROFILE_SCOPE("pcd.parse");
+        size_t consumed = 0;
+        size_t dropped = 0;
+        PointT point{};
+        while (!text.empty() && consumed < maxLines) {
+            const size_t newline = text.find('\n');
+            const auto line = text.substr(0, newline);
+            text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+            ++consumed;
+
+            const auto record = parseASCIIRecord(line, columns, point);
+            if (record == ASCIIRecord::Point) {
+                out.push_back(point);
+            } else if (record == ASCIIRecord::NonFinite) {
+                dense = false;
+                ++dropped;
+            }
+        }
+        SCANFORGE_PROFILE_COUNT(PointsDropped, dropped);
+        return consumed;
+    }
+
+    // Offer up to `count` ascii lines from a stream to a selection; lines the stride skips are not parsed
+    template <typename PointT>
+    static void selectASCIILines(std::istream& file, io::LineReader& lines, const ASCIIColumns& columns, size_t count, io::PointSelection<PointT>& selection,
+                                 typename io::PointSelection<PointT>::Part& part) {
+        SCANFORGE_PROFILE_SCOPE("pcd.parse");
+        std::string_view line;
+        size_t bytes = 0;
+        for (uint64_t i = 0; i < count && lines.next(file, line); ++i) {
+            bytes += line.size() + 1;
+            selection.offer(part, i, [&](auto& point) { return parseASCIIRecord(line, columns, point) == ASCIIRecord::Point; });
+        }
+        SCANFORGE_PROFILE_COUNT(BytesRead, bytes);
+    }
+
+    // Offer up to maxLines lines of in-memory text, the first of them line firstLine of the payload
+    template <typename PointT>
+    static void selectASCIIText(std::string_view text, const ASCIIColumns& columns, uint64_t firstLine, size_t maxLines, io::PointSelection<PointT>& selection,
+                                typename io::PointSelection<PointT>::Part& part) {
+        SCANFORGE_PROFILE_SCOPE("pcd.parse");
+        for (size_t i = 0; !text.empty() && i < maxLines; ++i) {
+            const size_t newline = text.find('\n');
+            const auto line = text.substr(0, newline);
+            text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+            selection.offer(part, firstLine + i, [&](auto& point) { return parseASCIIRecord(line, columns, point) == ASCIIRecord::Point; });
+        }
+    }
+
+    // Threads worth starting for an ascii payload: small payloads are not split below MIN_ASCII_BYTES_PER_THREAD
+    static unsigned parserThreads(size_t bytes, unsigned requested) {
+        const unsigned available = tooling::availableThreads(requested);
+        const size_t useful = std::max<size_t>(1, bytes / MIN_ASCII_BYTES_PER_THREAD);
+        return static_cast<unsigned>(std::min<size_t>(available, useful));
+    }
+
+    // Cut text into about `threads` ranges of whole lines
+    static std::vector<std::string_view> splitASCIIText(std::string_view text, unsigned threads) {
+        threads = std::max(1u, threads);
+        std::vector<std::string_view> slices;
+        for (size_t begin = 0, t = 1; begin < text.size(); ++t) {
+            size_t end = t >= threads ? text.size() : std::max(begin, text.size() / threads * t);
+            if (end < text.size()) {
+                const size_t newline = text.find('\n', end);
+                end = newline == std::string_view::npos ? text.size() : newline + 1;
+            }
+            slices.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return slices;
+    }
+
+    /**
+     * Parse the first header.points lines of an ascii payload, appending to pointCloud.
+     * The text is cut into one range per thread at newline boundaries, the ranges are parsed
+     * concurrently into private buffers and concatenated in file order.
+     */
+    template <typename PointT>
+    static void parseASCIIPayload(std::string_view text, const PCDHeader& header, unsigned threads, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter) {
+        if (filter.active()) {
+            selectASCIIPayload(text, header, threads, pointCloud, filter);
+            return;
+        }
+        const auto columns = createASCIIColumns(header);
+        const auto slices = splitASCIIText(text, threads);
+
+        struct Part {
+            std::vector<PointT> points;
+            size_t lines = 0;
+            bool dense = true;
+        };
+        std::vector<Part> parts(slices.size());
+        auto parse = [&](size_t i, size_t maxLines) {
+            parts[i] = Part{};
+            parts[i].lines = parseASCIIText(slices[i], columns, maxLines, parts[i].points, parts[i].dense);
+        };
+        if (slices.size() > 1) {
+            tooling::parallelFor(slices.size(), [&parse](size_t i) { parse(i, SIZE_MAX); });
+        } else if (!slices.empty()) {
+            parse(0, header.points);
+        }
+
+        // Lines past POINTS are ignored: the range holding the last one is parsed again up to it
+        size_t remaining = header.points;
+        for (size_t i = 0; i < parts.size() && remaining > 0; ++i) {
+            if (parts[i].lines > remaining) {
+                parse(i, remaining);
+            }
+            pointCloud.points.insert(pointCloud.points.end(), parts[i].points.begin(), parts[i].points.end());
+            pointCloud.is_dense = pointCloud.is_dense && parts[i].dense;
+            remaining -= parts[i].lines;
+        }
+    }
+
+    // parseASCIIPayload() through a filter: ranges learn the number of their first line up front, so the stride and the sample see payload line numbers
+    template <typename PointT>
+    static void selectASCIIPayload(std::string_view text, const PCDHeader& header, unsigned threads, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter) {
+        const auto columns = createASCIIColumns(header);
+        const auto slices = splitASCIIText(text, threads);
+        std::vector<uint64_t> firstLines(slices.size() + 1, 0);
+        for (size_t i = 0; i < slices.size(); ++i) {
+            firstLines[i + 1] = firstLines[i] + static_cast<uint64_t>(std::count(slices[i].begin(), slices[i].end(), '\n'));
+        }
+
+        io::PointSelection<PointT> selection(filter);
+        auto select = [&](size_t i) {
+            if (firstLines[i] >= header.points) {
+                return;
+            }
+            const auto lines = static_cast<size_t>(std::min<uint64_t>(header.points - firstLines[i], firstLines[i + 1] - firstLines[i] + 1));
+            auto part = selection.part(firstLines[i], lines);
+            selectASCIIText(slices[i], columns, firstLines[i], lines, selection, part);
+            selection.commit(std::move(part));
+        };
+        tooling::parallelFor(slices.size(), select);
+
+        appendSelection(selection, pointCloud);
+    }
+
+    template <typename PointT>
+    bool parseBinaryData(std::span<const uint8_t> data, const PCDHeader& header, PointCloud<PointT>& pointCloud, const io::LoadFilter& filter) {
+        const DecodePlan plan = createDecodePlan(header);
+        if (!plan.isValid()) {
+            Log::error("Missing or unsupported XYZ fields");
+            return false;
+        }
+
+        const size_t count = header.points;
+        if (data.size() < plan.stride * count) {
+            Log::error("Data size mismatch");
+            return false;
+        }
+
+        if (filter.active()) {
+            io::PointSelection<PointT> selection(filter);
+            auto part = selection.part(0, count);
+            selectRecords(data.data(), count, plan, selection, part);
+            selection.commit(std::move(part));
+            appendSelection(selection, pointCloud);
+            return true;
+        }
+
+        const size_t base = pointCloud.points.size();
+        pointCloud.points.resize(base + count);
+        std::span<PointT> out(pointCloud.points.data() + base, count);
+
+        const size_t written = decodeRecords(data.data(), count, plan, out);
+        pointCloud.points.resize(base + written);
+        if (written != count) {
+            pointCloud.is_dense = false;
+        }
+        return true;
+    }
+
+    // Dispatch to the decoder specialised for the plan layout
+    template <typename PointT>
+    static size_t decodeRecords(const uint8_t* data, size_t count, const DecodePlan& plan, std::span<PointT> out) {
+        SCANFORGE_PROFILE_SCOPE("pcd.decode");
+        size_t written = 0;
+        switch (plan.layout) {
+            case DecodePlan::Layout::XYZRGB:
+                written = decodeRecords<DecodePlan::Layout::XYZRGB>(data, count, plan, out);
+                break;
+            case DecodePlan::Layout::XYZ:
+                written = decodeRecords<DecodePlan::Layout::XYZ>(data, count, plan, out);
+                break;
+            case DecodePlan::Layout::Generic:
+                written = decodeRecords<DecodePlan::Layout::Generic>(data, count, plan, out);
+                break;
+        }
+        SCANFORGE_PROFILE_COUNT(PointsDropped, count - written);
+        return written;
+    }
+
+    // Decode `count` records into `out`, dropping non-finite points; returns the number kept
+    template <DecodePlan::Layout L, typename PointT>
+    static size_t decodeRecords(const uint8_t* data, size_t count, const DecodePlan& plan, std::span<PointT> out) {
+        constexpr bool packed = L != DecodePlan::Layout::Generic;
+        const size_t stride = L == DecodePlan::Layout::XYZRGB ? 16 : L == DecodePlan::Layout::XYZ ? 12 : plan.stride;
+        const size_t xOffset = packed ? 0 : plan.xOffset;
+        const size_t yOffset = packed ? 4 : plan.yOffset;
+        const size_t zOffset = packed ? 8 : plan.zOffset;
+
+        auto decodeOne = [&](const uint8_t* rec, PointT& point) {
+            Point3D& position = getPosition(point);
+            std::memcpy(&position.x, rec + xOffset, sizeof(float));
+            std::memcpy(&position.y, rec + yOffset, sizeof(float));
+            std::memcpy(&position.z, rec + zOffset, sizeof(float));
+            // The packed layouts hold nothing but x, y, z and rgb, so other attributes keep their defaults there
+            if constexpr (L == DecodePlan::Layout::Generic) {
+                if constexpr (HasIntensity<PointT>) {
+                    point.intensity = plan.intensity ? static_cast<float>(readNumber(rec, *plan.intensity)) : 0.0f;
+                }
+                if constexpr (HasClassification<PointT>) {
+                    point.classification = plan.classification ? toClassification(readNumber(rec, *plan.classification)) : uint8_t{0};
+                }
+                if constexpr (HasGpsTime<PointT>) {
+                    point.gpsTime = plan.gpsTime ? readNumber(rec, *plan.gpsTime) : 0.0;
+                }
+            }
+            if constexpr (!HasColor<PointT>) {
+                return;
+            } else if constexpr (L == DecodePlan::Layout::XYZRGB) {
+                uint32_t rgbPacked;
+                std::memcpy(&rgbPacked, rec + 12, sizeof(uint32_t));
+                point.color = RGB(rgbPacked);
+            } else if constexpr (L == DecodePlan::Layout::XYZ) {
+                point.color = RGB(255, 255, 255);  // Default white
+            } else {
+                if (plan.rgbOffset) {
+                    uint32_t rgbPacked;
+                    std::memcpy(&rgbPacked, rec + *plan.rgbOffset, sizeof(uint32_t));
+                    point.color = RGB(rgbPacked);
                 } else {
-                    file << "0";  // Default value for unknown fields
+                    point.color = RGB(255, 255, 255);  // Default white
+                }
+            }
+        };
+
+        size_t written = 0;
+        size_t i = 0;
+
+        if constexpr (L == DecodePlan::Layout::XYZRGB) {
+            // Four records per step with one SIMD NaN/Inf test; the common all-finite case writes straight through
+            for (; i + 4 <= count; i += 4) {
+                const uint8_t* rec = data + i * 16;
+                const uint32_t mask = simd::finiteXYZMask4(rec);
+                for (size_t k = 0; k < 4; ++k) {
+                    if (mask & (1u << k)) {
+                        decodeOne(rec + k * 16, out[written++]);
+                    }
                 }
             }
-            file << "\n";
         }
 
+        for (; i < count; ++i) {
+            PointT& point = out[written];
+            decodeOne(data + i * stride, point);
+            const Point3D& position = getPosition(point);
+            if (std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)) {
+                ++written;
+            }
+        }
+        return written;
+    }
+
+    /**
+     * Offer the records the stride keeps to a selection, each decoded on its own with the generic plan
+     * @param firstIndex File index of the first record of data
+     *
+     * The position is read first: a record that is not finite or lies outside the box is
+     * rejected before its other fields are decoded.
+     */
+    template <typename PointT>
+    static void selectRecords(const uint8_t* data, size_t count, const DecodePlan& plan, io::PointSelection<PointT>& selection, typename io::PointSelection<PointT>::Part& part,
+                              uint64_t firstIndex = 0) {
+        SCANFORGE_PROFILE_SCOPE("pcd.decode");
+        const io::LoadFilter& filter = selection.filter();
+        for (uint64_t i = (filter.stride - firstIndex % filter.stride) % filter.stride; i < count; i += std::min<uint64_t>(filter.stride, count - i)) {
+            const uint8_t* record = data + static_cast<size_t>(i) * plan.stride;
+            selection.offer(part, firstIndex + i, [&](auto& point) {
+                Point3D position;
+                std::memcpy(&position.x, record + plan.xOffset, sizeof(float));
+                std::memcpy(&position.y, record + plan.yOffset, sizeof(float));
+                std::memcpy(&position.z, record + plan.zOffset, sizeof(float));
+                if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z) || !filter.contains(position)) {
+                    return false;
+                }
+                return decodeRecords<DecodePlan::Layout::Generic>(record, 1, plan, std::span(&point, 1)) == 1;
+            });
+        }
+    }
+
+    // Interleave the records [first, first + count) of a column-major block of `points` points
+    static void gatherRecords(const uint8_t* columns, size_t points, const PCDHeader& header, size_t first, size_t count, uint8_t* records) {
+        const size_t stride = header.getPointSize();
+        for (size_t f = 0, offset = 0; f < header.fields.size(); ++f) {
+            const size_t width = size_t{header.sizes[f]} * header.counts[f];
+            const uint8_t* column = columns + points * offset + first * width;
+            for (size_t i = 0; i < count; ++i) {
+                std::memcpy(records + i * stride + offset, column + i * width, width);
+            }
+            offset += width;
+        }
+    }
+
+    /**
+     * Decode the `count` points of a column-major block into `out`, dropping non-finite points
+     * @return Points kept
+     *
+     * The packed layouts read x, y, z and rgb straight from their columns. Any other layout goes
+     * through the record decoder, GATHER_POINTS records interleaved at a time.
+     */
+    template <typename PointT>
+    static size_t decodeColumns(const uint8_t* columns, size_t count, const PCDHeader& header, const DecodePlan& plan, std::span<PointT> out) {
+        size_t written = 0;
+        if (plan.layout == DecodePlan::Layout::Generic) {
+            std::vector<uint8_t> records(std::min(count, GATHER_POINTS) * plan.stride);
+            for (size_t first = 0; first < count; first += GATHER_POINTS) {
+                const size_t n = std::min(GATHER_POINTS, count - first);
+                gatherRecords(columns, count, header, first, n, records.data());
+                written += decodeRecords(records.data(), n, plan, out.subspan(written));
+            }
+            return written;
+        }
+
+        SCANFORGE_PROFILE_SCOPE("pcd.decode");
+        const uint8_t* xs = columns;
+        const uint8_t* ys = columns + count * sizeof(float);
+        const uint8_t* zs = columns + 2 * count * sizeof(float);
+        [[maybe_unused]] const uint8_t* rgbs = columns + 3 * count * sizeof(float);
+        for (size_t i = 0; i < count; ++i) {
+            PointT& point = out[written];
+            Point3D& position = getPosition(point);
+            std::memcpy(&position.x, xs + i * sizeof(float), sizeof(float));
+            std::memcpy(&position.y, ys + i * sizeof(float), sizeof(float));
+            std::memcpy(&position.z, zs + i * sizeof(float), sizeof(float));
+            if constexpr (HasColor<PointT>) {
+                if (plan.layout == DecodePlan::Layout::XYZRGB) {
+                    uint32_t rgbPacked;
+                    std::memcpy(&rgbPacked, rgbs + i * sizeof(uint32_t), sizeof(uint32_t));
+                    point.color = RGB(rgbPacked);
+                } else {
+                    point.color = RGB(255, 255, 255);  // Default white
+                }
+            }
+            if (std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)) {
+                ++written;
+            }
+        }
+        SCANFORGE_PROFILE_COUNT(PointsDropped, count - written);
+        return written;
+    }
+
+    // Offer the points of a column-major block to a selection, GATHER_POINTS records interleaved at a time
+    template <typename PointT>
+    static void selectColumns(const uint8_t* columns, size_t count, const PCDHeader& header, const DecodePlan& plan, io::PointSelection<PointT>& selection, uint64_t firstIndex) {
+        std::vector<uint8_t> records(std::min(count, GATHER_POINTS) * plan.stride);
+        auto part = selection.part(firstIndex, count);
+        for (size_t first = 0; first < count; first += GATHER_POINTS) {
+            const size_t n = std::min(GATHER_POINTS, count - first);
+            gatherRecords(columns, count, header, first, n, records.data());
+            selectRecords(records.data(), n, plan, selection, part, firstIndex + first);
+        }
+        selection.commit(std::move(part));
+    }
+
+    // Copy one field between its column and the interleaved records; Width is fixed for the common sizes
+    template <size_t Width, bool ToColumns>
+    static void transposeField(const uint8_t* src, uint8_t* dst, size_t points, size_t stride, size_t fieldOffset, size_t width) {
+        const size_t w = Width != 0 ? Width : width;
+        const size_t columnOffset = points * fieldOffset;
+        for (size_t i = 0; i < points; ++i) {
+            if constexpr (ToColumns) {
+                std::memcpy(dst + columnOffset + i * w, src + i * stride + fieldOffset, w);
+            } else {
+                std::memcpy(dst + i * stride + fieldOffset, src + columnOffset + i * w, w);
+            }
+        }
+    }
+
+    /**
+     * @brief Convert between interleaved records and the column-major layout of binary_compressed
+     *
+     * PCL stores every field contiguously for all points before the next field (x x x ... y y y ...),
+     * which is what makes the payload compress well. Records of four 4-byte fields use the SIMD
+     * 4x4 transpose, any other layout goes field by field.
+     */
+    template <bool ToColumns>
+    static ByteBuffer transposeFields(std::span<const uint8_t> data, const PCDHeader& header, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        ByteBuffer result(data.size(), resource);
+        if (!transposeFields<ToColumns>(data, header, std::span(result))) {
+            return ByteBuffer(resource);
+        }
+        return result;
+    }
+
+    // transposeFields() into a buffer of data.size() bytes
+    template <bool ToColumns>
+    static bool transposeFields(std::span<const uint8_t> data, const PCDHeader& header, std::span<uint8_t> result) {
+        SCANFORGE_PROFILE_SCOPE("pcd.transpose");
+        const size_t stride = header.getPointSize();
+        if (data.empty() || stride == 0 || data.size() % stride != 0 || result.size() != data.size()) {
+            return false;
+        }
+        const size_t points = data.size() / stride;
+
+        const bool fourWords = stride == 16 && std::ranges::all_of(std::views::zip(header.sizes, header.counts), [](const auto& size_count) {
+            const auto& [size, count] = size_count;
+            return size * count == 4;
+        });
+        if (fourWords) {
+            if constexpr (ToColumns) {
+                simd::deinterleave4x32(data.data(), points, result.data());
+            } else {
+                simd::interleave4x32(data.data(), points, result.data());
+            }
+            return true;
+        }
+
+        for (size_t f = 0, offset = 0; f < header.fields.size(); ++f) {
+            const size_t width = header.sizes[f] * header.counts[f];
+            switch (width) {
+                case 1: transposeField<1, ToColumns>(data.data(), result.data(), points, stride, offset, width); break;
+                case 2: transposeField<2, ToColumns>(data.data(), result.data(), points, stride, offset, width); break;
+                case 4: transposeField<4, ToColumns>(data.data(), result.data(), points, stride, offset, width); break;
+                case 8: transposeField<8, ToColumns>(data.data(), result.data(), points, stride, offset, width); break;
+                default: transposeField<0, ToColumns>(data.data(), result.data(), points, stride, offset, width); break;
+            }
+            offset += width;
+        }
+        return true;
+    }
+
+    // transposeFields() applied to each block of blockPoints points, as binary_compressed_chunked stores them
+    template <bool ToColumns>
+    static ByteBuffer transposeBlocks(std::span<const uint8_t> data, const PCDHeader& header, uint32_t blockPoints,
+                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        const size_t blockBytes = header.getPointSize() * blockPoints;
+        if (blockBytes == 0) {
+            return ByteBuffer(resource);
+        }
+        ByteBuffer result(data.size(), resource);
+        for (size_t first = 0; first < data.size(); first += blockBytes) {
+            const size_t bytes = std::min(blockBytes, data.size() - first);
+            if (!transposeFields<ToColumns>(data.subspan(first, bytes), header, std::span(result).subspan(first, bytes))) {
+                return ByteBuffer(resource);
+            }
+        }
+        return result;
+    }
+
+    // Column-major binary_compressed payload to interleaved records
+    static ByteBuffer reorderFields(std::span<const uint8_t> data, const PCDHeader& header, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        if (data.size() != header.getPointSize() * header.points) {
+            Log::error("Decompressed size {} does not match {} points of {} bytes", data.size(), header.points, header.getPointSize());
+            return ByteBuffer(resource);
+        }
+        return transposeFields<false>(data, header, resource);
+    }
+
+    // Interleaved records to the column-major binary_compressed payload
+    static ByteBuffer splitFields(std::span<const uint8_t> data, const PCDHeader& header) { return transposeFields<true>(data, header); }
+
+    // countWidth > 0 pads WIDTH, HEIGHT and POINTS so that a streaming writer can rewrite them in place
+    bool writeHeader(std::ostream& file, const PCDHeader& header, const std::string& dataType, int countWidth = 0) {
+        file << "# .PCD v" << header.version << " - Point Cloud Data file format\n";
+        file << "VERSION " << header.version << "\n";
+
+        file << "FIELDS";
+        for (const auto& field : header.fields) {
+            file << " " << field;
+        }
+        file << "\n";
+
+        file << "SIZE";
+        for (const auto& size : header.sizes) {
+            file << " " << size;
+        }
+        file << "\n";
+
+        file << "TYPE";
+        for (const auto& type : header.types) {
+            file << " " << type;
+        }
+        file << "\n";
+
+        file << "COUNT";
+        for (const auto& count : header.counts) {
+            file << " " << count;
+        }
+        file << "\n";
+
+        auto count = [countWidth](uint32_t value) {
+            std::string text = std::to_string(value);
+            text.resize(std::max(text.size(), static_cast<size_t>(countWidth)), ' ');
+            return text;
+        };
+        file << "WIDTH " << count(header.width) << "\n";
+        file << "HEIGHT " << count(header.height) << "\n";
+        file << "VIEWPOINT " << header.viewpoint << "\n";
+        file << "POINTS " << count(header.points) << "\n";
+        file << "DATA " << dataType << "\n";
+
         return file.good();
     }
 
-    bool writeBinary(std::ofstream& file, const PCDHeader& header, const PointCloudXYZRGB& pointCloud) {
+    // Format lines with std::to_chars into buffer and write it whenever a WRITE_BLOCK_SIZE block is full
+    bool writeASCII(std::ostream& file, const PCDHeader& header, std::span<const PointXYZRGB> points, std::vector<char>& buffer) {
+        SCANFORGE_PROFILE_SCOPE("pcd.format");
         size_t xIdx = header.getFieldIndex("x");
         size_t yIdx = header.getFieldIndex("y");
         size_t zIdx = header.getFieldIndex("z");
@@ -611,30 +1910,77 @@ class PCDProcessor {
             return false;
         }
 
-        for (const auto& point : pointCloud.points) {
+        // A token is at most a float in shortest round-trip form, like "-1.17549435e-38", plus its separator
+        constexpr size_t MAX_TOKEN = 16;
+        const size_t maxLine = header.fields.size() * MAX_TOKEN + 1;
+        buffer.resize(WRITE_BLOCK_SIZE + maxLine);
+        char* const begin = buffer.data();
+        char* const limit = begin + WRITE_BLOCK_SIZE;
+        char* const end = begin + buffer.size();
+        char* cursor = begin;
+
+        for (const auto& point : points) {
             // Write all fields in the order specified by the header
             for (size_t i = 0; i < header.fields.size(); ++i) {
+                if (i > 0)
+                    *cursor++ = ' ';
+
                 if (i == xIdx) {
-                    file.write(reinterpret_cast<const char*>(&point.position.x), sizeof(float));
+                    cursor = std::to_chars(cursor, end, point.position.x).ptr;
                 } else if (i == yIdx) {
-                    file.write(reinterpret_cast<const char*>(&point.position.y), sizeof(float));
+                    cursor = std::to_chars(cursor, end, point.position.y).ptr;
                 } else if (i == zIdx) {
-                    file.write(reinterpret_cast<const char*>(&point.position.z), sizeof(float));
+                    cursor = std::to_chars(cursor, end, point.position.z).ptr;
                 } else if (i == rgbIdx && rgbIdx != SIZE_MAX) {
-                    uint32_t rgbPacked = point.color.toPacked();
-                    file.write(reinterpret_cast<const char*>(&rgbPacked), sizeof(uint32_t));
+                    cursor = std::to_chars(cursor, end, point.color.toPacked()).ptr;
                 } else {
-                    // Write default values for unknown fields based on their size
-                    std::vector<uint8_t> defaultValue(header.sizes[i], 0);
-                    file.write(reinterpret_cast<const char*>(defaultValue.data()), header.sizes[i]);
+                    *cursor++ = '0';  // Default value for unknown fields
                 }
             }
+            *cursor++ = '\n';
+
+            if (cursor >= limit) {
+                SCANFORGE_PROFILE_SCOPE("pcd.write");
+                SCANFORGE_PROFILE_COUNT(BytesWritten, cursor - begin);
+                file.write(begin, cursor - begin);
+                cursor = begin;
+            }
         }
+        SCANFORGE_PROFILE_SCOPE("pcd.write");
+        SCANFORGE_PROFILE_COUNT(BytesWritten, cursor - begin);
+        file.write(begin, cursor - begin);
 
         return file.good();
     }
 
-    bool writeBinaryCompressed(std::ofstream& file, const PCDHeader& header, const PointCloudXYZRGB& pointCloud) {
+    // Serialize records into buffer one WRITE_BLOCK_SIZE block at a time and write each block in one call
+    bool writeBinary(std::ostream& file, const PCDHeader& header, std::span<const PointXYZRGB> points, std::vector<uint8_t>& buffer) {
+        const size_t pointsPerBlock = std::max<size_t>(1, WRITE_BLOCK_SIZE / std::max<size_t>(1, header.getPointSize()));
+        for (size_t first = 0; first < points.size(); first += pointsPerBlock) {
+            buffer.clear();
+            if (!serializeRecords(header, points.subspan(first, std::min(pointsPerBlock, points.size() - first)), buffer)) {
+                return false;
+            }
+            SCANFORGE_PROFILE_SCOPE("pcd.write");
+            SCANFORGE_PROFILE_COUNT(BytesWritten, buffer.size());
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+        return file.good();
+    }
+
+    bool writeBinaryCompressed(std::ostream& file, const PCDHeader& header, const PointCloudXYZRGB& pointCloud, codec::LZFCodec::Level level) {
+        if (pointCloud.empty()) {
+            Log::error("Cannot compress an empty point cloud");
+            return false;
+        }
+
+        std::vector<uint8_t> records;
+        return serializeRecords(header, pointCloud.points, records) && writeCompressedRecords(file, header, records, level);
+    }
+
+    // Append interleaved binary records for points to records; unknown fields stay zeroed
+    static bool serializeRecords(const PCDHeader& header, std::span<const PointXYZRGB> points, std::vector<uint8_t>& records) {
+        SCANFORGE_PROFILE_SCOPE("pcd.encode");
         size_t xIdx = header.getFieldIndex("x");
         size_t yIdx = header.getFieldIndex("y");
         size_t zIdx = header.getFieldIndex("z");
@@ -645,38 +1991,42 @@ class PCDProcessor {
             return false;
         }
 
-        // Generate binary data into a vector
-        std::vector<uint8_t> uncompressedData;
-        for (const auto& point : pointCloud.points) {
-            for (size_t i = 0; i < header.fields.size(); ++i) {
-                if (i == xIdx) {
-                    const auto* ptr = reinterpret_cast<const uint8_t*>(&point.position.x);
-                    uncompressedData.insert(uncompressedData.end(), ptr, ptr + sizeof(float));
-                } else if (i == yIdx) {
-                    const auto* ptr = reinterpret_cast<const uint8_t*>(&point.position.y);
-                    uncompressedData.insert(uncompressedData.end(), ptr, ptr + sizeof(float));
-                } else if (i == zIdx) {
-                    const auto* ptr = reinterpret_cast<const uint8_t*>(&point.position.z);
-                    uncompressedData.insert(uncompressedData.end(), ptr, ptr + sizeof(float));
-                } else if (i == rgbIdx && rgbIdx != SIZE_MAX) {
-                    uint32_t rgbPacked = point.color.toPacked();
-                    const auto* ptr = reinterpret_cast<const uint8_t*>(&rgbPacked);
-                    uncompressedData.insert(uncompressedData.end(), ptr, ptr + sizeof(uint32_t));
-                } else {
-                    // Add default values for unknown fields
-                    for (uint32_t j = 0; j < header.sizes[i]; ++j) {
-                        uncompressedData.push_back(0);
-                    }
-                }
+        const size_t stride = header.getPointSize();
+        const size_t xOffset = header.getFieldOffset(xIdx);
+        const size_t yOffset = header.getFieldOffset(yIdx);
+        const size_t zOffset = header.getFieldOffset(zIdx);
+        const size_t rgbOffset = rgbIdx != SIZE_MAX ? header.getFieldOffset(rgbIdx) : 0;
+        const size_t base = records.size();
+        records.resize(base + stride * points.size(), 0);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto& point = points[i];
+            uint8_t* record = records.data() + base + i * stride;
+            std::memcpy(record + xOffset, &point.position.x, sizeof(float));
+            std::memcpy(record + yOffset, &point.position.y, sizeof(float));
+            std::memcpy(record + zOffset, &point.position.z, sizeof(float));
+            if (rgbIdx != SIZE_MAX) {
+                uint32_t rgbPacked = point.color.toPacked();
+                std::memcpy(record + rgbOffset, &rgbPacked, sizeof(uint32_t));
             }
         }
+        return true;
+    }
 
-        // Compress the data
-        auto compressedData = scanforge::codec::LZFCodec::compress(uncompressedData);
+    // Transpose interleaved records to columns, compress them and write the size prefix and payload
+    static bool writeCompressedRecords(std::ostream& file, const PCDHeader& header, std::span<const uint8_t> records, codec::LZFCodec::Level level) {
+        // PCL expects the fields column by column
+        auto uncompressedData = splitFields(records, header);
+        std::vector<uint8_t> compressedData;
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.compress");
+            compressedData = scanforge::codec::LZFCodec::compress(uncompressedData, level);
+        }
         if (compressedData.empty()) {
             Log::error("Failed to compress point cloud data");
             return false;
         }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, compressedData.size());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, uncompressedData.size());
 
         // Write compression header
         uint32_t compressedSize = static_cast<uint32_t>(compressedData.size());
@@ -686,10 +2036,394 @@ class PCDProcessor {
         file.write(reinterpret_cast<const char*>(&uncompressedSize), sizeof(uncompressedSize));
 
         // Write compressed data
+        SCANFORGE_PROFILE_SCOPE("pcd.write");
+        SCANFORGE_PROFILE_COUNT(BytesWritten, 2 * sizeof(uint32_t) + compressedData.size());
         file.write(reinterpret_cast<const char*>(compressedData.data()), static_cast<std::streamsize>(compressedData.size()));
 
         return file.good();
     }
+
+    // Reserve the index offset that opens a binary_compressed_chunked payload
+    static bool beginBlocks(std::ostream& file) {
+        const uint64_t placeholder = 0;
+        file.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+        return file.good();
+    }
+
+    // Compress interleaved records as blocks of blockPoints points and append their sizes to blockSizes
+    static bool writeCompressedBlocks(std::ostream& file, const PCDHeader& header, std::span<const uint8_t> records, uint32_t blockPoints, std::vector<uint32_t>& blockSizes,
+                                      unsigned threadCount, codec::LZFCodec::Level level) {
+        if (records.empty()) {
+            return true;
+        }
+        const auto columns = transposeBlocks<true>(records, header, blockPoints);
+        std::vector<uint32_t> sizes;
+        std::vector<uint8_t> compressed;
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.compress");
+            compressed = codec::LZFCodec::compressBlocks(columns, header.getPointSize() * blockPoints, sizes, threadCount, level);
+        }
+        if (compressed.empty()) {
+            Log::error("Failed to compress point cloud data");
+            return false;
+        }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, compressed.size());
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, columns.size());
+        blockSizes.insert(blockSizes.end(), sizes.begin(), sizes.end());
+        SCANFORGE_PROFILE_SCOPE("pcd.write");
+        SCANFORGE_PROFILE_COUNT(BytesWritten, compressed.size());
+        file.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+        return file.good();
+    }
+
+    // Append the block index and point the payload's leading offset at it
+    static bool finishBlocks(std::ostream& file, std::streampos payloadStart, uint32_t blockPoints, std::span<const uint32_t> blockSizes) {
+        const auto indexStart = file.tellp();
+        const auto count = static_cast<uint32_t>(blockSizes.size());
+        file.write(reinterpret_cast<const char*>(&blockPoints), sizeof(blockPoints));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(blockSizes.data()), static_cast<std::streamsize>(blockSizes.size_bytes()));
+        const auto end = file.tellp();
+
+        const auto indexOffset = static_cast<uint64_t>(indexStart - payloadStart);
+        file.seekp(payloadStart);
+        file.write(reinterpret_cast<const char*>(&indexOffset), sizeof(indexOffset));
+        file.seekp(end);
+        return file.good();
+    }
+
+    std::pmr::memory_resource* resource_;
+};
+
+/**
+ * @brief Chunked PCD reader decoding a window of points per call
+ *
+ * ascii, binary and binary_compressed_chunked files are streamed in constant memory, the latter
+ * one compressed block at a time. A binary_compressed payload is one LZF stream over column-major
+ * fields, so it is decompressed once on open() and then handed out chunk by chunk. Non-finite
+ * points are dropped, as loadPCD() does.
+ */
+class PCDReader final : public io::PointReader {
+   public:
+    PCDReader() = default;
+    explicit PCDReader(const std::filesystem::path& filename, const io::AsyncOptions& options = {}) { open(filename, options); }
+
+    /**
+     * @brief Open a PCD file and position the reader on its first point
+     * @param filename Path to PCD file
+     * @param options Read-ahead of the file: blocks kept in flight and the I/O backend
+     * @return True if the header is valid and the data type supported
+     */
+    bool open(const std::filesystem::path& filename, const io::AsyncOptions& options = {}) {
+        const bool opened = file_.open(filename, options);
+        good_ = false;
+        remaining_ = 0;
+        dense_ = true;
+        records_.clear();
+        lines_ = io::LineReader{};
+        cursor_ = 0;
+        index_ = PCDProcessor::BlockIndex{};
+        nextBlock_ = 0;
+        if (!opened) {
+            Log::error("Failed to open file: {}", filename.string());
+            return false;
+        }
+
+        header_ = PCDProcessor::PCDHeader{};
+        if (!processor_.parseHeader(file_, header_) || !header_.hasXYZ()) {
+            Log::error("Invalid header or missing XYZ fields in file: {}", filename.string());
+            return false;
+        }
+
+        if (header_.dataType == "ascii") {
+            columns_ = PCDProcessor::createASCIIColumns(header_);
+        } else {
+            plan_ = PCDProcessor::createDecodePlan(header_);
+            if (!plan_.isValid()) {
+                Log::error("Missing or unsupported XYZ fields");
+                return false;
+            }
+        }
+        if (header_.dataType == "binary_compressed") {
+            records_ = processor_.readCompressedRecords(file_, header_);
+            if (records_.empty()) {
+                return false;
+            }
+        } else if (header_.dataType == "binary_compressed_chunked") {
+            if (!readBlockIndex()) {
+                return false;
+            }
+        } else if (header_.dataType != "binary" && header_.dataType != "ascii") {
+            Log::error("Unsupported data type '{}' in file: {}", header_.dataType, filename.string());
+            return false;
+        }
+
+        remaining_ = header_.points;
+        good_ = true;
+        return true;
+    }
+
+    bool is_open() const { return file_.is_open() && good_; }
+    const PCDProcessor::PCDHeader& header() const { return header_; }
+
+    /** @brief False once a non-finite point has been dropped */
+    bool dense() const { return dense_; }
+
+    uint64_t size() const override { return header_.points; }
+
+    size_t next(std::span<PointXYZRGB> out) override {
+        size_t written = 0;
+        // Dropped points can leave a window short, keep decoding until it is full or the file ends
+        while (good_ && remaining_ > 0 && written < out.size()) {
+            const size_t count = std::min(out.size() - written, remaining_);
+            const size_t decoded = header_.dataType == "ascii" ? nextASCII(count, out.subspan(written)) : nextBinary(count, out.subspan(written));
+            if (!good_) {
+                return 0;
+            }
+            written += decoded;
+        }
+        SCANFORGE_PROFILE_COUNT(PointsDecoded, written);
+        return written;
+    }
+
+    bool good() const override { return good_; }
+
+   private:
+    size_t nextASCII(size_t count, std::span<PointXYZRGB> out) {
+        const size_t written = PCDProcessor::readASCIIPoints(file_, lines_, columns_, count, out, dense_);
+        remaining_ = lines_.eof() ? 0 : remaining_ - count;
+        return written;
+    }
+
+    // Read the index at the end of a binary_compressed_chunked payload, then return to the first block
+    bool readBlockIndex() {
+        auto parsed = PCDProcessor::readBlockIndex(file_, header_);
+        if (!parsed) {
+            return false;
+        }
+        index_ = std::move(*parsed);
+        return true;
+    }
+
+    // Decompress the next binary_compressed_chunked block into records_
+    bool readBlock() {
+        const uint32_t size = index_.sizes[nextBlock_];
+        const uint64_t firstPoint = uint64_t{nextBlock_} * index_.blockPoints;
+        const auto points = static_cast<uint32_t>(std::min<uint64_t>(index_.blockPoints, header_.points - firstPoint));
+        buffer_.resize(size);
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.read");
+            file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size));
+        }
+        if (static_cast<size_t>(file_.gcount()) != size) {
+            Log::error("Failed to read compressed data");
+            return false;
+        }
+        SCANFORGE_PROFILE_COUNT(BytesRead, size);
+
+        blockColumns_.resize(size_t{points} * plan_.stride);
+        {
+            SCANFORGE_PROFILE_SCOPE("pcd.decompress");
+            if (codec::LZFCodec::decompress(buffer_, blockColumns_) != blockColumns_.size()) {
+                Log::error("Failed to decompress data");
+                return false;
+            }
+        }
+        SCANFORGE_PROFILE_COUNT(CompressedBytes, size);
+        SCANFORGE_PROFILE_COUNT(UncompressedBytes, blockColumns_.size());
+        // Reuses the records of the previous block, so a steady stream of blocks allocates nothing
+        records_.resize(blockColumns_.size());
+        cursor_ = 0;
+        ++nextBlock_;
+        return PCDProcessor::transposeFields<false>(blockColumns_, header_, std::span(records_));
+    }
+
+    size_t nextBinary(size_t count, std::span<PointXYZRGB> out) {
+        const uint8_t* records = nullptr;
+        if (header_.dataType == "binary_compressed") {
+            records = records_.data() + cursor_;
+        } else if (header_.dataType == "binary_compressed_chunked") {
+            if (cursor_ == records_.size() && !readBlock()) {
+                good_ = false;
+                return 0;
+            }
+            count = std::min(count, (records_.size() - cursor_) / plan_.stride);
+            records = records_.data() + cursor_;
+        } else {
+            buffer_.resize(count * plan_.stride);
+            {
+                SCANFORGE_PROFILE_SCOPE("pcd.read");
+                file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+            }
+            if (static_cast<size_t>(file_.gcount()) != buffer_.size()) {
+                Log::error("Failed to read expected amount of binary data");
+                good_ = false;
+                return 0;
+            }
+            SCANFORGE_PROFILE_COUNT(BytesRead, buffer_.size());
+            records = buffer_.data();
+        }
+        cursor_ += count * plan_.stride;
+        remaining_ -= count;
+
+        const size_t written = PCDProcessor::decodeRecords(records, count, plan_, out);
+        if (written != count) {
+            dense_ = false;
+        }
+        return written;
+    }
+
+    io::AsyncInputStream file_;
+    PCDProcessor processor_;
+    PCDProcessor::PCDHeader header_;
+    PCDProcessor::DecodePlan plan_;
+    PCDProcessor::ASCIIColumns columns_;
+    io::LineReader lines_;               // Buffered ascii lines
+    ByteBuffer records_;                 // Decompressed binary_compressed records, or the current chunked block
+    std::vector<uint8_t> buffer_;        // One window of binary records, or one compressed block
+    std::vector<uint8_t> blockColumns_;  // Column-major fields of the current chunked block
+    PCDProcessor::BlockIndex index_;
+    uint32_t nextBlock_ = 0;
+    size_t cursor_ = 0;
+    size_t remaining_ = 0;
+    bool dense_ = true;
+    bool good_ = false;
+};
+
+/**
+ * @brief Chunked PCD writer; WIDTH, HEIGHT and POINTS are patched into the header on close()
+ *
+ * ascii and binary points are written as they arrive, binary_compressed_chunked ones a block at
+ * a time. binary_compressed needs every field in one column-major LZF stream, so its records are
+ * buffered until close().
+ */
+class PCDWriter final : public io::PointWriter {
+   public:
+    PCDWriter() = default;
+    PCDWriter(const std::filesystem::path& filename, const PCDProcessor::PCDHeader& header, codec::LZFCodec::Level level = codec::LZFCodec::Level::Normal,
+              const io::AsyncOptions& options = {}) {
+        open(filename, header, level, options);
+    }
+    ~PCDWriter() override {
+        if (file_.is_open()) {
+            close();
+        }
+    }
+
+    PCDWriter(const PCDWriter&) = delete;
+    PCDWriter& operator=(const PCDWriter&) = delete;
+
+    /**
+     * @brief Create a PCD file and write a provisional header
+     * @param filename Path to output PCD file
+     * @param header Template providing fields and dataType; point counts are ignored
+     * @param level LZF compression level for binary_compressed
+     * @param options Write-behind of the file: blocks kept in flight and the I/O backend
+     * @return True if the file was created
+     */
+    bool open(const std::filesystem::path& filename, const PCDProcessor::PCDHeader& header, codec::LZFCodec::Level level = codec::LZFCodec::Level::Normal,
+              const io::AsyncOptions& options = {}) {
+        header_ = header;
+        level_ = level;
+        count_ = 0;
+        records_.clear();
+        good_ = false;
+        if (header_.dataType != "ascii" && header_.dataType != "binary" && header_.dataType != "binary_compressed" && header_.dataType != "binary_compressed_chunked") {
+            Log::error("Unsupported data type '{}' for saving", header_.dataType);
+            return false;
+        }
+
+        if (!file_.open(filename, options)) {
+            Log::error("Failed to create file: {}", filename.string());
+            return false;
+        }
+        good_ = processor_.writeHeader(file_, header_, header_.dataType, COUNT_WIDTH);
+        blockSizes_.clear();
+        payloadStart_ = file_.tellp();
+        if (good_ && header_.dataType == "binary_compressed_chunked") {
+            good_ = PCDProcessor::beginBlocks(file_);
+        }
+        return good_;
+    }
+
+    bool is_open() const { return file_.is_open() && good_; }
+
+    /** @brief Number of points written so far */
+    uint64_t count() const { return count_; }
+
+    bool write(std::span<const PointXYZRGB> points) override {
+        if (!good_) {
+            return false;
+        }
+        if (header_.dataType == "ascii") {
+            good_ = processor_.writeASCII(file_, header_, points, text_);
+        } else if (header_.dataType == "binary") {
+            good_ = processor_.writeBinary(file_, header_, points, records_);
+        } else {
+            good_ = PCDProcessor::serializeRecords(header_, points, records_);
+        }
+        if (good_ && header_.dataType == "binary_compressed_chunked") {
+            // Compress every full block, the rest waits for more points or close()
+            const size_t blockBytes = header_.getPointSize() * PCDProcessor::COMPRESSED_BLOCK_POINTS;
+            const size_t full = records_.size() - records_.size() % blockBytes;
+            good_ = PCDProcessor::writeCompressedBlocks(file_, header_, std::span(records_).first(full), PCDProcessor::COMPRESSED_BLOCK_POINTS, blockSizes_, 1, level_);
+            records_.erase(records_.begin(), records_.begin() + static_cast<ptrdiff_t>(full));
+        }
+        count_ += points.size();
+        SCANFORGE_PROFILE_COUNT(PointsEncoded, points.size());
+        return good_;
+    }
+
+    bool close() override {
+        if (!file_.is_open()) {
+            return good_;
+        }
+        if (good_ && count_ > UINT32_MAX) {
+            Log::error("{} points exceed the PCD POINTS field", count_);
+            good_ = false;
+        }
+        if (good_ && header_.dataType == "binary_compressed") {
+            good_ = count_ > 0 && PCDProcessor::writeCompressedRecords(file_, header_, records_, level_);
+            if (count_ == 0) {
+                Log::error("Cannot compress an empty point cloud");
+            }
+        }
+        if (good_ && header_.dataType == "binary_compressed_chunked") {
+            good_ = count_ > 0 && PCDProcessor::writeCompressedBlocks(file_, header_, records_, PCDProcessor::COMPRESSED_BLOCK_POINTS, blockSizes_, 1, level_) &&
+                    PCDProcessor::finishBlocks(file_, payloadStart_, PCDProcessor::COMPRESSED_BLOCK_POINTS, blockSizes_);
+            if (count_ == 0) {
+                Log::error("Cannot compress an empty point cloud");
+            }
+        }
+        if (good_) {
+            // Keep an organized WIDTH x HEIGHT grid when the points filled it exactly
+            const auto points = static_cast<uint32_t>(count_);
+            if (uint64_t{header_.width} * header_.height != count_) {
+                header_.width = points;
+                header_.height = 1;
+            }
+            header_.points = points;
+            file_.seekp(0);
+            good_ = processor_.writeHeader(file_, header_, header_.dataType, COUNT_WIDTH);
+        }
+        file_.close();
+        return good_ && !file_.fail();
+    }
+
+   private:
+    static constexpr int COUNT_WIDTH = 10;  // Digits of the largest uint32_t
+
+    io::AsyncOutputStream file_;
+    PCDProcessor processor_;
+    PCDProcessor::PCDHeader header_;
+    codec::LZFCodec::Level level_ = codec::LZFCodec::Level::Normal;
+    std::vector<uint8_t> records_;      // binary: one block of records, binary_compressed: every record until close(),
+                                        // binary_compressed_chunked: the records of the block being filled
+    std::vector<char> text_;            // One block of ascii lines
+    std::vector<uint32_t> blockSizes_;  // Compressed size of every binary_compressed_chunked block written
+    std::streampos payloadStart_ = 0;
+    uint64_t count_ = 0;
+    bool good_ = false;
 };
 
 }  // namespace scanforge
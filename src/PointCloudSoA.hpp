@@ -0,0 +1,209 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "simd/Simd.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace scanforge {
+
+/**
+ * @brief Allocator returning storage aligned to Alignment bytes, so SIMD kernels start on a cache line
+ */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment})); }
+    void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t{Alignment}); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * @brief Structure-of-arrays point cloud: one aligned column per coordinate and color channel.
+ *
+ * Holds the same data as PointCloudXYZRGB, but whole-cloud passes (bounds, centroid,
+ * transforms, crops) read contiguous floats and run on the SIMD kernels in simd/Simd.hpp
+ * instead of striding over 15-byte points. Convert with the PointCloudXYZRGB constructor
+ * and toAoS(), or load columns directly with LASProcessor::loadLASColumns() and io::readColumns().
+ */
+class PointCloudSoA {
+   public:
+    template <typename T>
+    using Column = std::vector<T, AlignedAllocator<T>>;
+
+    Column<float> x, y, z;
+    Column<uint8_t> r, g, b;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool is_dense = true;
+
+    PointCloudSoA() = default;
+    explicit PointCloudSoA(const PointCloudXYZRGB& cloud) : width(cloud.width), height(cloud.height), is_dense(cloud.is_dense) { append(cloud.points); }
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void clear() {
+        resize(0);
+        width = 0;
+        height = 0;
+        is_dense = true;
+    }
+
+    void reserve(size_t count) {
+        forEachColumn([count](auto& column) { column.reserve(count); });
+    }
+
+    void resize(size_t count) {
+        forEachColumn([count](auto& column) { column.resize(count); });
+    }
+
+    void push_back(const PointXYZRGB& point) {
+        x.push_back(point.position.x);
+        y.push_back(point.position.y);
+        z.push_back(point.position.z);
+        r.push_back(point.color.r);
+        g.push_back(point.color.g);
+        b.push_back(point.color.b);
+    }
+
+    PointXYZRGB operator[](size_t idx) const { return PointXYZRGB(x[idx], y[idx], z[idx], r[idx], g[idx], b[idx]); }
+
+    void set(size_t idx, const PointXYZRGB& point) {
+        x[idx] = point.position.x;
+        y[idx] = point.position.y;
+        z[idx] = point.position.z;
+        r[idx] = point.color.r;
+        g[idx] = point.color.g;
+        b[idx] = point.color.b;
+    }
+
+    /** @brief Append interleaved points, splitting them into the columns */
+    void append(std::span<const PointXYZRGB> points) {
+        const size_t first = size();
+        resize(first + points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            set(first + i, points[i]);
+        }
+    }
+
+    /**
+     * @brief Interleave points [first, first + out.size()) into out, e.g. to feed a PointWriter chunk by chunk
+     * @param first Index of the first point to copy
+     * @param out Destination, must not extend past size()
+     */
+    void copyTo(size_t first, std::span<PointXYZRGB> out) const {
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = (*this)[first + i];
+        }
+    }
+
+    /** @brief Interleaved copy of the cloud */
+    PointCloudXYZRGB toAoS() const {
+        PointCloudXYZRGB cloud;
+        cloud.points.resize(size());
+        copyTo(0, cloud.points);
+        cloud.width = width;
+        cloud.height = height;
+        cloud.is_dense = is_dense;
+        return cloud;
+    }
+
+    /**
+     * @brief Axis-aligned bounds, {0,0,0} twice for an empty cloud; NaN coordinates are ignored
+     *
+     * An axis with nothing but NaN gets +inf as its minimum and -inf as its maximum.
+     */
+    std::pair<Point3D, Point3D> getBoundingBox() const {
+        if (empty()) {
+            return {
+                {0, 0, 0},
+                {0, 0, 0}
+            };
+        }
+
+        Point3D min_pt, max_pt;
+        simd::minMax(x.data(), size(), min_pt.x, max_pt.x);
+        simd::minMax(y.data(), size(), min_pt.y, max_pt.y);
+        simd::minMax(z.data(), size(), min_pt.z, max_pt.z);
+        return {min_pt, max_pt};
+    }
+
+    /** @brief Mean position, accumulated in double precision; {0,0,0} for an empty cloud */
+    Point3D getCentroid() const {
+        if (empty()) {
+            return {0, 0, 0};
+        }
+
+        const double n = static_cast<double>(size());
+        return {static_cast<float>(simd::sum(x.data(), size()) / n), static_cast<float>(simd::sum(y.data(), size()) / n),
+                static_cast<float>(simd::sum(z.data(), size()) / n)};
+    }
+
+    /**
+     * @brief Apply an affine transform to every position
+     * @param affine Row-major 3x4 matrix [R | t]: p' = R p + t
+     */
+    void transform(const std::array<float, 12>& affine) { simd::transformAffine(x.data(), y.data(), z.data(), size(), affine.data()); }
+
+    /**
+     * @brief Keep only the points inside a box, preserving their order
+     * @param min Box minimum, inclusive
+     * @param max Box maximum, inclusive
+     * @return Number of points kept
+     */
+    size_t cropBox(const Point3D& min, const Point3D& max) {
+        const std::array<float, 3> lo{min.x, min.y, min.z};
+        const std::array<float, 3> hi{max.x, max.y, max.z};
+        std::vector<uint8_t> inside(size());
+        simd::insideBox(x.data(), y.data(), z.data(), size(), lo.data(), hi.data(), inside.data());
+
+        size_t kept = 0;
+        for (size_t i = 0; i < inside.size(); ++i) {
+            if (inside[i]) {
+                forEachColumn([kept, i](auto& column) { column[kept] = column[i]; });
+                ++kept;
+            }
+        }
+
+        if (kept != size()) {
+            resize(kept);
+            width = static_cast<uint32_t>(kept);
+            height = 1;
+        }
+        return kept;
+    }
+
+   private:
+    template <typename F>
+    void forEachColumn(F&& f) {
+        f(x);
+        f(y);
+        f(z);
+        f(r);
+        f(g);
+        f(b);
+    }
+};
+
+}  // namespace scanforge
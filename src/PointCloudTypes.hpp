@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <concepts>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace scanforge {
@@ -60,19 +62,111 @@ struct PointXYZRGB {
     PointXYZRGB(float x, float y, float z, uint8_t r, uint8_t g, uint8_t b) : position(x, y, z), color(r, g, b) {}
 };
 
+/**
+ * @brief Attributes a point type can be composed of, one member each
+ *
+ * Loaders decode an attribute only when the requested point type has it, so a cloud of
+ * PointWith<field::Intensity> never touches the color or GPS time bytes of a record.
+ * Defaults are what a file lacking the attribute yields.
+ */
+namespace field {
+struct Color {
+    RGB color{255, 255, 255};
+};
+struct Intensity {
+    float intensity = 0;  // LAS stores uint16, PCD usually float; float holds both exactly
+};
+struct Classification {
+    uint8_t classification = 0;  // ASPRS class; PCD "label" values above 255 saturate
+};
+struct Returns {
+    uint8_t returnNumber = 0;
+    uint8_t numberOfReturns = 0;
+};
+struct GpsTime {
+    double gpsTime = 0;
+};
+struct NearInfrared {
+    uint16_t nearInfrared = 0;
+};
+}  // namespace field
+
+/**
+ * @brief Point type composed at compile time from a position and the given fields
+ *
+ * @code
+ * using PointXYZIC = PointWith<field::Intensity, field::Classification>;
+ * auto [header, cloud] = LASProcessor().loadLAS<PointXYZIC>("scan.las");
+ * @endcode
+ */
+template <typename... Fields>
+struct PointWith : Fields... {
+    Point3D position{0, 0, 0};
+
+    PointWith() = default;
+    explicit PointWith(const Point3D& pos) : position(pos) {}
+};
+
+using PointXYZI = PointWith<field::Intensity>;
+using PointXYZRGBClass = PointWith<field::Color, field::Classification>;
+using PointLAS = PointWith<field::Color, field::Intensity, field::Classification, field::Returns, field::GpsTime, field::NearInfrared>;
+
+// What a point type carries, with PointXYZRGB counting as a colored point
+template <typename PointT>
+concept HasColor = requires(PointT p) { { p.color } -> std::same_as<RGB&>; };
+template <typename PointT>
+concept HasIntensity = requires(PointT p) { { p.intensity } -> std::same_as<float&>; };
+template <typename PointT>
+concept HasClassification = requires(PointT p) { { p.classification } -> std::same_as<uint8_t&>; };
+template <typename PointT>
+concept HasReturns = requires(PointT p) {
+    { p.returnNumber } -> std::same_as<uint8_t&>;
+    { p.numberOfReturns } -> std::same_as<uint8_t&>;
+};
+template <typename PointT>
+concept HasGpsTime = requires(PointT p) { { p.gpsTime } -> std::same_as<double&>; };
+template <typename PointT>
+concept HasNearInfrared = requires(PointT p) { { p.nearInfrared } -> std::same_as<uint16_t&>; };
+
+/** @brief Position of a point, whatever its type; lets generic algorithms accept any cloud */
+inline const Point3D& getPosition(const Point3D& point) { return point; }
+inline const Point3D& getPosition(const PointXYZRGB& point) { return point.position; }
+template <typename... Fields>
+const Point3D& getPosition(const PointWith<Fields...>& point) {
+    return point.position;
+}
+
+inline Point3D& getPosition(Point3D& point) { return point; }
+inline Point3D& getPosition(PointXYZRGB& point) { return point.position; }
+template <typename... Fields>
+Point3D& getPosition(PointWith<Fields...>& point) {
+    return point.position;
+}
+
 /**
  * @brief Point cloud data structure
+ *
+ * The points allocate from a std::pmr::memory_resource, the default one (new/delete) unless
+ * the cloud is constructed with another: a tooling::Arena or a pool lets a long-running worker
+ * load cloud after cloud without going back to the global heap. Copies allocate from the
+ * default resource; moves keep the resource of their source.
  */
 template <typename PointT>
 class PointCloud {
    public:
-    std::vector<PointT> points;
+    std::pmr::vector<PointT> points;
     uint32_t width = 0;
     uint32_t height = 0;
     bool is_dense = true;
 
     PointCloud() = default;
-    explicit PointCloud(size_t reserve_size) { points.reserve(reserve_size); }
+    explicit PointCloud(std::pmr::memory_resource* resource) : points(resource) {}
+    explicit PointCloud(size_t reserve_size, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : points(resource) {
+        points.reserve(reserve_size);
+    }
+
+    /** @brief Resource the points allocate from */
+    std::pmr::memory_resource* memoryResource() const { return points.get_allocator().resource(); }
 
     void clear() {
         points.clear();
@@ -104,7 +198,7 @@ class PointCloud {
         Point3D max_pt = min_pt;
 
         for (const auto& point : points) {
-            Point3D pos = getPosition(point);
+            const Point3D& pos = getPosition(point);
             min_pt.x = std::min(min_pt.x, pos.x);
             min_pt.y = std::min(min_pt.y, pos.y);
             min_pt.z = std::min(min_pt.z, pos.z);
@@ -115,12 +209,6 @@ class PointCloud {
 
         return {min_pt, max_pt};
     }
-
-   private:
-    // Helper function to extract position from different point types
-    Point3D getPosition(const Point3D& point) const { return point; }
-
-    Point3D getPosition(const PointXYZRGB& point) const { return point.position; }
 };
 
 // Type aliases for common point cloud types
@@ -0,0 +1,1978 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace scanforge::codec {
+
+/**
+ * @brief Building blocks of the LASzip entropy coder.
+ * Adaptive arithmetic coding after Amir Said's FastAC, as used by LASzip.
+ * Reference: https://github.com/LASzip/LASzip/tree/master/src
+ */
+namespace laz {
+
+inline constexpr uint32_t AC_MIN_LENGTH = 0x01000000U;  // Renormalize below this interval length
+inline constexpr uint32_t AC_MAX_LENGTH = 0xFFFFFFFFU;
+inline constexpr uint32_t BM_LENGTH_SHIFT = 13;  // Bit model probability precision
+inline constexpr uint32_t BM_MAX_COUNT = 1U << BM_LENGTH_SHIFT;
+inline constexpr uint32_t DM_LENGTH_SHIFT = 15;  // Symbol model probability precision
+inline constexpr uint32_t DM_MAX_COUNT = 1U << DM_LENGTH_SHIFT;
+
+/** @brief Adaptive probability of a binary event */
+class ArithmeticBitModel {
+   public:
+    void update() {
+        // Halve the counts when they grow too large, then recompute the probability
+        if ((bitCount_ += updateCycle_) > BM_MAX_COUNT) {
+            bitCount_ = (bitCount_ + 1) >> 1;
+            bit0Count_ = (bit0Count_ + 1) >> 1;
+            if (bit0Count_ == bitCount_) {
+                ++bitCount_;
+            }
+        }
+        const uint32_t scale = 0x80000000U / bitCount_;
+        bit0Prob_ = (bit0Count_ * scale) >> (31 - BM_LENGTH_SHIFT);
+        updateCycle_ = std::min<uint32_t>((5 * updateCycle_) >> 2, 64);
+        bitsUntilUpdate_ = updateCycle_;
+    }
+
+   private:
+    friend class ArithmeticEncoder;
+    friend class ArithmeticDecoder;
+
+    uint32_t bit0Prob_ = 1U << (BM_LENGTH_SHIFT - 1);
+    uint32_t bit0Count_ = 1;
+    uint32_t bitCount_ = 2;
+    uint32_t updateCycle_ = 4;
+    uint32_t bitsUntilUpdate_ = 4;
+};
+
+/** @brief Adaptive distribution over a small alphabet */
+class ArithmeticModel {
+   public:
+    explicit ArithmeticModel(uint32_t symbols) : distribution_(symbols), symbolCount_(symbols, 1), symbols_(symbols), updateCycle_(symbols) {
+        update();
+        symbolsUntilUpdate_ = updateCycle_ = (symbols_ + 6) >> 1;
+    }
+
+    void update() {
+        if ((totalCount_ += updateCycle_) > DM_MAX_COUNT) {
+            totalCount_ = 0;
+            for (auto& count : symbolCount_) {
+                count = (count + 1) >> 1;
+                totalCount_ += count;
+            }
+        }
+
+        // Cumulative distribution scaled to DM_LENGTH_SHIFT bits
+        const uint32_t scale = 0x80000000U / totalCount_;
+        uint32_t sum = 0;
+        for (uint32_t k = 0; k < symbols_; ++k) {
+            distribution_[k] = (scale * sum) >> (31 - DM_LENGTH_SHIFT);
+            sum += symbolCount_[k];
+        }
+
+        updateCycle_ = std::min((5 * updateCycle_) >> 2, (symbols_ + 6) << 3);
+        symbolsUntilUpdate_ = updateCycle_;
+    }
+
+   private:
+    friend class ArithmeticEncoder;
+    friend class ArithmeticDecoder;
+
+    std::vector<uint32_t> distribution_;
+    std::vector<uint32_t> symbolCount_;
+    uint32_t symbols_;
+    uint32_t totalCount_ = 0;
+    uint32_t updateCycle_;
+    uint32_t symbolsUntilUpdate_ = 0;
+};
+
+/** @brief Arithmetic encoder appending to a byte vector */
+class ArithmeticEncoder {
+   public:
+    explicit ArithmeticEncoder(std::vector<uint8_t>& out) : out_(out) {}
+
+    void encodeBit(ArithmeticBitModel& model, uint32_t bit) {
+        const uint32_t x = model.bit0Prob_ * (length_ >> BM_LENGTH_SHIFT);
+        if (bit == 0) {
+            length_ = x;
+            ++model.bit0Count_;
+        } else {
+            addToBase(x);
+            length_ -= x;
+        }
+        renormalize();
+        if (--model.bitsUntilUpdate_ == 0) {
+            model.update();
+        }
+    }
+
+    void encodeSymbol(ArithmeticModel& model, uint32_t symbol) {
+        if (symbol == model.symbols_ - 1) {
+            // The last symbol takes the remainder of the interval
+            const uint32_t x = model.distribution_[symbol] * (length_ >> DM_LENGTH_SHIFT);
+            addToBase(x);
+            length_ -= x;
+        } else {
+            length_ >>= DM_LENGTH_SHIFT;
+            const uint32_t x = model.distribution_[symbol] * length_;
+            addToBase(x);
+            length_ = model.distribution_[symbol + 1] * length_ - x;
+        }
+        renormalize();
+        ++model.symbolCount_[symbol];
+        if (--model.symbolsUntilUpdate_ == 0) {
+            model.update();
+        }
+    }
+
+    // Raw bits with uniform probability, up to 32
+    void writeBits(uint32_t bits, uint32_t value) {
+        if (bits > 19) {
+            writeShort(value & 0xFFFF);
+            value >>= 16;
+            bits -= 16;
+        }
+        length_ >>= bits;
+        addToBase(value * length_);
+        renormalize();
+    }
+
+    void writeShort(uint32_t value) {
+        length_ >>= 16;
+        addToBase(value * length_);
+        renormalize();
+    }
+
+    void writeInt(uint32_t value) {
+        writeShort(value & 0xFFFF);
+        writeShort(value >> 16);
+    }
+
+    /** @brief Flush the interval; the trailing bytes keep the decoder's 4-byte look-ahead inside the stream */
+    void done() {
+        const bool anotherByte = length_ > 2 * AC_MIN_LENGTH;
+        if (anotherByte) {
+            addToBase(AC_MIN_LENGTH);
+            length_ = AC_MIN_LENGTH >> 1;
+        } else {
+            addToBase(AC_MIN_LENGTH >> 1);
+            length_ = AC_MIN_LENGTH >> 9;
+        }
+        renormalize();
+        out_.insert(out_.end(), anotherByte ? 3 : 2, uint8_t{0});
+    }
+
+   private:
+    void addToBase(uint32_t x) {
+        const uint32_t previous = base_;
+        base_ += x;
+        if (previous > base_) {
+            // Carry into the bytes already emitted
+            size_t p = out_.size();
+            while (out_[--p] == 0xFF) {
+                out_[p] = 0;
+            }
+            ++out_[p];
+        }
+    }
+
+    void renormalize() {
+        while (length_ < AC_MIN_LENGTH) {
+            out_.push_back(static_cast<uint8_t>(base_ >> 24));
+            base_ <<= 8;
+            length_ <<= 8;
+        }
+    }
+
+    std::vector<uint8_t>& out_;
+    uint32_t base_ = 0;
+    uint32_t length_ = AC_MAX_LENGTH;
+};
+
+/** @brief Arithmetic decoder reading from a byte span */
+class ArithmeticDecoder {
+   public:
+    explicit ArithmeticDecoder(std::span<const uint8_t> in) : in_(in) {
+        for (int i = 0; i < 4; ++i) {
+            value_ = (value_ << 8) | nextByte();
+        }
+    }
+
+    uint32_t decodeBit(ArithmeticBitModel& model) {
+        const uint32_t x = model.bit0Prob_ * (length_ >> BM_LENGTH_SHIFT);
+        const uint32_t bit = value_ >= x ? 1 : 0;
+        if (bit == 0) {
+            length_ = x;
+            ++model.bit0Count_;
+        } else {
+            value_ -= x;
+            length_ -= x;
+        }
+        renormalize();
+        if (--model.bitsUntilUpdate_ == 0) {
+            model.update();
+        }
+        return bit;
+    }
+
+    uint32_t decodeSymbol(ArithmeticModel& model) {
+        // Bisect the cumulative distribution for the sub-interval holding the value
+        uint32_t low = 0;
+        uint32_t high = length_;
+        uint32_t symbol = 0;
+        uint32_t n = model.symbols_;
+        length_ >>= DM_LENGTH_SHIFT;
+        uint32_t k = n >> 1;
+        do {
+            const uint32_t z = length_ * model.distribution_[k];
+            if (z > value_) {
+                n = k;
+                high = z;
+            } else {
+                symbol = k;
+                low = z;
+            }
+        } while ((k = (symbol + n) >> 1) != symbol);
+
+        value_ -= low;
+        length_ = high - low;
+        renormalize();
+        ++model.symbolCount_[symbol];
+        if (--model.symbolsUntilUpdate_ == 0) {
+            model.update();
+        }
+        return symbol;
+    }
+
+    uint32_t readBits(uint32_t bits) {
+        if (bits > 19) {
+            const uint32_t low = readShort();
+            return (readBits(bits - 16) << 16) | low;
+        }
+        length_ >>= bits;
+        const uint32_t value = std::min(value_ / length_, (1U << bits) - 1);
+        value_ -= length_ * value;
+        renormalize();
+        return value;
+    }
+
+    uint32_t readShort() {
+        length_ >>= 16;
+        const uint32_t value = std::min<uint32_t>(value_ / length_, 0xFFFF);
+        value_ -= length_ * value;
+        renormalize();
+        return value;
+    }
+
+    uint32_t readInt() {
+        const uint32_t low = readShort();
+        return (readShort() << 16) | low;
+    }
+
+    /** @brief True if decoding ran past the end of the input, which only corrupt data does */
+    bool overrun() const { return overrun_; }
+
+   private:
+    uint32_t nextByte() {
+        if (position_ < in_.size()) {
+            return in_[position_++];
+        }
+        overrun_ = true;
+        return 0;
+    }
+
+    void renormalize() {
+        while (length_ < AC_MIN_LENGTH) {
+            value_ = (value_ << 8) | nextByte();
+            length_ <<= 8;
+        }
+    }
+
+    std::span<const uint8_t> in_;
+    size_t position_ = 0;
+    uint32_t value_ = 0;
+    uint32_t length_ = AC_MAX_LENGTH;
+    bool overrun_ = false;
+};
+
+/**
+ * @brief Entropy coder for integer residuals against a prediction.
+ *
+ * A residual is sent as the bit length k of its magnitude, coded per context, followed by
+ * its k low bits: the top bitsHigh of them through an adaptive model and the rest raw.
+ */
+class IntegerCodec {
+   public:
+    IntegerCodec(uint32_t bits, uint32_t contexts, uint32_t bitsHigh = 8) : bits_(bits), bitsHigh_(bitsHigh) {
+        if (bits_ >= 32) {
+            bits_ = 32;
+            corrMin_ = INT32_MIN;
+            corrMax_ = INT32_MAX;
+        } else {
+            corrMin_ = -(int64_t{1} << (bits_ - 1));
+            corrMax_ = corrMin_ + (int64_t{1} << bits_) - 1;
+        }
+        bitLengths_.reserve(contexts);
+        for (uint32_t i = 0; i < contexts; ++i) {
+            bitLengths_.emplace_back(bits_ + 1);
+        }
+        correctors_.reserve(bits_);
+        for (uint32_t i = 1; i <= bits_; ++i) {
+            correctors_.emplace_back(1U << std::min(i, bitsHigh_));
+        }
+    }
+
+    void compress(ArithmeticEncoder& encoder, int32_t predicted, int32_t real, uint32_t context = 0) {
+        // Fold the residual into the coder's range
+        int64_t corr = int64_t{real} - predicted;
+        if (corr < corrMin_) {
+            corr += int64_t{1} << bits_;
+        } else if (corr > corrMax_) {
+            corr -= int64_t{1} << bits_;
+        }
+        writeCorrector(encoder, static_cast<int32_t>(corr), bitLengths_[context]);
+    }
+
+    int32_t decompress(ArithmeticDecoder& decoder, int32_t predicted, uint32_t context = 0) {
+        const int64_t real = int64_t{predicted} + readCorrector(decoder, bitLengths_[context]);
+        if (bits_ == 32) {
+            return static_cast<int32_t>(static_cast<uint32_t>(real & 0xFFFFFFFF));
+        }
+        const int64_t range = int64_t{1} << bits_;
+        return static_cast<int32_t>(real < 0 ? real + range : (real >= range ? real - range : real));
+    }
+
+    /** @brief Bit length of the last residual, used as a context by the point codec */
+    uint32_t getK() const { return k_; }
+
+   private:
+    void writeCorrector(ArithmeticEncoder& encoder, int32_t c, ArithmeticModel& bitLength) {
+        uint32_t magnitude = c <= 0 ? 0U - static_cast<uint32_t>(c) : static_cast<uint32_t>(c) - 1;
+        k_ = 0;
+        while (magnitude != 0) {
+            magnitude >>= 1;
+            ++k_;
+        }
+        encoder.encodeSymbol(bitLength, k_);
+
+        if (k_ == 0) {
+            encoder.encodeBit(zeroOrOne_, static_cast<uint32_t>(c));
+        } else if (k_ < 32) {
+            // Map c into [0, 2^k): negatives below 2^(k-1), positives above
+            const uint32_t value = c < 0 ? static_cast<uint32_t>(int64_t{c} + (int64_t{1} << k_) - 1) : static_cast<uint32_t>(c) - 1;
+            if (k_ <= bitsHigh_) {
+                encoder.encodeSymbol(correctors_[k_ - 1], value);
+            } else {
+                const uint32_t lowBits = k_ - bitsHigh_;
+                encoder.encodeSymbol(correctors_[k_ - 1], value >> lowBits);
+                encoder.writeBits(lowBits, value & ((1U << lowBits) - 1));
+            }
+        }
+    }
+
+    int64_t readCorrector(ArithmeticDecoder& decoder, ArithmeticModel& bitLength) {
+        k_ = decoder.decodeSymbol(bitLength);
+        if (k_ == 0) {
+            return decoder.decodeBit(zeroOrOne_);
+        }
+        if (k_ >= 32) {
+            return corrMin_;
+        }
+
+        int64_t c;
+        if (k_ <= bitsHigh_) {
+            c = decoder.decodeSymbol(correctors_[k_ - 1]);
+        } else {
+            const uint32_t lowBits = k_ - bitsHigh_;
+            c = decoder.decodeSymbol(correctors_[k_ - 1]);
+            c = (c << lowBits) | decoder.readBits(lowBits);
+        }
+        return c >= (int64_t{1} << (k_ - 1)) ? c + 1 : c - ((int64_t{1} << k_) - 1);
+    }
+
+    uint32_t bits_;
+    uint32_t bitsHigh_;
+    int64_t corrMin_;
+    int64_t corrMax_;
+    uint32_t k_ = 0;
+    std::vector<ArithmeticModel> bitLengths_;  // Per context: bit length of the residual
+    std::vector<ArithmeticModel> correctors_;  // Per bit length 1..bits: high bits of the residual
+    ArithmeticBitModel zeroOrOne_;             // Residuals of bit length 0 are 0 or 1
+};
+
+/** @brief Running median of the last five values, in constant time per update */
+class StreamingMedian5 {
+   public:
+    void add(int32_t v) {
+        if (high_) {
+            if (v < values_[2]) {
+                values_[4] = values_[3];
+                values_[3] = values_[2];
+                if (v < values_[0]) {
+                    values_[2] = values_[1];
+                    values_[1] = values_[0];
+                    values_[0] = v;
+                } else if (v < values_[1]) {
+                    values_[2] = values_[1];
+                    values_[1] = v;
+                } else {
+                    values_[2] = v;
+                }
+            } else {
+                if (v < values_[3]) {
+                    values_[4] = values_[3];
+                    values_[3] = v;
+                } else {
+                    values_[4] = v;
+                }
+                high_ = false;
+            }
+        } else {
+            if (values_[2] < v) {
+                values_[0] = values_[1];
+                values_[1] = values_[2];
+                if (values_[4] < v) {
+                    values_[2] = values_[3];
+                    values_[3] = values_[4];
+                    values_[4] = v;
+                } else if (values_[3] < v) {
+                    values_[2] = values_[3];
+                    values_[3] = v;
+                } else {
+                    values_[2] = v;
+                }
+            } else {
+                if (values_[1] < v) {
+                    values_[0] = values_[1];
+                    values_[1] = v;
+                } else {
+                    values_[0] = v;
+                }
+                high_ = true;
+            }
+        }
+    }
+
+    int32_t get() const { return values_[2]; }
+
+   private:
+    std::array<int32_t, 5> values_{};
+    bool high_ = true;
+};
+
+template <typename T>
+T load(const uint8_t* bytes) {
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void store(uint8_t* bytes, T value) {
+    std::memcpy(bytes, &value, sizeof(T));
+}
+
+/** @brief Model of a context that most chunks never reach, created on first use */
+inline ArithmeticModel& lazyModel(std::unique_ptr<ArithmeticModel>& slot, uint32_t symbols) {
+    if (!slot) {
+        slot = std::make_unique<ArithmeticModel>(symbols);
+    }
+    return *slot;
+}
+
+/** @brief LASzip POINT10 item, version 2: the 20-byte core shared by point formats 0-5 */
+class Point10Codec {
+   public:
+    static constexpr size_t SIZE = 20;
+
+    explicit Point10Codec(const uint8_t* first) {
+        std::memcpy(last_.data(), first, SIZE);
+        store<uint16_t>(last_.data() + 12, 0);  // Intensity is predicted per return, not from the first point
+    }
+
+    void encode(ArithmeticEncoder& encoder, const uint8_t* item) {
+        const uint32_t r = item[14] & 7;
+        const uint32_t n = (item[14] >> 3) & 7;
+        const uint32_t m = RETURN_MAP[n][r];
+        const uint32_t l = RETURN_LEVEL[n][r];
+        const auto intensity = load<uint16_t>(item + 12);
+
+        // Flag the attributes that differ from the previous point
+        const uint32_t changed = (last_[14] != item[14] ? 32U : 0U) | (lastIntensity_[m] != intensity ? 16U : 0U) | (last_[15] != item[15] ? 8U : 0U) |
+                                 (last_[16] != item[16] ? 4U : 0U) | (last_[17] != item[17] ? 2U : 0U) | (std::memcmp(last_.data() + 18, item + 18, 2) != 0 ? 1U : 0U);
+        encoder.encodeSymbol(changedValues_, changed);
+
+        if (changed & 32) {
+            encoder.encodeSymbol(model(bitByte_, last_[14]), item[14]);
+        }
+        if (changed & 16) {
+            intensity_.compress(encoder, lastIntensity_[m], intensity, std::min(m, 3U));
+            lastIntensity_[m] = intensity;
+        }
+        if (changed & 8) {
+            encoder.encodeSymbol(model(classification_, last_[15]), item[15]);
+        }
+        if (changed & 4) {
+            encoder.encodeSymbol(scanAngleRank_[(item[14] >> 6) & 1], static_cast<uint8_t>(item[16] - last_[16]));
+        }
+        if (changed & 2) {
+            encoder.encodeSymbol(model(userData_, last_[17]), item[17]);
+        }
+        if (changed & 1) {
+            pointSourceID_.compress(encoder, load<uint16_t>(last_.data() + 18), load<uint16_t>(item + 18));
+        }
+
+        // Coordinates: x and y against the median of recent deltas, z against the last height of the same return level
+        const int32_t dx = static_cast<int32_t>(load<uint32_t>(item) - load<uint32_t>(last_.data()));
+        dx_.compress(encoder, lastXDiff_[m].get(), dx, n == 1 ? 1U : 0U);
+        lastXDiff_[m].add(dx);
+
+        const int32_t dy = static_cast<int32_t>(load<uint32_t>(item + 4) - load<uint32_t>(last_.data() + 4));
+        dy_.compress(encoder, lastYDiff_[m].get(), dy, yContext(n));
+        lastYDiff_[m].add(dy);
+
+        const auto z = load<int32_t>(item + 8);
+        z_.compress(encoder, lastHeight_[l], z, zContext(n));
+        lastHeight_[l] = z;
+
+        std::memcpy(last_.data(), item, SIZE);
+    }
+
+    void decode(ArithmeticDecoder& decoder, uint8_t* item) {
+        const uint32_t changed = decoder.decodeSymbol(changedValues_);
+        uint32_t r = last_[14] & 7;
+        uint32_t n = (last_[14] >> 3) & 7;
+        uint32_t m = RETURN_MAP[n][r];
+        uint32_t l = RETURN_LEVEL[n][r];
+
+        if (changed != 0) {
+            if (changed & 32) {
+                last_[14] = static_cast<uint8_t>(decoder.decodeSymbol(model(bitByte_, last_[14])));
+                r = last_[14] & 7;
+                n = (last_[14] >> 3) & 7;
+                m = RETURN_MAP[n][r];
+                l = RETURN_LEVEL[n][r];
+            }
+            if (changed & 16) {
+                lastIntensity_[m] = static_cast<uint16_t>(intensity_.decompress(decoder, lastIntensity_[m], std::min(m, 3U)));
+            }
+            store<uint16_t>(last_.data() + 12, lastIntensity_[m]);
+            if (changed & 8) {
+                last_[15] = static_cast<uint8_t>(decoder.decodeSymbol(model(classification_, last_[15])));
+            }
+            if (changed & 4) {
+                last_[16] = static_cast<uint8_t>(decoder.decodeSymbol(scanAngleRank_[(last_[14] >> 6) & 1]) + last_[16]);
+            }
+            if (changed & 2) {
+                last_[17] = static_cast<uint8_t>(decoder.decodeSymbol(model(userData_, last_[17])));
+            }
+            if (changed & 1) {
+                store(last_.data() + 18, static_cast<uint16_t>(pointSourceID_.decompress(decoder, load<uint16_t>(last_.data() + 18))));
+            }
+        }
+
+        const int32_t dx = dx_.decompress(decoder, lastXDiff_[m].get(), n == 1 ? 1U : 0U);
+        store(last_.data(), load<uint32_t>(last_.data()) + static_cast<uint32_t>(dx));
+        lastXDiff_[m].add(dx);
+
+        const int32_t dy = dy_.decompress(decoder, lastYDiff_[m].get(), yContext(n));
+        store(last_.data() + 4, load<uint32_t>(last_.data() + 4) + static_cast<uint32_t>(dy));
+        lastYDiff_[m].add(dy);
+
+        const int32_t z = z_.decompress(decoder, lastHeight_[l], zContext(n));
+        store(last_.data() + 8, z);
+        lastHeight_[l] = z;
+
+        std::memcpy(item, last_.data(), SIZE);
+    }
+
+   private:
+    // Return number r of n returns, mapped to one of 16 coordinate contexts and to 8 height levels
+    static constexpr uint8_t RETURN_MAP[8][8] = {{15, 14, 13, 12, 11, 10, 9, 8}, {14, 0, 1, 3, 6, 10, 10, 9}, {13, 1, 2, 4, 7, 11, 11, 10}, {12, 3, 4, 5, 8, 12, 12, 11},
+                                                 {11, 6, 7, 8, 9, 13, 13, 12},   {10, 10, 11, 12, 13, 14, 14, 13}, {9, 10, 11, 12, 13, 14, 15, 14}, {8, 9, 10, 11, 12, 13, 14, 15}};
+    static constexpr uint8_t RETURN_LEVEL[8][8] = {{0, 1, 2, 3, 4, 5, 6, 7}, {1, 0, 1, 2, 3, 4, 5, 6}, {2, 1, 0, 1, 2, 3, 4, 5}, {3, 2, 1, 0, 1, 2, 3, 4},
+                                                   {4, 3, 2, 1, 0, 1, 2, 3}, {5, 4, 3, 2, 1, 0, 1, 2}, {6, 5, 4, 3, 2, 1, 0, 1}, {7, 6, 5, 4, 3, 2, 1, 0}};
+
+    uint32_t yContext(uint32_t n) const {
+        const uint32_t k = dx_.getK();
+        return (n == 1 ? 1U : 0U) + (k < 20 ? (k & ~1U) : 20U);
+    }
+
+    uint32_t zContext(uint32_t n) const {
+        const uint32_t k = (dx_.getK() + dy_.getK()) / 2;
+        return (n == 1 ? 1U : 0U) + (k < 18 ? (k & ~1U) : 18U);
+    }
+
+    // Byte models conditioned on the previous value, created on first use
+    static ArithmeticModel& model(std::array<std::unique_ptr<ArithmeticModel>, 256>& models, uint8_t context) { return lazyModel(models[context], 256); }
+
+    std::array<uint8_t, SIZE> last_{};
+    std::array<uint16_t, 16> lastIntensity_{};
+    std::array<StreamingMedian5, 16> lastXDiff_{};
+    std::array<StreamingMedian5, 16> lastYDiff_{};
+    std::array<int32_t, 8> lastHeight_{};
+
+    ArithmeticModel changedValues_{64};
+    std::array<ArithmeticModel, 2> scanAngleRank_{ArithmeticModel(256), ArithmeticModel(256)};
+    std::array<std::unique_ptr<ArithmeticModel>, 256> bitByte_;
+    std::array<std::unique_ptr<ArithmeticModel>, 256> classification_;
+    std::array<std::unique_ptr<ArithmeticModel>, 256> userData_;
+    IntegerCodec intensity_{16, 4};
+    IntegerCodec pointSourceID_{16, 1};
+    IntegerCodec dx_{32, 2};
+    IntegerCodec dy_{32, 22};
+    IntegerCodec z_{32, 20};
+};
+
+/**
+ * @brief LASzip GPSTIME11 item, version 2: double GPS time coded as integer deltas over up to four sequences.
+ * Version 3 codes the time of POINT14 the same way, but only for points whose time changed,
+ * so its models lack the symbol for an unchanged time.
+ */
+class GpsTime11Codec {
+   public:
+    static constexpr size_t SIZE = 8;
+
+    explicit GpsTime11Codec(const uint8_t* first, uint16_t version = 2)
+        : shift_(version >= 3 ? 1U : 0U), multi_(MULTI_TOTAL - shift_), zeroDiff_(6 - shift_) {
+        lastTime_[0] = load<int64_t>(first);
+    }
+
+    void encode(ArithmeticEncoder& encoder, const uint8_t* item) {
+        const auto time = load<int64_t>(item);
+        // At most one switch: after it the time is within 32 bits of the chosen sequence
+        for (;;) {
+            if (lastDiff_[last_] == 0) {
+                if (shift_ == 0 && time == lastTime_[last_]) {
+                    encoder.encodeSymbol(zeroDiff_, 0);
+                    return;
+                }
+                const int64_t diff = static_cast<int64_t>(static_cast<uint64_t>(time) - static_cast<uint64_t>(lastTime_[last_]));
+                if (fits32(diff)) {
+                    encoder.encodeSymbol(zeroDiff_, 1 - shift_);
+                    time_.compress(encoder, 0, static_cast<int32_t>(diff), 0);
+                    lastDiff_[last_] = static_cast<int32_t>(diff);
+                    extremeCounter_[last_] = 0;
+                    lastTime_[last_] = time;
+                    return;
+                }
+                if (auto other = otherSequence(time)) {
+                    encoder.encodeSymbol(zeroDiff_, *other + 2 - shift_);
+                    last_ = (last_ + *other) & 3;
+                    continue;
+                }
+                encoder.encodeSymbol(zeroDiff_, 2 - shift_);
+                startSequence(encoder, time);
+                return;
+            }
+
+            if (shift_ == 0 && time == lastTime_[last_]) {
+                encoder.encodeSymbol(multi_, MULTI_UNCHANGED);
+                return;
+            }
+            const int64_t diff = static_cast<int64_t>(static_cast<uint64_t>(time) - static_cast<uint64_t>(lastTime_[last_]));
+            if (fits32(diff)) {
+                encodeMultiple(encoder, static_cast<int32_t>(diff));
+                lastTime_[last_] = time;
+                return;
+            }
+            if (auto other = otherSequence(time)) {
+                encoder.encodeSymbol(multi_, MULTI_CODE_FULL - shift_ + *other);
+                last_ = (last_ + *other) & 3;
+                continue;
+            }
+            encoder.encodeSymbol(multi_, MULTI_CODE_FULL - shift_);
+            startSequence(encoder, time);
+            return;
+        }
+    }
+
+    void decode(ArithmeticDecoder& decoder, uint8_t* item) {
+        // Corrupt data could keep switching sequences; valid streams switch at most once per point
+        for (int switches = 0; switches < 4; ++switches) {
+            if (lastDiff_[last_] == 0) {
+                const uint32_t symbol = decoder.decodeSymbol(zeroDiff_) + shift_;
+                if (symbol == 1) {
+                    lastDiff_[last_] = time_.decompress(decoder, 0, 0);
+                    lastTime_[last_] = static_cast<int64_t>(static_cast<uint64_t>(lastTime_[last_]) + static_cast<uint64_t>(int64_t{lastDiff_[last_]}));
+                    extremeCounter_[last_] = 0;
+                } else if (symbol == 2) {
+                    readSequence(decoder);
+                } else if (symbol > 2) {
+                    last_ = (last_ + symbol - 2) & 3;
+                    continue;
+                }
+                break;
+            }
+
+            uint32_t symbol = decoder.decodeSymbol(multi_);
+            if (symbol >= MULTI_UNCHANGED) {
+                symbol += shift_;
+            }
+            if (symbol == 1) {
+                addToLast(time_.decompress(decoder, lastDiff_[last_], 1));
+                extremeCounter_[last_] = 0;
+            } else if (symbol < MULTI_UNCHANGED) {
+                int32_t diff;
+                if (symbol == 0) {
+                    diff = time_.decompress(decoder, 0, 7);
+                    countExtreme(diff);
+                } else if (symbol < MULTI) {
+                    diff = time_.decompress(decoder, times(static_cast<int32_t>(symbol), lastDiff_[last_]), symbol < 10 ? 2U : 3U);
+                } else if (symbol == MULTI) {
+                    diff = time_.decompress(decoder, times(static_cast<int32_t>(MULTI), lastDiff_[last_]), 4);
+                    countExtreme(diff);
+                } else {
+                    const int32_t multiple = static_cast<int32_t>(MULTI) - static_cast<int32_t>(symbol);
+                    if (multiple > MULTI_MINUS) {
+                        diff = time_.decompress(decoder, times(multiple, lastDiff_[last_]), 5);
+                    } else {
+                        diff = time_.decompress(decoder, times(MULTI_MINUS, lastDiff_[last_]), 6);
+                        countExtreme(diff);
+                    }
+                }
+                addToLast(diff);
+            } else if (symbol == MULTI_CODE_FULL) {
+                readSequence(decoder);
+            } else if (symbol > MULTI_CODE_FULL) {
+                last_ = (last_ + symbol - MULTI_CODE_FULL) & 3;
+                continue;
+            }
+            break;
+        }
+        store(item, lastTime_[last_]);
+    }
+
+   private:
+    static constexpr uint32_t MULTI = 500;
+    static constexpr int32_t MULTI_MINUS = -10;
+    static constexpr uint32_t MULTI_UNCHANGED = static_cast<uint32_t>(static_cast<int32_t>(MULTI) - MULTI_MINUS + 1);
+    static constexpr uint32_t MULTI_CODE_FULL = static_cast<uint32_t>(static_cast<int32_t>(MULTI) - MULTI_MINUS + 2);
+    static constexpr uint32_t MULTI_TOTAL = static_cast<uint32_t>(static_cast<int32_t>(MULTI) - MULTI_MINUS + 6);
+
+    static bool fits32(int64_t value) { return value >= INT32_MIN && value <= INT32_MAX; }
+
+    // Integer product with the wrap-around of the reference implementation
+    static int32_t times(int32_t multiple, int32_t diff) { return static_cast<int32_t>(static_cast<uint32_t>(multiple) * static_cast<uint32_t>(diff)); }
+
+    void addToLast(int32_t diff) { lastTime_[last_] = static_cast<int64_t>(static_cast<uint64_t>(lastTime_[last_]) + static_cast<uint64_t>(int64_t{diff})); }
+
+    // After a few outliers in a row, adopt the new delta as the sequence's regular spacing
+    void countExtreme(int32_t diff) {
+        if (++extremeCounter_[last_] > 3) {
+            lastDiff_[last_] = diff;
+            extremeCounter_[last_] = 0;
+        }
+    }
+
+    // Offset 1-3 of a sequence the time is within 32 bits of
+    std::optional<uint32_t> otherSequence(int64_t time) const {
+        for (uint32_t i = 1; i < 4; ++i) {
+            if (fits32(static_cast<int64_t>(static_cast<uint64_t>(time) - static_cast<uint64_t>(lastTime_[(last_ + i) & 3])))) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void encodeMultiple(ArithmeticEncoder& encoder, int32_t diff) {
+        // Quantized ratio to the sequence's regular delta; clamped since only its range matters
+        const float ratio = std::clamp(static_cast<float>(diff) / static_cast<float>(lastDiff_[last_]), -20.0f, 600.0f);
+        const int32_t multiple = static_cast<int32_t>(ratio >= 0.0f ? ratio + 0.5f : ratio - 0.5f);
+
+        if (multiple == 1) {
+            encoder.encodeSymbol(multi_, 1);
+            time_.compress(encoder, lastDiff_[last_], diff, 1);
+            extremeCounter_[last_] = 0;
+        } else if (multiple > 0) {
+            if (multiple < static_cast<int32_t>(MULTI)) {
+                encoder.encodeSymbol(multi_, static_cast<uint32_t>(multiple));
+                time_.compress(encoder, times(multiple, lastDiff_[last_]), diff, multiple < 10 ? 2U : 3U);
+            } else {
+                encoder.encodeSymbol(multi_, MULTI);
+                time_.compress(encoder, times(static_cast<int32_t>(MULTI), lastDiff_[last_]), diff, 4);
+                countExtreme(diff);
+            }
+        } else if (multiple < 0) {
+            if (multiple > MULTI_MINUS) {
+                encoder.encodeSymbol(multi_, static_cast<uint32_t>(static_cast<int32_t>(MULTI) - multiple));
+                time_.compress(encoder, times(multiple, lastDiff_[last_]), diff, 5);
+            } else {
+                encoder.encodeSymbol(multi_, static_cast<uint32_t>(static_cast<int32_t>(MULTI) - MULTI_MINUS));
+                time_.compress(encoder, times(MULTI_MINUS, lastDiff_[last_]), diff, 6);
+                countExtreme(diff);
+            }
+        } else {
+            encoder.encodeSymbol(multi_, 0);
+            time_.compress(encoder, 0, diff, 7);
+            countExtreme(diff);
+        }
+    }
+
+    // Start a new sequence with the full 64-bit time: high word predicted from the current sequence, low word raw
+    void startSequence(ArithmeticEncoder& encoder, int64_t time) {
+        const auto bits = static_cast<uint64_t>(time);
+        time_.compress(encoder, static_cast<int32_t>(static_cast<uint64_t>(lastTime_[last_]) >> 32), static_cast<int32_t>(bits >> 32), 8);
+        encoder.writeInt(static_cast<uint32_t>(bits & 0xFFFFFFFF));
+        next_ = (next_ + 1) & 3;
+        last_ = next_;
+        lastDiff_[last_] = 0;
+        extremeCounter_[last_] = 0;
+        lastTime_[last_] = time;
+    }
+
+    void readSequence(ArithmeticDecoder& decoder) {
+        next_ = (next_ + 1) & 3;
+        const auto high = static_cast<uint32_t>(time_.decompress(decoder, static_cast<int32_t>(static_cast<uint64_t>(lastTime_[last_]) >> 32), 8));
+        lastTime_[next_] = static_cast<int64_t>((uint64_t{high} << 32) | decoder.readInt());
+        last_ = next_;
+        lastDiff_[last_] = 0;
+        extremeCounter_[last_] = 0;
+    }
+
+    uint32_t shift_;  // 1 in version 3, whose symbols after the missing "unchanged" one move down by one
+    std::array<int64_t, 4> lastTime_{};  // Bit patterns of the doubles, compared as integers
+    std::array<int32_t, 4> lastDiff_{};
+    std::array<int32_t, 4> extremeCounter_{};
+    uint32_t last_ = 0;
+    uint32_t next_ = 0;
+
+    ArithmeticModel multi_;
+    ArithmeticModel zeroDiff_;
+    IntegerCodec time_{32, 9};
+};
+
+/** @brief LASzip RGB12 item, version 2: byte-wise colour deltas, green and blue predicted from red */
+class Rgb12Codec {
+   public:
+    static constexpr size_t SIZE = 6;
+
+    explicit Rgb12Codec(const uint8_t* first) { std::memcpy(last_.data(), first, SIZE); }
+
+    /** @brief The last colour coded, as record bytes */
+    const uint8_t* last() const { return reinterpret_cast<const uint8_t*>(last_.data()); }
+
+    void encode(ArithmeticEncoder& encoder, const uint8_t* item) {
+        std::array<uint16_t, 3> rgb;
+        std::memcpy(rgb.data(), item, SIZE);
+
+        uint32_t used = ((last_[0] & 0x00FF) != (rgb[0] & 0x00FF) ? 1U : 0U) | ((last_[0] & 0xFF00) != (rgb[0] & 0xFF00) ? 2U : 0U) |
+                        ((last_[1] & 0x00FF) != (rgb[1] & 0x00FF) ? 4U : 0U) | ((last_[1] & 0xFF00) != (rgb[1] & 0xFF00) ? 8U : 0U) |
+                        ((last_[2] & 0x00FF) != (rgb[2] & 0x00FF) ? 16U : 0U) | ((last_[2] & 0xFF00) != (rgb[2] & 0xFF00) ? 32U : 0U);
+        if (rgb[0] != rgb[1] || rgb[0] != rgb[2]) {
+            used |= 64;  // Not grey: green and blue are coded too
+        }
+        encoder.encodeSymbol(byteUsed_, used);
+
+        int32_t diffLow = 0;
+        int32_t diffHigh = 0;
+        if (used & 1) {
+            diffLow = low(rgb[0]) - low(last_[0]);
+            encoder.encodeSymbol(diff_[0], static_cast<uint8_t>(diffLow));
+        }
+        if (used & 2) {
+            diffHigh = high(rgb[0]) - high(last_[0]);
+            encoder.encodeSymbol(diff_[1], static_cast<uint8_t>(diffHigh));
+        }
+        if (used & 64) {
+            if (used & 4) {
+                encoder.encodeSymbol(diff_[2], static_cast<uint8_t>(low(rgb[1]) - clamp(diffLow + low(last_[1]))));
+            }
+            if (used & 16) {
+                diffLow = (diffLow + low(rgb[1]) - low(last_[1])) / 2;
+                encoder.encodeSymbol(diff_[4], static_cast<uint8_t>(low(rgb[2]) - clamp(diffLow + low(last_[2]))));
+            }
+            if (used & 8) {
+                encoder.encodeSymbol(diff_[3], static_cast<uint8_t>(high(rgb[1]) - clamp(diffHigh + high(last_[1]))));
+            }
+            if (used & 32) {
+                diffHigh = (diffHigh + high(rgb[1]) - high(last_[1])) / 2;
+                encoder.encodeSymbol(diff_[5], static_cast<uint8_t>(high(rgb[2]) - clamp(diffHigh + high(last_[2]))));
+            }
+        }
+        last_ = rgb;
+    }
+
+    void decode(ArithmeticDecoder& decoder, uint8_t* item) {
+        std::array<uint16_t, 3> rgb;
+        const uint32_t used = decoder.decodeSymbol(byteUsed_);
+
+        int32_t lo = (used & 1) ? fold(decoder.decodeSymbol(diff_[0]), low(last_[0])) : low(last_[0]);
+        int32_t hi = (used & 2) ? fold(decoder.decodeSymbol(diff_[1]), high(last_[0])) : high(last_[0]);
+        rgb[0] = static_cast<uint16_t>((hi << 8) | lo);
+
+        if (used & 64) {
+            int32_t diff = lo - low(last_[0]);
+            const int32_t greenLow = (used & 4) ? fold(decoder.decodeSymbol(diff_[2]), clamp(diff + low(last_[1]))) : low(last_[1]);
+            int32_t blueLow = low(last_[2]);
+            if (used & 16) {
+                diff = (diff + greenLow - low(last_[1])) / 2;
+                blueLow = fold(decoder.decodeSymbol(diff_[4]), clamp(diff + low(last_[2])));
+            }
+
+            diff = hi - high(last_[0]);
+            const int32_t greenHigh = (used & 8) ? fold(decoder.decodeSymbol(diff_[3]), clamp(diff + high(last_[1]))) : high(last_[1]);
+            int32_t blueHigh = high(last_[2]);
+            if (used & 32) {
+                diff = (diff + greenHigh - high(last_[1])) / 2;
+                blueHigh = fold(decoder.decodeSymbol(diff_[5]), clamp(diff + high(last_[2])));
+            }
+            rgb[1] = static_cast<uint16_t>((greenHigh << 8) | greenLow);
+            rgb[2] = static_cast<uint16_t>((blueHigh << 8) | blueLow);
+        } else {
+            rgb[1] = rgb[2] = rgb[0];
+        }
+
+        std::memcpy(item, rgb.data(), SIZE);
+        last_ = rgb;
+    }
+
+   private:
+    static int32_t low(uint16_t value) { return value & 0xFF; }
+    static int32_t high(uint16_t value) { return value >> 8; }
+    static int32_t clamp(int32_t value) { return std::clamp(value, 0, 255); }
+    static int32_t fold(uint32_t corr, int32_t predicted) { return static_cast<int32_t>((corr + static_cast<uint32_t>(predicted)) & 0xFF); }
+
+    std::array<uint16_t, 3> last_{};
+    ArithmeticModel byteUsed_{128};
+    std::array<ArithmeticModel, 6> diff_{ArithmeticModel(256), ArithmeticModel(256), ArithmeticModel(256), ArithmeticModel(256), ArithmeticModel(256), ArithmeticModel(256)};
+};
+
+/** @brief LASzip BYTE item, version 2: extra bytes coded as deltas to the previous point, one model per byte */
+class ExtraBytesCodec {
+   public:
+    ExtraBytesCodec(const uint8_t* first, size_t size) : last_(first, first + size) {
+        models_.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            models_.emplace_back(256);
+        }
+    }
+
+    void encode(ArithmeticEncoder& encoder, const uint8_t* item) {
+        for (size_t i = 0; i < last_.size(); ++i) {
+            encoder.encodeSymbol(models_[i], static_cast<uint8_t>(item[i] - last_[i]));
+            last_[i] = item[i];
+        }
+    }
+
+    void decode(ArithmeticDecoder& decoder, uint8_t* item) {
+        for (size_t i = 0; i < last_.size(); ++i) {
+            last_[i] = static_cast<uint8_t>(decoder.decodeSymbol(models_[i]) + last_[i]);
+            item[i] = last_[i];
+        }
+    }
+
+   private:
+    std::vector<uint8_t> last_;
+    std::vector<ArithmeticModel> models_;
+};
+
+/**
+ * @brief Coder streams of one layered LAS 1.4 item within a chunk.
+ *
+ * Each group of attributes is coded into its own layer, and the chunk lists the layer sizes
+ * before the layers, so a reader can skip what it does not need. The writer leaves out the
+ * layers whose attributes never changed within the chunk; they read as unchanged.
+ */
+class Layers {
+   public:
+    explicit Layers(size_t count) : bytes_(count), kept_(count, false), sizes_(count, 0), decoders_(count) {
+        encoders_.reserve(count);
+        for (auto& bytes : bytes_) {
+            encoders_.emplace_back(bytes);
+        }
+    }
+
+    ArithmeticEncoder& encoder(size_t layer) { return encoders_[layer]; }
+
+    /** @brief Store a layer in the chunk, as one of its attributes changed */
+    void keep(size_t layer) { kept_[layer] = true; }
+
+    /** @brief Flush the kept layers and append the byte count of every layer, 0 for those left out */
+    void finish(std::vector<uint8_t>& out) {
+        for (size_t i = 0; i < bytes_.size(); ++i) {
+            if (kept_[i]) {
+                encoders_[i].done();
+            } else {
+                bytes_[i].clear();
+            }
+            const auto size = static_cast<uint32_t>(bytes_[i].size());
+            out.insert(out.end(), reinterpret_cast<const uint8_t*>(&size), reinterpret_cast<const uint8_t*>(&size) + sizeof(size));
+        }
+    }
+
+    /** @brief Append the bytes of the layers; call after finish() */
+    void appendBytes(std::vector<uint8_t>& out) const {
+        for (const auto& bytes : bytes_) {
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+    }
+
+    /** @brief Read the layer sizes from the front of `in` and advance past them */
+    bool readSizes(std::span<const uint8_t>& in) {
+        if (in.size() < 4 * sizes_.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < sizes_.size(); ++i) {
+            sizes_[i] = load<uint32_t>(in.data() + 4 * i);
+        }
+        in = in.subspan(4 * sizes_.size());
+        return true;
+    }
+
+    /** @brief Start a decoder on each stored layer from the front of `in` and advance past them */
+    bool readBytes(std::span<const uint8_t>& in) {
+        for (size_t i = 0; i < sizes_.size(); ++i) {
+            if (sizes_[i] > in.size()) {
+                return false;
+            }
+            if (sizes_[i] > 0) {
+                decoders_[i].emplace(in.first(sizes_[i]));
+            }
+            in = in.subspan(sizes_[i]);
+        }
+        return true;
+    }
+
+    /** @brief True if the chunk stores the layer; an absent layer's attributes keep their last values */
+    bool has(size_t layer) const { return decoders_[layer].has_value(); }
+
+    ArithmeticDecoder& decoder(size_t layer) { return *decoders_[layer]; }
+
+    /** @brief True if decoding ran past the end of any layer */
+    bool overrun() const {
+        return std::ranges::any_of(decoders_, [](const auto& decoder) { return decoder && decoder->overrun(); });
+    }
+
+   private:
+    std::vector<std::vector<uint8_t>> bytes_;  // Sized once: the encoders refer to these vectors
+    std::vector<ArithmeticEncoder> encoders_;
+    std::vector<bool> kept_;
+    std::vector<uint32_t> sizes_;
+    std::vector<std::optional<ArithmeticDecoder>> decoders_;
+};
+
+/**
+ * @brief LASzip POINT14 item, version 3: the 30-byte core of point formats 6-10, coded in nine layers.
+ *
+ * Returns and x/y share the first layer; z, classification, flags, intensity, scan angle, user
+ * data, point source and GPS time have one each. Every scanner channel keeps its own
+ * predictors, started from the last point before the scan switched to it, and the channel
+ * selects the context of the items that follow POINT14 in the record.
+ */
+class Point14Codec {
+   public:
+    static constexpr size_t SIZE = 30;
+
+    enum Layer : size_t { RETURNS_XY, Z, CLASSIFICATION, FLAGS, INTENSITY, SCAN_ANGLE, USER_DATA, POINT_SOURCE, GPS_TIME, LAYERS };
+
+    explicit Point14Codec(const uint8_t* first) : current_(channelOf(first)) {
+        contexts_[current_] = std::make_unique<Context>(first);
+        // Like LASzip, always store the coordinate layers, even for a chunk of one point
+        layers_.keep(RETURNS_XY);
+        layers_.keep(Z);
+    }
+
+    Layers& layers() { return layers_; }
+
+    /** @brief Scanner channel of the last record coded */
+    uint32_t context() const { return current_; }
+
+    void encode(const uint8_t* item) {
+        // The previous point's return context picks the model, before any switch of channel
+        Context& previous = *contexts_[current_];
+        const uint32_t lastReturn = returnContext(previous);
+        const uint32_t channel = channelOf(item);
+        const bool channelChanged = channel != current_;
+
+        // Attributes are compared with the last point of the new channel, if it has one
+        const uint8_t* last = channelChanged && contexts_[channel] ? contexts_[channel]->last.data() : previous.last.data();
+        const bool sourceChanged = std::memcmp(last + 20, item + 20, 2) != 0;
+        const bool timeChanged = std::memcmp(last + 22, item + 22, 8) != 0;
+        const bool angleChanged = std::memcmp(last + 18, item + 18, 2) != 0;
+        const uint32_t lastN = last[14] >> 4;
+        const uint32_t lastR = last[14] & 15;
+        const uint32_t n = item[14] >> 4;
+        const uint32_t r = item[14] & 15;
+
+        uint32_t changed = (channelChanged ? 64U : 0U) | (sourceChanged ? 32U : 0U) | (timeChanged ? 16U : 0U) | (angleChanged ? 8U : 0U) | (n != lastN ? 4U : 0U);
+        if (r != lastR) {
+            changed |= r == ((lastR + 1) & 15) ? 1U : (r == ((lastR + 15) & 15) ? 2U : 3U);
+        }
+        ArithmeticEncoder& xy = layers_.encoder(RETURNS_XY);
+        xy.encodeSymbol(previous.changedValues[lastReturn], changed);
+        if (channelChanged) {
+            xy.encodeSymbol(previous.scannerChannel, (channel + 3 - current_) & 3);
+        }
+        Context& c = select(channel);
+
+        if (n != lastN) {
+            xy.encodeSymbol(lazyModel(c.numberOfReturns[lastN], 16), n);
+        }
+        if ((changed & 3) == 3) {
+            if (timeChanged) {
+                xy.encodeSymbol(lazyModel(c.returnNumber[lastR], 16), r);
+            } else {
+                xy.encodeSymbol(c.returnNumberSameTime, (r + 14 - lastR) & 15);  // Steps of 2 to 14 returns
+            }
+        }
+
+        // Coordinates as in POINT10, with separate medians for points that start a new pulse
+        const uint32_t m = RETURN_MAP[n][r];
+        const uint32_t l = returnLevel(n, r);
+        const uint32_t cpr = (r == 1 ? 2U : 0U) | (r >= n ? 1U : 0U);  // First, last, both or neither
+        const uint32_t pulse = timeChanged ? 1U : 0U;
+        const uint32_t single = n == 1 ? 1U : 0U;
+
+        const int32_t dx = static_cast<int32_t>(load<uint32_t>(item) - load<uint32_t>(c.last.data()));
+        c.dx.compress(xy, c.lastXDiff[2 * m + pulse].get(), dx, single);
+        c.lastXDiff[2 * m + pulse].add(dx);
+
+        const int32_t dy = static_cast<int32_t>(load<uint32_t>(item + 4) - load<uint32_t>(c.last.data() + 4));
+        c.dy.compress(xy, c.lastYDiff[2 * m + pulse].get(), dy, single + evenBits(c.dx.getK(), 20));
+        c.lastYDiff[2 * m + pulse].add(dy);
+
+        const auto z = load<int32_t>(item + 8);
+        c.z.compress(layers_.encoder(Z), c.lastZ[l], z, single + evenBits((c.dx.getK() + c.dy.getK()) / 2, 18));
+        c.lastZ[l] = z;
+
+        if (item[16] != c.last[16]) {
+            layers_.keep(CLASSIFICATION);
+        }
+        layers_.encoder(CLASSIFICATION).encodeSymbol(lazyModel(c.classification[classContext(c.last[16], cpr)], 256), item[16]);
+
+        const uint32_t lastFlags = flagsOf(c.last[15]);
+        const uint32_t flags = flagsOf(item[15]);
+        if (flags != lastFlags) {
+            layers_.keep(FLAGS);
+        }
+        layers_.encoder(FLAGS).encodeSymbol(lazyModel(c.flags[lastFlags], 64), flags);
+
+        const auto intensity = load<uint16_t>(item + 12);
+        if (intensity != load<uint16_t>(c.last.data() + 12)) {
+            layers_.keep(INTENSITY);
+        }
+        c.intensity.compress(layers_.encoder(INTENSITY), c.lastIntensity[2 * cpr + pulse], intensity, cpr);
+        c.lastIntensity[2 * cpr + pulse] = intensity;
+
+        if (angleChanged) {
+            layers_.keep(SCAN_ANGLE);
+            c.scanAngle.compress(layers_.encoder(SCAN_ANGLE), load<int16_t>(c.last.data() + 18), load<int16_t>(item + 18), pulse);
+        }
+
+        if (item[17] != c.last[17]) {
+            layers_.keep(USER_DATA);
+        }
+        layers_.encoder(USER_DATA).encodeSymbol(lazyModel(c.userData[c.last[17] / 4], 256), item[17]);
+
+        if (sourceChanged) {
+            layers_.keep(POINT_SOURCE);
+            c.pointSource.compress(layers_.encoder(POINT_SOURCE), load<uint16_t>(c.last.data() + 20), load<uint16_t>(item + 20));
+        }
+
+        if (timeChanged) {
+            layers_.keep(GPS_TIME);
+            c.gpsTime.encode(layers_.encoder(GPS_TIME), item + 22);
+        }
+
+        std::memcpy(c.last.data(), item, SIZE);
+        c.lastTimeChanged = timeChanged;
+    }
+
+    /** @brief Decode the next record; the chunk must store the returns and x/y layer */
+    void decode(uint8_t* item) {
+        ArithmeticDecoder& xy = layers_.decoder(RETURNS_XY);
+        Context* c = contexts_[current_].get();
+        const uint32_t changed = xy.decodeSymbol(c->changedValues[returnContext(*c)]);
+        if (changed & 64) {
+            const uint32_t channel = (current_ + xy.decodeSymbol(c->scannerChannel) + 1) & 3;
+            c = &select(channel);
+            c->last[15] = static_cast<uint8_t>((c->last[15] & 0xCF) | (channel << 4));
+        }
+        uint8_t* last = c->last.data();
+        const bool sourceChanged = (changed & 32) != 0;
+        const bool timeChanged = (changed & 16) != 0;
+        const bool angleChanged = (changed & 8) != 0;
+
+        const uint32_t lastN = last[14] >> 4;
+        const uint32_t lastR = last[14] & 15;
+        const uint32_t n = (changed & 4) ? xy.decodeSymbol(lazyModel(c->numberOfReturns[lastN], 16)) : lastN;
+        uint32_t r = lastR;
+        if ((changed & 3) == 1) {
+            r = (lastR + 1) & 15;
+        } else if ((changed & 3) == 2) {
+            r = (lastR + 15) & 15;
+        } else if ((changed & 3) == 3) {
+            r = timeChanged ? xy.decodeSymbol(lazyModel(c->returnNumber[lastR], 16)) : (lastR + xy.decodeSymbol(c->returnNumberSameTime) + 2) & 15;
+        }
+        last[14] = static_cast<uint8_t>(r | (n << 4));
+
+        const uint32_t m = RETURN_MAP[n][r];
+        const uint32_t l = returnLevel(n, r);
+        const uint32_t cpr = (r == 1 ? 2U : 0U) | (r >= n ? 1U : 0U);
+        const uint32_t pulse = timeChanged ? 1U : 0U;
+        const uint32_t single = n == 1 ? 1U : 0U;
+
+        const int32_t dx = c->dx.decompress(xy, c->lastXDiff[2 * m + pulse].get(), single);
+        store(last, load<uint32_t>(last) + static_cast<uint32_t>(dx));
+        c->lastXDiff[2 * m + pulse].add(dx);
+
+        const int32_t dy = c->dy.decompress(xy, c->lastYDiff[2 * m + pulse].get(), single + evenBits(c->dx.getK(), 20));
+        store(last + 4, load<uint32_t>(last + 4) + static_cast<uint32_t>(dy));
+        c->lastYDiff[2 * m + pulse].add(dy);
+
+        if (layers_.has(Z)) {
+            const int32_t z = c->z.decompress(layers_.decoder(Z), c->lastZ[l], single + evenBits((c->dx.getK() + c->dy.getK()) / 2, 18));
+            store(last + 8, z);
+            c->lastZ[l] = z;
+        }
+        if (layers_.has(CLASSIFICATION)) {
+            last[16] = static_cast<uint8_t>(layers_.decoder(CLASSIFICATION).decodeSymbol(lazyModel(c->classification[classContext(last[16], cpr)], 256)));
+        }
+        if (layers_.has(FLAGS)) {
+            const uint32_t flags = layers_.decoder(FLAGS).decodeSymbol(lazyModel(c->flags[flagsOf(last[15])], 64));
+            last[15] = static_cast<uint8_t>((flags & 0x0F) | (last[15] & 0x30) | ((flags & 0x30) << 2));
+        }
+        if (layers_.has(INTENSITY)) {
+            uint16_t& intensity = c->lastIntensity[2 * cpr + pulse];
+            intensity = static_cast<uint16_t>(c->intensity.decompress(layers_.decoder(INTENSITY), intensity, cpr));
+            store(last + 12, intensity);
+        }
+        if (angleChanged && layers_.has(SCAN_ANGLE)) {
+            store(last + 18, static_cast<uint16_t>(c->scanAngle.decompress(layers_.decoder(SCAN_ANGLE), load<int16_t>(last + 18), pulse)));
+        }
+        if (layers_.has(USER_DATA)) {
+            last[17] = static_cast<uint8_t>(layers_.decoder(USER_DATA).decodeSymbol(lazyModel(c->userData[last[17] / 4], 256)));
+        }
+        if (sourceChanged && layers_.has(POINT_SOURCE)) {
+            store(last + 20, static_cast<uint16_t>(c->pointSource.decompress(layers_.decoder(POINT_SOURCE), load<uint16_t>(last + 20))));
+        }
+        if (timeChanged && layers_.has(GPS_TIME)) {
+            c->gpsTime.decode(layers_.decoder(GPS_TIME), last + 22);
+        }
+
+        std::memcpy(item, last, SIZE);
+        c->lastTimeChanged = timeChanged;
+    }
+
+   private:
+    // Predictors and models of one scanner channel, started from the last record before it
+    struct Context {
+        explicit Context(const uint8_t* first) : gpsTime(first + 22, 3) {
+            std::memcpy(last.data(), first, SIZE);
+            lastIntensity.fill(load<uint16_t>(first + 12));
+            lastZ.fill(load<int32_t>(first + 8));
+        }
+
+        std::array<uint8_t, SIZE> last{};
+        bool lastTimeChanged = false;
+        std::array<uint16_t, 8> lastIntensity{};
+        std::array<StreamingMedian5, 12> lastXDiff{};
+        std::array<StreamingMedian5, 12> lastYDiff{};
+        std::array<int32_t, 8> lastZ{};
+
+        std::vector<ArithmeticModel> changedValues = std::vector<ArithmeticModel>(8, ArithmeticModel(128));
+        ArithmeticModel scannerChannel{3};
+        std::array<std::unique_ptr<ArithmeticModel>, 16> numberOfReturns;
+        std::array<std::unique_ptr<ArithmeticModel>, 16> returnNumber;
+        ArithmeticModel returnNumberSameTime{13};
+        IntegerCodec dx{32, 2};
+        IntegerCodec dy{32, 22};
+        IntegerCodec z{32, 20};
+        std::array<std::unique_ptr<ArithmeticModel>, 64> classification;
+        std::array<std::unique_ptr<ArithmeticModel>, 64> flags;
+        std::array<std::unique_ptr<ArithmeticModel>, 64> userData;
+        IntegerCodec intensity{16, 4};
+        IntegerCodec scanAngle{16, 2};
+        IntegerCodec pointSource{16, 1};
+        GpsTime11Codec gpsTime;
+    };
+
+    // Up to 15 returns mapped to 6 coordinate contexts: single, first and last of two, then first, intermediate and last
+    static constexpr uint8_t RETURN_MAP[16][16] = {
+        {0, 1, 2, 3, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5, 5, 5}, {1, 0, 1, 3, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5, 5, 5}, {2, 1, 2, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5},
+        {3, 3, 4, 5, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5, 5, 5}, {4, 3, 4, 4, 5, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5, 5}, {5, 3, 4, 4, 4, 5, 4, 5, 3, 4, 4, 5, 5, 5, 5, 5},
+        {3, 3, 4, 4, 4, 4, 5, 4, 5, 3, 4, 4, 5, 5, 5, 5}, {4, 3, 4, 4, 4, 4, 4, 5, 4, 5, 3, 4, 4, 5, 5, 5}, {4, 3, 4, 4, 4, 4, 4, 4, 5, 4, 5, 3, 4, 4, 5, 5},
+        {5, 3, 4, 4, 4, 4, 4, 4, 4, 5, 4, 5, 3, 4, 4, 5}, {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 5, 4, 5, 3, 4, 4}, {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 4, 5, 3, 4},
+        {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 4, 5, 3}, {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 4, 5}, {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 4},
+        {5, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5}};
+
+    // Height level: how many returns r is from the last one, at most 7
+    static uint32_t returnLevel(uint32_t n, uint32_t r) { return std::min(n > r ? n - r : r - n, 7U); }
+
+    static uint32_t channelOf(const uint8_t* record) { return (record[15] >> 4) & 3; }
+
+    // Edge of flight line, scan direction and the four classification flags
+    static uint32_t flagsOf(uint8_t byte) { return ((byte >> 2) & 0x30U) | (byte & 0x0FU); }
+
+    static uint32_t classContext(uint8_t lastClass, uint32_t cpr) { return ((lastClass & 0x1FU) << 1) | (cpr == 3 ? 1U : 0U); }
+
+    static uint32_t evenBits(uint32_t k, uint32_t cap) { return k < cap ? (k & ~1U) : cap; }
+
+    // Single, first, last or intermediate return of the channel's last point, and whether its time changed
+    static uint32_t returnContext(const Context& c) {
+        const uint32_t r = c.last[14] & 15;
+        const uint32_t n = c.last[14] >> 4;
+        return (r == 1 ? 1U : 0U) | (r >= n ? 2U : 0U) | (c.lastTimeChanged ? 4U : 0U);
+    }
+
+    Context& select(uint32_t channel) {
+        if (!contexts_[channel]) {
+            contexts_[channel] = std::make_unique<Context>(contexts_[current_]->last.data());
+        }
+        current_ = channel;
+        return *contexts_[channel];
+    }
+
+    Layers layers_{LAYERS};
+    uint32_t current_;
+    std::array<std::unique_ptr<Context>, 4> contexts_;
+};
+
+/** @brief LASzip RGB14 and RGBNIR14 items, version 3: RGB12's colour coding per scanner channel in one layer, NIR byte deltas in a second */
+class Rgb14Codec {
+   public:
+    enum Layer : size_t { RGB, NIR };
+
+    Rgb14Codec(const uint8_t* first, bool nir, uint32_t context) : nir_(nir), layers_(nir ? 2 : 1), current_(context) {
+        contexts_[context] = std::make_unique<Context>(first, nir);
+    }
+
+    Layers& layers() { return layers_; }
+
+    void encode(const uint8_t* item, uint32_t context) {
+        Context& c = select(context);
+        if (std::memcmp(c.rgb.last(), item, Rgb12Codec::SIZE) != 0) {
+            layers_.keep(RGB);
+        }
+        c.rgb.encode(layers_.encoder(RGB), item);
+        if (!nir_) {
+            return;
+        }
+
+        const auto nir = load<uint16_t>(item + Rgb12Codec::SIZE);
+        const uint32_t used = ((nir ^ c.nir) & 0x00FF ? 1U : 0U) | ((nir ^ c.nir) & 0xFF00 ? 2U : 0U);
+        if (used != 0) {
+            layers_.keep(NIR);
+        }
+        ArithmeticEncoder& encoder = layers_.encoder(NIR);
+        encoder.encodeSymbol(c.nirUsed, used);
+        if (used & 1) {
+            encoder.encodeSymbol(c.nirDiff[0], static_cast<uint8_t>((nir & 0xFF) - (c.nir & 0xFF)));
+        }
+        if (used & 2) {
+            encoder.encodeSymbol(c.nirDiff[1], static_cast<uint8_t>((nir >> 8) - (c.nir >> 8)));
+        }
+        c.nir = nir;
+    }
+
+    void decode(uint8_t* item, uint32_t context) {
+        Context& c = select(context);
+        if (layers_.has(RGB)) {
+            c.rgb.decode(layers_.decoder(RGB), item);
+        } else {
+            std::memcpy(item, c.rgb.last(), Rgb12Codec::SIZE);
+        }
+        if (!nir_) {
+            return;
+        }
+
+        if (layers_.has(NIR)) {
+            ArithmeticDecoder& decoder = layers_.decoder(NIR);
+            const uint32_t used = decoder.decodeSymbol(c.nirUsed);
+            const uint32_t low = (used & 1) ? (decoder.decodeSymbol(c.nirDiff[0]) + (c.nir & 0xFFU)) & 0xFF : c.nir & 0xFFU;
+            const uint32_t high = (used & 2) ? (decoder.decodeSymbol(c.nirDiff[1]) + (c.nir >> 8)) & 0xFF : c.nir >> 8U;
+            c.nir = static_cast<uint16_t>((high << 8) | low);
+        }
+        store(item + Rgb12Codec::SIZE, c.nir);
+    }
+
+   private:
+    struct Context {
+        Context(const uint8_t* first, bool hasNir) : rgb(first), nir(hasNir ? load<uint16_t>(first + Rgb12Codec::SIZE) : uint16_t{0}) {}
+
+        Rgb12Codec rgb;
+        uint16_t nir;
+        ArithmeticModel nirUsed{4};
+        std::array<ArithmeticModel, 2> nirDiff{ArithmeticModel(256), ArithmeticModel(256)};
+    };
+
+    Context& select(uint32_t channel) {
+        if (!contexts_[channel]) {
+            std::array<uint8_t, Rgb12Codec::SIZE + 2> last;
+            std::memcpy(last.data(), contexts_[current_]->rgb.last(), Rgb12Codec::SIZE);
+            store(last.data() + Rgb12Codec::SIZE, contexts_[current_]->nir);
+            contexts_[channel] = std::make_unique<Context>(last.data(), nir_);
+        }
+        current_ = channel;
+        return *contexts_[channel];
+    }
+
+    bool nir_;
+    Layers layers_;
+    uint32_t current_;
+    std::array<std::unique_ptr<Context>, 4> contexts_;
+};
+
+/** @brief LASzip BYTE14 item, version 3: BYTE's per-byte deltas per scanner channel, each byte in its own layer */
+class Byte14Codec {
+   public:
+    Byte14Codec(const uint8_t* first, size_t size, uint32_t context) : layers_(size), current_(context) { contexts_[context] = std::make_unique<Context>(first, size); }
+
+    Layers& layers() { return layers_; }
+
+    void encode(const uint8_t* item, uint32_t context) {
+        Context& c = select(context);
+        for (size_t i = 0; i < c.last.size(); ++i) {
+            if (item[i] != c.last[i]) {
+                layers_.keep(i);
+            }
+            layers_.encoder(i).encodeSymbol(c.models[i], static_cast<uint8_t>(item[i] - c.last[i]));
+            c.last[i] = item[i];
+        }
+    }
+
+    void decode(uint8_t* item, uint32_t context) {
+        Context& c = select(context);
+        for (size_t i = 0; i < c.last.size(); ++i) {
+            if (layers_.has(i)) {
+                c.last[i] = static_cast<uint8_t>(layers_.decoder(i).decodeSymbol(c.models[i]) + c.last[i]);
+            }
+            item[i] = c.last[i];
+        }
+    }
+
+   private:
+    struct Context {
+        Context(const uint8_t* first, size_t size) : last(first, first + size), models(size, ArithmeticModel(256)) {}
+
+        std::vector<uint8_t> last;
+        std::vector<ArithmeticModel> models;
+    };
+
+    Context& select(uint32_t channel) {
+        if (!contexts_[channel]) {
+            const auto& last = contexts_[current_]->last;
+            contexts_[channel] = std::make_unique<Context>(last.data(), last.size());
+        }
+        current_ = channel;
+        return *contexts_[channel];
+    }
+
+    Layers layers_;
+    uint32_t current_;
+    std::array<std::unique_ptr<Context>, 4> contexts_;
+};
+
+}  // namespace laz
+
+/**
+ * @brief LASzip-compatible compression of LAS point records (LAZ).
+ *
+ * Point data is split into chunks of a fixed number of points, each coded independently:
+ * the first record is stored raw, the others as residuals through an adaptive arithmetic
+ * coder. Chunks can therefore be compressed and decompressed in parallel; a table at the
+ * end of the point data gives their compressed sizes.
+ *
+ * Point formats 0-3 use the point-wise items (POINT10, GPSTIME11, RGB12 and extra BYTEs,
+ * version 2, compressor 2). Formats 6-8 use the layered LAS 1.4 items (POINT14, RGB14 or
+ * RGBNIR14 and BYTE14, version 3, compressor 3), whose chunks store a point count and a
+ * table of layer sizes after the raw first record. Formats 4, 5, 9 and 10 carry wave
+ * packets, which are not implemented.
+ * Reference: https://github.com/LASzip/LASzip
+ */
+class LAZCodec {
+   public:
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 50000;
+    static constexpr uint32_t VARIABLE_CHUNK_SIZE = 0xFFFFFFFF;
+    static constexpr uint16_t VLR_RECORD_ID = 22204;
+    static constexpr std::string_view VLR_USER_ID = "laszip encoded";
+
+    static constexpr uint16_t POINTWISE_CHUNKED = 2;
+    static constexpr uint16_t LAYERED_CHUNKED = 3;
+
+    enum class ItemType : uint16_t { BYTE = 0, POINT10 = 6, GPSTIME11 = 7, RGB12 = 8, POINT14 = 10, RGB14 = 11, RGBNIR14 = 12, BYTE14 = 14 };
+
+    struct Item {
+        uint16_t type;
+        uint16_t size;
+        uint16_t version;
+    };
+
+    /** @brief Contents of the LASzip VLR describing how the point records were compressed */
+    struct Parameters {
+        uint16_t compressor = POINTWISE_CHUNKED;
+        uint16_t coder = 0;       // 0 = arithmetic
+        uint8_t versionMajor = 2;
+        uint8_t versionMinor = 2;
+        uint16_t versionRevision = 0;
+        uint32_t options = 0;
+        uint32_t chunkSize = DEFAULT_CHUNK_SIZE;
+        int64_t numberOfSpecialEVLRs = -1;
+        int64_t offsetToSpecialEVLRs = -1;
+        std::vector<Item> items;
+
+        /** @brief Bytes of one uncompressed record */
+        size_t recordLength() const {
+            size_t length = 0;
+            for (const auto& item : items) {
+                length += item.size;
+            }
+            return length;
+        }
+
+        /**
+         * @brief True if this codec can handle the item list, in this order: POINT10, optional GPSTIME11,
+         * RGB12 and BYTE, point-wise; or POINT14, optional RGB14 or RGBNIR14 and BYTE14, layered
+         */
+        bool isSupported() const {
+            if (coder != 0 || items.empty()) {
+                return false;
+            }
+            size_t i = 1;
+            if (compressor == POINTWISE_CHUNKED && is(items[0], ItemType::POINT10, laz::Point10Codec::SIZE, 2)) {
+                if (i < items.size() && is(items[i], ItemType::GPSTIME11, laz::GpsTime11Codec::SIZE, 2)) {
+                    ++i;
+                }
+                if (i < items.size() && is(items[i], ItemType::RGB12, laz::Rgb12Codec::SIZE, 2)) {
+                    ++i;
+                }
+                if (i < items.size() && is(items[i], ItemType::BYTE, items[i].size, 2) && items[i].size > 0) {
+                    ++i;
+                }
+            } else if (compressor == LAYERED_CHUNKED && is(items[0], ItemType::POINT14, laz::Point14Codec::SIZE, 3)) {
+                if (i < items.size() && (is(items[i], ItemType::RGB14, laz::Rgb12Codec::SIZE, 3) || is(items[i], ItemType::RGBNIR14, laz::Rgb12Codec::SIZE + 2, 3))) {
+                    ++i;
+                }
+                if (i < items.size() && is(items[i], ItemType::BYTE14, items[i].size, 3) && items[i].size > 0) {
+                    ++i;
+                }
+            } else {
+                return false;
+            }
+            return i == items.size();
+        }
+
+        /** @brief True for the layered LAS 1.4 items, whose chunks start with a point count and a table of layer sizes */
+        bool isLayered() const { return compressor == LAYERED_CHUNKED; }
+
+        /** @brief Serialize as the payload of the LASzip VLR */
+        std::vector<uint8_t> serialize() const {
+            std::vector<uint8_t> payload;
+            payload.reserve(34 + 6 * items.size());
+            auto put = [&payload](auto value) {
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+                payload.insert(payload.end(), bytes, bytes + sizeof(value));
+            };
+            put(compressor);
+            put(coder);
+            put(versionMajor);
+            put(versionMinor);
+            put(versionRevision);
+            put(options);
+            put(chunkSize);
+            put(numberOfSpecialEVLRs);
+            put(offsetToSpecialEVLRs);
+            put(static_cast<uint16_t>(items.size()));
+            for (const auto& item : items) {
+                put(item.type);
+                put(item.size);
+                put(item.version);
+            }
+            return payload;
+        }
+
+        /**
+         * @brief Parse the payload of the LASzip VLR
+         * @return Parameters, std::nullopt if the payload is too short for its item count
+         */
+        static std::optional<Parameters> parse(std::span<const uint8_t> payload) {
+            if (payload.size() < 34) {
+                return std::nullopt;
+            }
+            Parameters parameters;
+            const uint8_t* p = payload.data();
+            auto get = [&p](auto& value) {
+                value = laz::load<std::remove_reference_t<decltype(value)>>(p);
+                p += sizeof(value);
+            };
+            get(parameters.compressor);
+            get(parameters.coder);
+            get(parameters.versionMajor);
+            get(parameters.versionMinor);
+            get(parameters.versionRevision);
+            get(parameters.options);
+            get(parameters.chunkSize);
+            get(parameters.numberOfSpecialEVLRs);
+            get(parameters.offsetToSpecialEVLRs);
+            uint16_t count = 0;
+            get(count);
+            if (payload.size() < 34 + 6 * size_t{count}) {
+                return std::nullopt;
+            }
+            parameters.items.resize(count);
+            for (auto& item : parameters.items) {
+                get(item.type);
+                get(item.size);
+                get(item.version);
+            }
+            return parameters;
+        }
+
+        /**
+         * @brief Items for a LAS point format and record length, extra bytes coded as one BYTE or BYTE14 item
+         * @return Parameters, std::nullopt for formats other than 0-3 and 6-8 or records shorter than the format
+         */
+        static std::optional<Parameters> forPointFormat(uint8_t format, uint16_t recordLength) {
+            Parameters parameters;
+            ItemType extraBytes = ItemType::BYTE;
+            uint16_t version = 2;
+            if (format <= 3) {
+                parameters.items.push_back({static_cast<uint16_t>(ItemType::POINT10), laz::Point10Codec::SIZE, 2});
+                if (format == 1 || format == 3) {
+                    parameters.items.push_back({static_cast<uint16_t>(ItemType::GPSTIME11), laz::GpsTime11Codec::SIZE, 2});
+                }
+                if (format == 2 || format == 3) {
+                    parameters.items.push_back({static_cast<uint16_t>(ItemType::RGB12), laz::Rgb12Codec::SIZE, 2});
+                }
+            } else if (format >= 6 && format <= 8) {
+                // LASzip writes its own version 3.4 revision 3 into the VLR of layered files
+                parameters.compressor = LAYERED_CHUNKED;
+                parameters.versionMajor = 3;
+                parameters.versionMinor = 4;
+                parameters.versionRevision = 3;
+                extraBytes = ItemType::BYTE14;
+                version = 3;
+                parameters.items.push_back({static_cast<uint16_t>(ItemType::POINT14), laz::Point14Codec::SIZE, 3});
+                if (format == 7) {
+                    parameters.items.push_back({static_cast<uint16_t>(ItemType::RGB14), laz::Rgb12Codec::SIZE, 3});
+                } else if (format == 8) {
+                    parameters.items.push_back({static_cast<uint16_t>(ItemType::RGBNIR14), laz::Rgb12Codec::SIZE + 2, 3});
+                }
+            } else {
+                return std::nullopt;
+            }
+            const size_t core = parameters.recordLength();
+            if (recordLength < core) {
+                return std::nullopt;
+            }
+            if (recordLength > core) {
+                parameters.items.push_back({static_cast<uint16_t>(extraBytes), static_cast<uint16_t>(recordLength - core), version});
+            }
+            return parameters;
+        }
+
+       private:
+        static bool is(const Item& item, ItemType type, size_t size, uint16_t version) {
+            return item.type == static_cast<uint16_t>(type) && item.size == size && item.version == version;
+        }
+    };
+
+    /** @brief Location of one compressed chunk and the points it holds */
+    struct Chunk {
+        uint64_t firstPoint = 0;
+        uint64_t points = 0;
+        uint64_t offset = 0;  // From the start of the file
+        uint64_t bytes = 0;
+    };
+
+    /**
+     * @brief Compress consecutive records into one chunk
+     * @param records count * recordLength() bytes of uncompressed records, count >= 1
+     * @param parameters Supported item list
+     * @param out Receives the chunk, replacing its contents
+     */
+    static void compressChunk(std::span<const uint8_t> records, const Parameters& parameters, std::vector<uint8_t>& out) {
+        out.clear();
+        const size_t stride = parameters.recordLength();
+        if (records.size() < stride) {
+            return;
+        }
+
+        // The first record is stored raw and seeds the predictors
+        out.assign(records.begin(), records.begin() + static_cast<ptrdiff_t>(stride));
+        if (parameters.isLayered()) {
+            LayeredItemCodecs codecs(records.data(), parameters);
+            for (size_t offset = stride; offset + stride <= records.size(); offset += stride) {
+                codecs.encode(records.data() + offset);
+            }
+            const auto points = static_cast<uint32_t>(records.size() / stride);
+            out.insert(out.end(), reinterpret_cast<const uint8_t*>(&points), reinterpret_cast<const uint8_t*>(&points) + sizeof(points));
+            codecs.finish(out);
+            return;
+        }
+
+        ItemCodecs codecs(records.data(), parameters);
+        std::vector<uint8_t> coded;
+        coded.reserve(records.size() / 4);
+        laz::ArithmeticEncoder encoder(coded);
+        for (size_t offset = stride; offset + stride <= records.size(); offset += stride) {
+            codecs.encode(encoder, records.data() + offset);
+        }
+        encoder.done();
+        out.insert(out.end(), coded.begin(), coded.end());
+    }
+
+    /**
+     * @brief Decompress one chunk
+     * @param chunk Compressed bytes of the chunk
+     * @param parameters Supported item list
+     * @param records Destination for the chunk's records; its size gives the point count
+     * @return False if the chunk is too short for its records, or a layered chunk holds another point count
+     */
+    static bool decompressChunk(std::span<const uint8_t> chunk, const Parameters& parameters, std::span<uint8_t> records) {
+        const size_t stride = parameters.recordLength();
+        if (records.empty()) {
+            return true;
+        }
+        if (chunk.size() < stride) {
+            return false;
+        }
+
+        std::memcpy(records.data(), chunk.data(), stride);
+        if (parameters.isLayered()) {
+            const size_t points = records.size() / stride;
+            std::span<const uint8_t> rest = chunk.subspan(stride);
+            if (rest.size() < 4 || laz::load<uint32_t>(rest.data()) != points) {
+                return false;
+            }
+            rest = rest.subspan(4);
+            LayeredItemCodecs codecs(records.data(), parameters);
+            if (!codecs.read(rest, points)) {
+                return false;
+            }
+            for (size_t offset = stride; offset + stride <= records.size(); offset += stride) {
+                codecs.decode(records.data() + offset);
+            }
+            return !codecs.overrun();
+        }
+
+        ItemCodecs codecs(records.data(), parameters);
+        laz::ArithmeticDecoder decoder(chunk.subspan(stride));
+        for (size_t offset = stride; offset + stride <= records.size(); offset += stride) {
+            codecs.decode(decoder, records.data() + offset);
+        }
+        return !decoder.overrun();
+    }
+
+    /**
+     * @brief Serialize the chunk table written after the last chunk
+     * @param chunkBytes Compressed size of each chunk, in file order
+     * @param chunkPoints Point count of each chunk, only stored for VARIABLE_CHUNK_SIZE
+     * @param out Receives the table, replacing its contents
+     */
+    static void writeChunkTable(std::span<const uint64_t> chunkBytes, std::span<const uint64_t> chunkPoints, std::vector<uint8_t>& out) {
+        out.assign(8, 0);
+        laz::store<uint32_t>(out.data() + 4, static_cast<uint32_t>(chunkBytes.size()));  // Version 0, then the chunk count
+        if (chunkBytes.empty()) {
+            return;
+        }
+        laz::ArithmeticEncoder encoder(out);
+        laz::IntegerCodec sizes(32, 2);
+        for (size_t i = 0; i < chunkBytes.size(); ++i) {
+            if (!chunkPoints.empty()) {
+                sizes.compress(encoder, i > 0 ? static_cast<int32_t>(chunkPoints[i - 1]) : 0, static_cast<int32_t>(chunkPoints[i]), 0);
+            }
+            sizes.compress(encoder, i > 0 ? static_cast<int32_t>(chunkBytes[i - 1]) : 0, static_cast<int32_t>(chunkBytes[i]), 1);
+        }
+        encoder.done();
+    }
+
+    /**
+     * @brief Parse a chunk table and lay the chunks out in the file
+     * @param table Bytes from the start of the chunk table
+     * @param parameters Provides the chunk size
+     * @param totalPoints Point count of the file
+     * @param firstChunk File offset of the first chunk
+     * @return Chunks in file order, std::nullopt if the table is malformed or does not cover totalPoints
+     */
+    static std::optional<std::vector<Chunk>> readChunkTable(std::span<const uint8_t> table, const Parameters& parameters, uint64_t totalPoints, uint64_t firstChunk) {
+        if (table.size() < 8 || laz::load<uint32_t>(table.data()) != 0) {
+            return std::nullopt;
+        }
+        const auto count = laz::load<uint32_t>(table.data() + 4);
+        const bool variable = parameters.chunkSize == VARIABLE_CHUNK_SIZE;
+        if (!variable && (parameters.chunkSize == 0 || count != (totalPoints + parameters.chunkSize - 1) / parameters.chunkSize)) {
+            return std::nullopt;
+        }
+
+        if (count == 0) {
+            // No chunks means no coded sizes, and the writer emits no coder flush bytes either
+            return totalPoints == 0 ? std::optional<std::vector<Chunk>>{std::in_place} : std::nullopt;
+        }
+
+        std::vector<Chunk> chunks(count);
+        laz::ArithmeticDecoder decoder(table.subspan(8));
+        laz::IntegerCodec sizes(32, 2);
+        uint32_t previousPoints = 0;
+        uint32_t previousBytes = 0;
+        uint64_t firstPoint = 0;
+        uint64_t offset = firstChunk;
+        for (auto& chunk : chunks) {
+            if (variable) {
+                previousPoints = static_cast<uint32_t>(sizes.decompress(decoder, static_cast<int32_t>(previousPoints), 0));
+                chunk.points = previousPoints;
+            } else {
+                chunk.points = std::min<uint64_t>(parameters.chunkSize, totalPoints - firstPoint);
+            }
+            previousBytes = static_cast<uint32_t>(sizes.decompress(decoder, static_cast<int32_t>(previousBytes), 1));
+            chunk.bytes = previousBytes;
+            chunk.firstPoint = firstPoint;
+            chunk.offset = offset;
+            firstPoint += chunk.points;
+            offset += chunk.bytes;
+        }
+        if (decoder.overrun() || firstPoint != totalPoints) {
+            return std::nullopt;
+        }
+        return chunks;
+    }
+
+   private:
+    // Codecs of one record's items, in item order and laid out back to back as in the record
+    class ItemCodecs {
+       public:
+        ItemCodecs(const uint8_t* first, const Parameters& parameters) : point_(first) {
+            size_t offset = laz::Point10Codec::SIZE;
+            for (size_t i = 1; i < parameters.items.size(); ++i) {
+                const auto& item = parameters.items[i];
+                if (item.type == static_cast<uint16_t>(ItemType::GPSTIME11)) {
+                    gpsTime_.emplace(first + offset);
+                    gpsOffset_ = offset;
+                } else if (item.type == static_cast<uint16_t>(ItemType::RGB12)) {
+                    rgb_.emplace(first + offset);
+                    rgbOffset_ = offset;
+                } else {
+                    extra_.emplace(first + offset, item.size);
+                    extraOffset_ = offset;
+                }
+                offset += item.size;
+            }
+        }
+
+        void encode(laz::ArithmeticEncoder& encoder, const uint8_t* record) {
+            point_.encode(encoder, record);
+            if (gpsTime_) {
+                gpsTime_->encode(encoder, record + gpsOffset_);
+            }
+            if (rgb_) {
+                rgb_->encode(encoder, record + rgbOffset_);
+            }
+            if (extra_) {
+                extra_->encode(encoder, record + extraOffset_);
+            }
+        }
+
+        void decode(laz::ArithmeticDecoder& decoder, uint8_t* record) {
+            point_.decode(decoder, record);
+            if (gpsTime_) {
+                gpsTime_->decode(decoder, record + gpsOffset_);
+            }
+            if (rgb_) {
+                rgb_->decode(decoder, record + rgbOffset_);
+            }
+            if (extra_) {
+                extra_->decode(decoder, record + extraOffset_);
+            }
+        }
+
+       private:
+        laz::Point10Codec point_;
+        std::optional<laz::GpsTime11Codec> gpsTime_;
+        std::optional<laz::Rgb12Codec> rgb_;
+        std::optional<laz::ExtraBytesCodec> extra_;
+        size_t gpsOffset_ = 0;
+        size_t rgbOffset_ = 0;
+        size_t extraOffset_ = 0;
+    };
+
+    // Codecs of one layered record's items; the scanner channel of POINT14 selects the context of the others
+    class LayeredItemCodecs {
+       public:
+        LayeredItemCodecs(const uint8_t* first, const Parameters& parameters) : point_(first) {
+            size_t offset = laz::Point14Codec::SIZE;
+            for (size_t i = 1; i < parameters.items.size(); ++i) {
+                const auto& item = parameters.items[i];
+                if (item.type == static_cast<uint16_t>(ItemType::BYTE14)) {
+                    extra_.emplace(first + offset, item.size, point_.context());
+                    extraOffset_ = offset;
+                } else {
+                    rgb_.emplace(first + offset, item.type == static_cast<uint16_t>(ItemType::RGBNIR14), point_.context());
+                    rgbOffset_ = offset;
+                }
+                offset += item.size;
+            }
+        }
+
+        void encode(const uint8_t* record) {
+            point_.encode(record);
+            if (rgb_) {
+                rgb_->encode(record + rgbOffset_, point_.context());
+            }
+            if (extra_) {
+                extra_->encode(record + extraOffset_, point_.context());
+            }
+        }
+
+        void decode(uint8_t* record) {
+            point_.decode(record);
+            if (rgb_) {
+                rgb_->decode(record + rgbOffset_, point_.context());
+            }
+            if (extra_) {
+                extra_->decode(record + extraOffset_, point_.context());
+            }
+        }
+
+        /** @brief Append the layer sizes of all items, then their layers */
+        void finish(std::vector<uint8_t>& out) {
+            forEachLayers([&out](laz::Layers& layers) { layers.finish(out); });
+            forEachLayers([&out](laz::Layers& layers) { layers.appendBytes(out); });
+        }
+
+        /** @brief Read the layer sizes and layers following the point count; more than one point needs the returns and x/y layer */
+        bool read(std::span<const uint8_t>& in, size_t points) {
+            bool ok = true;
+            forEachLayers([&](laz::Layers& layers) { ok = ok && layers.readSizes(in); });
+            forEachLayers([&](laz::Layers& layers) { ok = ok && layers.readBytes(in); });
+            return ok && (points <= 1 || point_.layers().has(laz::Point14Codec::RETURNS_XY));
+        }
+
+        bool overrun() {
+            bool overrun = false;
+            forEachLayers([&overrun](laz::Layers& layers) { overrun = overrun || layers.overrun(); });
+            return overrun;
+        }
+
+       private:
+        template <typename F>
+        void forEachLayers(F&& f) {
+            f(point_.layers());
+            if (rgb_) {
+                f(rgb_->layers());
+            }
+            if (extra_) {
+                f(extra_->layers());
+            }
+        }
+
+        laz::Point14Codec point_;
+        std::optional<laz::Rgb14Codec> rgb_;
+        std::optional<laz::Byte14Codec> extra_;
+        size_t rgbOffset_ = 0;
+        size_t extraOffset_ = 0;
+    };
+};
+
+}  // namespace scanforge::codec
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "tooling/Parallel.hpp"
+
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <span>
 #include <vector>
 
@@ -16,52 +20,82 @@ class LZFCodec {
    public:
     /**
      * @brief Decompress LZF compressed data.
+     *
+     * Tokens are decoded without bounds checks while more than a token's worth of input and
+     * output slack remains: literal runs are copied 32 bytes at a time and back-references
+     * 16 or 8 bytes at a time, over-copying into the slack that the next tokens overwrite.
+     * Short overlapping offsets repeat their pattern until it spans a full copy width. The
+     * last tokens near either end take the fully checked path.
+     *
      * @param compressed Span of compressed data
      * @param output Span of output buffer
      * @return Number of bytes decompressed, or 0 on failure
      */
     static size_t decompress(std::span<const uint8_t> compressed, std::span<uint8_t> output) {
-        auto ip = compressed.begin();
-        auto op = output.begin();
-        const auto in_end = compressed.end();
-        const auto out_end = output.end();
-        const auto out_start = op;
+        const uint8_t* ip = compressed.data();
+        uint8_t* op = output.data();
+        const uint8_t* const inEnd = ip + compressed.size();
+        uint8_t* const outEnd = op + output.size();
+        uint8_t* const outStart = op;
+
+        while (inEnd - ip >= static_cast<ptrdiff_t>(FAST_INPUT_SLACK) && outEnd - op >= static_cast<ptrdiff_t>(FAST_OUTPUT_SLACK)) {
+            const uint8_t ctrl = *ip++;
+
+            if (ctrl < 32) {  // Literal run: ctrl + 1 bytes, copied as a full MAX_LIT block
+                std::memcpy(op, ip, MAX_LIT);
+                ip += ctrl + 1;
+                op += ctrl + 1;
+                continue;
+            }
+
+            size_t len = ctrl >> 5;
+            if (len == 7) {  // Extended length
+                len += *ip++;
+            }
+            const size_t offset = static_cast<size_t>(((ctrl & 0x1f) << 8) + *ip++ + 1);
+            if (static_cast<size_t>(op - outStart) < offset) {
+                return 0;  // Error: invalid back reference
+            }
+            len += 2;
+            copyMatch(op, offset, len);
+            op += len;
+        }
 
-        while (ip != in_end && op != out_end) {
+        while (ip != inEnd && op != outEnd) {
             const uint8_t ctrl = *ip++;
 
             if (ctrl < 32) {  // Literal run: ctrl + 1 bytes
                 const size_t run_len = ctrl + 1;
 
-                if (std::distance(op, out_end) < static_cast<ptrdiff_t>(run_len) || std::distance(ip, in_end) < static_cast<ptrdiff_t>(run_len)) {
+                if (static_cast<size_t>(outEnd - op) < run_len || static_cast<size_t>(inEnd - ip) < run_len) {
                     return 0;  // Error: not enough data or space
                 }
 
-                std::copy_n(ip, run_len, op);
-                ip += static_cast<ptrdiff_t>(run_len);
-                op += static_cast<ptrdiff_t>(run_len);
+                std::memcpy(op, ip, run_len);
+                ip += run_len;
+                op += run_len;
             } else {  // Back reference
                 uint32_t len = ctrl >> 5;
 
-                if (ip == in_end)
+                if (ip == inEnd)
                     return 0;  // Error: truncated input
 
                 if (len == 7) {  // Extended length
                     len += *ip++;
-                    if (ip == in_end)
+                    if (ip == inEnd)
                         return 0;  // Error: truncated input
                 }
 
                 const size_t offset = static_cast<size_t>(((ctrl & 0x1f) << 8) + *ip++ + 1);
 
-                if (std::distance(out_start, op) < static_cast<ptrdiff_t>(offset)) {
+                if (static_cast<size_t>(op - outStart) < offset) {
                     return 0;  // Error: invalid back reference
                 }
 
-                auto ref = op - static_cast<ptrdiff_t>(offset);
+                const uint8_t* ref = op - offset;
                 const size_t copy_len = len + 2;
 
-                if (std::distance(op, out_end) < static_cast<ptrdiff_t>(copy_len)) {
+                if (static_cast<size_t>(outEnd - op) < copy_len) {
                     return 0;  // Error: not enough space for back reference
                 }
 
@@ -71,7 +105,7 @@ class LZFCodec {
                 }
             }
         }
-        return static_cast<size_t>(std::distance(out_start, op));
+        return static_cast<size_t>(op - outStart);
     }
 
     /**
@@ -91,56 +125,177 @@ class LZFCodec {
         return uncompressed;
     }
 
+    /**
+     * @brief Decompress LZF data into a caller-owned buffer, resized to expectedSize.
+     *
+     * Reusing one buffer from call to call, or giving it a pooled std::pmr allocator, spares
+     * the allocation the vector-returning overload makes every time.
+     *
+     * @param compressed Span of compressed data
+     * @param expectedSize Expected size of uncompressed data
+     * @param output Receives the data; a std::vector or std::pmr::vector of uint8_t
+     * @return True if exactly expectedSize bytes were decompressed
+     */
+    template <typename Buffer>
+    static bool decompress(std::span<const uint8_t> compressed, size_t expectedSize, Buffer& output) {
+        output.resize(expectedSize);
+        return decompress(compressed, std::span<uint8_t>(output)) == expectedSize;
+    }
+
+    /**
+     * @brief Compression effort, mirroring liblzf's VERY_FAST build and its best-ratio build.
+     * Both levels produce standard LZF streams readable by any LZF decoder (PCL included);
+     * Fast only rehashes the two bytes before a match end instead of every matched position.
+     */
+    enum class Level : uint8_t { Fast, Normal };
+
     /**
      * @brief Compress data using LZF algorithm.
+     *
+     * Single-probe hash table over 3-byte prefixes as in liblzf 3.6: back-references reach
+     * up to 8 KB behind the cursor and up to 264 bytes long (extended length byte past 8).
+     * The output is byte-identical to lzf_compress() built with HLOG=16 for the same level.
+     *
      * @param input Span of input data
      * @param output Span of output buffer
-     * @return Number of bytes compressed, or 0 on failure
+     * @param level Speed/ratio trade-off
+     * @return Number of bytes compressed, or 0 on failure (empty input or output too small)
      */
-    static size_t compress(std::span<const uint8_t> input, std::span<uint8_t> output) {
-        auto ip = input.begin();
-        auto op = output.begin();
-        const auto in_end = input.end();
-        const auto out_end = output.end();
-        const auto out_start = op;
-
-        // Simple literal-only compression for reliability
-        while (ip != in_end) {
-            // Collect literals into runs (max 31 per run)
-            const auto literal_start = ip;
-            size_t literal_count = 0;
-
-            while (ip != in_end && literal_count < 31) {
+    static size_t compress(std::span<const uint8_t> input, std::span<uint8_t> output, Level level = Level::Normal) {
+        const size_t inLen = input.size();
+        const size_t outLen = output.size();
+        if (inLen == 0 || outLen == 0) {
+            return 0;
+        }
+
+        const uint8_t* in = input.data();
+        uint8_t* out = output.data();
+
+        // Positions are stored relative to the input start; 0 doubles as "empty slot" since a
+        // match at offset 0 is never taken (same convention as liblzf's zero-initialised table).
+        std::vector<uint32_t> hashTable(HASH_SIZE, 0);
+
+        size_t ip = 0;
+        size_t op = 1;  // Reserve the control byte of the first literal run
+        size_t lit = 0;
+
+        uint32_t hval = inLen >= 2 ? first(in) : 0;
+        while (ip + 2 < inLen) {
+            hval = next(hval, in + ip);
+            uint32_t& slot = hashTable[hashIndex(hval, level)];
+            const size_t ref = slot;
+            slot = static_cast<uint32_t>(ip);
+
+            size_t off = 0;
+            if (ref < ip && (off = ip - ref - 1) < MAX_OFF && ref > 0 && in[ref + 2] == in[ip + 2] && in[ref] == in[ip] && in[ref + 1] == in[ip + 1]) {
+                // Match found: extend it as far as the window and MAX_REF allow
+                size_t len = 2;
+                const size_t maxLen = std::min(inLen - ip - len, MAX_REF);
+
+                if (op - (lit == 0 ? 1 : 0) + 3 + 1 >= outLen) {
+                    return 0;  // Not enough space
+                }
+
+                out[op - lit - 1] = static_cast<uint8_t>(lit - 1);  // Close the pending literal run
+                op -= (lit == 0 ? 1 : 0);                             // ...or drop it if it is empty
+
+                do {
+                    ++len;
+                } while (len < maxLen && in[ref + len] == in[ip + len]);
+
+                len -= 2;  // Encoded length is octets - 2
                 ++ip;
-                ++literal_count;
-            }
 
-            // Check if we have enough output space
-            if (std::distance(op, out_end) < static_cast<ptrdiff_t>(literal_count + 1)) {
-                return 0;  // Not enough space
+                if (len < 7) {
+                    out[op++] = static_cast<uint8_t>((off >> 8) + (len << 5));
+                } else {
+                    out[op++] = static_cast<uint8_t>((off >> 8) + (7 << 5));
+                    out[op++] = static_cast<uint8_t>(len - 7);
+                }
+                out[op++] = static_cast<uint8_t>(off);
+
+                lit = 0;
+                ++op;  // Start a new literal run
+
+                ip += len + 1;
+                if (ip + 2 >= inLen) {
+                    break;
+                }
+
+                if (level == Level::Fast) {
+                    // Only seed the two positions preceding the new cursor
+                    ip -= 2;
+                    hval = first(in + ip);
+                    for (int k = 0; k < 2; ++k) {
+                        hval = next(hval, in + ip);
+                        hashTable[hashIndex(hval, level)] = static_cast<uint32_t>(ip);
+                        ++ip;
+                    }
+                } else {
+                    // Seed every position covered by the match for better future matches
+                    ip -= len + 1;
+                    do {
+                        hval = next(hval, in + ip);
+                        hashTable[hashIndex(hval, level)] = static_cast<uint32_t>(ip);
+                        ++ip;
+                    } while (len--);
+                }
+            } else {
+                if (op >= outLen) {
+                    return 0;  // Not enough space
+                }
+
+                ++lit;
+                out[op++] = in[ip++];
+
+                if (lit == MAX_LIT) {
+                    out[op - lit - 1] = static_cast<uint8_t>(lit - 1);
+                    lit = 0;
+                    ++op;
+                }
             }
+        }
+
+        // At most 3 trailing bytes remain, plus the pending control byte
+        if (op + 3 > outLen) {
+            return 0;
+        }
 
-            // Output literal run header
-            *op++ = static_cast<uint8_t>(literal_count - 1);
+        while (ip < inLen) {
+            ++lit;
+            out[op++] = in[ip++];
 
-            // Copy literal bytes
-            op = std::copy(literal_start, ip, op);
+            if (lit == MAX_LIT) {
+                out[op - lit - 1] = static_cast<uint8_t>(lit - 1);
+                lit = 0;
+                ++op;
+            }
         }
 
-        return static_cast<size_t>(std::distance(out_start, op));
+        out[op - lit - 1] = static_cast<uint8_t>(lit - 1);
+        op -= (lit == 0 ? 1 : 0);
+
+        return op;
     }
 
     /**
-     * @brief Compress data from a vector.
-     * @param uncompressed Vector containing uncompressed data
+     * @brief Worst-case compressed size for a given input length.
+     * Incompressible input costs one control byte per 32 literals; the constant covers the
+     * last partial run and the room compress() checks for before committing to a match.
+     */
+    static constexpr size_t maxCompressedSize(size_t inputSize) { return inputSize + inputSize / MAX_LIT + 16; }
+
+    /**
+     * @brief Compress data into a new vector.
+     * @param uncompressed Data to compress
+     * @param level Speed/ratio trade-off
      * @return Vector with compressed data, or empty vector on failure
      */
-    static std::vector<uint8_t> compress(const std::vector<uint8_t>& uncompressed) {
+    static std::vector<uint8_t> compress(std::span<const uint8_t> uncompressed, Level level = Level::Normal) {
         // Allocate buffer with extra space for worst-case scenario
-        size_t maxCompressedSize = uncompressed.size() + (uncompressed.size() >> 3) + 16;
-        std::vector<uint8_t> compressed(maxCompressedSize);
+        std::vector<uint8_t> compressed(maxCompressedSize(uncompressed.size()));
 
-        size_t compressedSize = compress(uncompressed, compressed);
+        size_t compressedSize = compress(uncompressed, compressed, level);
 
         if (compressedSize == 0) {
             return {};  // Compression failed
@@ -150,13 +305,166 @@ class LZFCodec {
         return compressed;
     }
 
+    /**
+     * @brief Compress data as independent LZF blocks, spreading the blocks over threads.
+     *
+     * Every block is a complete LZF stream of blockSize input bytes (the last one may be
+     * shorter), so blocks can later be decompressed in any order and in parallel. Matches
+     * never cross a block boundary, which costs a little ratio on small blocks.
+     *
+     * @param input Data to compress
+     * @param blockSize Uncompressed bytes per block
+     * @param blockSizes Receives the compressed size of every block, in input order
+     * @param threadCount Threads compressing blocks; 0 uses every hardware thread
+     * @param level Speed/ratio trade-off
+     * @return The blocks back to back, or empty vector on failure
+     */
+    static std::vector<uint8_t> compressBlocks(std::span<const uint8_t> input, size_t blockSize, std::vector<uint32_t>& blockSizes, unsigned threadCount = 1,
+                                               Level level = Level::Normal) {
+        blockSizes.clear();
+        if (input.empty() || blockSize == 0) {
+            return {};
+        }
+        const size_t blocks = (input.size() + blockSize - 1) / blockSize;
+        const size_t slot = maxCompressedSize(blockSize);
+
+        // Each block gets a worst-case slot, the slots are then packed in order
+        std::vector<uint8_t> output(blocks * slot);
+        blockSizes.resize(blocks);
+        const bool ok = forEachBlock(blocks, threadCount, [&](size_t i) {
+            const auto block = input.subspan(i * blockSize, std::min(blockSize, input.size() - i * blockSize));
+            const size_t size = compress(block, std::span(output).subspan(i * slot, slot), level);
+            blockSizes[i] = static_cast<uint32_t>(size);
+            return size > 0;
+        });
+        if (!ok) {
+            blockSizes.clear();
+            return {};
+        }
+
+        size_t packed = 0;
+        for (size_t i = 0; i < blocks; ++i) {
+            std::memmove(output.data() + packed, output.data() + i * slot, blockSizes[i]);
+            packed += blockSizes[i];
+        }
+        output.resize(packed);
+        return output;
+    }
+
+    /**
+     * @brief Decompress blocks written by compressBlocks(), spreading the blocks over threads.
+     * @param compressed The blocks back to back
+     * @param blockSizes Compressed size of every block
+     * @param output Receives the data; its size selects the expected block count
+     * @param blockSize Uncompressed bytes per block, the last block may be shorter
+     * @param threadCount Threads decompressing blocks; 0 uses every hardware thread
+     * @return True if every block filled exactly its part of output
+     */
+    static bool decompressBlocks(std::span<const uint8_t> compressed, std::span<const uint32_t> blockSizes, std::span<uint8_t> output, size_t blockSize,
+                                 unsigned threadCount = 1) {
+        if (blockSize == 0 || blockSizes.size() != (output.size() + blockSize - 1) / blockSize) {
+            return false;
+        }
+
+        std::vector<size_t> offsets(blockSizes.size() + 1, 0);
+        for (size_t i = 0; i < blockSizes.size(); ++i) {
+            offsets[i + 1] = offsets[i] + blockSizes[i];
+        }
+        if (offsets.back() > compressed.size()) {
+            return false;
+        }
+
+        return forEachBlock(blockSizes.size(), threadCount, [&](size_t i) {
+            const auto block = output.subspan(i * blockSize, std::min(blockSize, output.size() - i * blockSize));
+            return decompress(compressed.subspan(offsets[i], blockSizes[i]), block) == block.size();
+        });
+    }
+
     // Legacy pointer-based interface for compatibility
     static size_t decompress(const uint8_t* compressed, size_t compressedSize, uint8_t* uncompressed, size_t uncompressedSize) {
         return decompress(std::span{compressed, compressedSize}, std::span{uncompressed, uncompressedSize});
     }
 
-    static size_t compress(const uint8_t* uncompressed, size_t uncompressedSize, uint8_t* compressed, size_t compressedCapacity) {
-        return compress(std::span{uncompressed, uncompressedSize}, std::span{compressed, compressedCapacity});
+    static size_t compress(const uint8_t* uncompressed, size_t uncompressedSize, uint8_t* compressed, size_t compressedCapacity, Level level = Level::Normal) {
+        return compress(std::span{uncompressed, uncompressedSize}, std::span{compressed, compressedCapacity}, level);
+    }
+
+   private:
+    static constexpr unsigned HASH_LOG = 16;
+    static constexpr size_t HASH_SIZE = size_t{1} << HASH_LOG;
+    static constexpr size_t MAX_LIT = size_t{1} << 5;                   // Longest literal run
+    static constexpr size_t MAX_OFF = size_t{1} << 13;                  // 8 KB back-reference window
+    static constexpr size_t MAX_REF = (size_t{1} << 8) + (size_t{1} << 3);  // Longest match
+
+    // A literal token reads 1 + MAX_LIT bytes at most, a back-reference writes MAX_REF + 2 rounded up to a 16-byte copy
+    static constexpr size_t FAST_INPUT_SLACK = 1 + MAX_LIT;
+    static constexpr size_t FAST_OUTPUT_SLACK = MAX_REF + 2 + 16;
+
+    /**
+     * Copy a back-reference of len bytes starting offset bytes behind op, possibly writing up to
+     * 15 bytes past op + len. Offsets of a copy width or more copy whole words that never
+     * overlap; shorter offsets that overlap their own output repeat the pattern until a multiple
+     * of the offset spans 8 bytes, after which 8-byte copies are exact again.
+     */
+    static void copyMatch(uint8_t* op, size_t offset, size_t len) {
+        const uint8_t* ref = op - offset;
+        if (offset >= 16) {
+            for (size_t i = 0; i < len; i += 16) {
+                std::memcpy(op + i, ref + i, 16);
+            }
+            return;
+        }
+        if (offset >= 8) {
+            for (size_t i = 0; i < len; i += 8) {
+                std::memcpy(op + i, ref + i, 8);
+            }
+            return;
+        }
+        if (len <= offset) {
+            // The match itself does not overlap, only the over-copied tail does: load before storing
+            uint64_t word;
+            std::memcpy(&word, ref, sizeof(word));
+            std::memcpy(op, &word, sizeof(word));
+            return;
+        }
+        if (offset == 1) {
+            std::memset(op, *ref, len);
+            return;
+        }
+
+        const size_t distance = offset * ((8 + offset - 1) / offset);  // Smallest multiple of offset >= 8
+        size_t done = 0;
+        for (; done < std::min(len, distance); ++done) {
+            op[done] = ref[done];
+        }
+        for (; done < len; done += 8) {
+            std::memcpy(op + done, op + done - distance, 8);
+        }
+    }
+
+    // Run work(i) for every block, threads taking the next block as they finish; stops at the first failure
+    template <typename Work>
+    static bool forEachBlock(size_t blocks, unsigned threadCount, Work&& work) {
+        std::atomic<size_t> nextBlock = 0;
+        std::atomic<bool> ok = true;
+        auto run = [&] {
+            for (size_t i = nextBlock++; i < blocks && ok; i = nextBlock++) {
+                if (!work(i)) {
+                    ok = false;
+                }
+            }
+        };
+
+        tooling::runWorkers(static_cast<unsigned>(std::min<size_t>(tooling::availableThreads(threadCount), blocks)), run);
+        return ok;
+    }
+
+    static uint32_t first(const uint8_t* p) { return (static_cast<uint32_t>(p[0]) << 8) | p[1]; }
+    static uint32_t next(uint32_t v, const uint8_t* p) { return (v << 8) | p[2]; }
+
+    static size_t hashIndex(uint32_t h, Level level) {
+        const uint32_t idx = level == Level::Fast ? ((h >> (3 * 8 - HASH_LOG)) - h * 5) : (((h ^ (h << 5)) >> (3 * 8 - HASH_LOG)) - h * 5);
+        return idx & (HASH_SIZE - 1);
     }
 };
 
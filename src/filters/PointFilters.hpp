@@ -0,0 +1,172 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "spatial/Geometry.hpp"
+#include "spatial/KdTree.hpp"
+#include "spatial/VoxelGrid.hpp"
+#include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Point cloud filters: voxel-grid downsampling and statistical outlier removal
+ *
+ * Filters read one cloud and write another; output may be the input cloud itself. Non-finite
+ * points never reach the output, which is always dense and unorganized (height 1).
+ */
+namespace scanforge::filters {
+using Log = scanforge::tooling::Log;
+
+namespace detail {
+
+inline constexpr size_t MIN_VOXELS_PER_THREAD = 16384;
+inline constexpr size_t MIN_QUERIES_PER_THREAD = 4096;
+
+template <typename PointT>
+void finishCloud(PointCloud<PointT>& cloud) {
+    cloud.width = static_cast<uint32_t>(cloud.size());
+    cloud.height = 1;
+    cloud.is_dense = true;
+}
+
+/** @brief Mean of the points of one voxel; colors are averaged and rounded */
+template <typename PointT>
+PointT centroidOf(const spatial::VoxelGrid<PointT>& grid, const typename spatial::VoxelGrid<PointT>::Voxel& voxel, const PointCloud<PointT>& cloud) {
+    double x = 0, y = 0, z = 0;
+    for (const Point3D& p : grid.positions(voxel)) {
+        x += static_cast<double>(p.x);
+        y += static_cast<double>(p.y);
+        z += static_cast<double>(p.z);
+    }
+    const double count = voxel.count;
+    const Point3D mean{static_cast<float>(x / count), static_cast<float>(y / count), static_cast<float>(z / count)};
+
+    if constexpr (std::is_same_v<PointT, PointXYZRGB>) {
+        uint64_t r = 0, g = 0, b = 0;
+        for (uint32_t index : grid.indices(voxel)) {
+            r += cloud[index].color.r;
+            g += cloud[index].color.g;
+            b += cloud[index].color.b;
+        }
+        const auto average = [&](uint64_t sum) { return static_cast<uint8_t>((sum + voxel.count / 2) / voxel.count); };
+        return PointXYZRGB(mean, RGB(average(r), average(g), average(b)));
+    } else {
+        static_cast<void>(cloud);
+        return mean;
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Replace the points of every occupied voxel by their centroid
+ * @param input Cloud to downsample
+ * @param output Receives one point per occupied voxel, in Morton order of the voxels
+ * @param voxelSize Edge length of the voxels
+ * @param threadCount Threads indexing and averaging; 0 uses every hardware thread
+ * @return False for an invalid voxel size (see spatial::VoxelGrid::build)
+ */
+template <typename PointT>
+bool voxelDownsample(const PointCloud<PointT>& input, PointCloud<PointT>& output, float voxelSize, unsigned threadCount = 1) {
+    SCANFORGE_PROFILE_SCOPE("filter.voxel");
+    spatial::VoxelGrid<PointT> grid;
+    if (!grid.build(input, voxelSize, threadCount)) {
+        return false;
+    }
+
+    const auto voxels = grid.voxels();
+    PointCloud<PointT> result(output.memoryResource());  // Moved into output below without a copy
+    result.points.resize(voxels.size());
+    const unsigned threads = tooling::workerThreads(voxels.size(), threadCount, detail::MIN_VOXELS_PER_THREAD);
+    tooling::parallelSlices(voxels.size(), threads, [&](size_t first, size_t count) {
+        for (size_t v = first; v < first + count; ++v) {
+            result.points[v] = detail::centroidOf(grid, voxels[v], input);
+        }
+    });
+    detail::finishCloud(result);
+
+    Log::debug("Voxel downsampling at {}: {} points -> {}", voxelSize, input.size(), result.size());
+    output = std::move(result);
+    return true;
+}
+
+/**
+ * @brief Remove points whose mean distance to their neighbours is unusually large
+ *
+ * For every point the mean distance to its meanK nearest neighbours is computed on a KD-tree.
+ * Points are kept while that distance is at most the mean over the cloud plus
+ * stddevMultiplier standard deviations.
+ *
+ * @param input Cloud to filter
+ * @param output Receives the inliers, in their input order
+ * @param meanK Neighbours per point, at least 1
+ * @param stddevMultiplier Threshold in standard deviations above the mean distance
+ * @param threadCount Threads building the tree and querying it; 0 uses every hardware thread
+ * @return False if meanK is 0 or the cloud cannot be indexed
+ */
+template <typename PointT>
+bool removeStatisticalOutliers(const PointCloud<PointT>& input, PointCloud<PointT>& output, size_t meanK = 8, double stddevMultiplier = 1.0,
+                               unsigned threadCount = 1) {
+    SCANFORGE_PROFILE_SCOPE("filter.outliers");
+    if (meanK == 0) {
+        Log::error("Statistical outlier removal needs at least one neighbour");
+        return false;
+    }
+    spatial::KdTree<PointT> tree;
+    if (!tree.build(input, threadCount)) {
+        return false;
+    }
+
+    // The first neighbour of a point is the point itself, or a duplicate at the same distance
+    std::vector<float> meanDistances(input.size(), std::nanf(""));
+    const unsigned threads = tooling::workerThreads(input.size(), threadCount, detail::MIN_QUERIES_PER_THREAD);
+    tooling::parallelSlices(input.size(), threads, [&](size_t first, size_t count) {
+        std::vector<typename spatial::KdTree<PointT>::Neighbor> neighbors;
+        for (size_t i = first; i < first + count; ++i) {
+            const Point3D& p = getPosition(input.points[i]);
+            if (!spatial::isFinite(p)) {
+                continue;
+            }
+            tree.knnSearch(p, meanK + 1, neighbors);
+            double sum = 0;
+            for (size_t n = 1; n < neighbors.size(); ++n) {
+                sum += std::sqrt(static_cast<double>(neighbors[n].squaredDistance));
+            }
+            meanDistances[i] = neighbors.size() > 1 ? static_cast<float>(sum / static_cast<double>(neighbors.size() - 1)) : 0.0f;
+        }
+    });
+
+    double sum = 0, sumOfSquares = 0;
+    for (float distance : meanDistances) {
+        if (!std::isnan(distance)) {
+            sum += static_cast<double>(distance);
+            sumOfSquares += static_cast<double>(distance) * static_cast<double>(distance);
+        }
+    }
+    const double finite = static_cast<double>(tree.size());
+    const double mean = finite > 0 ? sum / finite : 0.0;
+    const double variance = finite > 1 ? std::max(0.0, (sumOfSquares - sum * mean) / (finite - 1)) : 0.0;
+    const double threshold = mean + stddevMultiplier * std::sqrt(variance);
+
+    PointCloud<PointT> result(tree.size(), output.memoryResource());
+    for (size_t i = 0; i < input.size(); ++i) {
+        if (!std::isnan(meanDistances[i]) && static_cast<double>(meanDistances[i]) <= threshold) {
+            result.push_back(input.points[i]);
+        }
+    }
+    detail::finishCloud(result);
+
+    Log::debug("Statistical outlier removal (k = {}, threshold {:.4f}): {} points -> {}", meanK, threshold, input.size(), result.size());
+    output = std::move(result);
+    return true;
+}
+
+}  // namespace scanforge::filters
@@ -0,0 +1,989 @@
+#pragma once
+
+#include "tooling/Logger.hpp"
+#include "tooling/Profiler.hpp"
+#include "tooling/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <streambuf>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #if defined(__linux__) && __has_include(<linux/io_uring.h>)
+        #define SCANFORGE_HAS_IO_URING 1
+        #include <linux/io_uring.h>
+        // Pulled in through <linux/fs.h>, and too common a name to leave defined
+        #undef BLOCK_SIZE
+        #undef BLOCK_SIZE_BITS
+        #include <sys/mman.h>
+        #include <sys/syscall.h>
+    #endif
+#endif
+
+namespace scanforge::io {
+
+/** @brief Kernel interface an AsyncFile queues its requests with */
+enum class IOBackend {
+    Auto,        // IoUring on Linux when the kernel allows it, Overlapped on Windows, Threads elsewhere
+    Threads,     // Blocking positioned reads and writes on a shared pool of I/O threads
+    IoUring,     // Linux io_uring
+    Overlapped,  // Windows overlapped I/O
+};
+
+/** @brief How an asynchronous stream moves its bytes */
+struct AsyncOptions {
+    IOBackend backend = IOBackend::Auto;
+    size_t blockSize = size_t{1} << 20;  // Bytes per request
+    unsigned depth = 4;                  // Requests kept in flight
+};
+
+/**
+ * @brief File with positioned reads and writes that complete in the background
+ *
+ * Requests are queued in numbered slots, one request per slot at a time: read() or write()
+ * starts one and returns at once, wait() blocks until it completed. With several slots
+ * queued the kernel, or the I/O threads, work on all of them while the caller decodes, which
+ * hides the latency of each request on network storage.
+ *
+ * An AsyncFile belongs to one thread. Buffers handed to read() and write() must stay valid
+ * until wait() returned for their slot; close() and the destructor wait for every slot.
+ *
+ * @code
+ * io::AsyncFile file;
+ * file.open("scan.las", io::AsyncFile::Mode::Read, io::IOBackend::Auto, 2);
+ * file.read(0, 0, first);
+ * file.read(1, first.size(), second);
+ * auto bytes = file.wait(0);  // The second read is still under way
+ * @endcode
+ */
+class AsyncFile {
+   public:
+    enum class Mode {
+        Read,
+        Write,  // Creates the file, truncating an existing one
+    };
+
+    AsyncFile() = default;
+    ~AsyncFile() { close(); }
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    /** @brief True if the backend can be used in this build and on this system */
+    static bool available(IOBackend backend) {
+        switch (backend) {
+            case IOBackend::Auto:
+            case IOBackend::Threads:
+                return true;
+            case IOBackend::IoUring:
+#ifdef SCANFORGE_HAS_IO_URING
+            {
+                // Kernels older than 5.6, seccomp filters and kernel.io_uring_disabled all refuse a ring
+                static const bool usable = [] {
+                    Ring ring;
+                    return ring.setup(1);
+                }();
+                return usable;
+            }
+#else
+                return false;
+#endif
+            case IOBackend::Overlapped:
+#ifdef _WIN32
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    /**
+     * @brief Open a file for asynchronous reads or writes, closing any previous file first
+     * @param path File to open
+     * @param mode Read an existing file, or create one to write
+     * @param backend Interface to queue requests with; Auto picks the best available one
+     * @param slots Requests that can be in flight at once, at least 1
+     * @return True if the file is open
+     */
+    bool open(const std::filesystem::path& path, Mode mode, IOBackend backend, unsigned slots) {
+        close();
+        const bool automatic = backend == IOBackend::Auto;
+        if (automatic) {
+#ifdef _WIN32
+            backend = IOBackend::Overlapped;
+#else
+            backend = available(IOBackend::IoUring) ? IOBackend::IoUring : IOBackend::Threads;
+#endif
+        }
+        if (!available(backend)) {
+            tooling::Log::error("I/O backend {} is not available on this system", backendName(backend));
+            return false;
+        }
+
+#ifdef _WIN32
+        const DWORD access = mode == Mode::Read ? GENERIC_READ : GENERIC_WRITE;
+        const DWORD disposition = mode == Mode::Read ? OPEN_EXISTING : CREATE_ALWAYS;
+        handle_ = CreateFileW(path.c_str(), access, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle_ == INVALID_HANDLE_VALUE) {
+            tooling::Log::error("Failed to open file: {}", path.string());
+            return false;
+        }
+#else
+        fd_ = mode == Mode::Read ? ::open(path.c_str(), O_RDONLY | O_CLOEXEC) : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd_ < 0) {
+            tooling::Log::error("Failed to open file: {}", path.string());
+            return false;
+        }
+        if (mode == Mode::Read) {
+            ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+
+        slots_ = std::vector<Slot>(std::max(1u, slots));
+#ifdef _WIN32
+        for (auto& slot : slots_) {
+            slot.event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        }
+#endif
+#ifdef SCANFORGE_HAS_IO_URING
+        if (backend == IOBackend::IoUring && !ring_.setup(static_cast<unsigned>(slots_.size()))) {
+            // Rings count against RLIMIT_MEMLOCK on older kernels, so many open files may run out
+            if (!automatic) {
+                tooling::Log::error("Failed to set up an io_uring for: {}", path.string());
+                close();
+                return false;
+            }
+            backend = IOBackend::Threads;
+        }
+#endif
+        backend_ = backend;
+        return true;
+    }
+
+    /** @brief Wait for every request, then close the file; safe to call on a closed file */
+    void close() {
+        for (unsigned slot = 0; slot < slots_.size(); ++slot) {
+            if (slots_[slot].busy) {
+                wait(slot);
+            }
+        }
+#ifdef SCANFORGE_HAS_IO_URING
+        ring_.reset();
+#endif
+#ifdef _WIN32
+        for (auto& slot : slots_) {
+            if (slot.event != nullptr) {
+                CloseHandle(slot.event);
+            }
+        }
+        if (handle_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(handle_);
+        }
+        handle_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+#endif
+        slots_.clear();
+    }
+
+    bool is_open() const {
+#ifdef _WIN32
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    /** @brief Backend the open file queues its requests with */
+    IOBackend backend() const { return backend_; }
+
+    unsigned slots() const { return static_cast<unsigned>(slots_.size()); }
+
+    /** @brief Current size of the file, 0 if it cannot be queried */
+    uint64_t size() const {
+#ifdef _WIN32
+        LARGE_INTEGER fileSize{};
+        return GetFileSizeEx(handle_, &fileSize) ? static_cast<uint64_t>(fileSize.QuadPart) : 0;
+#else
+        struct stat fileStat{};
+        return ::fstat(fd_, &fileStat) == 0 ? static_cast<uint64_t>(fileStat.st_size) : 0;
+#endif
+    }
+
+    /** @brief True while the slot holds a request not yet waited for */
+    bool busy(unsigned slot) const { return slots_[slot].busy; }
+
+    /**
+     * @brief Start reading buffer.size() bytes at offset into buffer
+     * @return False if the slot is in use or the file is not open
+     */
+    bool read(unsigned slot, uint64_t offset, std::span<uint8_t> buffer) { return start(slot, Mode::Read, offset, buffer.data(), buffer.size()); }
+
+    /** @brief Start writing buffer at offset; the bytes must not change until wait() */
+    bool write(unsigned slot, uint64_t offset, std::span<const uint8_t> buffer) {
+        return start(slot, Mode::Write, offset, const_cast<uint8_t*>(buffer.data()), buffer.size());
+    }
+
+    /**
+     * @brief Wait until the request of a slot completed and free the slot
+     * @return Bytes transferred, fewer than asked only for a read reaching the end of the file;
+     *         nullopt if the request failed or the slot held none
+     */
+    std::optional<size_t> wait(unsigned slot) {
+        Slot& s = slots_[slot];
+        if (!s.busy) {
+            return std::nullopt;
+        }
+        SCANFORGE_PROFILE_SCOPE("io.wait");
+        // Requests may complete partially: the rest is queued again until done, or until a read hits the end of the file
+        bool failed = false;
+        while (true) {
+            const int64_t result = complete(slot);
+            if (result < 0 || (result == 0 && s.mode == Mode::Write)) {
+                failed = true;
+                break;
+            }
+            s.done += static_cast<size_t>(result);
+            if (result == 0 || s.done == s.size) {
+                break;
+            }
+            issue(slot);
+        }
+        s.busy = false;
+        if (failed) {
+            tooling::Log::error("Asynchronous {} of {} bytes at offset {} failed", s.mode == Mode::Read ? "read" : "write", s.size, s.offset);
+            return std::nullopt;
+        }
+        return s.done;
+    }
+
+    static const char* backendName(IOBackend backend) {
+        switch (backend) {
+            case IOBackend::Auto:
+                return "auto";
+            case IOBackend::Threads:
+                return "threads";
+            case IOBackend::IoUring:
+                return "io_uring";
+            case IOBackend::Overlapped:
+                return "overlapped";
+        }
+        return "unknown";
+    }
+
+   private:
+    static constexpr unsigned IO_THREADS = 8;            // Shared by every file on the Threads backend
+    static constexpr size_t MAX_REQUEST = size_t{1} << 30;  // Larger requests are split, as Win32 counts in DWORDs
+
+    struct Slot {
+        Mode mode = Mode::Read;
+        uint64_t offset = 0;
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t done = 0;      // Bytes transferred by the completed parts
+        bool busy = false;
+        bool complete = false;  // The part under way has completed, with result
+        int64_t result = 0;     // Bytes of that part, negative on failure
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        HANDLE event = nullptr;
+#endif
+    };
+
+#ifdef SCANFORGE_HAS_IO_URING
+    // Submission and completion rings shared with the kernel, driven through the raw system calls
+    class Ring {
+       public:
+        Ring() = default;
+        ~Ring() { reset(); }
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+
+        bool setup(unsigned entries) {
+            reset();
+            io_uring_params params{};
+            fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (fd_ < 0) {
+                return false;
+            }
+            // IORING_OP_READ and IORING_OP_WRITE came with the same kernel as this feature
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+                reset();
+                return false;
+            }
+
+            sqSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) {
+                sqSize_ = cqSize_ = std::max(sqSize_, cqSize_);
+            }
+            sq_ = map(sqSize_, IORING_OFF_SQ_RING);
+            cq_ = single ? sq_ : map(cqSize_, IORING_OFF_CQ_RING);
+            sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+            sqes_ = static_cast<io_uring_sqe*>(map(sqesSize_, IORING_OFF_SQES));
+            if (sq_ == nullptr || cq_ == nullptr || sqes_ == nullptr) {
+                reset();
+                return false;
+            }
+            singleMap_ = single;
+
+            auto* sq = static_cast<uint8_t*>(sq_);
+            auto* cq = static_cast<uint8_t*>(cq_);
+            sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void reset() {
+            if (sqes_ != nullptr) {
+                ::munmap(sqes_, sqesSize_);
+            }
+            if (cq_ != nullptr && !singleMap_) {
+                ::munmap(cq_, cqSize_);
+            }
+            if (sq_ != nullptr) {
+                ::munmap(sq_, sqSize_);
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+            sq_ = cq_ = nullptr;
+            sqes_ = nullptr;
+            singleMap_ = false;
+            fd_ = -1;
+        }
+
+        // Queue one read or write and hand it to the kernel; false if the kernel refused it
+        bool submit(uint8_t opcode, int file, uint64_t offset, uint8_t* data, uint32_t size, uint64_t tag) {
+            const unsigned tail = *sqTail_;  // Only this thread moves the tail
+            const unsigned index = tail & sqMask_;
+            io_uring_sqe& sqe = sqes_[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = opcode;
+            sqe.fd = file;
+            sqe.off = offset;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = size;
+            sqe.user_data = tag;
+            sqArray_[index] = index;
+            std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+            while (true) {
+                const long submitted = ::syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0);
+                if (submitted >= 0 || errno != EINTR) {
+                    return submitted == 1;
+                }
+            }
+        }
+
+        // Hand every completion to done(tag, result); with wait set, block until there is one
+        template <typename Done>
+        bool reap(bool wait, Done&& done) {
+            unsigned head = *cqHead_;
+            unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            if (head == tail && wait) {
+                if (::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                    return false;
+                }
+                tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            }
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                done(cqe.user_data, cqe.res);
+            }
+            std::atomic_ref<unsigned>(*cqHead_).store(head, std::memory_order_release);
+            return true;
+        }
+
+       private:
+        void* map(size_t size, off_t offset) const {
+            void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+            return address == MAP_FAILED ? nullptr : address;
+        }
+
+        int fd_ = -1;
+        void* sq_ = nullptr;
+        void* cq_ = nullptr;
+        io_uring_sqe* sqes_ = nullptr;
+        size_t sqSize_ = 0;
+        size_t cqSize_ = 0;
+        size_t sqesSize_ = 0;
+        bool singleMap_ = false;
+        unsigned* sqTail_ = nullptr;
+        unsigned* sqArray_ = nullptr;
+        unsigned sqMask_ = 0;
+        unsigned* cqHead_ = nullptr;
+        unsigned* cqTail_ = nullptr;
+        unsigned cqMask_ = 0;
+        io_uring_cqe* cqes_ = nullptr;
+    };
+#endif
+
+    static tooling::ThreadPool& ioThreads() {
+        static tooling::ThreadPool pool(IO_THREADS);
+        return pool;
+    }
+
+    bool start(unsigned slot, Mode mode, uint64_t offset, uint8_t* data, size_t size) {
+        if (!is_open() || slot >= slots_.size() || slots_[slot].busy) {
+            tooling::Log::error("Asynchronous file slot {} is not free", slot);
+            return false;
+        }
+        Slot& s = slots_[slot];
+        s.mode = mode;
+        s.offset = offset;
+        s.data = data;
+        s.size = size;
+        s.done = 0;
+        s.busy = true;
+        if (size == 0) {
+            s.complete = true;
+            s.result = 0;
+            return true;
+        }
+        issue(slot);
+        return true;
+    }
+
+    // Queue the part of a slot's request not yet transferred
+    void issue(unsigned slot) {
+        Slot& s = slots_[slot];
+        const uint64_t offset = s.offset + s.done;
+        uint8_t* const data = s.data + s.done;
+        const size_t size = std::min(s.size - s.done, MAX_REQUEST);
+        s.complete = false;
+
+        switch (backend_) {
+#ifdef SCANFORGE_HAS_IO_URING
+            case IOBackend::IoUring:
+                if (!ring_.submit(s.mode == Mode::Read ? IORING_OP_READ : IORING_OP_WRITE, fd_, offset, data, static_cast<uint32_t>(size), slot)) {
+                    s.complete = true;
+                    s.result = -1;
+                }
+                return;
+#endif
+#ifdef _WIN32
+            case IOBackend::Overlapped: {
+                s.overlapped = OVERLAPPED{};
+                s.overlapped.Offset = static_cast<DWORD>(offset);
+                s.overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                s.overlapped.hEvent = s.event;
+                ResetEvent(s.event);
+                const BOOL ok = s.mode == Mode::Read ? ReadFile(handle_, data, static_cast<DWORD>(size), nullptr, &s.overlapped)
+                                                     : WriteFile(handle_, data, static_cast<DWORD>(size), nullptr, &s.overlapped);
+                if (!ok && GetLastError() != ERROR_IO_PENDING) {
+                    s.complete = true;
+                    s.result = GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+                }
+                return;
+            }
+#endif
+            default:
+                ioThreads().submit([this, slot, mode = s.mode, offset, data, size] {
+                    const int64_t result = transferAt(mode, offset, data, size);
+                    // Notified under the lock: once the waiter sees complete, the file may be closed and gone
+                    std::lock_guard lock(mutex_);
+                    slots_[slot].result = result;
+                    slots_[slot].complete = true;
+                    completed_.notify_all();
+                });
+                return;
+        }
+    }
+
+    // Block until the part under way of a slot completed; its bytes, or negative on failure
+    int64_t complete(unsigned slot) {
+        Slot& s = slots_[slot];
+        switch (backend_) {
+#ifdef SCANFORGE_HAS_IO_URING
+            case IOBackend::IoUring:
+                while (!s.complete) {
+                    const bool ok = ring_.reap(true, [this](uint64_t tag, int32_t result) {
+                        slots_[tag].result = result;
+                        slots_[tag].complete = true;
+                    });
+                    if (!ok) {
+                        return -1;
+                    }
+                }
+                return s.result;
+#endif
+#ifdef _WIN32
+            case IOBackend::Overlapped: {
+                if (s.complete) {
+                    return s.result;
+                }
+                DWORD bytes = 0;
+                if (!GetOverlappedResult(handle_, &s.overlapped, &bytes, TRUE)) {
+                    return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+                }
+                return bytes;
+            }
+#endif
+            default: {
+                std::unique_lock lock(mutex_);
+                completed_.wait(lock, [&s] { return s.complete; });
+                return s.result;
+            }
+        }
+    }
+
+    // Blocking positioned transfer, run on an I/O thread
+    int64_t transferAt(Mode mode, uint64_t offset, uint8_t* data, size_t size) const {
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        DWORD bytes = 0;
+        const BOOL ok = mode == Mode::Read ? ReadFile(handle_, data, static_cast<DWORD>(size), nullptr, &overlapped) : WriteFile(handle_, data, static_cast<DWORD>(size), nullptr, &overlapped);
+        int64_t result = -1;
+        if (ok || GetLastError() == ERROR_IO_PENDING) {
+            result = GetOverlappedResult(handle_, &overlapped, &bytes, TRUE) ? static_cast<int64_t>(bytes) : GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+        } else if (GetLastError() == ERROR_HANDLE_EOF) {
+            result = 0;
+        }
+        CloseHandle(overlapped.hEvent);
+        return result;
+#else
+        while (true) {
+            const ssize_t result = mode == Mode::Read ? ::pread(fd_, data, size, static_cast<off_t>(offset)) : ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+            if (result >= 0 || errno != EINTR) {
+                return result;
+            }
+        }
+#endif
+    }
+
+    std::vector<Slot> slots_;
+    IOBackend backend_ = IOBackend::Threads;
+    std::mutex mutex_;  // Guards the completion of Threads requests
+    std::condition_variable completed_;
+#ifdef _WIN32
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+#ifdef SCANFORGE_HAS_IO_URING
+    Ring ring_;
+#endif
+};
+
+/**
+ * @brief Input stream buffer that keeps the next blocks of a file in flight
+ *
+ * While the reader consumes one block, the following depth - 1 are being read. Seeking inside
+ * the blocks already read ahead, or forwards into them, keeps them; any other seek restarts
+ * at the new position with one block, and the read-ahead once the reader moves past it.
+ */
+class ReadAheadBuffer final : public std::streambuf {
+   public:
+    ReadAheadBuffer() = default;
+    ~ReadAheadBuffer() override { close(); }
+
+    ReadAheadBuffer(const ReadAheadBuffer&) = delete;
+    ReadAheadBuffer& operator=(const ReadAheadBuffer&) = delete;
+
+    bool open(const std::filesystem::path& path, const AsyncOptions& options) {
+        close();
+        const unsigned depth = std::max(1u, options.depth);
+        if (!file_.open(path, AsyncFile::Mode::Read, options.backend, depth)) {
+            return false;
+        }
+        size_ = file_.size();
+        blocks_ = std::vector<Block>(depth);
+        for (auto& block : blocks_) {
+            block.data.resize(std::max<size_t>(1, options.blockSize));
+        }
+        restart(0);
+        return true;
+    }
+
+    void close() {
+        if (file_.is_open()) {
+            drain();
+            file_.close();
+        }
+        blocks_.clear();
+        setg(nullptr, nullptr, nullptr);
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    IOBackend backend() const { return file_.backend(); }
+
+   protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        if (!advance()) {
+            return traits_type::eof();
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in) || !is_open()) {
+            return pos_type(off_type(-1));
+        }
+        const uint64_t base = direction == std::ios_base::beg ? 0 : direction == std::ios_base::cur ? position() : size_;
+        if (offset == 0 && direction == std::ios_base::cur) {
+            return pos_type(static_cast<off_type>(base));
+        }
+        if (offset < 0 && static_cast<uint64_t>(-offset) > base) {
+            return pos_type(off_type(-1));
+        }
+        return seekTo(static_cast<uint64_t>(static_cast<off_type>(base) + offset));
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in) || !is_open() || off_type(target) < 0) {
+            return pos_type(off_type(-1));
+        }
+        return seekTo(static_cast<uint64_t>(off_type(target)));
+    }
+
+   private:
+    struct Block {
+        std::vector<uint8_t> data;
+        uint64_t offset = 0;
+        bool queued = false;
+    };
+
+    // Position of the next byte the reader gets
+    uint64_t position() const { return active_ ? blocks_[head_].offset + static_cast<uint64_t>(gptr() - eback()) : start_; }
+
+    pos_type seekTo(uint64_t target) {
+        if (active_ && target >= blocks_[head_].offset && target < blocks_[head_].offset + static_cast<uint64_t>(egptr() - eback())) {
+            setg(eback(), eback() + (target - blocks_[head_].offset), egptr());
+            return pos_type(static_cast<off_type>(target));
+        }
+        // Forwards into the blocks in flight keeps them, anything else starts over
+        if (target >= position() && target < queuedEnd_) {
+            while (advance()) {
+                const uint64_t end = blocks_[head_].offset + static_cast<uint64_t>(egptr() - eback());
+                if (target < end) {
+                    setg(eback(), eback() + (target - blocks_[head_].offset), egptr());
+                    return pos_type(static_cast<off_type>(target));
+                }
+            }
+        }
+        restart(target);
+        return pos_type(static_cast<off_type>(target));
+    }
+
+    // Start reading at position with a single block: a reader seeking around, LASIndex, say, does
+    // not pay for read-ahead it will not use. Reading past that block queues the others.
+    void restart(uint64_t position) {
+        drain();
+        setg(nullptr, nullptr, nullptr);
+        active_ = false;
+        head_ = 0;
+        start_ = position;
+        queuedEnd_ = position;
+        queue(0);
+    }
+
+    void queue(unsigned b) {
+        Block& block = blocks_[b];
+        block.queued = false;
+        if (queuedEnd_ >= size_) {
+            return;
+        }
+        const size_t bytes = static_cast<size_t>(std::min<uint64_t>(block.data.size(), size_ - queuedEnd_));
+        block.offset = queuedEnd_;
+        block.queued = file_.read(b, queuedEnd_, std::span(block.data).first(bytes));
+        queuedEnd_ += bytes;
+    }
+
+    // Move the get area to the next block, queueing the one used up; false at the end or on failure
+    bool advance() {
+        if (active_) {
+            // Blocks in flight follow head_ in file order, the free ones after them
+            active_ = false;
+            start_ = blocks_[head_].offset + static_cast<uint64_t>(egptr() - eback());
+            const auto depth = static_cast<unsigned>(blocks_.size());
+            head_ = (head_ + 1) % depth;
+            for (unsigned i = 0; i < depth; ++i) {
+                if (!blocks_[(head_ + i) % depth].queued) {
+                    queue((head_ + i) % depth);
+                }
+            }
+        }
+        setg(nullptr, nullptr, nullptr);
+        Block& block = blocks_[head_];
+        if (!block.queued) {
+            return false;
+        }
+        block.queued = false;
+        const auto bytes = file_.wait(head_);
+        if (!bytes || *bytes == 0) {
+            return false;  // The stream reports the short read
+        }
+        auto* data = reinterpret_cast<char*>(block.data.data());
+        setg(data, data, data + *bytes);
+        active_ = true;
+        return true;
+    }
+
+    // Wait for every block in flight, dropping what it read
+    void drain() {
+        for (unsigned b = 0; b < blocks_.size(); ++b) {
+            if (blocks_[b].queued) {
+                file_.wait(b);
+                blocks_[b].queued = false;
+            }
+        }
+    }
+
+    AsyncFile file_;
+    std::vector<Block> blocks_;  // Ring of blocks; slot b of file_ reads into blocks_[b]
+    unsigned head_ = 0;          // Block holding the next bytes of the file
+    bool active_ = false;        // The get area lies in blocks_[head_]
+    uint64_t start_ = 0;         // Position when the get area is empty
+    uint64_t queuedEnd_ = 0;     // End of the last block queued
+    uint64_t size_ = 0;
+};
+
+/**
+ * @brief Output stream buffer writing full blocks in the background while the next fill up
+ *
+ * Writes are positioned, so seeking back to patch a header only flushes what is buffered.
+ * Failed writes are reported by the next overflow or sync, which sets the stream's badbit.
+ */
+class WriteBehindBuffer final : public std::streambuf {
+   public:
+    WriteBehindBuffer() = default;
+    ~WriteBehindBuffer() override { close(); }
+
+    WriteBehindBuffer(const WriteBehindBuffer&) = delete;
+    WriteBehindBuffer& operator=(const WriteBehindBuffer&) = delete;
+
+    bool open(const std::filesystem::path& path, const AsyncOptions& options) {
+        close();
+        const unsigned depth = std::max(1u, options.depth);
+        if (!file_.open(path, AsyncFile::Mode::Write, options.backend, depth)) {
+            return false;
+        }
+        blocks_ = std::vector<Block>(depth);
+        for (auto& block : blocks_) {
+            block.data.resize(std::max<size_t>(1, options.blockSize));
+        }
+        head_ = 0;
+        position_ = 0;
+        end_ = 0;
+        failed_ = false;
+        fill();
+        return true;
+    }
+
+    /** @brief Write what is buffered, wait for every write and close the file; false if any failed */
+    bool close() {
+        if (!file_.is_open()) {
+            return !failed_;
+        }
+        const bool ok = sync() == 0;
+        file_.close();
+        blocks_.clear();
+        setp(nullptr, nullptr);
+        return ok;
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    IOBackend backend() const { return file_.backend(); }
+
+   protected:
+    int_type overflow(int_type c) override {
+        if (!flush()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        if (!file_.is_open()) {
+            return failed_ ? -1 : 0;
+        }
+        flush();
+        for (unsigned b = 0; b < blocks_.size(); ++b) {
+            finish(b);
+        }
+        return failed_ ? -1 : 0;
+    }
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::out) || !is_open()) {
+            return pos_type(off_type(-1));
+        }
+        const uint64_t here = position_ + static_cast<uint64_t>(pptr() - pbase());
+        if (offset == 0 && direction == std::ios_base::cur) {
+            return pos_type(static_cast<off_type>(here));
+        }
+        const uint64_t base = direction == std::ios_base::beg ? 0 : direction == std::ios_base::cur ? here : std::max(end_, here);
+        if (offset < 0 && static_cast<uint64_t>(-offset) > base) {
+            return pos_type(off_type(-1));
+        }
+        return seekTo(static_cast<uint64_t>(static_cast<off_type>(base) + offset));
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::out) || !is_open() || off_type(target) < 0) {
+            return pos_type(off_type(-1));
+        }
+        return seekTo(static_cast<uint64_t>(off_type(target)));
+    }
+
+   private:
+    struct Block {
+        std::vector<uint8_t> data;
+        bool queued = false;
+        size_t bytes = 0;
+    };
+
+    pos_type seekTo(uint64_t target) {
+        if (sync() != 0) {
+            return pos_type(off_type(-1));
+        }
+        position_ = target;
+        fill();
+        return pos_type(static_cast<off_type>(target));
+    }
+
+    // Queue the filled part of the current block and move on to the next one
+    bool flush() {
+        const auto bytes = static_cast<size_t>(pptr() - pbase());
+        if (bytes > 0) {
+            Block& block = blocks_[head_];
+            block.bytes = bytes;
+            block.queued = file_.write(head_, position_, std::span(block.data).first(bytes));
+            failed_ = failed_ || !block.queued;
+            position_ += bytes;
+            end_ = std::max(end_, position_);
+            head_ = (head_ + 1) % static_cast<unsigned>(blocks_.size());
+        }
+        finish(head_);
+        fill();
+        return !failed_;
+    }
+
+    // Wait for the write of a block, if it has one in flight
+    void finish(unsigned b) {
+        Block& block = blocks_[b];
+        if (block.queued) {
+            const auto written = file_.wait(b);
+            failed_ = failed_ || !written || *written != block.bytes;
+            block.queued = false;
+        }
+    }
+
+    void fill() {
+        auto* data = reinterpret_cast<char*>(blocks_[head_].data.data());
+        setp(data, data + blocks_[head_].data.size());
+    }
+
+    AsyncFile file_;
+    std::vector<Block> blocks_;  // Ring of blocks; slot b of file_ writes blocks_[b]
+    unsigned head_ = 0;          // Block being filled
+    uint64_t position_ = 0;      // File offset of the block being filled
+    uint64_t end_ = 0;           // End of the furthest write
+    bool failed_ = false;
+};
+
+/**
+ * @brief std::istream over a ReadAheadBuffer, for code written against std::ifstream
+ *
+ * @code
+ * io::AsyncInputStream file("scan.las", {.blockSize = 4 << 20, .depth = 8});
+ * file.read(buffer, size);  // The next reads are already under way
+ * @endcode
+ */
+class AsyncInputStream : public std::istream {
+   public:
+    AsyncInputStream() : std::istream(&buffer_) {}
+    AsyncInputStream(const std::filesystem::path& path, const AsyncOptions& options) : std::istream(&buffer_) { open(path, options); }
+
+    bool open(const std::filesystem::path& path, const AsyncOptions& options) {
+        clear();
+        if (!buffer_.open(path, options)) {
+            setstate(std::ios_base::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    void close() { buffer_.close(); }
+    bool is_open() const { return buffer_.is_open(); }
+    IOBackend backend() const { return buffer_.backend(); }
+
+   private:
+    ReadAheadBuffer buffer_;
+};
+
+/** @brief std::ostream over a WriteBehindBuffer, for code written against std::ofstream */
+class AsyncOutputStream : public std::ostream {
+   public:
+    AsyncOutputStream() : std::ostream(&buffer_) {}
+    AsyncOutputStream(const std::filesystem::path& path, const AsyncOptions& options) : std::ostream(&buffer_) { open(path, options); }
+
+    bool open(const std::filesystem::path& path, const AsyncOptions& options) {
+        clear();
+        if (!buffer_.open(path, options)) {
+            setstate(std::ios_base::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Flush and close; sets failbit if a write failed */
+    void close() {
+        if (buffer_.is_open() && !buffer_.close()) {
+            setstate(std::ios_base::failbit);
+        }
+    }
+
+    bool is_open() const { return buffer_.is_open(); }
+    IOBackend backend() const { return buffer_.backend(); }
+
+   private:
+    WriteBehindBuffer buffer_;
+};
+
+}  // namespace scanforge::io
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+namespace scanforge::io {
+
+/**
+ * @brief Buffered line splitter over a std::istream, without a string allocation per line.
+ *
+ * The stream is read in blocks of blockSize bytes and lines are handed out as views into
+ * that buffer; a block only grows when a single line is longer than it. Lines end at '\n'
+ * (a trailing '\r' is kept) and a last line without terminator is returned as well.
+ *
+ * The stream is passed to every call rather than stored, so the reader can sit next to
+ * the stream it reads in a movable object.
+ *
+ * @code
+ * io::LineReader lines;
+ * std::string_view line;
+ * while (lines.next(file, line)) {
+ *     parse(line);
+ * }
+ * @endcode
+ */
+class LineReader {
+   public:
+    static constexpr size_t BLOCK_SIZE = size_t{1} << 20;
+
+    explicit LineReader(size_t blockSize = BLOCK_SIZE) : blockSize_(blockSize > 0 ? blockSize : 1) {}
+
+    /**
+     * @brief Fetch the next line
+     * @param stream Stream positioned where the previous call left it
+     * @param line Receives the line without its '\n'; valid until the next call
+     * @return False once the stream is exhausted
+     */
+    bool next(std::istream& stream, std::string_view& line) {
+        while (true) {
+            const char* begin = buffer_.data() + begin_;
+            if (const void* newline = end_ > begin_ ? std::memchr(begin, '\n', end_ - begin_) : nullptr) {
+                const size_t length = static_cast<size_t>(static_cast<const char*>(newline) - begin);
+                line = std::string_view(begin, length);
+                begin_ += length + 1;
+                return true;
+            }
+            if (exhausted_) {
+                if (begin_ == end_) {
+                    return false;
+                }
+                line = std::string_view(begin, end_ - begin_);
+                begin_ = end_;
+                return true;
+            }
+            fill(stream);
+        }
+    }
+
+    /** @brief True once every line has been returned */
+    bool eof() const { return exhausted_ && begin_ == end_; }
+
+   private:
+    // Keep the unfinished line at the front and append the next block behind it
+    void fill(std::istream& stream) {
+        const size_t pending = end_ - begin_;
+        if (begin_ > 0 && pending > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, pending);
+        }
+        begin_ = 0;
+        end_ = pending;
+        if (buffer_.size() < pending + blockSize_) {
+            buffer_.resize(pending + blockSize_);
+        }
+
+        stream.read(buffer_.data() + end_, static_cast<std::streamsize>(blockSize_));
+        const auto got = static_cast<size_t>(stream.gcount());
+        end_ += got;
+        exhausted_ = got == 0;
+    }
+
+    std::vector<char> buffer_;
+    size_t blockSize_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool exhausted_ = false;
+};
+
+}  // namespace scanforge::io
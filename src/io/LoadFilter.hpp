@@ -0,0 +1,327 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "tooling/Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace scanforge::io {
+using Log = scanforge::tooling::Log;
+
+/**
+ * @brief Which records of a file a loader keeps, decided while the file is decoded
+ *
+ * The tests run cheapest first: the stride on the record index, so that skipped records are
+ * never decoded, then the box on the position, then the predicate on the decoded attributes,
+ * and last the sample over the records that passed everything else. A default filter keeps
+ * every point.
+ *
+ * @code
+ * io::LoadFilter filter;
+ * filter.box = io::LoadFilter::Box{.minX = 0, .minY = 0, .maxX = 500, .maxY = 500};
+ * filter.predicate = io::classificationIn({2});  // Ground only
+ * auto [header, ground] = processor.loadLAS(filename, filter, 0);
+ * @endcode
+ */
+struct LoadFilter {
+    /** @brief Inclusive box; the default bounds leave an axis unrestricted */
+    struct Box {
+        double minX = -std::numeric_limits<double>::infinity();
+        double minY = -std::numeric_limits<double>::infinity();
+        double minZ = -std::numeric_limits<double>::infinity();
+        double maxX = std::numeric_limits<double>::infinity();
+        double maxY = std::numeric_limits<double>::infinity();
+        double maxZ = std::numeric_limits<double>::infinity();
+
+        bool contains(const Point3D& p) const {
+            const auto x = static_cast<double>(p.x);
+            const auto y = static_cast<double>(p.y);
+            const auto z = static_cast<double>(p.z);
+            return x >= minX && x <= maxX && y >= minY && y <= maxY && z >= minZ && z <= maxZ;
+        }
+    };
+
+    /** @brief Sees every attribute the file has; attributes it lacks keep their defaults */
+    using Predicate = std::function<bool(const PointLAS&)>;
+
+    uint64_t stride = 1;      // Keep records 0, stride, 2 * stride, ... of the file
+    uint64_t sampleSize = 0;  // Keep a uniform random sample of at most this many points, 0 keeps all
+    uint64_t seed = 0;        // Seed of the sample; the same seed picks the same points
+    std::optional<Box> box;
+    Predicate predicate;
+
+    /** @brief True if the filter can reject anything */
+    bool active() const { return stride > 1 || sampleSize > 0 || box || predicate; }
+
+    bool isValid() const {
+        if (stride == 0) {
+            Log::error("Load stride must be at least 1");
+            return false;
+        }
+        if (box && !(box->minX <= box->maxX && box->minY <= box->maxY && box->minZ <= box->maxZ)) {
+            Log::error("Load box has a minimum above its maximum");
+            return false;
+        }
+        return true;
+    }
+
+    bool keepsRecord(uint64_t index) const { return index % stride == 0; }
+
+    bool contains(const Point3D& p) const { return !box || box->contains(p); }
+};
+
+/** @brief Predicate keeping the points of the given classes */
+inline LoadFilter::Predicate classificationIn(std::span<const uint8_t> classes) {
+    std::bitset<256> wanted;
+    for (uint8_t c : classes) {
+        wanted.set(c);
+    }
+    return [wanted](const PointLAS& p) { return wanted.test(p.classification); };
+}
+
+inline LoadFilter::Predicate classificationIn(std::initializer_list<uint8_t> classes) { return classificationIn(std::span(classes.begin(), classes.size())); }
+
+/** @brief Predicate keeping first returns, single returns included */
+inline LoadFilter::Predicate firstReturns() {
+    return [](const PointLAS& p) { return p.returnNumber <= 1; };
+}
+
+/** @brief Predicate keeping last returns, single returns included */
+inline LoadFilter::Predicate lastReturns() {
+    return [](const PointLAS& p) { return p.returnNumber >= p.numberOfReturns; };
+}
+
+/**
+ * @brief Collects the points a LoadFilter keeps from records decoded in parallel
+ *
+ * Decoders split a file into parts of consecutive records, fill one Part each through offer()
+ * and commit() it from any thread. finish() returns the kept points in file order, whatever
+ * the order parts were committed in.
+ *
+ * Sampling gives every record a pseudo-random key derived from the seed and its index and
+ * keeps the sampleSize smallest keys (bottom-k sampling). Unlike reservoir sampling this
+ * needs no sequential pass, so the sample does not depend on the number of threads; a record
+ * whose key is above the current cut-off is rejected before it is decoded.
+ */
+template <typename PointT>
+class PointSelection {
+   public:
+    struct Sample {
+        uint64_t key;
+        uint64_t index;
+        PointT point;
+    };
+
+    struct Part {
+        uint64_t first = 0;               // Index of the first record the part covers
+        std::pmr::vector<PointT> points;  // Kept points in file order, when not sampling
+        std::vector<Sample> samples;      // Candidates for the sample
+        uint64_t cutoff = NO_CUTOFF;      // Keys above this cannot make it into the sample
+    };
+
+    /**
+     * @param filter Filter to apply; must outlive the selection
+     * @param bounds Bounds of the file as {min, max}, used to estimate how much the box keeps
+     */
+    explicit PointSelection(const LoadFilter& filter, std::optional<std::pair<Point3D, Point3D>> bounds = std::nullopt)
+        : filter_(filter), fraction_(estimateFraction(filter, bounds)) {}
+
+    const LoadFilter& filter() const { return filter_; }
+
+    /** @brief Empty part for the records [first, first + records), reserved for what it should keep */
+    Part part(uint64_t first, size_t records) const {
+        Part part;
+        part.first = first;
+        if (fraction_) {
+            const auto expected = static_cast<size_t>(static_cast<double>(records) * *fraction_ / static_cast<double>(filter_.stride)) + 1;
+            if (sampling()) {
+                part.samples.reserve(std::min<uint64_t>(expected, 2 * filter_.sampleSize));
+            } else {
+                part.points.reserve(expected);
+            }
+        }
+        return part;
+    }
+
+    /**
+     * @brief Run the filter on record `index`
+     * @param decode Callable filling a point of any type from the record, returning false to drop it
+     *               (a non-finite position, say); with a predicate it decodes a PointLAS
+     */
+    template <typename Decode>
+    void offer(Part& part, uint64_t index, Decode&& decode) {
+        if (!filter_.keepsRecord(index)) {
+            return;
+        }
+        const uint64_t key = sampling() ? sampleKey(index) : 0;
+        if (sampling() && key > std::min(part.cutoff, cutoff_.load(std::memory_order_relaxed))) {
+            return;
+        }
+
+        PointT point{};
+        if (filter_.predicate) {
+            PointLAS probe{};
+            if (!decode(probe) || !filter_.contains(probe.position) || !filter_.predicate(probe)) {
+                return;
+            }
+            point = project(probe);
+        } else if (!decode(point) || !filter_.contains(getPosition(point))) {
+            return;
+        }
+
+        if (!sampling()) {
+            part.points.push_back(point);
+            return;
+        }
+        part.samples.push_back({key, index, point});
+        if (part.samples.size() >= 2 * filter_.sampleSize) {
+            part.cutoff = prune(part.samples, filter_.sampleSize);
+        }
+    }
+
+    /** @brief Hand a filled part over; thread safe */
+    void commit(Part&& part) {
+        std::lock_guard lock(mutex_);
+        if (!sampling()) {
+            parts_.push_back(std::move(part));
+            return;
+        }
+        pool_.insert(pool_.end(), part.samples.begin(), part.samples.end());
+        if (pool_.size() >= filter_.sampleSize) {
+            cutoff_.store(prune(pool_, filter_.sampleSize), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief The kept points in file order; the selection is empty afterwards
+     * @param resource Resource the returned points allocate from
+     */
+    std::pmr::vector<PointT> finish(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        std::lock_guard lock(mutex_);
+        std::pmr::vector<PointT> points(resource);
+        if (sampling()) {
+            prune(pool_, filter_.sampleSize);
+            std::sort(pool_.begin(), pool_.end(), [](const Sample& a, const Sample& b) { return a.index < b.index; });
+            points.reserve(pool_.size());
+            for (const auto& sample : pool_) {
+                points.push_back(sample.point);
+            }
+            pool_.clear();
+            return points;
+        }
+
+        std::sort(parts_.begin(), parts_.end(), [](const Part& a, const Part& b) { return a.first < b.first; });
+        size_t total = 0;
+        for (const auto& part : parts_) {
+            total += part.points.size();
+        }
+        if (parts_.size() == 1) {
+            points = std::move(parts_.front().points);  // Steals the buffer unless resource differs from the part's
+        } else {
+            points.reserve(total);
+            for (auto& part : parts_) {
+                points.insert(points.end(), part.points.begin(), part.points.end());
+                part.points = {};
+            }
+        }
+        parts_.clear();
+        return points;
+    }
+
+   private:
+    static constexpr uint64_t NO_CUTOFF = std::numeric_limits<uint64_t>::max();
+
+    bool sampling() const { return filter_.sampleSize > 0; }
+
+    // SplitMix64 of the seeded record index: uniform, and the same for a record on every run
+    uint64_t sampleKey(uint64_t index) const {
+        uint64_t z = filter_.seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Keep the k smallest keys, ties broken by index; returns the largest key kept
+    static uint64_t prune(std::vector<Sample>& samples, uint64_t k) {
+        const auto before = [](const Sample& a, const Sample& b) { return a.key < b.key || (a.key == b.key && a.index < b.index); };
+        if (samples.size() > k) {
+            std::nth_element(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(k - 1), samples.end(), before);
+            samples.resize(static_cast<size_t>(k));
+            return samples.back().key;
+        }
+        return samples.size() == k ? std::max_element(samples.begin(), samples.end(), before)->key : NO_CUTOFF;
+    }
+
+    // The attributes of a probe the point type has
+    static PointT project(const PointLAS& probe) {
+        if constexpr (std::is_same_v<PointT, PointLAS>) {
+            return probe;
+        } else {
+            PointT point{};
+            getPosition(point) = probe.position;
+            if constexpr (HasColor<PointT>) {
+                point.color = probe.color;
+            }
+            if constexpr (HasIntensity<PointT>) {
+                point.intensity = probe.intensity;
+            }
+            if constexpr (HasClassification<PointT>) {
+                point.classification = probe.classification;
+            }
+            if constexpr (HasReturns<PointT>) {
+                point.returnNumber = probe.returnNumber;
+                point.numberOfReturns = probe.numberOfReturns;
+            }
+            if constexpr (HasGpsTime<PointT>) {
+                point.gpsTime = probe.gpsTime;
+            }
+            if constexpr (HasNearInfrared<PointT>) {
+                point.nearInfrared = probe.nearInfrared;
+            }
+            return point;
+        }
+    }
+
+    // Share of the records expected to pass the box, nullopt when it cannot be told in advance
+    static std::optional<double> estimateFraction(const LoadFilter& filter, const std::optional<std::pair<Point3D, Point3D>>& bounds) {
+        if (filter.predicate) {
+            return std::nullopt;
+        }
+        if (!filter.box) {
+            return 1.0;
+        }
+        if (!bounds) {
+            return std::nullopt;
+        }
+        const auto overlap = [](double min, double max, float lower, float upper) {
+            const double extent = static_cast<double>(upper) - static_cast<double>(lower);
+            const double inside = std::min(max, static_cast<double>(upper)) - std::max(min, static_cast<double>(lower));
+            return inside < 0 ? 0.0 : extent > 0 ? std::min(1.0, inside / extent) : 1.0;
+        };
+        const auto& [min, max] = *bounds;
+        const auto& box = *filter.box;
+        return overlap(box.minX, box.maxX, min.x, max.x) * overlap(box.minY, box.maxY, min.y, max.y) * overlap(box.minZ, box.maxZ, min.z, max.z);
+    }
+
+    const LoadFilter& filter_;
+    std::optional<double> fraction_;
+    std::atomic<uint64_t> cutoff_{NO_CUTOFF};  // Largest key of the committed sample once it is full
+    std::mutex mutex_;
+    std::vector<Part> parts_;
+    std::vector<Sample> pool_;
+};
+
+}  // namespace scanforge::io
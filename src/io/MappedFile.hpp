@@ -0,0 +1,180 @@
+#pragma once
+
+#include "tooling/Logger.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace scanforge::io {
+
+/**
+ * @brief Read-only memory mapping of a whole file (POSIX mmap / Win32 MapViewOfFile).
+ *
+ * The mapping lives as long as the object; spans returned by data() must not outlive it.
+ * Empty files open successfully and expose an empty span.
+ *
+ * @code
+ * io::MappedFile file("scan.pcd");
+ * if (file.is_open()) {
+ *     std::span<const uint8_t> bytes = file.data();
+ * }
+ * @endcode
+ */
+class MappedFile {
+   public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Map a file read-only, unmapping any previous file first
+     * @param path File to map
+     * @return True if the file is mapped (or empty), false otherwise
+     */
+    bool open(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            tooling::Log::error("Failed to open file for mapping: {}", path.string());
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            tooling::Log::error("Failed to query size of file: {}", path.string());
+            close();
+            return false;
+        }
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        open_ = true;
+        if (size_ == 0) {
+            return true;
+        }
+
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            tooling::Log::error("Failed to create file mapping: {}", path.string());
+            close();
+            return false;
+        }
+
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            tooling::Log::error("Failed to map view of file: {}", path.string());
+            close();
+            return false;
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            tooling::Log::error("Failed to open file for mapping: {}", path.string());
+            return false;
+        }
+
+        struct stat fileStat{};
+        if (::fstat(fd, &fileStat) != 0) {
+            tooling::Log::error("Failed to query size of file: {}", path.string());
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(fileStat.st_size);
+        open_ = true;
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+
+        void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps its own reference to the file
+        if (address == MAP_FAILED) {
+            tooling::Log::error("Failed to map file: {}", path.string());
+            size_ = 0;
+            open_ = false;
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(address);
+        ::posix_madvise(address, size_, POSIX_MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    /** @brief Unmap the file; safe to call on a closed mapping */
+    void close() {
+#ifdef _WIN32
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+
+    bool is_open() const { return open_; }
+    size_t size() const { return size_; }
+    std::span<const uint8_t> data() const { return {data_, size_}; }
+
+   private:
+    void swap(MappedFile& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(open_, other.open_);
+#ifdef _WIN32
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+#endif
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+}  // namespace scanforge::io
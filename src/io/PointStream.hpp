@@ -0,0 +1,196 @@
+#pragma once
+
+#include "PointCloudSoA.hpp"
+#include "PointCloudTypes.hpp"
+#include "tooling/BoundedQueue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace scanforge::io {
+
+/**
+ * @brief Pull-style source of points, read one caller-sized chunk at a time.
+ *
+ * Implemented by LASReader and PCDReader so that huge files can be processed through a
+ * fixed-size window instead of a fully materialized PointCloud.
+ *
+ * @code
+ * LASReader reader("tile.las");
+ * std::vector<PointXYZRGB> chunk(65536);
+ * while (size_t n = reader.next(chunk)) {
+ *     process(std::span(chunk).first(n));
+ * }
+ * @endcode
+ */
+class PointReader {
+   public:
+    virtual ~PointReader() = default;
+
+    /** @brief Number of points announced by the file header; non-finite points may be dropped on read */
+    virtual uint64_t size() const = 0;
+
+    /**
+     * @brief Decode the next points into out
+     * @param out Destination window, filled as far as the file allows
+     * @return Number of points written, 0 once the file is exhausted or after an error
+     */
+    virtual size_t next(std::span<PointXYZRGB> out) = 0;
+
+    /** @brief False once a read or decode error occurred */
+    virtual bool good() const = 0;
+};
+
+/**
+ * @brief Push-style sink of points, written one chunk at a time.
+ *
+ * Header fields that depend on every point (counts, bounding box) are patched by close().
+ */
+class PointWriter {
+   public:
+    virtual ~PointWriter() = default;
+
+    /**
+     * @brief Append points to the file
+     * @param points Points to encode
+     * @return True if all points were written
+     */
+    virtual bool write(std::span<const PointXYZRGB> points) = 0;
+
+    /**
+     * @brief Flush pending data and finalize the header
+     * @return True if the file is complete and consistent
+     */
+    virtual bool close() = 0;
+};
+
+/**
+ * @brief Visit every point of a reader through one reused buffer
+ * @param reader Source of points
+ * @param chunkSize Points per chunk
+ * @param visitor Callable taking std::span<const PointXYZRGB>, returning false to stop early
+ * @return True if the reader was exhausted without error and the visitor never stopped
+ */
+template <typename Visitor>
+bool forEachChunk(PointReader& reader, size_t chunkSize, Visitor&& visitor) {
+    std::vector<PointXYZRGB> chunk(chunkSize > 0 ? chunkSize : 1);
+    while (size_t count = reader.next(chunk)) {
+        if (!visitor(std::span<const PointXYZRGB>(chunk.data(), count))) {
+            return false;
+        }
+    }
+    return reader.good();
+}
+
+/**
+ * @brief Decode all remaining points of a reader into a column-oriented cloud
+ *
+ * Points are split into the columns one chunk at a time, so the interleaved staging buffer
+ * stays cache-sized whatever the file size.
+ *
+ * @param reader Source of points
+ * @param cloud Receives the points, appended after any it already holds
+ * @param chunkSize Points per chunk
+ * @return True if the reader was exhausted without error
+ */
+inline bool readColumns(PointReader& reader, PointCloudSoA& cloud, size_t chunkSize = 16384) {
+    cloud.reserve(cloud.size() + static_cast<size_t>(reader.size()));
+    const bool ok = forEachChunk(reader, chunkSize, [&cloud](std::span<const PointXYZRGB> points) {
+        cloud.append(points);
+        return true;
+    });
+    cloud.width = static_cast<uint32_t>(cloud.size());
+    cloud.height = 1;
+    return ok;
+}
+
+/**
+ * @brief Stream all points from a reader into a writer in constant memory, then close the writer
+ * @param reader Source of points
+ * @param writer Sink of points
+ * @param chunkSize Points per chunk
+ * @return True if every point was copied and the writer closed cleanly
+ */
+inline bool copyPoints(PointReader& reader, PointWriter& writer, size_t chunkSize = 65536) {
+    const bool copied = forEachChunk(reader, chunkSize, [&writer](std::span<const PointXYZRGB> points) { return writer.write(points); });
+    const bool closed = writer.close();
+    return copied && closed;
+}
+
+/**
+ * @brief Visit every point of a reader while a producer thread reads ahead
+ *
+ * A producer thread reads and decodes chunks while the calling thread visits the previous
+ * ones. The two stages exchange `queueDepth` recycled buffers through bounded queues, so
+ * memory stays at queueDepth * chunkSize points whatever the file size.
+ *
+ * @param reader Source of points, only used from the producer thread
+ * @param chunkSize Points per chunk
+ * @param queueDepth Number of chunks in flight
+ * @param visitor Callable taking std::span<const PointXYZRGB>, returning false to stop early
+ * @return True if the reader was exhausted without error and the visitor never stopped
+ */
+template <typename Visitor>
+bool prefetchChunks(PointReader& reader, size_t chunkSize, size_t queueDepth, Visitor&& visitor) {
+    struct Chunk {
+        std::vector<PointXYZRGB> points;
+        size_t count = 0;
+    };
+
+    queueDepth = queueDepth > 0 ? queueDepth : 1;
+    tooling::BoundedQueue<Chunk> empty(queueDepth);
+    tooling::BoundedQueue<Chunk> filled(queueDepth);
+    for (size_t i = 0; i < queueDepth; ++i) {
+        empty.push(Chunk{std::vector<PointXYZRGB>(chunkSize > 0 ? chunkSize : 1), 0});
+    }
+
+    std::atomic<bool> readOk = true;
+    std::jthread producer([&] {
+        while (auto chunk = empty.pop()) {
+            chunk->count = reader.next(chunk->points);
+            if (chunk->count == 0 || !filled.push(std::move(*chunk))) {
+                break;
+            }
+        }
+        readOk = reader.good();
+        filled.close();
+    });
+
+    bool visited = true;
+    while (auto chunk = filled.pop()) {
+        if (visited) {
+            visited = visitor(std::span<const PointXYZRGB>(chunk->points.data(), chunk->count));
+        }
+        if (!visited) {
+            empty.close();  // Stop the producer, keep draining so it never blocks on a full queue
+            continue;
+        }
+        empty.push(std::move(*chunk));
+    }
+    producer.join();
+    return readOk && visited;
+}
+
+/**
+ * @brief Stream all points from a reader into a writer with reading and writing overlapped
+ *
+ * Reading runs ahead on its own thread as in prefetchChunks(), while the calling thread
+ * encodes and writes.
+ *
+ * @param reader Source of points, only used from the producer thread
+ * @param writer Sink of points, closed on return
+ * @param chunkSize Points per chunk
+ * @param queueDepth Number of chunks in flight
+ * @return True if every point was copied and the writer closed cleanly
+ */
+inline bool pipePoints(PointReader& reader, PointWriter& writer, size_t chunkSize = 65536, size_t queueDepth = 4) {
+    const bool copied = prefetchChunks(reader, chunkSize, queueDepth, [&writer](std::span<const PointXYZRGB> points) { return writer.write(points); });
+    const bool closed = writer.close();
+    return copied && closed;
+}
+
+}  // namespace scanforge::io
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "io/PointStream.hpp"
+#include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scanforge::io {
+
+/**
+ * @brief Cut a point stream into square XY tiles, one output file per occupied tile
+ *
+ * The tiler reads its input once, a producer thread reading ahead, and routes every point to
+ * the tile floor((x - originX) / tileSize), floor((y - originY) / tileSize). Points collect in
+ * per-tile buffers; once bufferPoints are buffered in total, all buffers are flushed at once,
+ * one tile per thread, so encoding runs in parallel while memory stays bounded.
+ *
+ * At most maxOpenFiles files are open at a time, tile writers and spill files together. Part
+ * of the budget, half of it or one file per thread if that is less, is kept for spill files;
+ * the rest goes to tile writers. Tiles that appear once every writer slot is taken spill their
+ * points to a temporary raw file next to the output, which is reopened only while flushing,
+ * and are encoded after the open tiles are closed. A spilled tile needs two files to encode,
+ * so a budget of one is raised to two.
+ *
+ * Files are named `<prefix>_<x0>_<y0>.<extension>` after the lower-left corner of the tile.
+ *
+ * @code
+ * Tiler tiler({.tileSize = 1000, .extension = "laz", .threads = 0}, [&](const std::filesystem::path& path) {
+ *     auto writer = std::make_unique<LASWriter>(path, header);
+ *     return writer->is_open() ? std::move(writer) : nullptr;
+ * });
+ * LASReader reader("survey.las");
+ * tiler.run(reader, "tiles");
+ * @endcode
+ */
+class Tiler {
+   public:
+    /** @brief XY extent announced by the input, used to size the tile table up front */
+    struct Bounds {
+        double minX, minY, maxX, maxY;
+    };
+
+    struct Options {
+        double tileSize = 1000.0;
+        double originX = 0.0;  // Grid anchor; with the default, tile corners are multiples of tileSize
+        double originY = 0.0;
+        std::optional<Bounds> bounds{};
+        size_t maxOpenFiles = 64;         // Tile writers and spill files open at once
+        size_t bufferPoints = 1u << 22;  // Points buffered over all tiles before a flush
+        size_t chunkSize = 65536;         // Points per read
+        std::string prefix = "tile";
+        std::string extension = "las";
+        unsigned threads = 1;  // Threads routing and encoding; 0 uses every hardware thread
+    };
+
+    /** @brief Creates the writer of one tile, or returns nullptr after logging why it cannot */
+    using WriterFactory = std::function<std::unique_ptr<PointWriter>(const std::filesystem::path&)>;
+
+    struct TileSummary {
+        int64_t column, row;  // Tile coordinates in the grid
+        double minX, minY;    // Lower-left corner
+        std::filesystem::path path;
+        uint64_t points;
+    };
+
+    Tiler(Options options, WriterFactory factory) : options_(std::move(options)), factory_(std::move(factory)) {}
+
+    /**
+     * @brief Tile every point of a reader into outputDirectory
+     * @param reader Source of points, read once
+     * @param outputDirectory Created if missing; tile files already there are overwritten
+     * @return True if every tile file was written completely
+     */
+    bool run(PointReader& reader, const std::filesystem::path& outputDirectory) {
+        tiles_.clear();
+        lookup_.clear();
+        buffered_ = 0;
+        openWriters_ = 0;
+        dropped_ = 0;
+        outsideBounds_ = 0;
+        if (!(options_.tileSize > 0) || !std::isfinite(options_.tileSize)) {
+            tooling::Log::error("Tile size must be positive, not {}", options_.tileSize);
+            return false;
+        }
+        if (options_.maxOpenFiles == 0) {
+            tooling::Log::error("The tiler needs at least one open file");
+            return false;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(outputDirectory, error);
+        if (error) {
+            tooling::Log::error("Failed to create tile directory {}: {}", outputDirectory.string(), error.message());
+            return false;
+        }
+        directory_ = outputDirectory;
+        threads_ = tooling::availableThreads(options_.threads);
+        const size_t budget = std::max<size_t>(options_.maxOpenFiles, 2);
+        spillSlots_ = std::clamp<size_t>(budget / 2, 1, threads_);
+        writerSlots_ = budget - spillSlots_;
+        if (options_.bounds) {
+            const auto& b = *options_.bounds;
+            const double columns = std::floor((b.maxX - options_.originX) / options_.tileSize) - std::floor((b.minX - options_.originX) / options_.tileSize) + 1;
+            const double rows = std::floor((b.maxY - options_.originY) / options_.tileSize) - std::floor((b.minY - options_.originY) / options_.tileSize) + 1;
+            if (columns > 0 && rows > 0 && columns * rows <= MAX_RESERVED_TILES) {
+                lookup_.reserve(static_cast<size_t>(columns * rows));
+            }
+            tooling::Log::info("Tiling into up to {} x {} tiles of {}", columns, rows, options_.tileSize);
+        }
+
+        std::vector<uint64_t> keys;
+        bool ok = prefetchChunks(reader, options_.chunkSize, QUEUE_DEPTH, [&](std::span<const PointXYZRGB> points) {
+            route(points, keys);
+            return buffered_ < options_.bufferPoints || flush();
+        });
+        ok = flush() && ok;
+        ok = finish() && ok;
+
+        if (dropped_ > 0) {
+            tooling::Log::warning("Dropped {} points with non-finite or out-of-grid coordinates", dropped_);
+        }
+        if (outsideBounds_ > 0) {
+            tooling::Log::warning("{} points lie outside the bounds announced by the input header", outsideBounds_);
+        }
+        return ok;
+    }
+
+    /** @brief Tiles written by the last run(), in the order they first received points */
+    std::vector<TileSummary> tiles() const {
+        std::vector<TileSummary> summaries;
+        summaries.reserve(tiles_.size());
+        for (const auto& tile : tiles_) {
+            summaries.push_back({tile.column, tile.row, options_.originX + static_cast<double>(tile.column) * options_.tileSize,
+                                 options_.originY + static_cast<double>(tile.row) * options_.tileSize, tile.path, tile.points});
+        }
+        return summaries;
+    }
+
+   private:
+    static constexpr size_t QUEUE_DEPTH = 4;
+    static constexpr double MAX_RESERVED_TILES = 1 << 20;
+    static constexpr int64_t TILE_LIMIT = int64_t{1} << 30;  // Tile coordinates lie in (-TILE_LIMIT, TILE_LIMIT)
+    static constexpr uint64_t NO_TILE = UINT64_MAX;
+    static constexpr size_t MIN_POINTS_PER_THREAD = 16384;
+    static constexpr size_t MIN_KEPT_CAPACITY = 1024;
+
+    struct Tile {
+        int64_t column = 0, row = 0;
+        std::filesystem::path path;
+        std::filesystem::path spillPath;  // Set once the tile spills
+        std::unique_ptr<PointWriter> writer;
+        std::vector<PointXYZRGB> buffer;
+        uint64_t points = 0;
+        bool failed = false;
+        bool reported = false;
+    };
+
+    // Tile key of every point in parallel, then a serial pass appends points to their buffers
+    void route(std::span<const PointXYZRGB> points, std::vector<uint64_t>& keys) {
+        keys.resize(points.size());
+        const unsigned threads = tooling::workerThreads(points.size(), threads_, MIN_POINTS_PER_THREAD);
+        tooling::parallelSlices(points.size(), threads, [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                keys[i] = keyOf(points[i].position);
+            }
+        });
+
+        uint64_t lastKey = NO_TILE;
+        Tile* last = nullptr;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (keys[i] == NO_TILE) {
+                ++dropped_;
+                continue;
+            }
+            if (keys[i] != lastKey) {
+                lastKey = keys[i];
+                last = &tileFor(keys[i]);
+            }
+            if (options_.bounds && !insideBounds(points[i].position)) {
+                ++outsideBounds_;
+            }
+            last->buffer.push_back(points[i]);
+            ++buffered_;
+        }
+    }
+
+    // Column and row offset to non-negative values, packed into the high and low 32 bits
+    uint64_t keyOf(const Point3D& p) const {
+        const double column = std::floor((static_cast<double>(p.x) - options_.originX) / options_.tileSize);
+        const double row = std::floor((static_cast<double>(p.y) - options_.originY) / options_.tileSize);
+        constexpr auto LIMIT = static_cast<double>(TILE_LIMIT);
+        if (!(std::abs(column) < LIMIT) || !(std::abs(row) < LIMIT)) {
+            return NO_TILE;  // Also catches NaN
+        }
+        return static_cast<uint64_t>(static_cast<int64_t>(column) + TILE_LIMIT) << 32 | static_cast<uint64_t>(static_cast<int64_t>(row) + TILE_LIMIT);
+    }
+
+    bool insideBounds(const Point3D& p) const {
+        const auto& b = *options_.bounds;
+        const double x = p.x, y = p.y;
+        return x >= b.minX && x <= b.maxX && y >= b.minY && y <= b.maxY;
+    }
+
+    Tile& tileFor(uint64_t key) {
+        auto [it, inserted] = lookup_.try_emplace(key, tiles_.size());
+        if (inserted) {
+            Tile& tile = tiles_.emplace_back();
+            tile.column = static_cast<int64_t>(key >> 32) - TILE_LIMIT;
+            tile.row = static_cast<int64_t>(key & 0xFFFFFFFFu) - TILE_LIMIT;
+            tile.path = directory_ / std::format("{}_{}_{}.{}", options_.prefix, corner(options_.originX, tile.column), corner(options_.originY, tile.row), options_.extension);
+        }
+        return tiles_[it->second];
+    }
+
+    std::string corner(double origin, int64_t index) const {
+        const double value = origin + static_cast<double>(index) * options_.tileSize;
+        return value == std::floor(value) ? std::format("{:.0f}", value) : std::format("{:.3f}", value);
+    }
+
+    // Serially open writers while the cap allows, then write every non-empty buffer, one tile per
+    // task, with no more spill files open at once than their share of the budget
+    bool flush() {
+        std::vector<Tile*> writing, spilling;
+        for (auto& tile : tiles_) {
+            if (tile.buffer.empty() || tile.failed) {
+                tile.buffer.clear();
+                continue;
+            }
+            if (!tile.writer && tile.spillPath.empty()) {
+                if (openWriters_ < writerSlots_) {
+                    tile.writer = factory_(tile.path);
+                    tile.failed = !tile.writer;
+                    openWriters_ += tile.writer ? 1u : 0u;
+                } else {
+                    tile.spillPath = tile.path;
+                    tile.spillPath += ".spill";
+                    std::ofstream(tile.spillPath, std::ios::binary | std::ios::trunc);
+                }
+            }
+            if (!tile.failed) {
+                (tile.writer ? writing : spilling).push_back(&tile);
+            }
+        }
+
+        // Buffers above an even share of the budget are released, so that capacity kept across
+        // flushes stays near bufferPoints however the points fall into tiles
+        const size_t share = std::max(options_.bufferPoints / std::max<size_t>(1, tiles_.size()), MIN_KEPT_CAPACITY);
+        const auto release = [share](Tile& tile) {
+            tile.points += tile.buffer.size();
+            if (tile.buffer.capacity() > share) {
+                std::vector<PointXYZRGB>().swap(tile.buffer);
+            } else {
+                tile.buffer.clear();
+            }
+        };
+        forEachTile(writing, threads_, [&](Tile& tile) {
+            tile.failed = !tile.writer->write(tile.buffer);
+            release(tile);
+        });
+        forEachTile(spilling, static_cast<unsigned>(spillSlots_), [&](Tile& tile) {
+            std::ofstream spill(tile.spillPath, std::ios::binary | std::ios::app);
+            spill.write(reinterpret_cast<const char*>(tile.buffer.data()), static_cast<std::streamsize>(tile.buffer.size() * sizeof(PointXYZRGB)));
+            tile.failed = !spill;
+            release(tile);
+        });
+        buffered_ = 0;
+        return reportFailures();
+    }
+
+    // Close the open writers, then encode the spilled tiles with two files open per task
+    bool finish() {
+        std::vector<Tile*> open, spilled;
+        for (auto& tile : tiles_) {
+            (tile.writer ? open : spilled).push_back(&tile);
+        }
+        forEachTile(open, threads_, [](Tile& tile) {
+            tile.failed = !tile.writer->close() || tile.failed;
+            tile.writer.reset();
+        });
+        openWriters_ = 0;
+
+        std::erase_if(spilled, [](const Tile* tile) { return tile->spillPath.empty(); });
+        forEachTile(spilled, static_cast<unsigned>(spillSlots_), [this](Tile& tile) {
+            if (!tile.failed) {
+                tile.failed = !encodeSpill(tile);
+            }
+            std::error_code ignored;
+            std::filesystem::remove(tile.spillPath, ignored);
+        });
+        return reportFailures();
+    }
+
+    bool encodeSpill(Tile& tile) const {
+        auto writer = factory_(tile.path);
+        if (!writer) {
+            return false;
+        }
+        std::ifstream spill(tile.spillPath, std::ios::binary);
+        std::vector<PointXYZRGB> chunk(options_.chunkSize > 0 ? options_.chunkSize : 1);
+        bool ok = static_cast<bool>(spill);
+        while (ok) {
+            spill.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size() * sizeof(PointXYZRGB)));
+            const auto count = static_cast<size_t>(spill.gcount()) / sizeof(PointXYZRGB);
+            if (count == 0) {
+                break;
+            }
+            ok = writer->write(std::span<const PointXYZRGB>(chunk.data(), count));
+        }
+        return writer->close() && ok;
+    }
+
+    template <typename Work>
+    static void forEachTile(std::span<Tile* const> tiles, unsigned threadCount, Work&& work) {
+        std::atomic<size_t> next{0};
+        auto worker = [&] {
+            for (size_t t = next++; t < tiles.size(); t = next++) {
+                work(*tiles[t]);
+            }
+        };
+        const auto threads = static_cast<unsigned>(std::min<size_t>(threadCount, tiles.size()));
+        tooling::runWorkers(threads, worker);
+    }
+
+    // Log each failed tile once; a failed tile receives no further points
+    bool reportFailures() {
+        bool ok = true;
+        for (auto& tile : tiles_) {
+            if (tile.failed) {
+                if (!tile.reported) {
+                    tooling::Log::error("Failed to write tile {}", tile.path.string());
+                    tile.reported = true;
+                }
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    Options options_;
+    WriterFactory factory_;
+    std::filesystem::path directory_;
+    unsigned threads_ = 1;
+    size_t writerSlots_ = 1;  // Share of the file budget for tile writers
+    size_t spillSlots_ = 1;   // Spill files open at once; encoding a spilled tile takes two files
+    std::vector<Tile> tiles_;
+    std::unordered_map<uint64_t, size_t> lookup_;  // Packed tile key -> index into tiles_
+    size_t buffered_ = 0;
+    size_t openWriters_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t outsideBounds_ = 0;
+};
+
+}  // namespace scanforge::io
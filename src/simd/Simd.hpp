@@ -0,0 +1,677 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SCANFORGE_SIMD_SSE2 1
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define SCANFORGE_SIMD_AVX2 1
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define SCANFORGE_SIMD_NEON 1
+#endif
+
+namespace scanforge::simd {
+
+/**
+ * @brief Small SIMD kernels shared by the point cloud codecs.
+ * Each kernel has an SSE2 (x86-64 baseline) and a NEON implementation and falls back to
+ * scalar code elsewhere, so results are identical on every platform: the reductions keep the
+ * same partial sums on every path and never fuse a multiply into an add. Wider AVX2 variants
+ * are compiled in when the build enables them (ENABLE_AVX2).
+ */
+
+/**
+ * @brief Finite-coordinate mask for four consecutive 16-byte {x, y, z, w} float records
+ * @param records Pointer to 64 bytes, no alignment requirement
+ * @return Bit i set when x, y and z of record i are all finite
+ */
+inline uint32_t finiteXYZMask4(const uint8_t* records) {
+#if defined(SCANFORGE_SIMD_SSE2)
+    const float* f = reinterpret_cast<const float*>(records);
+    const __m128 r0 = _mm_loadu_ps(f);
+    const __m128 r1 = _mm_loadu_ps(f + 4);
+    const __m128 r2 = _mm_loadu_ps(f + 8);
+    const __m128 r3 = _mm_loadu_ps(f + 12);
+
+    // Partial 4x4 transpose: only the x, y and z columns are needed
+    const __m128 xy01 = _mm_unpacklo_ps(r0, r1);
+    const __m128 xy23 = _mm_unpacklo_ps(r2, r3);
+    const __m128 zw01 = _mm_unpackhi_ps(r0, r1);
+    const __m128 zw23 = _mm_unpackhi_ps(r2, r3);
+    const __m128 x = _mm_movelh_ps(xy01, xy23);
+    const __m128 y = _mm_movehl_ps(xy23, xy01);
+    const __m128 z = _mm_movelh_ps(zw01, zw23);
+
+    // v - v is 0 for finite values and NaN for NaN/Inf, which never compares equal
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 fx = _mm_cmpeq_ps(_mm_sub_ps(x, x), zero);
+    const __m128 fy = _mm_cmpeq_ps(_mm_sub_ps(y, y), zero);
+    const __m128 fz = _mm_cmpeq_ps(_mm_sub_ps(z, z), zero);
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(fx, _mm_and_ps(fy, fz))));
+#elif defined(SCANFORGE_SIMD_NEON)
+    const float32x4x4_t v = vld4q_f32(reinterpret_cast<const float*>(records));
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const uint32x4_t fx = vceqq_f32(vsubq_f32(v.val[0], v.val[0]), zero);
+    const uint32x4_t fy = vceqq_f32(vsubq_f32(v.val[1], v.val[1]), zero);
+    const uint32x4_t fz = vceqq_f32(vsubq_f32(v.val[2], v.val[2]), zero);
+    const uint32x4_t m = vandq_u32(fx, vandq_u32(fy, fz));
+    return (vgetq_lane_u32(m, 0) & 1u) | (vgetq_lane_u32(m, 1) & 2u) | (vgetq_lane_u32(m, 2) & 4u) | (vgetq_lane_u32(m, 3) & 8u);
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < 4; ++i) {
+        float xyz[3];
+        std::memcpy(xyz, records + i * 16, sizeof(xyz));
+        if (std::isfinite(xyz[0]) && std::isfinite(xyz[1]) && std::isfinite(xyz[2])) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+#if defined(SCANFORGE_SIMD_SSE2)
+namespace detail {
+// In-register 4x4 transpose of 32-bit words; applied per 128-bit lane on AVX2
+template <typename V, typename Lo32, typename Hi32, typename Lo64, typename Hi64>
+inline void transpose4x4(V& a, V& b, V& c, V& d, Lo32 lo32, Hi32 hi32, Lo64 lo64, Hi64 hi64) {
+    const V ab0 = lo32(a, b);
+    const V ab1 = hi32(a, b);
+    const V cd0 = lo32(c, d);
+    const V cd1 = hi32(c, d);
+    a = lo64(ab0, cd0);
+    b = hi64(ab0, cd0);
+    c = lo64(ab1, cd1);
+    d = hi64(ab1, cd1);
+}
+
+inline void transpose4x4(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    transpose4x4(
+        a, b, c, d, [](__m128i x, __m128i y) { return _mm_unpacklo_epi32(x, y); }, [](__m128i x, __m128i y) { return _mm_unpackhi_epi32(x, y); },
+        [](__m128i x, __m128i y) { return _mm_unpacklo_epi64(x, y); }, [](__m128i x, __m128i y) { return _mm_unpackhi_epi64(x, y); });
+}
+
+    #if defined(SCANFORGE_SIMD_AVX2)
+inline void transpose4x4(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+    transpose4x4(
+        a, b, c, d, [](__m256i x, __m256i y) { return _mm256_unpacklo_epi32(x, y); }, [](__m256i x, __m256i y) { return _mm256_unpackhi_epi32(x, y); },
+        [](__m256i x, __m256i y) { return _mm256_unpacklo_epi64(x, y); }, [](__m256i x, __m256i y) { return _mm256_unpackhi_epi64(x, y); });
+}
+
+inline __m256i load2x128(const uint8_t* lo, const uint8_t* hi) {
+    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo));
+    const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(l), h, 1);
+}
+
+inline void store2x128(uint8_t* lo, uint8_t* hi, __m256i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lo), _mm256_castsi256_si128(v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hi), _mm256_extracti128_si256(v, 1));
+}
+    #endif
+}  // namespace detail
+#endif
+
+/**
+ * @brief Split 16-byte records of four 32-bit words into four word columns (AoS to SoA)
+ * @param records count * 16 bytes of interleaved records
+ * @param count Number of records
+ * @param columns Destination of 4 * count * 4 bytes: column k starts at k * count * 4
+ */
+inline void deinterleave4x32(const uint8_t* records, size_t count, uint8_t* columns) {
+    uint8_t* c0 = columns;
+    uint8_t* c1 = columns + count * 4;
+    uint8_t* c2 = columns + count * 8;
+    uint8_t* c3 = columns + count * 12;
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* r = records + i * 16;
+        __m256i a = detail::load2x128(r, r + 64);
+        __m256i b = detail::load2x128(r + 16, r + 80);
+        __m256i c = detail::load2x128(r + 32, r + 96);
+        __m256i d = detail::load2x128(r + 48, r + 112);
+        detail::transpose4x4(a, b, c, d);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c0 + i * 4), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c1 + i * 4), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c2 + i * 4), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c3 + i * 4), d);
+    }
+#endif
+#if defined(SCANFORGE_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        const uint8_t* r = records + i * 16;
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + 48));
+        detail::transpose4x4(a, b, c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c0 + i * 4), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c1 + i * 4), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c2 + i * 4), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c3 + i * 4), d);
+    }
+#elif defined(SCANFORGE_SIMD_NEON)
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4x4_t v = vld4q_u32(reinterpret_cast<const uint32_t*>(records + i * 16));
+        vst1q_u32(reinterpret_cast<uint32_t*>(c0 + i * 4), v.val[0]);
+        vst1q_u32(reinterpret_cast<uint32_t*>(c1 + i * 4), v.val[1]);
+        vst1q_u32(reinterpret_cast<uint32_t*>(c2 + i * 4), v.val[2]);
+        vst1q_u32(reinterpret_cast<uint32_t*>(c3 + i * 4), v.val[3]);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const uint8_t* r = records + i * 16;
+        std::memcpy(c0 + i * 4, r, 4);
+        std::memcpy(c1 + i * 4, r + 4, 4);
+        std::memcpy(c2 + i * 4, r + 8, 4);
+        std::memcpy(c3 + i * 4, r + 12, 4);
+    }
+}
+
+/**
+ * @brief Merge four 32-bit word columns into 16-byte records (SoA to AoS)
+ * @param columns 4 * count * 4 bytes: column k starts at k * count * 4
+ * @param count Number of records
+ * @param records Destination of count * 16 bytes
+ */
+inline void interleave4x32(const uint8_t* columns, size_t count, uint8_t* records) {
+    const uint8_t* c0 = columns;
+    const uint8_t* c1 = columns + count * 4;
+    const uint8_t* c2 = columns + count * 8;
+    const uint8_t* c3 = columns + count * 12;
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0 + i * 4));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c1 + i * 4));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c2 + i * 4));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c3 + i * 4));
+        detail::transpose4x4(a, b, c, d);
+        uint8_t* r = records + i * 16;
+        detail::store2x128(r, r + 64, a);
+        detail::store2x128(r + 16, r + 80, b);
+        detail::store2x128(r + 32, r + 96, c);
+        detail::store2x128(r + 48, r + 112, d);
+    }
+#endif
+#if defined(SCANFORGE_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + i * 4));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c1 + i * 4));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c2 + i * 4));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c3 + i * 4));
+        detail::transpose4x4(a, b, c, d);
+        uint8_t* r = records + i * 16;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + 48), d);
+    }
+#elif defined(SCANFORGE_SIMD_NEON)
+    for (; i + 4 <= count; i += 4) {
+        uint32x4x4_t v;
+        v.val[0] = vld1q_u32(reinterpret_cast<const uint32_t*>(c0 + i * 4));
+        v.val[1] = vld1q_u32(reinterpret_cast<const uint32_t*>(c1 + i * 4));
+        v.val[2] = vld1q_u32(reinterpret_cast<const uint32_t*>(c2 + i * 4));
+        v.val[3] = vld1q_u32(reinterpret_cast<const uint32_t*>(c3 + i * 4));
+        vst4q_u32(reinterpret_cast<uint32_t*>(records + i * 16), v);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        uint8_t* r = records + i * 16;
+        std::memcpy(r, c0 + i * 4, 4);
+        std::memcpy(r + 4, c1 + i * 4, 4);
+        std::memcpy(r + 8, c2 + i * 4, 4);
+        std::memcpy(r + 12, c3 + i * 4, 4);
+    }
+}
+
+/**
+ * @brief Dequantize integer coordinates: out[i] = float(values[i] * scale + offset)
+ * The arithmetic is done in double precision on every path, as LAS requires.
+ * @param values count input integers
+ * @param count Number of values
+ * @param scale Scale factor
+ * @param offset Offset added after scaling
+ * @param out Destination of count floats
+ */
+inline void scaleOffsetToFloat(const int32_t* values, size_t count, double scale, double offset, float* out) {
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    const __m256d scale4 = _mm256_set1_pd(scale);
+    const __m256d offset4 = _mm256_set1_pd(offset);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+        _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(v, scale4), offset4)));
+    }
+#elif defined(SCANFORGE_SIMD_SSE2)
+    const __m128d scale2 = _mm_set1_pd(scale);
+    const __m128d offset2 = _mm_set1_pd(offset);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        const __m128d lo = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(v), scale2), offset2);
+        const __m128d hi = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), scale2), offset2);
+        _mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+    }
+#elif defined(SCANFORGE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    const float64x2_t scale2 = vdupq_n_f64(scale);
+    const float64x2_t offset2 = vdupq_n_f64(offset);
+    for (; i + 4 <= count; i += 4) {
+        const int32x4_t v = vld1q_s32(values + i);
+        // Separate multiply and add: a fused multiply-add would round differently from the scalar path
+        const float64x2_t lo = vaddq_f64(vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(v))), scale2), offset2);
+        const float64x2_t hi = vaddq_f64(vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(v))), scale2), offset2);
+        vst1q_f32(out + i, vcombine_f32(vcvt_f32_f64(lo), vcvt_f32_f64(hi)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = static_cast<float>(static_cast<double>(values[i]) * scale + offset);
+    }
+}
+
+/**
+ * @brief Quantize float coordinates: out[i] = round((values[i] - offset) * inverseScale)
+ * Computed in double precision and rounded to nearest-even like the dequantization above.
+ * Results saturate to the int32 range; NaN maps to INT32_MIN on every path.
+ * @param values count input floats
+ * @param count Number of values
+ * @param offset Offset subtracted before scaling
+ * @param inverseScale Reciprocal of the scale factor
+ * @param out Destination of count integers
+ */
+inline void quantizeToInt32(const float* values, size_t count, double offset, double inverseScale, int32_t* out) {
+    constexpr double LOWEST = -2147483648.0;
+    constexpr double HIGHEST = 2147483647.0;
+    size_t i = 0;
+
+    // max(v, LOWEST) returns LOWEST for NaN, the scalar tail mirrors that operand order
+#if defined(SCANFORGE_SIMD_AVX2)
+    const __m256d o4 = _mm256_set1_pd(offset);
+    const __m256d s4 = _mm256_set1_pd(inverseScale);
+    const __m256d lo4 = _mm256_set1_pd(LOWEST);
+    const __m256d hi4 = _mm256_set1_pd(HIGHEST);
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_mul_pd(_mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(values + i)), o4), s4);
+        v = _mm256_min_pd(_mm256_max_pd(v, lo4), hi4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtpd_epi32(v));
+    }
+#elif defined(SCANFORGE_SIMD_SSE2)
+    const __m128d o2 = _mm_set1_pd(offset);
+    const __m128d s2 = _mm_set1_pd(inverseScale);
+    const __m128d lo2 = _mm_set1_pd(LOWEST);
+    const __m128d hi2 = _mm_set1_pd(HIGHEST);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 f = _mm_loadu_ps(values + i);
+        __m128d a = _mm_mul_pd(_mm_sub_pd(_mm_cvtps_pd(f), o2), s2);
+        __m128d b = _mm_mul_pd(_mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(f, f)), o2), s2);
+        a = _mm_min_pd(_mm_max_pd(a, lo2), hi2);
+        b = _mm_min_pd(_mm_max_pd(b, lo2), hi2);
+        const __m128i ints = _mm_unpacklo_epi64(_mm_cvtpd_epi32(a), _mm_cvtpd_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), ints);
+    }
+#elif defined(SCANFORGE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    const float64x2_t o2 = vdupq_n_f64(offset);
+    const float64x2_t s2 = vdupq_n_f64(inverseScale);
+    const float64x2_t lo2 = vdupq_n_f64(LOWEST);
+    const float64x2_t hi2 = vdupq_n_f64(HIGHEST);
+    auto clamp = [&](float64x2_t v) {
+        v = vbslq_f64(vcgtq_f64(v, lo2), v, lo2);  // NaN compares false and becomes LOWEST
+        return vbslq_f64(vcltq_f64(v, hi2), v, hi2);
+    };
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t f = vld1q_f32(values + i);
+        const float64x2_t a = clamp(vmulq_f64(vsubq_f64(vcvt_f64_f32(vget_low_f32(f)), o2), s2));
+        const float64x2_t b = clamp(vmulq_f64(vsubq_f64(vcvt_high_f64_f32(f), o2), s2));
+        vst1q_s32(out + i, vcombine_s32(vmovn_s64(vcvtnq_s64_f64(a)), vmovn_s64(vcvtnq_s64_f64(b))));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        double v = (static_cast<double>(values[i]) - offset) * inverseScale;
+        v = v > LOWEST ? v : LOWEST;
+        v = v < HIGHEST ? v : HIGHEST;
+        out[i] = static_cast<int32_t>(std::nearbyint(v));
+    }
+}
+
+/**
+ * @brief Minimum and maximum of a float column; NaN values are ignored
+ * The accumulators start at +inf and -inf, so a NaN anywhere, the first value included, is
+ * skipped. With no value other than NaN, minValue is +inf and maxValue is -inf: an empty
+ * range that leaves bounds it is merged into unchanged.
+ * @param values count floats
+ * @param count Number of values
+ * @param minValue Receives the smallest value
+ * @param maxValue Receives the largest value
+ */
+inline void minMax(const float* values, size_t count, float& minValue, float& maxValue) {
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    float lo = INF;
+    float hi = -INF;
+    size_t i = 0;
+
+    // min/max(value, acc) return acc when value is NaN, matching the scalar std::min(acc, value)
+#if defined(SCANFORGE_SIMD_AVX2)
+    if (count >= 8) {
+        __m256 lo8 = _mm256_set1_ps(INF);
+        __m256 hi8 = _mm256_set1_ps(-INF);
+        for (; i + 8 <= count; i += 8) {
+            const __m256 v = _mm256_loadu_ps(values + i);
+            lo8 = _mm256_min_ps(v, lo8);
+            hi8 = _mm256_max_ps(v, hi8);
+        }
+        alignas(32) float los[8], his[8];
+        _mm256_store_ps(los, lo8);
+        _mm256_store_ps(his, hi8);
+        for (size_t k = 0; k < 8; ++k) {
+            lo = std::min(lo, los[k]);
+            hi = std::max(hi, his[k]);
+        }
+    }
+#elif defined(SCANFORGE_SIMD_SSE2)
+    if (count >= 4) {
+        __m128 lo4 = _mm_set1_ps(INF);
+        __m128 hi4 = _mm_set1_ps(-INF);
+        for (; i + 4 <= count; i += 4) {
+            const __m128 v = _mm_loadu_ps(values + i);
+            lo4 = _mm_min_ps(v, lo4);
+            hi4 = _mm_max_ps(v, hi4);
+        }
+        alignas(16) float los[4], his[4];
+        _mm_store_ps(los, lo4);
+        _mm_store_ps(his, hi4);
+        for (size_t k = 0; k < 4; ++k) {
+            lo = std::min(lo, los[k]);
+            hi = std::max(hi, his[k]);
+        }
+    }
+#elif defined(SCANFORGE_SIMD_NEON)
+    if (count >= 4) {
+        // vminnm/vmaxnm pick the number when one operand is NaN
+        float32x4_t lo4 = vdupq_n_f32(INF);
+        float32x4_t hi4 = vdupq_n_f32(-INF);
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t v = vld1q_f32(values + i);
+            lo4 = vminnmq_f32(lo4, v);
+            hi4 = vmaxnmq_f32(hi4, v);
+        }
+        float los[4], his[4];
+        vst1q_f32(los, lo4);
+        vst1q_f32(his, hi4);
+        for (size_t k = 0; k < 4; ++k) {
+            lo = std::min(lo, los[k]);
+            hi = std::max(hi, his[k]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    minValue = lo;
+    maxValue = hi;
+}
+
+/**
+ * @brief Sum of a float column, accumulated in double precision
+ * Every path keeps eight partial sums, one per index modulo 8, and combines them in the same
+ * order, so the result is identical on every instruction set but can differ from a sequential
+ * loop in the last bits.
+ * @param values count floats
+ * @param count Number of values
+ * @return The sum
+ */
+inline double sum(const float* values, size_t count) {
+    double total = 0.0;
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_cvtps_pd(_mm_loadu_ps(values + i)));
+        acc1 = _mm256_add_pd(acc1, _mm256_cvtps_pd(_mm_loadu_ps(values + i + 4)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SCANFORGE_SIMD_SSE2)
+    __m128d acc[4] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+    for (; i + 8 <= count; i += 8) {
+        const __m128 v0 = _mm_loadu_ps(values + i);
+        const __m128 v1 = _mm_loadu_ps(values + i + 4);
+        acc[0] = _mm_add_pd(acc[0], _mm_cvtps_pd(v0));
+        acc[1] = _mm_add_pd(acc[1], _mm_cvtps_pd(_mm_movehl_ps(v0, v0)));
+        acc[2] = _mm_add_pd(acc[2], _mm_cvtps_pd(v1));
+        acc[3] = _mm_add_pd(acc[3], _mm_cvtps_pd(_mm_movehl_ps(v1, v1)));
+    }
+    alignas(16) double lanes[4];
+    _mm_store_pd(lanes, _mm_add_pd(acc[0], acc[2]));
+    _mm_store_pd(lanes + 2, _mm_add_pd(acc[1], acc[3]));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SCANFORGE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    float64x2_t acc[4] = {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+    for (; i + 8 <= count; i += 8) {
+        const float32x4_t v0 = vld1q_f32(values + i);
+        const float32x4_t v1 = vld1q_f32(values + i + 4);
+        acc[0] = vaddq_f64(acc[0], vcvt_f64_f32(vget_low_f32(v0)));
+        acc[1] = vaddq_f64(acc[1], vcvt_high_f64_f32(v0));
+        acc[2] = vaddq_f64(acc[2], vcvt_f64_f32(vget_low_f32(v1)));
+        acc[3] = vaddq_f64(acc[3], vcvt_high_f64_f32(v1));
+    }
+    total = vaddvq_f64(vaddq_f64(acc[0], acc[2])) + vaddvq_f64(vaddq_f64(acc[1], acc[3]));
+#else
+    double lanes[8] = {};
+    for (; i + 8 <= count; i += 8) {
+        for (size_t k = 0; k < 8; ++k) {
+            lanes[k] += static_cast<double>(values[i + k]);
+        }
+    }
+    total = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+#endif
+
+    for (; i < count; ++i) {
+        total += static_cast<double>(values[i]);
+    }
+    return total;
+}
+
+/**
+ * @brief Sum of squared deviations from a mean, accumulated in double precision
+ * Partial sums are laid out and combined as in sum(), each square rounded before it is added,
+ * so this too is identical on every instruction set. With the column's own mean this is its
+ * M2 term, which divided by the count gives the population variance.
+ * @param values count floats
+ * @param count Number of values
+ * @param mean Value the deviations are taken from
+ * @return The sum of (values[i] - mean)^2
+ */
+inline double sumSquaredDeviations(const float* values, size_t count, double mean) {
+    double total = 0.0;
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    const __m256d center = _mm256_set1_pd(mean);
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= count; i += 8) {
+        const __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(values + i)), center);
+        const __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(values + i + 4)), center);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SCANFORGE_SIMD_SSE2)
+    const __m128d center = _mm_set1_pd(mean);
+    __m128d acc[4] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+    for (; i + 8 <= count; i += 8) {
+        const __m128 v0 = _mm_loadu_ps(values + i);
+        const __m128 v1 = _mm_loadu_ps(values + i + 4);
+        const __m128d d[4] = {_mm_sub_pd(_mm_cvtps_pd(v0), center), _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v0, v0)), center),
+                              _mm_sub_pd(_mm_cvtps_pd(v1), center), _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v1, v1)), center)};
+        for (int k = 0; k < 4; ++k) {
+            acc[k] = _mm_add_pd(acc[k], _mm_mul_pd(d[k], d[k]));
+        }
+    }
+    alignas(16) double lanes[4];
+    _mm_store_pd(lanes, _mm_add_pd(acc[0], acc[2]));
+    _mm_store_pd(lanes + 2, _mm_add_pd(acc[1], acc[3]));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SCANFORGE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    const float64x2_t center = vdupq_n_f64(mean);
+    float64x2_t acc[4] = {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+    for (; i + 8 <= count; i += 8) {
+        const float32x4_t v0 = vld1q_f32(values + i);
+        const float32x4_t v1 = vld1q_f32(values + i + 4);
+        const float64x2_t d[4] = {vsubq_f64(vcvt_f64_f32(vget_low_f32(v0)), center), vsubq_f64(vcvt_high_f64_f32(v0), center),
+                                  vsubq_f64(vcvt_f64_f32(vget_low_f32(v1)), center), vsubq_f64(vcvt_high_f64_f32(v1), center)};
+        for (int k = 0; k < 4; ++k) {
+            acc[k] = vaddq_f64(acc[k], vmulq_f64(d[k], d[k]));  // Not vfmaq_f64: x86 rounds the square too
+        }
+    }
+    total = vaddvq_f64(vaddq_f64(acc[0], acc[2])) + vaddvq_f64(vaddq_f64(acc[1], acc[3]));
+#else
+    double lanes[8] = {};
+    for (; i + 8 <= count; i += 8) {
+        for (size_t k = 0; k < 8; ++k) {
+            const double d = static_cast<double>(values[i + k]) - mean;
+            lanes[k] += d * d;
+        }
+    }
+    total = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+#endif
+
+    for (; i < count; ++i) {
+        const double d = static_cast<double>(values[i]) - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+/**
+ * @brief Apply a row-major 3x4 affine transform in place to x/y/z columns
+ * @param x, y, z count floats each
+ * @param count Number of points
+ * @param m Twelve coefficients: x' = m[0] x + m[1] y + m[2] z + m[3], and so on for y' and z'
+ */
+inline void transformAffine(float* x, float* y, float* z, size_t count, const float* m) {
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = _mm256_loadu_ps(y + i);
+        const __m256 vz = _mm256_loadu_ps(z + i);
+        auto row = [&](const float* r) {
+            __m256 v = _mm256_add_ps(_mm256_mul_ps(vx, _mm256_set1_ps(r[0])), _mm256_mul_ps(vy, _mm256_set1_ps(r[1])));
+            return _mm256_add_ps(_mm256_add_ps(v, _mm256_mul_ps(vz, _mm256_set1_ps(r[2]))), _mm256_set1_ps(r[3]));
+        };
+        _mm256_storeu_ps(x + i, row(m));
+        _mm256_storeu_ps(y + i, row(m + 4));
+        _mm256_storeu_ps(z + i, row(m + 8));
+    }
+#elif defined(SCANFORGE_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+        auto row = [&](const float* r) {
+            __m128 v = _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(r[0])), _mm_mul_ps(vy, _mm_set1_ps(r[1])));
+            return _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(vz, _mm_set1_ps(r[2]))), _mm_set1_ps(r[3]));
+        };
+        _mm_storeu_ps(x + i, row(m));
+        _mm_storeu_ps(y + i, row(m + 4));
+        _mm_storeu_ps(z + i, row(m + 8));
+    }
+#elif defined(SCANFORGE_SIMD_NEON)
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t vx = vld1q_f32(x + i);
+        const float32x4_t vy = vld1q_f32(y + i);
+        const float32x4_t vz = vld1q_f32(z + i);
+        // Separate multiply and add keep results identical to the scalar path
+        auto row = [&](const float* r) {
+            float32x4_t v = vaddq_f32(vmulq_n_f32(vx, r[0]), vmulq_n_f32(vy, r[1]));
+            return vaddq_f32(vaddq_f32(v, vmulq_n_f32(vz, r[2])), vdupq_n_f32(r[3]));
+        };
+        vst1q_f32(x + i, row(m));
+        vst1q_f32(y + i, row(m + 4));
+        vst1q_f32(z + i, row(m + 8));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float px = x[i], py = y[i], pz = z[i];
+        x[i] = ((m[0] * px + m[1] * py) + m[2] * pz) + m[3];
+        y[i] = ((m[4] * px + m[5] * py) + m[6] * pz) + m[7];
+        z[i] = ((m[8] * px + m[9] * py) + m[10] * pz) + m[11];
+    }
+}
+
+/**
+ * @brief Flag points lying inside an axis-aligned box (bounds inclusive, NaN is outside)
+ * @param x, y, z count floats each
+ * @param count Number of points
+ * @param lo Box minimum {x, y, z}
+ * @param hi Box maximum {x, y, z}
+ * @param inside Receives 1 for points inside the box, 0 otherwise
+ */
+inline void insideBox(const float* x, const float* y, const float* z, size_t count, const float* lo, const float* hi, uint8_t* inside) {
+    size_t i = 0;
+
+#if defined(SCANFORGE_SIMD_SSE2)
+    const __m128 lx = _mm_set1_ps(lo[0]), ly = _mm_set1_ps(lo[1]), lz = _mm_set1_ps(lo[2]);
+    const __m128 hx = _mm_set1_ps(hi[0]), hy = _mm_set1_ps(hi[1]), hz = _mm_set1_ps(hi[2]);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+        __m128 in = _mm_and_ps(_mm_cmpge_ps(vx, lx), _mm_cmple_ps(vx, hx));
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(vy, ly), _mm_cmple_ps(vy, hy)));
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(vz, lz), _mm_cmple_ps(vz, hz)));
+        const int mask = _mm_movemask_ps(in);
+        for (size_t k = 0; k < 4; ++k) {
+            inside[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+        }
+    }
+#elif defined(SCANFORGE_SIMD_NEON)
+    const float32x4_t lx = vdupq_n_f32(lo[0]), ly = vdupq_n_f32(lo[1]), lz = vdupq_n_f32(lo[2]);
+    const float32x4_t hx = vdupq_n_f32(hi[0]), hy = vdupq_n_f32(hi[1]), hz = vdupq_n_f32(hi[2]);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t vx = vld1q_f32(x + i);
+        const float32x4_t vy = vld1q_f32(y + i);
+        const float32x4_t vz = vld1q_f32(z + i);
+        uint32x4_t in = vandq_u32(vcgeq_f32(vx, lx), vcleq_f32(vx, hx));
+        in = vandq_u32(in, vandq_u32(vcgeq_f32(vy, ly), vcleq_f32(vy, hy)));
+        in = vandq_u32(in, vandq_u32(vcgeq_f32(vz, lz), vcleq_f32(vz, hz)));
+        uint32_t lanes[4];
+        vst1q_u32(lanes, in);
+        for (size_t k = 0; k < 4; ++k) {
+            inside[i + k] = static_cast<uint8_t>(lanes[k] & 1);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        inside[i] = static_cast<uint8_t>(x[i] >= lo[0] && x[i] <= hi[0] && y[i] >= lo[1] && y[i] <= hi[1] && z[i] >= lo[2] && z[i] <= hi[2]);
+    }
+}
+
+}  // namespace scanforge::simd
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "tooling/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace scanforge::spatial {
+
+/** @brief True if p is finite */
+inline bool isFinite(const Point3D& p) { return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z); }
+
+/**
+ * @brief Finite bounds of a cloud's positions, computed by slices on up to threads threads
+ * @return {min, max} and the number of finite points; {0,0,0} twice when there are none
+ */
+template <typename PointT>
+std::pair<std::pair<Point3D, Point3D>, size_t> finiteBounds(const PointCloud<PointT>& cloud, unsigned threads) {
+    struct Part {
+        Point3D min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+        Point3D max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+        size_t count = 0;
+    };
+    const size_t slice = (cloud.size() + std::max(1u, threads) - 1) / std::max(1u, threads);
+    std::vector<Part> parts(std::max<size_t>(1, threads));
+    tooling::parallelSlices(cloud.size(), threads, [&](size_t first, size_t count) {
+        Part& part = parts[slice > 0 ? first / slice : 0];
+        for (size_t i = first; i < first + count; ++i) {
+            const Point3D& p = getPosition(cloud.points[i]);
+            if (!isFinite(p)) {
+                continue;
+            }
+            part.min = {std::min(part.min.x, p.x), std::min(part.min.y, p.y), std::min(part.min.z, p.z)};
+            part.max = {std::max(part.max.x, p.x), std::max(part.max.y, p.y), std::max(part.max.z, p.z)};
+            ++part.count;
+        }
+    });
+
+    Part total;
+    for (const auto& part : parts) {
+        total.min = {std::min(total.min.x, part.min.x), std::min(total.min.y, part.min.y), std::min(total.min.z, part.min.z)};
+        total.max = {std::max(total.max.x, part.max.x), std::max(total.max.y, part.max.y), std::max(total.max.z, part.max.z)};
+        total.count += part.count;
+    }
+    if (total.count == 0) {
+        return {{{0, 0, 0}, {0, 0, 0}}, 0};
+    }
+    return {{total.min, total.max}, total.count};
+}
+
+/** @brief True if p lies in the inclusive box [min, max] */
+inline bool insideBox(const Point3D& p, const Point3D& min, const Point3D& max) {
+    return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+}
+
+/** @brief Squared distance from p to the nearest point of the box [min, max], 0 inside it */
+inline float squaredDistanceToBox(const Point3D& p, const Point3D& min, const Point3D& max) {
+    const float dx = std::max({min.x - p.x, 0.0f, p.x - max.x});
+    const float dy = std::max({min.y - p.y, 0.0f, p.y - max.y});
+    const float dz = std::max({min.z - p.z, 0.0f, p.z - max.z});
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/** @brief Squared distance from p to the farthest corner of the box [min, max] */
+inline float squaredDistanceToFarCorner(const Point3D& p, const Point3D& min, const Point3D& max) {
+    const float dx = std::max(p.x - min.x, max.x - p.x);
+    const float dy = std::max(p.y - min.y, max.y - p.y);
+    const float dz = std::max(p.z - min.z, max.z - p.z);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+inline float squaredDistance(const Point3D& a, const Point3D& b) {
+    const Point3D d = a - b;
+    return d.dot(d);
+}
+
+}  // namespace scanforge::spatial
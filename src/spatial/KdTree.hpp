@@ -0,0 +1,272 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "spatial/Geometry.hpp"
+#include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace scanforge::spatial {
+using Log = scanforge::tooling::Log;
+
+/**
+ * @brief KD-tree over the positions of a point cloud for k-nearest and radius searches
+ *
+ * The tree is implicit: build() reorders a copy of the positions so that the node of a range
+ * [first, last) is its median element, split on the axis recorded for it, with the two halves
+ * as children. Ranges of at most LEAF_SIZE points are scanned. The tree stores a position,
+ * a cloud index and an axis byte per point and nothing else, so memory is proportional to the
+ * point count. Non-finite points are not indexed.
+ *
+ * Results are ordered by distance, ties by cloud index, so they do not depend on the tree
+ * layout or on the number of threads a batch runs on.
+ *
+ * @code
+ * KdTree<PointXYZRGB> tree(cloud, 0);
+ * auto nearest = tree.knnSearch(cloud[0].position, 8);
+ * auto batch = tree.knnSearch(queries, 8, 0);  // queries.size() * 8 neighbours
+ * @endcode
+ */
+template <typename PointT>
+class KdTree {
+   public:
+    struct Neighbor {
+        uint32_t index;         // Index into the indexed cloud
+        float squaredDistance;  // Squared distance to the query
+
+        bool operator<(const Neighbor& other) const {
+            return squaredDistance < other.squaredDistance || (squaredDistance == other.squaredDistance && index < other.index);
+        }
+    };
+
+    static constexpr uint32_t LEAF_SIZE = 16;
+    static constexpr uint32_t NO_NEIGHBOR = std::numeric_limits<uint32_t>::max();
+
+    KdTree() = default;
+
+    /** @copydoc build */
+    explicit KdTree(const PointCloud<PointT>& cloud, unsigned threadCount = 1) { build(cloud, threadCount); }
+
+    /**
+     * @brief Index the positions of a cloud, replacing the previous content
+     * @param cloud Points to index; the tree keeps a copy of their positions, not a reference
+     * @param threadCount Threads splitting the upper levels; 0 uses every hardware thread
+     * @return False if the cloud has more points than 32-bit indices address
+     */
+    bool build(const PointCloud<PointT>& cloud, unsigned threadCount = 1) {
+        entries_.clear();
+        axes_.clear();
+        if (cloud.size() > std::numeric_limits<uint32_t>::max()) {
+            Log::error("A KD-tree indexes at most {} points, not {}", std::numeric_limits<uint32_t>::max(), cloud.size());
+            return false;
+        }
+
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            const Point3D& p = getPosition(cloud.points[i]);
+            if (isFinite(p)) {
+                entries_.push_back({p, static_cast<uint32_t>(i)});
+            }
+        }
+        entries_.shrink_to_fit();
+        axes_.assign(entries_.size(), 0);
+
+        const unsigned threads = tooling::workerThreads(entries_.size(), threadCount, MIN_POINTS_PER_THREAD);
+        buildRange(0, entries_.size(), threads);
+        Log::debug("KD-tree of {} points built on {} threads", entries_.size(), threads);
+        return true;
+    }
+
+    bool empty() const { return entries_.empty(); }
+
+    /** @brief Number of indexed (finite) points */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief The k points nearest to query, nearest first
+     * @param out Replaced by min(k, size()) neighbours
+     */
+    void knnSearch(const Point3D& query, size_t k, std::vector<Neighbor>& out) const {
+        out.clear();
+        k = std::min(k, entries_.size());
+        if (k == 0 || !isFinite(query)) {
+            return;
+        }
+        out.reserve(k);
+        searchNearest(query, k, 0, entries_.size(), out);
+        std::sort_heap(out.begin(), out.end());
+    }
+
+    std::vector<Neighbor> knnSearch(const Point3D& query, size_t k) const {
+        std::vector<Neighbor> out;
+        knnSearch(query, k, out);
+        return out;
+    }
+
+    /**
+     * @brief Points within radius of query, boundary included, nearest first
+     * @param out Replaced by the neighbours found
+     */
+    void radiusSearch(const Point3D& query, float radius, std::vector<Neighbor>& out) const {
+        out.clear();
+        if (entries_.empty() || !isFinite(query) || !(radius >= 0)) {
+            return;
+        }
+        searchRadius(query, radius * radius, 0, entries_.size(), out);
+        std::sort(out.begin(), out.end());
+    }
+
+    std::vector<Neighbor> radiusSearch(const Point3D& query, float radius) const {
+        std::vector<Neighbor> out;
+        radiusSearch(query, radius, out);
+        return out;
+    }
+
+    /**
+     * @brief k-nearest search for every query, spread over threads
+     * @return min(k, size()) neighbours per query, query after query, nearest first; a
+     *         non-finite query gets entries with index NO_NEIGHBOR and infinite distance
+     */
+    std::vector<Neighbor> knnSearch(std::span<const Point3D> queries, size_t k, unsigned threadCount = 1) const {
+        k = std::min(k, entries_.size());
+        std::vector<Neighbor> out(queries.size() * k, Neighbor{NO_NEIGHBOR, std::numeric_limits<float>::infinity()});
+        forEachQuery(queries.size(), threadCount, [&](size_t q, std::vector<Neighbor>& scratch) {
+            knnSearch(queries[q], k, scratch);
+            std::copy(scratch.begin(), scratch.end(), out.begin() + static_cast<ptrdiff_t>(q * k));
+        });
+        return out;
+    }
+
+    /** @brief Radius search for every query, spread over threads; one result list per query */
+    std::vector<std::vector<Neighbor>> radiusSearch(std::span<const Point3D> queries, float radius, unsigned threadCount = 1) const {
+        std::vector<std::vector<Neighbor>> out(queries.size());
+        forEachQuery(queries.size(), threadCount, [&](size_t q, std::vector<Neighbor>&) { radiusSearch(queries[q], radius, out[q]); });
+        return out;
+    }
+
+   private:
+    struct Entry {
+        Point3D position;
+        uint32_t index;
+    };
+
+    static constexpr size_t MIN_POINTS_PER_THREAD = 65536;
+    static constexpr size_t QUERIES_PER_TASK = 256;  // Batch granularity, small enough to balance uneven queries
+
+    static float coordinate(const Point3D& p, unsigned axis) { return axis == 0 ? p.x : axis == 1 ? p.y : p.z; }
+
+    // Median split on the widest axis of the range; the halves of the upper levels build on their own threads
+    void buildRange(size_t first, size_t last, unsigned threads) {
+        while (last - first > LEAF_SIZE) {
+            Point3D min = entries_[first].position;
+            Point3D max = min;
+            for (size_t i = first + 1; i < last; ++i) {
+                const Point3D& p = entries_[i].position;
+                min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+                max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+            }
+            const Point3D extent = max - min;
+            const unsigned axis = extent.x >= extent.y && extent.x >= extent.z ? 0u : extent.y >= extent.z ? 1u : 2u;
+
+            const size_t middle = first + (last - first) / 2;
+            std::nth_element(entries_.begin() + static_cast<ptrdiff_t>(first), entries_.begin() + static_cast<ptrdiff_t>(middle), entries_.begin() + static_cast<ptrdiff_t>(last),
+                             [axis](const Entry& a, const Entry& b) { return coordinate(a.position, axis) < coordinate(b.position, axis); });
+            axes_[middle] = static_cast<uint8_t>(axis);
+
+            if (threads > 1) {
+                tooling::parallelInvoke([this, first, middle, half = threads / 2] { buildRange(first, middle, half); },
+                                        [this, middle, last, rest = threads - threads / 2] { buildRange(middle + 1, last, rest); });
+                return;
+            }
+            buildRange(first, middle, 1);
+            first = middle + 1;
+        }
+    }
+
+    // Max-heap of the best k so far; ties keep the lower index
+    void offer(std::vector<Neighbor>& heap, size_t k, const Neighbor& candidate) const {
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    void searchNearest(const Point3D& query, size_t k, size_t first, size_t last, std::vector<Neighbor>& heap) const {
+        if (last - first <= LEAF_SIZE) {
+            for (size_t i = first; i < last; ++i) {
+                offer(heap, k, {entries_[i].index, squaredDistance(query, entries_[i].position)});
+            }
+            return;
+        }
+        const size_t middle = first + (last - first) / 2;
+        offer(heap, k, {entries_[middle].index, squaredDistance(query, entries_[middle].position)});
+
+        const unsigned axis = axes_[middle];
+        const float offset = coordinate(query, axis) - coordinate(entries_[middle].position, axis);
+        const bool lowerFirst = offset < 0;
+        searchNearest(query, k, lowerFirst ? first : middle + 1, lowerFirst ? middle : last, heap);
+        // Equal distances still matter: a farther-side point may win a tie on its index
+        if (heap.size() < k || offset * offset <= heap.front().squaredDistance) {
+            searchNearest(query, k, lowerFirst ? middle + 1 : first, lowerFirst ? last : middle, heap);
+        }
+    }
+
+    void searchRadius(const Point3D& query, float r2, size_t first, size_t last, std::vector<Neighbor>& out) const {
+        if (last - first <= LEAF_SIZE) {
+            for (size_t i = first; i < last; ++i) {
+                const float d2 = squaredDistance(query, entries_[i].position);
+                if (d2 <= r2) {
+                    out.push_back({entries_[i].index, d2});
+                }
+            }
+            return;
+        }
+        const size_t middle = first + (last - first) / 2;
+        const float d2 = squaredDistance(query, entries_[middle].position);
+        if (d2 <= r2) {
+            out.push_back({entries_[middle].index, d2});
+        }
+
+        const unsigned axis = axes_[middle];
+        const float offset = coordinate(query, axis) - coordinate(entries_[middle].position, axis);
+        if (offset <= 0 || offset * offset <= r2) {
+            searchRadius(query, r2, first, middle, out);
+        }
+        if (offset >= 0 || offset * offset <= r2) {
+            searchRadius(query, r2, middle + 1, last, out);
+        }
+    }
+
+    // Workers claim QUERIES_PER_TASK queries at a time; each keeps one scratch vector
+    template <typename Work>
+    void forEachQuery(size_t count, unsigned threadCount, Work&& work) const {
+        const size_t tasks = (count + QUERIES_PER_TASK - 1) / QUERIES_PER_TASK;
+        const unsigned threads = tooling::workerThreads(tasks, threadCount, 1);
+        std::atomic<size_t> nextTask{0};
+        auto worker = [&] {
+            std::vector<Neighbor> scratch;
+            for (size_t task = nextTask++; task < tasks; task = nextTask++) {
+                const size_t end = std::min(count, (task + 1) * QUERIES_PER_TASK);
+                for (size_t q = task * QUERIES_PER_TASK; q < end; ++q) {
+                    work(q, scratch);
+                }
+            }
+        };
+        tooling::runWorkers(threads, worker);
+    }
+
+    std::vector<Entry> entries_;  // Indexed points in tree order
+    std::vector<uint8_t> axes_;   // Split axis of the node whose median sits at each entry
+};
+
+}  // namespace scanforge::spatial
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "spatial/Geometry.hpp"
+#include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace scanforge::spatial {
+
+/**
+ * @brief Morton (Z-order) codes of 21 bits per axis
+ *
+ * Interleaving the bits of quantized x, y and z gives a 63-bit key whose sort order walks
+ * space octant by octant: every octree cell, at every depth, is one contiguous key range.
+ * Octant bits are x = 1, y = 2, z = 4 at each level.
+ */
+namespace morton {
+
+inline constexpr unsigned BITS = 21;                    // Bits per axis
+inline constexpr uint32_t CELLS = uint32_t{1} << BITS;  // Grid cells per axis at full depth
+
+/** @brief Spread the low 21 bits of v two bits apart */
+constexpr uint64_t expand(uint32_t v) {
+    uint64_t x = v & (CELLS - 1);
+    x = (x | x << 32) & 0x1F00000000FFFFull;
+    x = (x | x << 16) & 0x1F0000FF0000FFull;
+    x = (x | x << 8) & 0x100F00F00F00F00Full;
+    x = (x | x << 4) & 0x10C30C30C30C30C3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+/** @brief Inverse of expand(): gather every third bit */
+constexpr uint32_t compact(uint64_t x) {
+    x &= 0x1249249249249249ull;
+    x = (x | x >> 2) & 0x10C30C30C30C30C3ull;
+    x = (x | x >> 4) & 0x100F00F00F00F00Full;
+    x = (x | x >> 8) & 0x1F0000FF0000FFull;
+    x = (x | x >> 16) & 0x1F00000000FFFFull;
+    x = (x | x >> 32) & (CELLS - 1);
+    return static_cast<uint32_t>(x);
+}
+
+constexpr uint64_t encode(uint32_t x, uint32_t y, uint32_t z) { return expand(x) | expand(y) << 1 | expand(z) << 2; }
+
+constexpr std::array<uint32_t, 3> decode(uint64_t code) { return {compact(code), compact(code >> 1), compact(code >> 2)}; }
+
+/** @brief Octant (0-7) of a code at depth 1..BITS below the root */
+constexpr unsigned octant(uint64_t code, unsigned depth) { return static_cast<unsigned>(code >> (3 * (BITS - depth))) & 7u; }
+
+/**
+ * @brief Quantizes positions inside a cube to the full-depth Morton grid
+ */
+struct Quantizer {
+    Point3D origin{0, 0, 0};
+    float size = 0;  // Cube edge length
+
+    /** @brief Smallest cube holding the bounds; the maximum lands in the last cell */
+    static Quantizer cubeAround(const Point3D& min, const Point3D& max) {
+        const float extent = std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+        return {min, extent > 0 ? extent : 1.0f};
+    }
+
+    uint32_t cell(float value, float low) const {
+        const double scaled = (static_cast<double>(value) - static_cast<double>(low)) / static_cast<double>(size) * CELLS;
+        return static_cast<uint32_t>(std::clamp(scaled, 0.0, static_cast<double>(CELLS - 1)));
+    }
+
+    uint64_t encode(const Point3D& p) const { return morton::encode(cell(p.x, origin.x), cell(p.y, origin.y), cell(p.z, origin.z)); }
+};
+
+}  // namespace morton
+
+/** @brief A sort key and the index of the point it belongs to */
+struct KeyedIndex {
+    uint64_t key;
+    uint32_t index;
+};
+
+/**
+ * @brief Stable parallel LSD radix sort of keyed indices by key
+ *
+ * Keys are sorted RADIX_BITS at a time, lowest digit first. Each pass counts digits per thread
+ * slice, turns the counts into per-slice output offsets and scatters every slice on its own
+ * thread, so equal keys keep their input order whatever the thread count. Passes whose digit is
+ * the same for every key are skipped, which makes small-extent keys cheap to sort.
+ */
+inline void sortByKey(std::span<KeyedIndex> entries, unsigned threadCount) {
+    constexpr unsigned RADIX_BITS = 16;  // Four passes over 64-bit keys, with a 512 KiB count table per slice
+    constexpr size_t BUCKETS = size_t{1} << RADIX_BITS;
+    constexpr size_t MIN_ENTRIES_PER_THREAD = 65536;
+    constexpr size_t SMALL_SORT = 256;  // Below this a comparison sort wins
+
+    if (entries.size() <= SMALL_SORT) {
+        std::stable_sort(entries.begin(), entries.end(), [](const KeyedIndex& a, const KeyedIndex& b) { return a.key < b.key; });
+        return;
+    }
+
+    const unsigned threads = tooling::workerThreads(entries.size(), threadCount, MIN_ENTRIES_PER_THREAD);
+    const size_t slice = (entries.size() + threads - 1) / threads;
+    std::vector<KeyedIndex> buffer(entries.size());
+    std::vector<size_t> counts(threads * BUCKETS);
+    std::span<KeyedIndex> from = entries;
+    std::span<KeyedIndex> to = buffer;
+
+    for (unsigned shift = 0; shift < 64; shift += RADIX_BITS) {
+        std::fill(counts.begin(), counts.end(), 0);
+        tooling::parallelSlices(entries.size(), threads, [&](size_t first, size_t count) {
+            size_t* histogram = counts.data() + first / slice * BUCKETS;
+            for (size_t i = first; i < first + count; ++i) {
+                ++histogram[(from[i].key >> shift) & (BUCKETS - 1)];
+            }
+        });
+
+        // Digit-major, slice-minor prefix sum: slice t writes digit d after slices 0..t-1 did
+        size_t offset = 0;
+        bool single = false;
+        for (size_t digit = 0; digit < BUCKETS && !single; ++digit) {
+            size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t) {
+                total += counts[t * BUCKETS + digit];
+            }
+            single = total == entries.size();
+        }
+        if (single) {
+            continue;
+        }
+        for (size_t digit = 0; digit < BUCKETS; ++digit) {
+            for (unsigned t = 0; t < threads; ++t) {
+                const size_t count = counts[t * BUCKETS + digit];
+                counts[t * BUCKETS + digit] = offset;
+                offset += count;
+            }
+        }
+
+        tooling::parallelSlices(entries.size(), threads, [&](size_t first, size_t count) {
+            size_t* next = counts.data() + first / slice * BUCKETS;
+            for (size_t i = first; i < first + count; ++i) {
+                to[next[(from[i].key >> shift) & (BUCKETS - 1)]++] = from[i];
+            }
+        });
+        std::swap(from, to);
+    }
+
+    if (from.data() != entries.data()) {
+        std::copy(from.begin(), from.end(), entries.begin());
+    }
+}
+
+/**
+ * @brief Permutation that orders a cloud along the Morton curve of its bounding cube
+ *
+ * Positions are quantized to 21 bits per axis against the finite bounds of the cloud, which
+ * are getBoundingBox() for a cloud without NaN or infinite coordinates. Points with equal codes
+ * keep their relative order, and non-finite points come last in input order.
+ *
+ * @return order[i] is the input index of the i-th point in Morton order
+ */
+template <typename PointT>
+std::vector<uint32_t> mortonOrder(const PointCloud<PointT>& cloud, unsigned threadCount = 1) {
+    SCANFORGE_PROFILE_SCOPE("morton.order");
+    constexpr size_t MIN_POINTS_PER_THREAD = 65536;
+    const unsigned threads = tooling::workerThreads(cloud.size(), threadCount, MIN_POINTS_PER_THREAD);
+    const auto [bounds, finite] = finiteBounds(cloud, threads);
+    const auto grid = morton::Quantizer::cubeAround(bounds.first, bounds.second);
+
+    std::vector<KeyedIndex> entries(cloud.size());
+    tooling::parallelSlices(cloud.size(), threads, [&](size_t first, size_t count) {
+        for (size_t i = first; i < first + count; ++i) {
+            const Point3D& p = getPosition(cloud.points[i]);
+            entries[i] = {isFinite(p) ? grid.encode(p) : std::numeric_limits<uint64_t>::max(), static_cast<uint32_t>(i)};
+        }
+    });
+    sortByKey(entries, threadCount);
+
+    std::vector<uint32_t> order(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        order[i] = entries[i].index;
+    }
+    return order;
+}
+
+/**
+ * @brief Reorder a cloud along the Morton curve of its bounding cube (see mortonOrder())
+ *
+ * Neighbouring points end up next to each other in memory and in files written afterwards,
+ * which speeds up spatial queries and improves compression. The cloud becomes unorganized.
+ *
+ * @return False if the cloud has more points than 32-bit indices address
+ */
+template <typename PointT>
+bool sortMorton(PointCloud<PointT>& cloud, unsigned threadCount = 1) {
+    SCANFORGE_PROFILE_SCOPE("morton.sort");
+    if (cloud.size() > std::numeric_limits<uint32_t>::max()) {
+        tooling::Log::error("Morton sorting handles at most {} points, not {}", std::numeric_limits<uint32_t>::max(), cloud.size());
+        return false;
+    }
+    const auto order = mortonOrder(cloud, threadCount);
+    std::pmr::vector<PointT> sorted(cloud.size(), cloud.memoryResource());
+    tooling::parallelSlices(order.size(), tooling::workerThreads(order.size(), threadCount, 65536), [&](size_t first, size_t count) {
+        for (size_t i = first; i < first + count; ++i) {
+            sorted[i] = cloud.points[order[i]];
+        }
+    });
+    cloud.points = std::move(sorted);
+    cloud.width = static_cast<uint32_t>(cloud.size());
+    cloud.height = 1;
+    return true;
+}
+
+}  // namespace scanforge::spatial
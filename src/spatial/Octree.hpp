@@ -0,0 +1,275 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "spatial/Geometry.hpp"
+#include "spatial/Morton.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace scanforge::spatial {
+using Log = scanforge::tooling::Log;
+
+/**
+ * @brief Octree over the positions of a point cloud, stored as one linear node array
+ *
+ * Points are sorted along a Morton curve, so the points of every node form one contiguous
+ * range of indices() and positions(). Nodes are laid out breadth first with the children of a
+ * node next to each other, and a node is split while it holds more than maxPointsPerLeaf
+ * points and the 21-level Morton grid has levels left. Each node keeps the tight bounds of its
+ * points, which prunes queries better than the cube it covers. Non-finite points are not indexed.
+ *
+ * Queries report indices into the indexed cloud, in Morton order.
+ *
+ * @code
+ * Octree<PointXYZRGB> octree(cloud, Octree<PointXYZRGB>::DEFAULT_LEAF_SIZE, 0);
+ * auto inside = octree.boxQuery({0, 0, 0}, {10, 10, 2});
+ * auto near = octree.radiusQuery(cloud[42].position, 0.5f);
+ * @endcode
+ */
+template <typename PointT>
+class Octree {
+   public:
+    struct Node {
+        Point3D min{0, 0, 0};     // Tight bounds of the points below the node
+        Point3D max{0, 0, 0};
+        uint32_t first = 0;       // Start of the node's range in indices() and positions()
+        uint32_t count = 0;       // Points below the node
+        uint32_t firstChild = 0;  // Children are nodes [firstChild, firstChild + popcount(childMask))
+        uint8_t childMask = 0;    // Bit o is set when octant o (x = 1, y = 2, z = 4) has a child
+        uint8_t depth = 0;        // 0 for the root
+
+        bool isLeaf() const { return childMask == 0; }
+        uint32_t childCount() const { return static_cast<uint32_t>(std::popcount(childMask)); }
+    };
+
+    static constexpr uint32_t DEFAULT_LEAF_SIZE = 64;
+
+    Octree() = default;
+
+    /** @copydoc build */
+    explicit Octree(const PointCloud<PointT>& cloud, uint32_t maxPointsPerLeaf = DEFAULT_LEAF_SIZE, unsigned threadCount = 1) { build(cloud, maxPointsPerLeaf, threadCount); }
+
+    /**
+     * @brief Index the positions of a cloud, replacing the previous content
+     * @param cloud Points to index; the octree keeps a copy of their positions, not a reference
+     * @param maxPointsPerLeaf Largest leaf, except at the deepest level where duplicates gather
+     * @param threadCount Threads computing codes, sorting and bounding nodes; 0 uses every hardware thread
+     * @return False if the cloud has more points than 32-bit indices address
+     */
+    bool build(const PointCloud<PointT>& cloud, uint32_t maxPointsPerLeaf = DEFAULT_LEAF_SIZE, unsigned threadCount = 1) {
+        nodes_.clear();
+        indices_.clear();
+        positions_.clear();
+        if (cloud.size() > std::numeric_limits<uint32_t>::max()) {
+            Log::error("An octree indexes at most {} points, not {}", std::numeric_limits<uint32_t>::max(), cloud.size());
+            return false;
+        }
+
+        const unsigned threads = tooling::workerThreads(cloud.size(), threadCount, MIN_POINTS_PER_THREAD);
+        const auto [bounds, finite] = finiteBounds(cloud, threads);
+        if (finite == 0) {
+            return true;
+        }
+        const auto grid = morton::Quantizer::cubeAround(bounds.first, bounds.second);
+
+        // Non-finite points get the largest key and are cut off after the sort
+        std::vector<KeyedIndex> entries(cloud.size());
+        tooling::parallelSlices(cloud.size(), threads, [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                const Point3D& p = getPosition(cloud.points[i]);
+                entries[i] = {isFinite(p) ? grid.encode(p) : NOT_INDEXED, static_cast<uint32_t>(i)};
+            }
+        });
+        sortByKey(entries, threads);
+        entries.resize(finite);
+
+        indices_.resize(finite);
+        positions_.resize(finite);
+        tooling::parallelSlices(finite, threads, [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                indices_[i] = entries[i].index;
+                positions_[i] = getPosition(cloud.points[entries[i].index]);
+            }
+        });
+
+        buildNodes(entries, std::max(1u, maxPointsPerLeaf));
+        computeBounds(threads);
+        Log::debug("Octree of {} points: {} nodes, depth {}", finite, nodes_.size(), depth());
+        return true;
+    }
+
+    bool empty() const { return indices_.empty(); }
+
+    /** @brief Number of indexed (finite) points */
+    size_t size() const { return indices_.size(); }
+
+    /** @brief Every node, breadth first; nodes()[0] is the root unless the octree is empty */
+    std::span<const Node> nodes() const { return nodes_; }
+    std::span<const Node> children(const Node& node) const { return std::span<const Node>(nodes_).subspan(node.firstChild, node.childCount()); }
+
+    /** @brief Deepest node level, 0 for a single leaf */
+    unsigned depth() const {
+        return nodes_.empty() ? 0 : nodes_.back().depth;  // Breadth-first order ends on the deepest level
+    }
+
+    /** @brief Cloud indices of all points in Morton order, or of the points below node */
+    std::span<const uint32_t> indices() const { return indices_; }
+    std::span<const uint32_t> indices(const Node& node) const { return std::span<const uint32_t>(indices_).subspan(node.first, node.count); }
+
+    /** @brief Positions in the order of indices() */
+    std::span<const Point3D> positions() const { return positions_; }
+    std::span<const Point3D> positions(const Node& node) const { return std::span<const Point3D>(positions_).subspan(node.first, node.count); }
+
+    /**
+     * @brief Append the indices of the points inside the inclusive box [min, max]
+     * @param out Receives cloud indices, in Morton order
+     */
+    void boxQuery(const Point3D& min, const Point3D& max, std::vector<uint32_t>& out) const {
+        query(
+            out, [&](const Node& node) { return node.max.x >= min.x && node.min.x <= max.x && node.max.y >= min.y && node.min.y <= max.y && node.max.z >= min.z && node.min.z <= max.z; },
+            [&](const Node& node) { return insideBox(node.min, min, max) && insideBox(node.max, min, max); }, [&](const Point3D& p) { return insideBox(p, min, max); });
+    }
+
+    std::vector<uint32_t> boxQuery(const Point3D& min, const Point3D& max) const {
+        std::vector<uint32_t> out;
+        boxQuery(min, max, out);
+        return out;
+    }
+
+    /**
+     * @brief Append the indices of the points within radius of center, boundary included
+     * @param out Receives cloud indices, in Morton order; nothing for a negative or NaN radius
+     */
+    void radiusQuery(const Point3D& center, float radius, std::vector<uint32_t>& out) const {
+        if (!(radius >= 0)) {
+            return;
+        }
+        const float r2 = radius * radius;
+        query(
+            out, [&](const Node& node) { return squaredDistanceToBox(center, node.min, node.max) <= r2; },
+            [&](const Node& node) { return squaredDistanceToFarCorner(center, node.min, node.max) <= r2; },
+            [&](const Point3D& p) { return squaredDistance(p, center) <= r2; });
+    }
+
+    std::vector<uint32_t> radiusQuery(const Point3D& center, float radius) const {
+        std::vector<uint32_t> out;
+        radiusQuery(center, radius, out);
+        return out;
+    }
+
+   private:
+    static constexpr size_t MIN_POINTS_PER_THREAD = 65536;
+    static constexpr uint64_t NOT_INDEXED = std::numeric_limits<uint64_t>::max();
+
+    // Split nodes breadth first: the children of a node are the octant runs of its key range
+    void buildNodes(std::span<const KeyedIndex> entries, uint32_t maxPointsPerLeaf) {
+        nodes_.push_back(Node{.first = 0, .count = static_cast<uint32_t>(entries.size())});
+        for (size_t n = 0; n < nodes_.size(); ++n) {
+            const Node node = nodes_[n];
+            if (node.count <= maxPointsPerLeaf || node.depth == morton::BITS) {
+                continue;
+            }
+
+            const unsigned depth = node.depth + 1u;
+            const auto firstChild = static_cast<uint32_t>(nodes_.size());
+            uint8_t mask = 0;
+            auto begin = entries.begin() + node.first;
+            const auto end = begin + node.count;
+            for (unsigned octant = 0; octant < 8 && begin != end; ++octant) {
+                const auto split = std::partition_point(begin, end, [&](const KeyedIndex& e) { return morton::octant(e.key, depth) <= octant; });
+                if (split != begin) {
+                    mask = static_cast<uint8_t>(mask | (1u << octant));
+                    nodes_.push_back(Node{.first = static_cast<uint32_t>(begin - entries.begin()), .count = static_cast<uint32_t>(split - begin), .depth = static_cast<uint8_t>(depth)});
+                }
+                begin = split;
+            }
+            nodes_[n].firstChild = firstChild;
+            nodes_[n].childMask = mask;
+        }
+    }
+
+    // Leaves bound their points in parallel, then parents merge their children from the deepest level up
+    void computeBounds(unsigned threads) {
+        tooling::parallelSlices(nodes_.size(), threads, [&](size_t first, size_t count) {
+            for (size_t n = first; n < first + count; ++n) {
+                Node& node = nodes_[n];
+                if (!node.isLeaf()) {
+                    continue;
+                }
+                node.min = node.max = positions_[node.first];
+                for (const Point3D& p : positions(node)) {
+                    node.min = {std::min(node.min.x, p.x), std::min(node.min.y, p.y), std::min(node.min.z, p.z)};
+                    node.max = {std::max(node.max.x, p.x), std::max(node.max.y, p.y), std::max(node.max.z, p.z)};
+                }
+            }
+        });
+
+        for (size_t n = nodes_.size(); n-- > 0;) {
+            Node& node = nodes_[n];
+            if (node.isLeaf()) {
+                continue;
+            }
+            node.min = nodes_[node.firstChild].min;
+            node.max = nodes_[node.firstChild].max;
+            for (const Node& child : children(node)) {
+                node.min = {std::min(node.min.x, child.min.x), std::min(node.min.y, child.min.y), std::min(node.min.z, child.min.z)};
+                node.max = {std::max(node.max.x, child.max.x), std::max(node.max.y, child.max.y), std::max(node.max.z, child.max.z)};
+            }
+        }
+    }
+
+    /**
+     * Depth-first traversal: nodes that overlap the region are opened, nodes it contains are
+     * reported whole, and the points of the leaves it crosses are tested one by one
+     */
+    template <typename Overlaps, typename Contains, typename Accept>
+    void query(std::vector<uint32_t>& out, Overlaps&& overlaps, Contains&& contains, Accept&& accept) const {
+        if (nodes_.empty()) {
+            return;
+        }
+
+        // A node pops before its up to 8 children are pushed, so 7 slots per level bound the stack
+        std::array<uint32_t, 7 * morton::BITS + 8> stack;
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes_[stack[--top]];
+            if (!overlaps(node)) {
+                continue;
+            }
+            if (contains(node)) {
+                const auto range = indices(node);
+                out.insert(out.end(), range.begin(), range.end());
+                continue;
+            }
+            if (node.isLeaf()) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    if (accept(positions_[i])) {
+                        out.push_back(indices_[i]);
+                    }
+                }
+                continue;
+            }
+            // Pushed last to first so that children pop in Morton order
+            for (uint32_t c = node.firstChild + node.childCount(); c-- > node.firstChild;) {
+                stack[top++] = c;
+            }
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> indices_;    // Cloud index of every indexed point, Morton order
+    std::vector<Point3D> positions_;  // Their positions, so that queries never touch the cloud
+};
+
+}  // namespace scanforge::spatial
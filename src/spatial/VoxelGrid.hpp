@@ -0,0 +1,307 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+#include "spatial/Geometry.hpp"
+#include "spatial/Morton.hpp"
+#include "tooling/Logger.hpp"
+#include "tooling/Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace scanforge::spatial {
+using Log = scanforge::tooling::Log;
+
+/**
+ * @brief Flat hashed voxel grid over the positions of a point cloud
+ *
+ * Space is cut into cubes of voxelSize and each occupied cube becomes one Voxel, found in O(1)
+ * through an open-addressing hash table. Points are sorted by the Morton code of their voxel,
+ * so the points of a voxel are one contiguous range and neighbouring voxels sit close together
+ * in memory. A point p lies in voxel floor(p / voxelSize) on each axis. Non-finite points are
+ * not indexed.
+ *
+ * @code
+ * VoxelGrid<Point3D> grid(cloud, 0.25f, 0);
+ * if (const auto* voxel = grid.find(cloud[0])) {
+ *     auto sameVoxel = grid.indices(*voxel);
+ * }
+ * @endcode
+ */
+template <typename PointT>
+class VoxelGrid {
+   public:
+    struct Voxel {
+        int32_t x, y, z;  // Voxel coordinates, floor(position / voxelSize)
+        uint32_t first;   // Start of the voxel's range in indices() and positions()
+        uint32_t count;
+    };
+
+    VoxelGrid() = default;
+
+    /** @copydoc build */
+    VoxelGrid(const PointCloud<PointT>& cloud, float voxelSize, unsigned threadCount = 1) { build(cloud, voxelSize, threadCount); }
+
+    /**
+     * @brief Index the positions of a cloud, replacing the previous content
+     * @param cloud Points to index; the grid keeps a copy of their positions, not a reference
+     * @param voxelSize Edge length of a voxel
+     * @param threadCount Threads computing keys and sorting; 0 uses every hardware thread
+     * @return False for a voxel size that is not positive, or for a cloud spanning more than
+     *         2^21 voxels on an axis or more points than 32-bit indices address
+     */
+    bool build(const PointCloud<PointT>& cloud, float voxelSize, unsigned threadCount = 1) {
+        voxels_.clear();
+        slots_.clear();
+        indices_.clear();
+        positions_.clear();
+        voxelSize_ = 0;
+        if (!(voxelSize > 0) || !std::isfinite(voxelSize)) {
+            Log::error("Voxel size must be positive, not {}", voxelSize);
+            return false;
+        }
+        if (cloud.size() > std::numeric_limits<uint32_t>::max()) {
+            Log::error("A voxel grid indexes at most {} points, not {}", std::numeric_limits<uint32_t>::max(), cloud.size());
+            return false;
+        }
+
+        const unsigned threads = tooling::workerThreads(cloud.size(), threadCount, MIN_POINTS_PER_THREAD);
+        const auto [bounds, finite] = finiteBounds(cloud, threads);
+        if (finite == 0) {
+            voxelSize_ = voxelSize;
+            return true;
+        }
+        const double low[3] = {cellCoordinate(bounds.first.x, voxelSize), cellCoordinate(bounds.first.y, voxelSize), cellCoordinate(bounds.first.z, voxelSize)};
+        const double high[3] = {cellCoordinate(bounds.second.x, voxelSize), cellCoordinate(bounds.second.y, voxelSize), cellCoordinate(bounds.second.z, voxelSize)};
+        for (int axis = 0; axis < 3; ++axis) {
+            if (low[axis] < std::numeric_limits<int32_t>::min() || high[axis] > std::numeric_limits<int32_t>::max() || high[axis] - low[axis] >= morton::CELLS) {
+                Log::error("Voxel size {} is too small for the extent of the cloud", voxelSize);
+                return false;
+            }
+        }
+        voxelSize_ = voxelSize;
+        origin_ = {static_cast<int64_t>(low[0]), static_cast<int64_t>(low[1]), static_cast<int64_t>(low[2])};
+        last_ = {static_cast<int64_t>(high[0]), static_cast<int64_t>(high[1]), static_cast<int64_t>(high[2])};
+
+        // Non-finite points get the largest key and are cut off after the sort
+        std::vector<KeyedIndex> entries(cloud.size());
+        tooling::parallelSlices(cloud.size(), threads, [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                const Point3D& p = getPosition(cloud.points[i]);
+                entries[i] = {isFinite(p) ? keyOf(cellOf(p)) : NOT_INDEXED, static_cast<uint32_t>(i)};
+            }
+        });
+        sortByKey(entries, threads);
+        entries.resize(finite);
+
+        indices_.resize(finite);
+        positions_.resize(finite);
+        tooling::parallelSlices(finite, threads, [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                indices_[i] = entries[i].index;
+                positions_[i] = getPosition(cloud.points[entries[i].index]);
+            }
+        });
+
+        for (size_t begin = 0; begin < finite;) {
+            size_t end = begin + 1;
+            while (end < finite && entries[end].key == entries[begin].key) {
+                ++end;
+            }
+            const auto cell = morton::decode(entries[begin].key);
+            voxels_.push_back({static_cast<int32_t>(origin_[0] + cell[0]), static_cast<int32_t>(origin_[1] + cell[1]), static_cast<int32_t>(origin_[2] + cell[2]),
+                               static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)});
+            begin = end;
+        }
+        buildTable();
+        Log::debug("Voxel grid of {} points: {} voxels of size {}", finite, voxels_.size(), voxelSize_);
+        return true;
+    }
+
+    bool empty() const { return indices_.empty(); }
+
+    /** @brief Number of indexed (finite) points */
+    size_t size() const { return indices_.size(); }
+
+    float voxelSize() const { return voxelSize_; }
+
+    /** @brief Occupied voxels in Morton order */
+    std::span<const Voxel> voxels() const { return voxels_; }
+
+    /** @brief Voxel coordinates of a position */
+    std::array<int64_t, 3> cellOf(const Point3D& p) const {
+        return {static_cast<int64_t>(cellCoordinate(p.x, voxelSize_)), static_cast<int64_t>(cellCoordinate(p.y, voxelSize_)), static_cast<int64_t>(cellCoordinate(p.z, voxelSize_))};
+    }
+
+    /** @brief Occupied voxel at the given coordinates, or nullptr */
+    const Voxel* find(int64_t x, int64_t y, int64_t z) const {
+        if (voxels_.empty() || x < origin_[0] || x > last_[0] || y < origin_[1] || y > last_[1] || z < origin_[2] || z > last_[2]) {
+            return nullptr;
+        }
+        for (size_t slot = slotOf(keyOf({x, y, z}));; slot = (slot + 1) & (slots_.size() - 1)) {
+            if (slots_[slot] == EMPTY_SLOT) {
+                return nullptr;
+            }
+            const Voxel& voxel = voxels_[slots_[slot]];
+            if (voxel.x == x && voxel.y == y && voxel.z == z) {
+                return &voxel;
+            }
+        }
+    }
+
+    /** @brief Occupied voxel holding a position, or nullptr */
+    const Voxel* find(const Point3D& p) const {
+        if (!isFinite(p) || voxels_.empty()) {
+            return nullptr;
+        }
+        const auto cell = cellOf(p);
+        return find(cell[0], cell[1], cell[2]);
+    }
+
+    /** @brief Cloud indices of all points in voxel order, or of the points of one voxel */
+    std::span<const uint32_t> indices() const { return indices_; }
+    std::span<const uint32_t> indices(const Voxel& voxel) const { return std::span<const uint32_t>(indices_).subspan(voxel.first, voxel.count); }
+
+    /** @brief Positions in the order of indices() */
+    std::span<const Point3D> positions() const { return positions_; }
+    std::span<const Point3D> positions(const Voxel& voxel) const { return std::span<const Point3D>(positions_).subspan(voxel.first, voxel.count); }
+
+    /**
+     * @brief Append the indices of the points inside the inclusive box [min, max]
+     *
+     * Voxels strictly inside the box's voxel range are reported whole; only the voxels on its
+     * border are tested point by point.
+     */
+    void boxQuery(const Point3D& min, const Point3D& max, std::vector<uint32_t>& out) const {
+        if (voxels_.empty() || !isFinite(min) || !isFinite(max)) {
+            return;
+        }
+        const auto low = cellOf(min);
+        const auto high = cellOf(max);
+        forEachVoxel(low, high, [&](const Voxel& voxel) {
+            // Division is monotonic, so a point of an interior voxel cannot fall outside the box
+            if (voxel.x > low[0] && voxel.x < high[0] && voxel.y > low[1] && voxel.y < high[1] && voxel.z > low[2] && voxel.z < high[2]) {
+                const auto range = indices(voxel);
+                out.insert(out.end(), range.begin(), range.end());
+                return;
+            }
+            appendIf(voxel, out, [&](const Point3D& p) { return insideBox(p, min, max); });
+        });
+    }
+
+    std::vector<uint32_t> boxQuery(const Point3D& min, const Point3D& max) const {
+        std::vector<uint32_t> out;
+        boxQuery(min, max, out);
+        return out;
+    }
+
+    /** @brief Append the indices of the points within radius of center, boundary included */
+    void radiusQuery(const Point3D& center, float radius, std::vector<uint32_t>& out) const {
+        if (voxels_.empty() || !isFinite(center) || !(radius >= 0)) {
+            return;
+        }
+        const float r2 = radius * radius;
+        const Point3D extent{radius, radius, radius};
+        forEachVoxel(cellOf(center - extent), cellOf(center + extent), [&](const Voxel& voxel) {
+            appendIf(voxel, out, [&](const Point3D& p) { return squaredDistance(p, center) <= r2; });
+        });
+    }
+
+    std::vector<uint32_t> radiusQuery(const Point3D& center, float radius) const {
+        std::vector<uint32_t> out;
+        radiusQuery(center, radius, out);
+        return out;
+    }
+
+   private:
+    static constexpr size_t MIN_POINTS_PER_THREAD = 65536;
+    static constexpr uint64_t NOT_INDEXED = std::numeric_limits<uint64_t>::max();
+    static constexpr uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+
+    // Computed in double so that the cell of a value never decreases as the value grows; clamped
+    // far beyond any valid cell so that converting it to int64_t stays defined
+    static double cellCoordinate(float value, float size) {
+        constexpr double LIMIT = 0x1p62;
+        return std::clamp(std::floor(static_cast<double>(value) / static_cast<double>(size)), -LIMIT, LIMIT);
+    }
+
+    // Morton code relative to the first occupied cell; the cell must lie in [origin_, last_]
+    uint64_t keyOf(const std::array<int64_t, 3>& cell) const {
+        return morton::encode(static_cast<uint32_t>(cell[0] - origin_[0]), static_cast<uint32_t>(cell[1] - origin_[1]), static_cast<uint32_t>(cell[2] - origin_[2]));
+    }
+
+    size_t slotOf(uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> tableShift_); }
+
+    // Power-of-two table at most half full, linear probing
+    void buildTable() {
+        const size_t capacity = std::bit_ceil(std::max<size_t>(2 * voxels_.size(), 2));
+        tableShift_ = 64u - static_cast<unsigned>(std::countr_zero(capacity));
+        slots_.assign(capacity, EMPTY_SLOT);
+        for (size_t v = 0; v < voxels_.size(); ++v) {
+            const Voxel& voxel = voxels_[v];
+            size_t slot = slotOf(keyOf({voxel.x, voxel.y, voxel.z}));
+            while (slots_[slot] != EMPTY_SLOT) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            slots_[slot] = static_cast<uint32_t>(v);
+        }
+    }
+
+    // Visit the occupied voxels in [low, high], probing each cell when that is cheaper than a scan
+    template <typename Visit>
+    void forEachVoxel(std::array<int64_t, 3> low, std::array<int64_t, 3> high, Visit&& visit) const {
+        uint64_t cells = 1;
+        for (size_t axis = 0; axis < 3; ++axis) {
+            low[axis] = std::max(low[axis], origin_[axis]);
+            high[axis] = std::min(high[axis], last_[axis]);
+            if (low[axis] > high[axis]) {
+                return;
+            }
+            cells *= static_cast<uint64_t>(high[axis] - low[axis] + 1);
+        }
+
+        if (cells <= voxels_.size()) {
+            for (int64_t z = low[2]; z <= high[2]; ++z) {
+                for (int64_t y = low[1]; y <= high[1]; ++y) {
+                    for (int64_t x = low[0]; x <= high[0]; ++x) {
+                        if (const Voxel* voxel = find(x, y, z)) {
+                            visit(*voxel);
+                        }
+                    }
+                }
+            }
+            return;
+        }
+        for (const Voxel& voxel : voxels_) {
+            if (voxel.x >= low[0] && voxel.x <= high[0] && voxel.y >= low[1] && voxel.y <= high[1] && voxel.z >= low[2] && voxel.z <= high[2]) {
+                visit(voxel);
+            }
+        }
+    }
+
+    template <typename Accept>
+    void appendIf(const Voxel& voxel, std::vector<uint32_t>& out, Accept&& accept) const {
+        for (uint32_t i = voxel.first; i < voxel.first + voxel.count; ++i) {
+            if (accept(positions_[i])) {
+                out.push_back(indices_[i]);
+            }
+        }
+    }
+
+    float voxelSize_ = 0;
+    std::array<int64_t, 3> origin_{};  // First and last occupied voxel coordinates on each axis
+    std::array<int64_t, 3> last_{};
+    unsigned tableShift_ = 63;
+    std::vector<Voxel> voxels_;
+    std::vector<uint32_t> slots_;      // Index into voxels_ per hash slot, EMPTY_SLOT when free
+    std::vector<uint32_t> indices_;
+    std::vector<Point3D> positions_;
+};
+
+}  // namespace scanforge::spatial
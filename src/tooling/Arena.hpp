@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace scanforge::tooling {
+
+/** @brief Byte buffer allocating from a std::pmr::memory_resource, an Arena say */
+using ByteBuffer = std::pmr::vector<uint8_t>;
+
+/**
+ * @brief Monotonic memory resource reset between units of work, keeping its memory
+ *
+ * Allocations bump a pointer through one block and deallocation does nothing; reset() frees
+ * everything at once. Whatever did not fit the block during a cycle comes from the upstream
+ * resource, and the next reset() replaces the block by one as large as that cycle needed.
+ * A worker that loads file after file therefore stops calling upstream once the block has
+ * grown to its largest file.
+ *
+ * Not thread safe: allocate from one thread at a time. The loaders only allocate from their
+ * resource on the calling thread, whatever the number of decoding threads.
+ *
+ * @code
+ * tooling::Arena arena;
+ * PCDProcessor processor(&arena);
+ * for (const auto& path : paths) {
+ *     {
+ *         auto [header, cloud] = processor.loadPCD(path);  // Points and scratch buffers live in arena
+ *         process(cloud);
+ *     }
+ *     arena.reset();  // Every cloud of the cycle must be gone
+ * }
+ * @endcode
+ */
+class Arena final : public std::pmr::memory_resource {
+   public:
+    /**
+     * @param initialBytes Size of the first block; 0 defers it to the first reset() after use
+     * @param upstream Resource providing the block and whatever does not fit it
+     */
+    explicit Arena(size_t initialBytes = 0, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : upstream_(upstream), overflow_(upstream) {
+        grow(initialBytes);
+    }
+
+    ~Arena() override { grow(0); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /** @brief Free every allocation, growing the block to what the cycle used if it overflowed */
+    void reset() {
+        overflow_.release();
+        if (used_ > capacity_) {
+            grow((used_ + GRANULE - 1) / GRANULE * GRANULE);
+        }
+        used_ = 0;
+    }
+
+    /** @brief Bytes of the block */
+    size_t capacity() const { return capacity_; }
+
+    /** @brief Bytes handed out since the last reset(), alignment padding included */
+    size_t used() const { return used_; }
+
+   private:
+    static constexpr size_t GRANULE = size_t{1} << 20;  // Blocks grow in whole MiB
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        const size_t start = (used_ + alignment - 1) & ~(alignment - 1);  // The block itself is BLOCK_ALIGNMENT aligned
+        if (alignment <= BLOCK_ALIGNMENT && start + bytes <= capacity_) {
+            used_ = start + bytes;
+            return block_ + start;
+        }
+        used_ = std::max(used_, capacity_) + bytes + alignment;
+        return overflow_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void grow(size_t bytes) {
+        if (block_ != nullptr) {
+            upstream_->deallocate(block_, capacity_, BLOCK_ALIGNMENT);
+        }
+        block_ = bytes > 0 ? static_cast<std::byte*>(upstream_->allocate(bytes, BLOCK_ALIGNMENT)) : nullptr;
+        capacity_ = bytes;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::pmr::monotonic_buffer_resource overflow_;  // Allocations past the block, released by reset()
+    std::byte* block_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
+
+}  // namespace scanforge::tooling
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace scanforge::tooling {
+
+/**
+ * @brief Blocking FIFO with a fixed capacity, connecting the stages of a pipeline.
+ *
+ * push() waits while the queue is full and pop() while it is empty, so a fast producer
+ * can never run more than `capacity` items ahead of its consumer. close() wakes every
+ * waiter: later pushes fail, pops drain what is left and then return std::nullopt.
+ */
+template <typename T>
+class BoundedQueue {
+   public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Append an item, waiting for room
+     * @return False if the queue was closed and the item dropped
+     */
+    bool push(T value) {
+        std::unique_lock lock(mutex_);
+        notFull_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item, waiting for one to arrive
+     * @return The item, or std::nullopt once the queue is closed and empty
+     */
+    std::optional<T> pop() {
+        std::unique_lock lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return value;
+    }
+
+    /** @brief Refuse further pushes and release all waiting threads */
+    void close() {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+}  // namespace scanforge::tooling
@@ -1,11 +1,33 @@
 #pragma once
 
-#include <iostream>
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <format>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <print>
-#include <chrono>
-#include <source_location>
+#include <string>
+#include <thread>
+#include <utility>
+
+/**
+ * Messages below SCANFORGE_MIN_LOG_LEVEL (0 DEBUG, 1 INFO, 2 WARNING, 3 ERROR) are compiled
+ * out: their Log:: calls have an empty body. It defaults to INFO in NDEBUG builds and to
+ * DEBUG otherwise; CMake sets it from MIN_LOG_LEVEL.
+ */
+#ifndef SCANFORGE_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define SCANFORGE_MIN_LOG_LEVEL 1
+#else
+#define SCANFORGE_MIN_LOG_LEVEL 0
+#endif
+#endif
 
 namespace scanforge::tooling {
 
@@ -16,68 +38,331 @@ enum class LogLevel {
     ERROR = 3
 };
 
+/**
+ * @brief Lets through the first `burst` messages of every period and counts the rest
+ *
+ * One RateLimit guards one message of a hot loop, usually as a function-local static. It
+ * takes no lock; under contention a window may let through a message or two more than
+ * `burst`.
+ */
+class RateLimit {
+   public:
+    explicit RateLimit(uint32_t burst, std::chrono::steady_clock::duration period = std::chrono::seconds(1))
+        : burst_(burst), period_(period.count()) {}
+
+    /**
+     * @brief Count a message and decide whether it is written
+     * @param suppressed Set to the messages held back since the last one let through
+     * @return True if the message is written
+     */
+    bool allow(uint64_t& suppressed) {
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        int64_t start = windowStart_.load(std::memory_order_relaxed);
+        if (now - start >= period_ && windowStart_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            passed_.store(0, std::memory_order_relaxed);
+        }
+        if (passed_.fetch_add(1, std::memory_order_relaxed) < burst_) {
+            suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /** @brief Messages held back since the last one let through, for a closing summary */
+    uint64_t suppressed() const {
+        return suppressed_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    const uint32_t burst_;
+    const int64_t period_;  // steady_clock ticks
+    std::atomic<int64_t> windowStart_{std::numeric_limits<int64_t>::min() / 2};
+    std::atomic<uint32_t> passed_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+/**
+ * @brief Leveled, std::format-checked logging to stdout or a setOutput() stream
+ *
+ * Format strings are checked against their arguments at compile time. Levels below
+ * SCANFORGE_MIN_LOG_LEVEL compile to nothing; the runtime level is one relaxed atomic load.
+ *
+ * Messages are written under a mutex as they come by default. Between startAsync() and
+ * stopAsync() the calling thread only formats its message and hands it to a bounded
+ * lock-free ring that one background thread writes out, so worker threads never wait on
+ * the output. When the ring is full a message is written synchronously rather than lost.
+ *
+ * @code
+ * static RateLimit limit(5);
+ * Log::warning(limit, "Skipping record {}", index);  // At most five a second, then a count of the rest
+ * @endcode
+ */
 class Logger {
-public:
+   public:
+    static constexpr LogLevel MIN_LEVEL = static_cast<LogLevel>(SCANFORGE_MIN_LOG_LEVEL);
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 4096;
+
     static Logger& getInstance() {
         static Logger instance;
         return instance;
     }
-    
+
     static void setLevel(LogLevel level) {
-        getInstance().current_level_ = level;
+        level_.store(level, std::memory_order_relaxed);
     }
-    
+
     static LogLevel getLevel() {
-        return getInstance().current_level_;
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Whether messages of a level are compiled in and pass the runtime level */
+    static bool enabled(LogLevel level) {
+        return level >= MIN_LEVEL && level >= getLevel();
     }
-    
+
     template<typename... Args>
-    static void log(LogLevel level, const std::string& format, Args&&... args) {
-        auto& instance = getInstance();
-        if (level < instance.current_level_) {
+    static void log(LogLevel level, std::format_string<Args...> format, Args&&... args) {
+        if (enabled(level)) {
+            write(level, std::format(format, std::forward<Args>(args)...));
+        }
+    }
+
+    /** @brief Log through a RateLimit, noting how many messages it held back before this one */
+    template<typename... Args>
+    static void log(LogLevel level, RateLimit& limit, std::format_string<Args...> format, Args&&... args) {
+        uint64_t suppressed = 0;
+        if (!enabled(level) || !limit.allow(suppressed)) {
             return;
         }
-        
-        auto now = std::chrono::system_clock::now();
-        std::string level_str = instance.getLevelString(level);
-        std::string message;
-        
-        if constexpr (sizeof...(args) > 0) {
-            message = std::vformat(format, std::make_format_args(args...));
-        } else {
-            message = format;
-        }
-        
-        std::println("[{:%Y-%m-%d %H:%M:%S}] [{}] {}", 
-                     std::chrono::floor<std::chrono::seconds>(now), 
-                     level_str, message);
-    }
-    
+        std::string message = std::format(format, std::forward<Args>(args)...);
+        if (suppressed > 0) {
+            message += std::format(" ({} similar messages suppressed)", suppressed);
+        }
+        write(level, std::move(message));
+    }
+
+    template<typename... Args>
+    static void debug(std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::DEBUG >= MIN_LEVEL) {
+            log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
+        }
+    }
+
+    template<typename... Args>
+    static void debug(RateLimit& limit, std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::DEBUG >= MIN_LEVEL) {
+            log(LogLevel::DEBUG, limit, format, std::forward<Args>(args)...);
+        }
+    }
+
     template<typename... Args>
-    static void debug(const std::string& format, Args&&... args) {
-        log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
+    static void info(std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::INFO >= MIN_LEVEL) {
+            log(LogLevel::INFO, format, std::forward<Args>(args)...);
+        }
+    }
+
+    template<typename... Args>
+    static void info(RateLimit& limit, std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::INFO >= MIN_LEVEL) {
+            log(LogLevel::INFO, limit, format, std::forward<Args>(args)...);
+        }
     }
-    
+
     template<typename... Args>
-    static void info(const std::string& format, Args&&... args) {
-        log(LogLevel::INFO, format, std::forward<Args>(args)...);
+    static void warning(std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::WARNING >= MIN_LEVEL) {
+            log(LogLevel::WARNING, format, std::forward<Args>(args)...);
+        }
     }
-    
+
     template<typename... Args>
-    static void warning(const std::string& format, Args&&... args) {
-        log(LogLevel::WARNING, format, std::forward<Args>(args)...);
+    static void warning(RateLimit& limit, std::format_string<Args...> format, Args&&... args) {
+        if constexpr (LogLevel::WARNING >= MIN_LEVEL) {
+            log(LogLevel::WARNING, limit, format, std::forward<Args>(args)...);
+        }
     }
-    
+
     template<typename... Args>
-    static void error(const std::string& format, Args&&... args) {
+    static void error(std::format_string<Args...> format, Args&&... args) {
         log(LogLevel::ERROR, format, std::forward<Args>(args)...);
     }
 
-private:
+    template<typename... Args>
+    static void error(RateLimit& limit, std::format_string<Args...> format, Args&&... args) {
+        log(LogLevel::ERROR, limit, format, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Hand messages to a background writer from here on
+     * @param capacity Messages the ring holds, rounded up to a power of two
+     */
+    static void startAsync(size_t capacity = DEFAULT_QUEUE_CAPACITY) {
+        auto& instance = getInstance();
+        std::lock_guard lock(instance.control_);
+        if (instance.writer_.joinable()) {
+            return;
+        }
+        instance.capacity_ = std::bit_ceil(std::max<size_t>(capacity, 2));
+        instance.cells_ = std::make_unique<Cell[]>(instance.capacity_);
+        for (size_t i = 0; i < instance.capacity_; ++i) {
+            instance.cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        instance.enqueued_.store(0, std::memory_order_relaxed);
+        instance.written_.store(0, std::memory_order_relaxed);
+        instance.stopping_.store(false, std::memory_order_relaxed);
+        instance.wake_.store(false, std::memory_order_relaxed);
+        instance.writer_ = std::thread([&instance] { instance.drainLoop(); });
+        async_.store(true);
+    }
+
+    /** @brief Write out every queued message and go back to writing synchronously */
+    static void stopAsync() {
+        getInstance().stop();
+    }
+
+    /** @brief Wait until the messages queued so far are written */
+    static void flush() {
+        auto& instance = getInstance();
+        if (async_.load()) {
+            const size_t target = instance.enqueued_.load(std::memory_order_acquire);
+            for (size_t written = instance.written_.load(std::memory_order_acquire); written < target; written = instance.written_.load(std::memory_order_acquire)) {
+                instance.wakeWriter();
+                instance.written_.wait(written, std::memory_order_acquire);
+            }
+        }
+        std::lock_guard lock(instance.output_);
+        std::fflush(instance.output_stream_);
+    }
+
+    /** @brief Write to this stream instead of stdout; the caller keeps it open while it is in use */
+    static void setOutput(std::FILE* stream) {
+        auto& instance = getInstance();
+        std::lock_guard lock(instance.output_);
+        std::fflush(instance.output_stream_);
+        instance.output_stream_ = stream != nullptr ? stream : stdout;
+    }
+
+    /** @brief Messages written synchronously because the ring was full */
+    static uint64_t overflowCount() {
+        return getInstance().overflows_.load(std::memory_order_relaxed);
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+   private:
+    using Clock = std::chrono::system_clock;
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::INFO;
+        Clock::time_point time;
+        std::string message;
+    };
+
     Logger() = default;
-    LogLevel current_level_ = LogLevel::INFO;
-    
-    std::string getLevelString(LogLevel level) const {
+
+    ~Logger() {
+        stop();
+    }
+
+    void stop() {
+        std::lock_guard lock(control_);
+        if (!writer_.joinable()) {
+            return;
+        }
+        async_.store(false);
+        // A thread that saw async_ still set may be about to queue its message
+        while (producers_.load() != 0) {
+            std::this_thread::yield();
+        }
+        stopping_.store(true, std::memory_order_release);
+        wakeWriter();
+        writer_.join();
+        cells_.reset();
+    }
+
+    static void write(LogLevel level, std::string message) {
+        const auto now = Clock::now();
+        auto& instance = getInstance();
+        instance.producers_.fetch_add(1);
+        if (async_.load() && instance.enqueue(level, now, message)) {
+            instance.producers_.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        instance.producers_.fetch_sub(1, std::memory_order_release);
+        std::lock_guard lock(instance.output_);
+        instance.emit(level, now, message);
+    }
+
+    /** @brief Claim a cell of the ring (Vyukov's bounded queue); false if it is full */
+    bool enqueue(LogLevel level, Clock::time_point time, std::string& message) {
+        size_t position = enqueued_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & (capacity_ - 1)];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (enqueued_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.level = level;
+                    cell.time = time;
+                    cell.message = std::move(message);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    wakeWriter();
+                    return true;
+                }
+            } else if (sequence < position) {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = enqueued_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void wakeWriter() {
+        if (!wake_.exchange(true, std::memory_order_release)) {
+            wake_.notify_one();
+        }
+    }
+
+    void drainLoop() {
+        size_t position = 0;
+        for (;;) {
+            wake_.wait(false, std::memory_order_acquire);
+            wake_.store(false, std::memory_order_relaxed);
+            const bool stopping = stopping_.load(std::memory_order_acquire);
+            {
+                std::lock_guard lock(output_);
+                for (;;) {
+                    Cell& cell = cells_[position & (capacity_ - 1)];
+                    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+                        break;
+                    }
+                    emit(cell.level, cell.time, cell.message);
+                    cell.message.clear();
+                    cell.sequence.store(position + capacity_, std::memory_order_release);
+                    ++position;
+                }
+                std::fflush(output_stream_);
+            }
+            written_.store(position, std::memory_order_release);
+            written_.notify_all();
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    /** @brief Write one line, with output_ held */
+    void emit(LogLevel level, Clock::time_point time, const std::string& message) {
+        std::println(output_stream_, "[{:%Y-%m-%d %H:%M:%S}] [{}] {}",
+                     std::chrono::floor<std::chrono::seconds>(time),
+                     getLevelString(level), message);
+    }
+
+    static const char* getLevelString(LogLevel level) {
         switch (level) {
             case LogLevel::DEBUG: return "DEBUG";
             case LogLevel::INFO: return "INFO";
@@ -86,6 +371,22 @@ private:
             default: return "UNKNOWN";
         }
     }
+
+    static inline std::atomic<LogLevel> level_{LogLevel::INFO};
+    static inline std::atomic<bool> async_{false};
+
+    std::mutex control_;  // Serializes startAsync() and stopAsync()
+    std::mutex output_;   // Keeps lines whole, guards output_stream_
+    std::FILE* output_stream_ = stdout;
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_ = 0;
+    alignas(64) std::atomic<size_t> enqueued_{0};
+    alignas(64) std::atomic<size_t> written_{0};
+    std::atomic<uint32_t> producers_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<bool> wake_{false};
+    std::atomic<bool> stopping_{false};
+    std::thread writer_;
 };
 
 using Log = Logger;
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "tooling/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace scanforge::tooling {
+
+/**
+ * @brief Threads a parallel step may use
+ * @param requested Thread count asked for; 0 uses every thread of the current pool, or every
+ *                  hardware thread outside a pool
+ */
+inline unsigned availableThreads(unsigned requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    if (const ThreadPool* pool = ThreadPool::current()) {
+        return pool->size();
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Threads worth starting for items, at least minPerThread items each
+ * @param requested Thread count asked for; 0 uses every available thread
+ */
+inline unsigned workerThreads(size_t items, unsigned requested, size_t minPerThread) {
+    return static_cast<unsigned>(std::clamp<size_t>(items / std::max<size_t>(1, minPerThread), 1, availableThreads(requested)));
+}
+
+/**
+ * @brief Run work(first, count) over equal slices of [0, items), one thread per slice
+ *
+ * Returns once every slice is done. With one thread, or nothing to do, work runs inline
+ * over the whole range. On a ThreadPool worker the slices become tasks of that pool, the
+ * calling thread taking the first, so nested parallelism shares the pool's threads.
+ */
+template <typename Work>
+void parallelSlices(size_t items, unsigned threads, Work&& work) {
+    if (threads <= 1 || items == 0) {
+        work(size_t{0}, items);
+        return;
+    }
+    const size_t slice = (items + threads - 1) / threads;
+    if (ThreadPool* pool = ThreadPool::current()) {
+        TaskGroup slices(*pool);
+        for (size_t first = slice; first < items; first += slice) {
+            slices.run([&work, first, count = std::min(slice, items - first)] { work(first, count); });
+        }
+        work(size_t{0}, std::min(slice, items));
+        slices.wait();
+        return;
+    }
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    for (size_t first = 0; first < items; first += slice) {
+        workers.emplace_back([&work, first, count = std::min(slice, items - first)] { work(first, count); });
+    }
+}
+
+/** @brief Run work(i) for every i in [0, count) at once, one thread or pool task each */
+template <typename Work>
+void parallelFor(size_t count, Work&& work) {
+    parallelSlices(count, static_cast<unsigned>(count), [&work](size_t first, size_t n) {
+        for (size_t i = first; i < first + n; ++i) {
+            work(i);
+        }
+    });
+}
+
+/**
+ * @brief Run work() on `threads` threads at once, for workers that share a queue of their own
+ *
+ * With one thread work runs inline; on a ThreadPool worker the copies are tasks of that pool.
+ */
+template <typename Work>
+void runWorkers(unsigned threads, Work&& work) {
+    parallelFor(std::max(1u, threads), [&work](size_t) { work(); });
+}
+
+/** @brief Run left() and right() in parallel, left on another thread or pool task */
+template <typename Left, typename Right>
+void parallelInvoke(Left&& left, Right&& right) {
+    if (ThreadPool* pool = ThreadPool::current()) {
+        TaskGroup other(*pool);
+        other.run([&left] { left(); });
+        right();
+        other.wait();
+        return;
+    }
+    std::jthread other([&left] { left(); });
+    right();
+}
+
+}  // namespace scanforge::tooling
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Profiling is compiled in by default, Release builds included (CMake: ENABLE_PROFILING=ON).
+ * Set SCANFORGE_PROFILING to 0 (CMake: -DENABLE_PROFILING=OFF) to compile every
+ * SCANFORGE_PROFILE_SCOPE and SCANFORGE_PROFILE_COUNT out of the processors.
+ */
+#ifndef SCANFORGE_PROFILING
+#define SCANFORGE_PROFILING 1
+#endif
+
+namespace scanforge::tooling {
+
+/** @brief Amounts the processors add up while profiling */
+enum class Counter : size_t {
+    BytesRead,          // File bytes the loaders and readers read or map; headers read through a stream are left out
+    BytesWritten,       // Point data bytes the savers and writers write, headers aside
+    PointsDecoded,      // Points the loaders and readers handed out
+    PointsEncoded,      // Points the savers and writers stored
+    PointsDropped,      // Records skipped for a non-finite coordinate
+    CompressedBytes,    // LZF and LAZ payload, compressed side
+    UncompressedBytes,  // LZF and LAZ payload, uncompressed side
+};
+
+inline constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::UncompressedBytes) + 1;
+
+inline constexpr std::array<std::string_view, COUNTER_COUNT> COUNTER_NAMES = {
+    "bytes_read", "bytes_written", "points_decoded", "points_encoded", "points_dropped", "compressed_bytes", "uncompressed_bytes",
+};
+
+namespace detail {
+
+/** @brief Write text as a quoted JSON string, escaping quotes, backslashes and control characters */
+inline void writeJSONString(std::ostream& out, std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out << '"';
+    for (const char c : text) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (byte < 0x20) {
+            out << "\\u00" << HEX[byte >> 4] << HEX[byte & 0xF];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}  // namespace detail
+
+/**
+ * @brief Process-wide timers of named stages and counters, off until enable(true)
+ *
+ * Stages are the scopes SCANFORGE_PROFILE_SCOPE names: header parsing, raw reads,
+ * decompression, field decoding, formatting and so on. Each thread accumulates its own
+ * time per stage, so timing a parallel step from its slices costs no shared cache line;
+ * report() sums them. A stage's time includes the stages nested in it, and sums over
+ * threads, so parallel stages may exceed the wall time. The busy time of a thread counts
+ * its outermost scopes only.
+ *
+ * While disabled a scope costs one relaxed atomic load. Compiled out with
+ * SCANFORGE_PROFILING=0 the macros expand to nothing and report() stays empty.
+ *
+ * @code
+ * Profiler::instance().enable(true);
+ * auto [header, cloud] = processor.loadPCD("scan.pcd");
+ * Profiler::instance().report().printTable(std::cout);
+ * @endcode
+ */
+class Profiler final {
+   public:
+    static constexpr bool COMPILED_IN = SCANFORGE_PROFILING != 0;
+    static constexpr size_t MAX_STAGES = 64;  // Stages past this share the last one, "other"
+
+    struct Stage {
+        std::string name;
+        uint64_t calls = 0;
+        uint64_t nanoseconds = 0;  // Summed over threads
+    };
+
+    struct Thread {
+        size_t index = 0;          // Slot of the thread; threads that end hand theirs to the next new thread
+        uint64_t nanoseconds = 0;  // Time inside outermost profiled scopes
+    };
+
+    /** @brief Snapshot of what was gathered since the profiler was enabled or reset */
+    struct Report {
+        std::vector<Stage> stages;  // Stages that ran, in order of first registration
+        std::array<uint64_t, COUNTER_COUNT> counters{};
+        std::vector<Thread> threads;  // Threads that ran a profiled scope
+        uint64_t wallNanoseconds = 0;
+
+        uint64_t counter(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+
+        /** @brief Uncompressed over compressed bytes, nullopt if nothing went through a codec */
+        std::optional<double> compressionRatio() const {
+            const uint64_t compressed = counter(Counter::CompressedBytes);
+            if (compressed == 0) {
+                return std::nullopt;
+            }
+            return static_cast<double>(counter(Counter::UncompressedBytes)) / static_cast<double>(compressed);
+        }
+
+        /** @brief Aligned tables of the stages, counters and threads, times in milliseconds */
+        void printTable(std::ostream& out) const {
+            const auto milliseconds = [](uint64_t nanoseconds) { return static_cast<double>(nanoseconds) * 1e-6; };
+            const auto share = [this](uint64_t nanoseconds) { return wallNanoseconds == 0 ? 0.0 : 100.0 * static_cast<double>(nanoseconds) / static_cast<double>(wallNanoseconds); };
+            size_t width = 16;
+            for (const auto& stage : stages) {
+                width = std::max(width, stage.name.size() + 2);
+            }
+
+            std::ostringstream table;
+            table << std::fixed << std::setprecision(2);
+            table << std::left << std::setw(static_cast<int>(width)) << "stage" << std::right << std::setw(10) << "calls" << std::setw(14) << "total ms" << std::setw(12)
+                  << "mean us" << std::setw(10) << "% wall" << '\n';
+            for (const auto& stage : stages) {
+                const double mean = stage.calls == 0 ? 0.0 : static_cast<double>(stage.nanoseconds) * 1e-3 / static_cast<double>(stage.calls);
+                table << std::left << std::setw(static_cast<int>(width)) << stage.name << std::right << std::setw(10) << stage.calls << std::setw(14)
+                      << milliseconds(stage.nanoseconds) << std::setw(12) << mean << std::setw(10) << share(stage.nanoseconds) << '\n';
+            }
+            table << std::left << std::setw(static_cast<int>(width)) << "wall" << std::right << std::setw(24) << milliseconds(wallNanoseconds) << "\n\n";
+
+            for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+                table << std::left << std::setw(static_cast<int>(width)) << COUNTER_NAMES[c] << std::right << std::setw(24) << counters[c] << '\n';
+            }
+            if (const auto ratio = compressionRatio()) {
+                table << std::left << std::setw(static_cast<int>(width)) << "compression" << std::right << std::setw(23) << *ratio << "x\n";
+            }
+
+            table << '\n' << std::left << std::setw(static_cast<int>(width)) << "thread" << std::right << std::setw(24) << "busy ms" << std::setw(10) << "% wall" << '\n';
+            for (const auto& thread : threads) {
+                table << std::left << std::setw(static_cast<int>(width)) << thread.index << std::right << std::setw(24) << milliseconds(thread.nanoseconds) << std::setw(10)
+                      << share(thread.nanoseconds) << '\n';
+            }
+            out << table.str();
+        }
+
+        /** @brief The report as one JSON object, times in nanoseconds; stage names are escaped */
+        void writeJSON(std::ostream& out) const {
+            std::ostringstream json;
+            json << std::setprecision(10);
+            json << "{\n  \"wall_ns\": " << wallNanoseconds << ",\n  \"stages\": [";
+            for (size_t i = 0; i < stages.size(); ++i) {
+                json << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+                detail::writeJSONString(json, stages[i].name);
+                json << ", \"calls\": " << stages[i].calls << ", \"total_ns\": " << stages[i].nanoseconds << "}";
+            }
+            json << "\n  ],\n  \"counters\": {";
+            for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+                json << (c == 0 ? "\n" : ",\n") << "    \"" << COUNTER_NAMES[c] << "\": " << counters[c];
+            }
+            json << "\n  },\n  \"compression_ratio\": ";
+            if (const auto ratio = compressionRatio()) {
+                json << *ratio;
+            } else {
+                json << "null";
+            }
+            json << ",\n  \"threads\": [";
+            for (size_t i = 0; i < threads.size(); ++i) {
+                json << (i == 0 ? "\n" : ",\n") << "    {\"index\": " << threads[i].index << ", \"busy_ns\": " << threads[i].nanoseconds << "}";
+            }
+            json << "\n  ]\n}\n";
+            out << json.str();
+        }
+    };
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    /** @brief True while scopes and counters record; always false when compiled out */
+    static bool enabled() { return COMPILED_IN && enabled_.load(std::memory_order_relaxed); }
+
+    /** @brief Start or stop recording; starting also resets what was gathered before */
+    void enable(bool on) {
+        if (on) {
+            reset();
+        }
+        enabled_.store(on && COMPILED_IN, std::memory_order_relaxed);
+    }
+
+    /** @brief Zero every stage, counter and thread time, and restart the wall clock */
+    void reset() {
+        const std::lock_guard lock(mutex_);
+        for (auto& record : records_) {
+            for (size_t s = 0; s < MAX_STAGES; ++s) {
+                record.calls[s].store(0, std::memory_order_relaxed);
+                record.nanoseconds[s].store(0, std::memory_order_relaxed);
+            }
+            record.busy.store(0, std::memory_order_relaxed);
+        }
+        for (auto& counter : counters_) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        start_ = Clock::now();
+    }
+
+    /**
+     * @brief Id of a stage, registering it on first use
+     * @param name Dotted name, format first: "pcd.decompress", "las.read"
+     */
+    size_t stage(std::string_view name) {
+        const std::lock_guard lock(mutex_);
+        const auto known = std::find(names_.begin(), names_.end(), name);
+        if (known != names_.end()) {
+            return static_cast<size_t>(known - names_.begin());
+        }
+        if (names_.size() == MAX_STAGES - 1) {
+            names_.emplace_back("other");
+        }
+        if (names_.size() == MAX_STAGES) {
+            return MAX_STAGES - 1;
+        }
+        names_.emplace_back(name);
+        return names_.size() - 1;
+    }
+
+    /** @brief Add to a counter while enabled */
+    void count(Counter counter, uint64_t amount) {
+        if (enabled()) {
+            counters_[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    /** @brief Everything gathered so far; the wall time runs up to this call */
+    Report report() const {
+        const std::lock_guard lock(mutex_);
+        Report report;
+        report.wallNanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count());
+        for (size_t s = 0; s < names_.size(); ++s) {
+            Stage stage{.name = names_[s], .calls = 0, .nanoseconds = 0};
+            for (const auto& record : records_) {
+                stage.calls += record.calls[s].load(std::memory_order_relaxed);
+                stage.nanoseconds += record.nanoseconds[s].load(std::memory_order_relaxed);
+            }
+            if (stage.calls > 0) {
+                report.stages.push_back(std::move(stage));
+            }
+        }
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+            report.counters[c] = counters_[c].load(std::memory_order_relaxed);
+        }
+        for (size_t t = 0; t < records_.size(); ++t) {
+            if (const uint64_t busy = records_[t].busy.load(std::memory_order_relaxed); busy > 0) {
+                report.threads.push_back(Thread{.index = t, .nanoseconds = busy});
+            }
+        }
+        return report;
+    }
+
+   private:
+    friend class ScopedTimer;
+    using Clock = std::chrono::steady_clock;
+
+    // Times of one thread; only that thread writes them, report() reads them concurrently
+    struct ThreadRecord {
+        std::array<std::atomic<uint64_t>, MAX_STAGES> calls{};
+        std::array<std::atomic<uint64_t>, MAX_STAGES> nanoseconds{};
+        std::atomic<uint64_t> busy{0};
+        unsigned depth = 0;  // Profiled scopes open on the thread
+    };
+
+    // Returns the record of the calling thread to the free list when the thread ends
+    struct ThreadSlot {
+        ThreadRecord* record = nullptr;
+        ~ThreadSlot() {
+            if (record) {
+                instance().release(record);
+            }
+        }
+    };
+
+    Profiler() = default;
+
+    static ThreadRecord& threadRecord() {
+        thread_local ThreadSlot slot;
+        if (!slot.record) {
+            slot.record = instance().acquire();
+        }
+        return *slot.record;
+    }
+
+    ThreadRecord* acquire() {
+        const std::lock_guard lock(mutex_);
+        if (!free_.empty()) {
+            ThreadRecord* record = free_.back();
+            free_.pop_back();
+            return record;
+        }
+        return &records_.emplace_back();
+    }
+
+    void release(ThreadRecord* record) {
+        const std::lock_guard lock(mutex_);
+        record->depth = 0;
+        free_.push_back(record);
+    }
+
+    static inline std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::deque<ThreadRecord> records_;  // Stable addresses for the threads holding them
+    std::vector<ThreadRecord*> free_;
+    std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters_{};
+    Clock::time_point start_ = Clock::now();
+};
+
+/**
+ * @brief Adds the time until the end of its scope to a stage of the calling thread
+ *
+ * Does nothing if the profiler was disabled when the scope opened.
+ */
+class ScopedTimer final {
+   public:
+    explicit ScopedTimer(size_t stage) : stage_(stage) {
+        if (Profiler::enabled()) {
+            record_ = &Profiler::threadRecord();
+            ++record_->depth;
+            start_ = Profiler::Clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (!record_) {
+            return;
+        }
+        const auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Profiler::Clock::now() - start_).count());
+        record_->calls[stage_].fetch_add(1, std::memory_order_relaxed);
+        record_->nanoseconds[stage_].fetch_add(elapsed, std::memory_order_relaxed);
+        if (--record_->depth == 0) {
+            record_->busy.fetch_add(elapsed, std::memory_order_relaxed);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    size_t stage_;
+    Profiler::ThreadRecord* record_ = nullptr;
+    Profiler::Clock::time_point start_{};
+};
+
+}  // namespace scanforge::tooling
+
+#define SCANFORGE_PROFILE_CONCAT_(a, b) a##b
+#define SCANFORGE_PROFILE_CONCAT(a, b) SCANFORGE_PROFILE_CONCAT_(a, b)
+
+#if SCANFORGE_PROFILING
+/** @brief Time the rest of the enclosing scope as the named stage */
+#define SCANFORGE_PROFILE_SCOPE(name)                                                                                                   \
+    static const size_t SCANFORGE_PROFILE_CONCAT(profileStage_, __LINE__) = ::scanforge::tooling::Profiler::instance().stage(name); \
+    const ::scanforge::tooling::ScopedTimer SCANFORGE_PROFILE_CONCAT(profileTimer_, __LINE__)(SCANFORGE_PROFILE_CONCAT(profileStage_, __LINE__))
+/** @brief Add amount to a tooling::Counter; amount is not evaluated while compiled out */
+#define SCANFORGE_PROFILE_COUNT(counter, amount) ::scanforge::tooling::Profiler::instance().count(::scanforge::tooling::Counter::counter, static_cast<uint64_t>(amount))
+#else
+#define SCANFORGE_PROFILE_SCOPE(name) static_cast<void>(0)
+#define SCANFORGE_PROFILE_COUNT(counter, amount) static_cast<void>(0)
+#endif
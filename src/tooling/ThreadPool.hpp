@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace scanforge::tooling {
+
+/**
+ * @brief Fixed set of worker threads that balance tasks by work stealing
+ *
+ * Every worker owns a deque: tasks it submits go to the back and it takes its own work from
+ * the back, so nested work stays hot in its cache, while idle workers steal from the front
+ * of the others. Tasks submitted from outside the pool go to a shared queue.
+ *
+ * Code running on a worker finds its pool through current(); tooling::parallelSlices() and
+ * the other helpers of Parallel.hpp then split their work into tasks of that pool instead
+ * of starting threads, so parallelism inside a task shares the pool's cores rather than
+ * adding to them. A task waiting for others (TaskGroup::wait()) runs queued tasks meanwhile,
+ * so nested waits neither idle a core nor deadlock; a thread outside the pool just sleeps.
+ * A nested wait only runs tasks other tasks submitted, never one from the shared queue: a
+ * task that may block, say on a ConcurrencyLimit, is submitted from outside the pool and so
+ * never starts on top of a task holding what it waits for.
+ *
+ * @code
+ * ThreadPool pool(0);
+ * TaskGroup files(pool);
+ * for (const auto& path : paths) {
+ *     files.run([&path] { convert(path); });  // convert() may use parallelSlices() itself
+ * }
+ * files.wait();
+ * @endcode
+ */
+class ThreadPool {
+   public:
+    using Task = std::function<void()>;
+
+    /** @param threads Worker threads; 0 starts one per hardware thread */
+    explicit ThreadPool(unsigned threads = 0) {
+        const unsigned count = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+        for (unsigned i = 0; i < count; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @brief Runs the tasks still queued, then joins the workers */
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        workers_.clear();
+    }
+
+    /** @brief Number of worker threads */
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    /** @brief The pool the calling thread works for, nullptr outside any pool */
+    static ThreadPool* current() { return current_; }
+
+    /** @brief Queue a task; from a worker of this pool it goes to that worker's own deque */
+    void submit(Task task) {
+        const bool shared = current_ != this;
+        Queue& queue = shared ? shared_ : *queues_[worker_];
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard lock(sleepMutex_);
+            ++(shared ? shared_.count : queued_);
+        }
+        // A worker in a nested wait ignores shared tasks, so waking just one could wake only it
+        if (shared) {
+            wake_.notify_all();
+        } else {
+            wake_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Wait until done() holds, running queued tasks meanwhile on a worker of this pool
+     *
+     * A worker with nothing to run, or a thread outside the pool, sleeps until a task is
+     * queued or notify() is called.
+     */
+    template <typename Done>
+    void helpUntil(Done&& done) {
+        if (current_ != this) {
+            std::unique_lock lock(sleepMutex_);
+            finished_.wait(lock, [&] { return done(); });
+            return;
+        }
+        while (!done()) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock lock(sleepMutex_);
+            wake_.wait(lock, [&] { return runnable() || done(); });
+        }
+    }
+
+    /** @brief Wake the threads waiting in helpUntil() to test their condition again */
+    void notify() {
+        { std::lock_guard lock(sleepMutex_); }
+        wake_.notify_all();
+        finished_.notify_all();
+    }
+
+   private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<size_t> count{0};  // Used for the shared queue only, changed under sleepMutex_
+    };
+
+    void work(size_t index) {
+        current_ = this;
+        worker_ = index;
+        while (true) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stopping_ || runnable(); });
+            if (stopping_ && queued_ == 0 && shared_.count == 0) {
+                return;
+            }
+        }
+    }
+
+    // True if the calling worker would find a task; inside a task it does not take shared ones
+    bool runnable() const { return queued_ > 0 || (depth_ == 0 && shared_.count > 0); }
+
+    // Take a task from the own deque's back, else from the front of another worker's deque or of the shared queue
+    bool runOne() {
+        Task task;
+        bool shared = false;
+        if (!take(*queues_[worker_], true, task)) {
+            for (size_t i = 1; i < queues_.size() && !task; ++i) {
+                take(*queues_[(worker_ + i) % queues_.size()], false, task);
+            }
+        }
+        if (!task && depth_ == 0) {
+            shared = take(shared_, false, task);
+        }
+        if (!task) {
+            return false;
+        }
+        {
+            std::lock_guard lock(sleepMutex_);
+            --(shared ? shared_.count : queued_);
+        }
+        ++depth_;
+        task();
+        --depth_;
+        return true;
+    }
+
+    static bool take(Queue& queue, bool back, Task& task) {
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        if (back) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+
+    static inline thread_local ThreadPool* current_ = nullptr;
+    static inline thread_local size_t worker_ = 0;
+    static inline thread_local unsigned depth_ = 0;  // Tasks running on the calling thread's stack
+
+    std::vector<std::unique_ptr<Queue>> queues_;  // One per worker
+    Queue shared_;                                // Tasks submitted from outside the pool
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;      // Workers waiting for tasks
+    std::condition_variable finished_;  // Threads outside the pool waiting in helpUntil()
+    std::atomic<size_t> queued_{0};  // Tasks waiting in the worker deques, changed under sleepMutex_
+    bool stopping_ = false;
+    std::vector<std::jthread> workers_;  // Last member: joined before the queues are destroyed
+};
+
+/**
+ * @brief Tasks run on a pool and waited for together
+ *
+ * The destructor waits as well, so a group never outlives the tasks that reference its scope.
+ */
+class TaskGroup {
+   public:
+    explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() { wait(); }
+
+    template <typename Task>
+    void run(Task&& task) {
+        ++active_;
+        pool_.submit([this, &pool = pool_, task = std::forward<Task>(task)]() mutable {
+            task();
+            if (--active_ == 0) {
+                pool.notify();  // The group may be gone once active_ is 0, the pool is not
+            }
+        });
+    }
+
+    /** @brief Return once every task run so far has finished, running queued tasks meanwhile */
+    void wait() {
+        pool_.helpUntil([this] { return active_ == 0; });
+    }
+
+   private:
+    ThreadPool& pool_;
+    std::atomic<size_t> active_{0};
+};
+
+/**
+ * @brief Bounds how many tasks of a pool are inside a section at once, I/O say
+ *
+ * A task waiting for a slot runs other queued tasks meanwhile, so the cores stay busy.
+ *
+ * @code
+ * ConcurrencyLimit io(pool, 2);
+ * {
+ *     auto slot = io.acquire();  // At most two files are read at once
+ *     read(path);
+ * }
+ * @endcode
+ */
+class ConcurrencyLimit {
+   public:
+    /** @brief Held section; leaving it frees the slot */
+    class Slot {
+       public:
+        Slot(Slot&& other) noexcept : limit_(std::exchange(other.limit_, nullptr)) {}
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot& operator=(Slot&&) = delete;
+
+        ~Slot() {
+            if (limit_) {
+                limit_->release();
+            }
+        }
+
+       private:
+        friend class ConcurrencyLimit;
+        explicit Slot(ConcurrencyLimit* limit) : limit_(limit) {}
+
+        ConcurrencyLimit* limit_;
+    };
+
+    /** @param limit Tasks allowed inside at once, at least 1 */
+    ConcurrencyLimit(ThreadPool& pool, unsigned limit) : pool_(pool), free_(std::max(1u, limit)) {}
+
+    /** @brief Wait for a free slot */
+    [[nodiscard]] Slot acquire() {
+        bool acquired = false;
+        pool_.helpUntil([&] { return acquired || (acquired = tryAcquire()); });
+        return Slot(this);
+    }
+
+   private:
+    bool tryAcquire() {
+        unsigned expected = free_.load();
+        while (expected > 0 && !free_.compare_exchange_weak(expected, expected - 1)) {
+        }
+        return expected > 0;
+    }
+
+    void release() {
+        ++free_;
+        pool_.notify();
+    }
+
+    ThreadPool& pool_;
+    std::atomic<unsigned> free_;
+};
+
+}  // namespace scanforge::tooling
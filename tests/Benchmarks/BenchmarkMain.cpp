@@ -0,0 +1,130 @@
+/**
+ * @brief Entry point of the benchmarks: size options and a JSON reporter adding rates and ratios
+ *
+ * Runs as any Catch2 binary, with these extra options:
+ *   --points N       size of the synthetic cloud (default 1000000)
+ *   --threads N      threads of the loaders, writers and block codecs (default 1, 0 for all)
+ *   --seed N         seed of the synthetic cloud
+ *   --data-dir PATH  where the scratch files go (default: a directory in the system temp directory)
+ *
+ * @code
+ * scanforgeBenchmarks --points 10000000 --reporter console --reporter scanforge-json::out=bench.json "[pcd]"
+ * @endcode
+ */
+
+#include <catch2/catch_session.hpp>
+#include <catch2/interfaces/catch_interfaces_reporter.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include "BenchmarkSupport.hpp"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace scanforge::benchmarks;
+
+namespace {
+
+std::string quoted(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+/**
+ * @brief Writes every benchmark as one JSON object, with the rates its declared workload gives
+ *
+ * Times are in nanoseconds per run: the mean with its bootstrapped confidence bounds and the
+ * standard deviation. Rates divide the workload by the mean: points/s, and MB/s (10^6 bytes)
+ * of file bytes for loaders and writers, of uncompressed bytes for codecs.
+ */
+class JsonBenchmarkReporter final : public Catch::StreamingReporterBase {
+   public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription() { return "Benchmark results as JSON, with throughput and compression ratio"; }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override {
+        std::ostringstream entry;
+        entry << std::setprecision(10);
+        const double mean = stats.mean.point.count();
+        entry << "    {\"name\": " << quoted(stats.info.name) << ", \"samples\": " << stats.info.samples << ", \"iterations\": " << stats.info.iterations
+              << ", \"mean_ns\": " << mean << ", \"mean_low_ns\": " << stats.mean.lower_bound.count() << ", \"mean_high_ns\": " << stats.mean.upper_bound.count()
+              << ", \"std_dev_ns\": " << stats.standardDeviation.point.count();
+        if (const auto* workload = findWorkload(stats.info.name); workload && mean > 0) {
+            const double seconds = mean * 1e-9;
+            entry << ", \"points\": " << workload->points << ", \"bytes\": " << workload->bytes << ", \"points_per_s\": " << static_cast<double>(workload->points) / seconds
+                  << ", \"mb_per_s\": " << static_cast<double>(workload->bytes) / seconds * 1e-6;
+            if (workload->ratio) {
+                entry << ", \"ratio\": " << *workload->ratio;
+            }
+        }
+        entry << "}";
+        entries_.push_back(entry.str());
+    }
+
+    void testRunEnded(const Catch::TestRunStats& stats) override {
+        m_stream << "{\n  \"library\": " << quoted("ScanForge " SCANFORGE_VERSION) << ",\n  \"points\": " << options().points << ",\n  \"threads\": " << options().threads
+                 << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n  \"seed\": " << options().seed << ",\n  \"benchmarks\": [";
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            m_stream << (i == 0 ? "\n" : ",\n") << entries_[i];
+        }
+        m_stream << "\n  ]\n}\n";
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+   private:
+    std::vector<std::string> entries_;
+};
+
+}  // namespace
+
+CATCH_REGISTER_REPORTER("scanforge-json", JsonBenchmarkReporter)
+
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+    session.configData().benchmarkSamples = 10;  // Catch2's default of 100 makes large clouds take hours
+
+    auto& config = options();
+    std::string dataDir = config.dataDir.string();
+    using Catch::Clara::Opt;
+    session.cli(session.cli() | Opt(config.points, "points")["--points"]("points of the synthetic cloud (default 1000000)") |
+                Opt(config.threads, "threads")["--threads"]("threads of the loaders, writers and block codecs, 0 for all (default 1)") |
+                Opt(config.seed, "seed")["--seed"]("seed of the synthetic cloud") | Opt(dataDir, "path")["--data-dir"]("directory for the scratch files"));
+    if (const int result = session.applyCommandLine(argc, argv); result != 0) {
+        return result;
+    }
+    if (config.points == 0) {
+        std::cerr << "--points must be at least 1\n";
+        return 1;
+    }
+
+    config.dataDir = dataDir;
+    std::error_code error;
+    const bool created = std::filesystem::create_directories(config.dataDir, error);
+    if (error) {
+        std::cerr << "Cannot create " << config.dataDir.string() << ": " << error.message() << '\n';
+        return 1;
+    }
+    const int result = session.run();
+    if (created) {
+        std::filesystem::remove(config.dataDir, error);  // Each benchmark removes its own files
+    }
+    return result;
+}
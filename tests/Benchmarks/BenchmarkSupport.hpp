@@ -0,0 +1,115 @@
+#pragma once
+
+#include "PointCloudTypes.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shared state of the benchmarks: the options, the synthetic cloud and the amounts of
+ *        data each benchmark processes, from which the reporter derives its rates
+ */
+namespace scanforge::benchmarks {
+
+/** @brief Set from the command line before any benchmark runs */
+struct Options {
+    size_t points = 1'000'000;  // Size of the synthetic cloud
+    unsigned threads = 1;       // Threads of the loaders, writers and block codecs; 0 uses every hardware thread
+    uint32_t seed = 1;
+    std::filesystem::path dataDir = std::filesystem::temp_directory_path() / "scanforge-benchmarks";
+};
+
+inline Options& options() {
+    static Options instance;
+    return instance;
+}
+
+/** @brief Work done by one run of a benchmark */
+struct Workload {
+    size_t points = 0;
+    size_t bytes = 0;             // Bytes read or written, uncompressed bytes for a codec
+    std::optional<double> ratio;  // Uncompressed over compressed size, for codecs and compressed files
+};
+
+inline std::map<std::string, Workload>& workloads() {
+    static std::map<std::string, Workload> instance;
+    return instance;
+}
+
+/** @brief Declare the work of a benchmark before running it; the reporter looks it up by name */
+inline void setWorkload(const std::string& name, const Workload& workload) { workloads()[name] = workload; }
+
+/** @brief Work declared for a benchmark, nullptr for none */
+inline const Workload* findWorkload(const std::string& name) {
+    const auto it = workloads().find(name);
+    return it == workloads().end() ? nullptr : &it->second;
+}
+
+/** @brief Path of a scratch file in the data directory */
+inline std::filesystem::path dataPath(const std::string& name) { return options().dataDir / name; }
+
+/**
+ * @brief Synthetic terrain scan of options().points points, built on first use
+ *
+ * Points lie on a jittered grid with 5 cm spacing over a smooth height field with a little
+ * noise, coloured by height, and are stored row after row as a scanner writes them. That
+ * gives the codecs the kind of redundancy real scans have, unlike uniform random points.
+ */
+inline const PointCloudXYZRGB& syntheticCloud() {
+    static const PointCloudXYZRGB cloud = [] {
+        const size_t count = options().points;
+        const size_t side = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count)))));
+        std::mt19937 random(options().seed);
+        std::normal_distribution<float> jitter(0.0f, 0.01f);
+        std::uniform_int_distribution<int> tint(-8, 8);
+
+        PointCloudXYZRGB generated(count);
+        for (size_t i = 0; i < count; ++i) {
+            const float x = static_cast<float>(i % side) * 0.05f + jitter(random);
+            const float y = static_cast<float>(i / side) * 0.05f + jitter(random);
+            const float z = 2.0f * std::sin(x / 7.0f) + std::cos(y / 5.0f) + 0.2f * std::sin(x * 1.3f + y) + jitter(random);
+            const float shade = std::clamp((z + 3.2f) / 6.4f, 0.0f, 1.0f);
+            const auto channel = [&](float value) { return static_cast<uint8_t>(std::clamp(static_cast<int>(value * 255.0f) + tint(random), 0, 255)); };
+            generated.push_back(PointXYZRGB(x, y, z, channel(shade), channel(0.6f), channel(1.0f - shade)));
+        }
+        generated.width = static_cast<uint32_t>(generated.size());
+        generated.height = 1;
+        return generated;
+    }();
+    return cloud;
+}
+
+/**
+ * @brief The cloud as the field-major records a binary_compressed PCD payload holds
+ *
+ * All x, then all y, z and packed rgb, four bytes each: the layout LZF compresses in PCD files.
+ */
+inline const std::vector<uint8_t>& syntheticColumns() {
+    static const std::vector<uint8_t> columns = [] {
+        const auto& cloud = syntheticCloud();
+        const size_t n = cloud.size();
+        std::vector<uint8_t> bytes(n * 16);
+        for (size_t i = 0; i < n; ++i) {
+            const auto& p = cloud.points[i];
+            const float rgb = std::bit_cast<float>(p.color.toPacked());
+            std::memcpy(bytes.data() + 4 * i, &p.position.x, 4);
+            std::memcpy(bytes.data() + 4 * (n + i), &p.position.y, 4);
+            std::memcpy(bytes.data() + 4 * (2 * n + i), &p.position.z, 4);
+            std::memcpy(bytes.data() + 4 * (3 * n + i), &rgb, 4);
+        }
+        return bytes;
+    }();
+    return columns;
+}
+
+}  // namespace scanforge::benchmarks
@@ -0,0 +1,62 @@
+/**
+ * @brief Benchmarks of LAS and LAZ saving and loading, per point format
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkSupport.hpp"
+#include "LASProcessor.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::benchmarks;
+
+namespace {
+
+using PointFormat = LASProcessor::PointFormat;
+
+void run(LASProcessor& processor, PointFormat format, bool compressed) {
+    const auto& cloud = syntheticCloud();
+    auto header = LASProcessor::createLASHeader(format);
+    header.compressed = compressed;
+    const string suffix = (compressed ? "LAZ format " : "LAS format ") + to_string(static_cast<int>(format));
+    const auto filename = dataPath(compressed ? "cloud.laz" : "cloud.las");
+
+    REQUIRE(processor.saveLAS(filename, header, cloud, options().threads));
+    Workload workload{.points = cloud.size(), .bytes = static_cast<size_t>(filesystem::file_size(filename)), .ratio = nullopt};
+    if (compressed) {
+        const size_t records = cloud.size() * LASProcessor::getPointRecordLength(format);
+        workload.ratio = static_cast<double>(records) / static_cast<double>(workload.bytes);
+    }
+
+    setWorkload("saveLAS " + suffix, workload);
+    BENCHMARK("saveLAS " + suffix) {
+        return processor.saveLAS(filename, header, cloud, options().threads);
+    };
+
+    setWorkload("loadLAS " + suffix, workload);
+    BENCHMARK("loadLAS " + suffix) {
+        auto [loadedHeader, loaded] = processor.loadLAS(filename, options().threads);
+        return loaded.size();
+    };
+    filesystem::remove(filename);
+}
+
+}  // namespace
+
+TEST_CASE("LAS save and load", "[benchmark][las]") {
+    LASProcessor processor;
+    for (const auto format : {PointFormat::FORMAT_0, PointFormat::FORMAT_1, PointFormat::FORMAT_2, PointFormat::FORMAT_3, PointFormat::FORMAT_6, PointFormat::FORMAT_7}) {
+        run(processor, format, false);
+    }
+}
+
+TEST_CASE("LAZ save and load", "[benchmark][laz]") {
+    LASProcessor processor;
+    for (const auto format : {PointFormat::FORMAT_0, PointFormat::FORMAT_1, PointFormat::FORMAT_2, PointFormat::FORMAT_3, PointFormat::FORMAT_6, PointFormat::FORMAT_7}) {
+        run(processor, format, true);
+    }
+}
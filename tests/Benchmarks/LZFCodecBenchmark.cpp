@@ -0,0 +1,63 @@
+/**
+ * @brief Benchmarks of LZF compression and decompression throughput and ratio
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkSupport.hpp"
+#include "codec/LZFCodec.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::benchmarks;
+using codec::LZFCodec;
+
+TEST_CASE("LZF compress and decompress", "[benchmark][lzf]") {
+    const auto& columns = syntheticColumns();
+    const span<const uint8_t> input(columns);
+
+    for (const auto level : {LZFCodec::Level::Fast, LZFCodec::Level::Normal}) {
+        const string suffix = level == LZFCodec::Level::Fast ? "fast" : "normal";
+        const auto compressed = LZFCodec::compress(input, level);
+        REQUIRE(!compressed.empty());
+        const Workload workload{.points = syntheticCloud().size(), .bytes = input.size(), .ratio = static_cast<double>(input.size()) / static_cast<double>(compressed.size())};
+
+        vector<uint8_t> buffer(LZFCodec::maxCompressedSize(input.size()));
+        setWorkload("LZF compress " + suffix, workload);
+        BENCHMARK("LZF compress " + suffix) {
+            return LZFCodec::compress(input, buffer, level);
+        };
+
+        vector<uint8_t> output(input.size());
+        REQUIRE(LZFCodec::decompress(compressed, output) == input.size());
+        setWorkload("LZF decompress " + suffix, workload);
+        BENCHMARK("LZF decompress " + suffix) {
+            return LZFCodec::decompress(compressed, output);
+        };
+    }
+}
+
+TEST_CASE("LZF blocks coded in parallel, as binary_compressed_chunked stores them", "[benchmark][lzf]") {
+    const span<const uint8_t> input(syntheticColumns());
+    constexpr size_t BLOCK_BYTES = size_t{1} << 20;
+    vector<uint32_t> blockSizes;
+    const auto blocks = LZFCodec::compressBlocks(input, BLOCK_BYTES, blockSizes, options().threads);
+    REQUIRE(!blocks.empty());
+    const Workload workload{.points = syntheticCloud().size(), .bytes = input.size(), .ratio = static_cast<double>(input.size()) / static_cast<double>(blocks.size())};
+
+    setWorkload("LZF compressBlocks", workload);
+    BENCHMARK("LZF compressBlocks") {
+        vector<uint32_t> sizes;
+        return LZFCodec::compressBlocks(input, BLOCK_BYTES, sizes, options().threads).size();
+    };
+
+    vector<uint8_t> output(input.size());
+    setWorkload("LZF decompressBlocks", workload);
+    BENCHMARK("LZF decompressBlocks") {
+        return LZFCodec::decompressBlocks(blocks, blockSizes, output, BLOCK_BYTES, options().threads);
+    };
+}
@@ -0,0 +1,63 @@
+/**
+ * @brief Benchmarks of PCD saving and loading, per data type and load mode
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkSupport.hpp"
+#include "PCDProcessor.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::benchmarks;
+
+namespace {
+
+bool save(PCDProcessor& processor, const string& filename, const string& dataType, const PointCloudXYZRGB& cloud) {
+    const auto header = PCDProcessor::createXYZRGBHeader(cloud, dataType);
+    if (dataType == "ascii") {
+        return processor.savePCD_ASCII(filename, header, cloud);
+    }
+    if (dataType == "binary") {
+        return processor.savePCD_Binary(filename, header, cloud);
+    }
+    if (dataType == "binary_compressed") {
+        return processor.savePCD_BinaryCompressed(filename, header, cloud);
+    }
+    return processor.savePCD_BinaryCompressedChunked(filename, header, cloud, options().threads);
+}
+
+}  // namespace
+
+TEST_CASE("PCD save and load", "[benchmark][pcd]") {
+    const auto& cloud = syntheticCloud();
+    const size_t uncompressed = cloud.size() * 16;  // x, y, z and rgb as binary records
+    PCDProcessor processor;
+
+    for (const string dataType : {"ascii", "binary", "binary_compressed", "binary_compressed_chunked"}) {
+        const string filename = dataPath("cloud_" + dataType + ".pcd").string();
+        REQUIRE(save(processor, filename, dataType, cloud));
+        Workload workload{.points = cloud.size(), .bytes = static_cast<size_t>(filesystem::file_size(filename)), .ratio = nullopt};
+        if (dataType.starts_with("binary_compressed")) {
+            workload.ratio = static_cast<double>(uncompressed) / static_cast<double>(workload.bytes);
+        }
+
+        setWorkload("savePCD " + dataType, workload);
+        BENCHMARK("savePCD " + dataType) {
+            return save(processor, filename, dataType, cloud);
+        };
+
+        for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            const string name = "loadPCD " + dataType + (mode == PCDProcessor::LoadMode::MemoryMapped ? " mmap" : "");
+            setWorkload(name, workload);
+            BENCHMARK(string(name)) {
+                auto [header, loaded] = processor.loadPCD(filename, mode, options().threads);
+                return loaded.size();
+            };
+        }
+        filesystem::remove(filename);
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * @brief Unit tests for the arena memory resource and the loaders allocating from it using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "TestClouds.hpp"
+#include "tooling/Arena.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::tooling;
+
+namespace {
+
+// Upstream resource counting the allocations that reach it
+class CountingResource final : public pmr::memory_resource {
+   public:
+    size_t allocations = 0;
+    size_t live = 0;
+
+   private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        ++live;
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        --live;
+        pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+}  // namespace
+
+TEST_CASE("Arena bumps through one block and grows it on reset", "[Arena]") {
+    CountingResource upstream;
+    {
+        Arena arena(4096, &upstream);
+        REQUIRE(arena.capacity() == 4096);
+        REQUIRE(upstream.allocations == 1);
+
+        GIVEN("allocations that fit the block") {
+            void* a = arena.allocate(100, 8);
+            void* b = arena.allocate(64, 64);
+            THEN("they come from the block, aligned, without reaching upstream") {
+                REQUIRE(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+                REQUIRE(static_cast<std::byte*>(b) >= static_cast<std::byte*>(a) + 100);
+                REQUIRE(arena.used() == 192);
+                REQUIRE(upstream.allocations == 1);
+            }
+            arena.reset();
+            REQUIRE(arena.used() == 0);
+            REQUIRE(arena.capacity() == 4096);
+        }
+
+        GIVEN("a cycle that overflows the block") {
+            pmr::vector<uint8_t> small(1000, &arena);
+            {
+                pmr::vector<uint8_t> large(3 * 1000 * 1000, &arena);
+                REQUIRE(upstream.allocations > 1);
+            }
+            small = {};
+            arena.reset();
+
+            THEN("the next block holds the whole cycle and the same work stays inside it") {
+                REQUIRE(arena.capacity() >= 3u * 1000 * 1000 + 1000);
+                REQUIRE(arena.capacity() % (size_t{1} << 20) == 0);
+                REQUIRE(upstream.live == 1);  // The overflow went back with the old block
+
+                const size_t before = upstream.allocations;
+                for (int cycle = 0; cycle < 3; ++cycle) {
+                    pmr::vector<uint8_t> again(1000, &arena);
+                    pmr::vector<uint8_t> big(3 * 1000 * 1000, &arena);
+                    again = {};
+                    big = {};
+                    arena.reset();
+                }
+                REQUIRE(upstream.allocations == before);
+            }
+        }
+    }
+    REQUIRE(upstream.live == 0);
+}
+
+TEST_CASE("Loaders allocate clouds and decode buffers from their resource", "[Arena][file_io]") {
+    const auto cloud = test::makeRampCloud(20000);
+    const string lasFile = "test_arena.laz";
+    const string pcdFile = "test_arena.pcd";
+    auto lasHeader = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+    lasHeader.compressed = true;
+    REQUIRE(LASProcessor().saveLAS(lasFile, lasHeader, cloud));
+    REQUIRE(PCDProcessor().savePCD_BinaryCompressedChunked(pcdFile, PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed_chunked"), cloud));
+
+    CountingResource upstream;
+    Arena arena(0, &upstream);
+    LASProcessor lasProcessor(&arena);
+    PCDProcessor pcdProcessor(&arena);
+    REQUIRE(lasProcessor.memoryResource() == &arena);
+
+    size_t afterWarmUp = 0;
+    for (int cycle = 0; cycle < 4; ++cycle) {
+        INFO("cycle " << cycle);
+        const unsigned threads = cycle % 2 == 0 ? 1 : 4;
+        {
+            const auto [header, las] = lasProcessor.loadLAS(lasFile, threads);
+            REQUIRE(header.isValid());
+            REQUIRE(las.size() == cloud.size());
+            REQUIRE(las.memoryResource() == &arena);
+            REQUIRE(las.points[12345].color.g == cloud.points[12345].color.g);
+
+            for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+                const auto [pcdHeader, pcd] = pcdProcessor.loadPCD(pcdFile, mode, threads);
+                REQUIRE(pcd.size() == cloud.size());
+                REQUIRE(pcd.memoryResource() == &arena);
+                REQUIRE(pcd.points.back().position.x == cloud.points.back().position.x);
+            }
+        }
+        arena.reset();
+        if (cycle == 1) {  // Both thread counts have run
+            afterWarmUp = upstream.allocations;
+            REQUIRE(arena.capacity() > 0);
+        }
+    }
+
+    THEN("once the arena has grown, loading does not reach upstream") {
+        REQUIRE(upstream.allocations == afterWarmUp);
+    }
+
+    filesystem::remove(lasFile);
+    filesystem::remove(pcdFile);
+}
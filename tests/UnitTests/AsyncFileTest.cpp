@@ -0,0 +1,244 @@
+/**
+ * @brief Unit tests for asynchronous file I/O and the read-ahead and write-behind streams using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "io/AsyncFile.hpp"
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+vector<uint8_t> makeBytes(size_t size) {
+    vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 7 + i / 251);
+    }
+    return bytes;
+}
+
+void writeFile(const string& filename, const vector<uint8_t>& bytes) {
+    ofstream out(filename, ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+}
+
+vector<uint8_t> readFile(const string& filename) {
+    ifstream in(filename, ios::binary);
+    return vector<uint8_t>(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+// Every backend this system offers, so each one is exercised where it exists
+vector<io::IOBackend> availableBackends() {
+    vector<io::IOBackend> backends;
+    for (auto backend : {io::IOBackend::Threads, io::IOBackend::IoUring, io::IOBackend::Overlapped}) {
+        if (io::AsyncFile::available(backend)) {
+            backends.push_back(backend);
+        }
+    }
+    return backends;
+}
+
+}  // namespace
+
+TEST_CASE("AsyncFile positioned reads and writes", "[AsyncFile][file_io]") {
+    const auto content = makeBytes(100000);
+
+    for (auto backend : availableBackends()) {
+        INFO("backend " << io::AsyncFile::backendName(backend));
+
+        GIVEN("a file read with several requests in flight") {
+            const string filename = "test_async_read.bin";
+            writeFile(filename, content);
+
+            io::AsyncFile file;
+            REQUIRE(file.open(filename, io::AsyncFile::Mode::Read, backend, 3));
+            REQUIRE(file.backend() == backend);
+            REQUIRE(file.size() == content.size());
+
+            vector<uint8_t> first(1000), second(5000), tail(500);
+            REQUIRE(file.read(0, 50000, first));
+            REQUIRE(file.read(1, 7, second));
+            REQUIRE(file.read(2, content.size() - 200, tail));
+
+            THEN("each slot completes with its bytes, short only at the end of the file") {
+                REQUIRE_FALSE(file.read(0, 0, first));  // Slot 0 is still in use
+                REQUIRE(file.wait(2) == 200u);
+                REQUIRE(file.wait(0) == first.size());
+                REQUIRE(file.wait(1) == second.size());
+                REQUIRE(equal(first.begin(), first.end(), content.begin() + 50000));
+                REQUIRE(equal(second.begin(), second.end(), content.begin() + 7));
+                REQUIRE(equal(tail.begin(), tail.begin() + 200, content.end() - 200));
+                REQUIRE_FALSE(file.wait(0).has_value());  // Nothing left to wait for
+            }
+
+            file.close();
+            filesystem::remove(filename);
+        }
+
+        GIVEN("a file written out of order") {
+            const string filename = "test_async_write.bin";
+            {
+                io::AsyncFile file;
+                REQUIRE(file.open(filename, io::AsyncFile::Mode::Write, backend, 2));
+                const span<const uint8_t> bytes(content);
+                REQUIRE(file.write(0, 60000, bytes.subspan(60000)));
+                REQUIRE(file.write(1, 0, bytes.first(60000)));
+                REQUIRE(file.wait(1) == 60000u);
+                REQUIRE(file.wait(0) == 40000u);
+            }
+
+            THEN("the file holds the bytes in place") {
+                REQUIRE(readFile(filename) == content);
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+
+    GIVEN("a backend this system does not offer, or a missing file") {
+        io::AsyncFile file;
+        if (!io::AsyncFile::available(io::IOBackend::Overlapped)) {
+            REQUIRE_FALSE(file.open("test_async_missing.bin", io::AsyncFile::Mode::Write, io::IOBackend::Overlapped, 1));
+        }
+        REQUIRE_FALSE(file.open("test_async_does_not_exist.bin", io::AsyncFile::Mode::Read, io::IOBackend::Auto, 1));
+        REQUIRE_FALSE(file.is_open());
+    }
+}
+
+TEST_CASE("Asynchronous streams read ahead and write behind", "[AsyncFile][file_io]") {
+    const auto content = makeBytes(10000);
+
+    for (auto backend : availableBackends()) {
+        INFO("backend " << io::AsyncFile::backendName(backend));
+        const io::AsyncOptions options{.backend = backend, .blockSize = 256, .depth = 3};
+
+        GIVEN("a file read through small blocks") {
+            const string filename = "test_async_stream.bin";
+            writeFile(filename, content);
+            io::AsyncInputStream in(filename, options);
+            REQUIRE(in.is_open());
+
+            THEN("reading it whole returns every byte and then end of file") {
+                vector<uint8_t> bytes(content.size() + 10);
+                in.read(reinterpret_cast<char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+                REQUIRE(in.gcount() == static_cast<streamsize>(content.size()));
+                REQUIRE(in.eof());
+                bytes.resize(content.size());
+                REQUIRE(bytes == content);
+            }
+
+            THEN("seeks inside, ahead of and behind the blocks read ahead land on the right bytes") {
+                char byte = 0;
+                for (size_t position : {size_t{5}, size_t{100}, size_t{600}, size_t{300}, size_t{9999}, size_t{0}, size_t{5000}}) {
+                    in.seekg(static_cast<streamoff>(position));
+                    REQUIRE(static_cast<size_t>(in.tellg()) == position);
+                    REQUIRE(in.get(byte));
+                    REQUIRE(static_cast<uint8_t>(byte) == content[position]);
+                    REQUIRE(static_cast<size_t>(in.tellg()) == position + 1);
+                }
+                in.seekg(-4, ios::end);
+                vector<char> last(4);
+                REQUIRE(in.read(last.data(), 4));
+                REQUIRE(equal(last.begin(), last.end(), content.end() - 4, [](char a, uint8_t b) { return static_cast<uint8_t>(a) == b; }));
+            }
+
+            in.close();
+            filesystem::remove(filename);
+        }
+
+        GIVEN("a file written through small blocks with a header patched at the end") {
+            const string filename = "test_async_stream_out.bin";
+            {
+                io::AsyncOutputStream out(filename, options);
+                REQUIRE(out.is_open());
+                out.write("XXXX", 4);
+                out.write(reinterpret_cast<const char*>(content.data()) + 4, static_cast<streamsize>(content.size() - 4));
+                REQUIRE(static_cast<size_t>(out.tellp()) == content.size());
+                out.seekp(0);
+                out.write(reinterpret_cast<const char*>(content.data()), 4);
+                out.seekp(0, ios::end);
+                REQUIRE(static_cast<size_t>(out.tellp()) == content.size());
+                out.close();
+                REQUIRE_FALSE(out.fail());
+            }
+
+            THEN("the file holds every byte") {
+                REQUIRE(readFile(filename) == content);
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+}
+
+TEST_CASE("Chunked readers and writers over asynchronous I/O", "[AsyncFile][PointStream]") {
+    PointCloudXYZRGB cloud;
+    for (int i = 0; i < 5000; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(f * 0.25f, -f * 0.5f, f, static_cast<uint8_t>(i), static_cast<uint8_t>(i / 20), 9));
+    }
+
+    for (auto backend : availableBackends()) {
+        INFO("backend " << io::AsyncFile::backendName(backend));
+        const io::AsyncOptions options{.backend = backend, .blockSize = 4096, .depth = 2};
+
+        GIVEN("a LAZ file written and read back in chunks") {
+            const string filename = "test_async_points.laz";
+            auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+            header.compressed = true;
+            {
+                LASWriter writer(filename, header, options);
+                REQUIRE(writer.is_open());
+                REQUIRE(writer.write(std::span(cloud.points).first(3000)));
+                REQUIRE(writer.write(std::span(cloud.points).subspan(3000)));
+                REQUIRE(writer.close());
+            }
+
+            LASReader reader(filename, options);
+            REQUIRE(reader.is_open());
+            REQUIRE(reader.size() == cloud.size());
+            vector<PointXYZRGB> points(cloud.size());
+            REQUIRE(reader.next(points) == cloud.size());
+
+            THEN("the points survive the round trip") {
+                for (size_t i = 0; i < cloud.size(); i += 499) {
+                    REQUIRE(points[i].position.x == Catch::Approx(cloud.points[i].position.x).margin(0.001));
+                    REQUIRE(points[i].position.y == Catch::Approx(cloud.points[i].position.y).margin(0.001));
+                    REQUIRE(points[i].color.g == cloud.points[i].color.g);
+                }
+            }
+
+            filesystem::remove(filename);
+        }
+
+        GIVEN("a chunked compressed PCD file written and read back") {
+            const string filename = "test_async_points.pcd";
+            {
+                PCDWriter writer(filename, PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, "binary_compressed_chunked"), codec::LZFCodec::Level::Normal, options);
+                REQUIRE(writer.is_open());
+                REQUIRE(writer.write(cloud.points));
+                REQUIRE(writer.close());
+            }
+
+            PCDReader reader(filename, options);
+            REQUIRE(reader.is_open());
+            vector<PointXYZRGB> points(cloud.size());
+            REQUIRE(reader.next(points) == cloud.size());
+
+            THEN("the points survive the round trip") {
+                REQUIRE(points.back().position.x == cloud.points.back().position.x);
+                REQUIRE(points[1234].color.r == cloud.points[1234].color.r);
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ * @brief Unit tests for the single-pass, mergeable point cloud statistics using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "CloudStatistics.hpp"
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+using PointStats = PointWith<field::Color, field::Classification, field::Returns>;
+
+PointCloud<PointStats> makeCloud(size_t count, unsigned seed = 7) {
+    mt19937 gen(seed);
+    normal_distribution<float> spread(0.0f, 25.0f);
+    uniform_int_distribution<int> byte(0, 255);
+    PointCloud<PointStats> cloud;
+    for (size_t i = 0; i < count; ++i) {
+        PointStats point(Point3D(1000.0f + spread(gen), -500.0f + 0.5f * spread(gen), 40.0f + 0.1f * spread(gen)));
+        point.color = RGB(static_cast<uint8_t>(byte(gen)), static_cast<uint8_t>(i % 256), 7);
+        point.classification = static_cast<uint8_t>(i % 3 == 0 ? 2 : 6);
+        point.returnNumber = static_cast<uint8_t>(1 + i % 2);
+        point.numberOfReturns = 2;
+        cloud.push_back(point);
+    }
+    return cloud;
+}
+
+// Two-pass reference: bounds and mean first, then the squared deviations, over finite points
+struct Reference {
+    array<double, 3> min{}, max{}, mean{}, variance{};
+    size_t count = 0;
+};
+
+template <typename PointT>
+Reference reference(span<const PointT> points) {
+    Reference ref;
+    ref.min.fill(numeric_limits<double>::infinity());
+    ref.max.fill(-numeric_limits<double>::infinity());
+    for (const auto& point : points) {
+        const Point3D& p = getPosition(point);
+        if (!spatial::isFinite(p)) {
+            continue;
+        }
+        const array<double, 3> v{p.x, p.y, p.z};
+        for (size_t a = 0; a < 3; ++a) {
+            ref.min[a] = std::min(ref.min[a], v[a]);
+            ref.max[a] = std::max(ref.max[a], v[a]);
+            ref.mean[a] += v[a];
+        }
+        ++ref.count;
+    }
+    for (auto& m : ref.mean) {
+        m /= static_cast<double>(ref.count);
+    }
+    for (const auto& point : points) {
+        const Point3D& p = getPosition(point);
+        if (spatial::isFinite(p)) {
+            const array<double, 3> v{p.x, p.y, p.z};
+            for (size_t a = 0; a < 3; ++a) {
+                ref.variance[a] += (v[a] - ref.mean[a]) * (v[a] - ref.mean[a]);
+            }
+        }
+    }
+    for (auto& v : ref.variance) {
+        v /= static_cast<double>(ref.count);
+    }
+    return ref;
+}
+
+void requireMatches(const CloudStatistics& stats, const Reference& ref) {
+    REQUIRE(stats.count() == ref.count);
+    const auto [minPt, maxPt] = stats.bounds();
+    const Point3D centroid = stats.centroid();
+    const Point3D variance = stats.variance();
+    const array<float, 3> mins{minPt.x, minPt.y, minPt.z}, maxs{maxPt.x, maxPt.y, maxPt.z}, means{centroid.x, centroid.y, centroid.z}, vars{variance.x, variance.y, variance.z};
+    for (size_t a = 0; a < 3; ++a) {
+        REQUIRE(mins[a] == static_cast<float>(ref.min[a]));
+        REQUIRE(maxs[a] == static_cast<float>(ref.max[a]));
+        REQUIRE_THAT(means[a], WithinAbs(ref.mean[a], 1e-3));
+        REQUIRE_THAT(vars[a], WithinRel(ref.variance[a], 1e-5));
+    }
+}
+
+}  // namespace
+
+TEST_CASE("CloudStatistics matches a two-pass reference", "[CloudStatistics]") {
+    auto cloud = makeCloud(300001);
+    cloud.points[5].position.x = numeric_limits<float>::quiet_NaN();
+    cloud.points[70000].position.z = numeric_limits<float>::infinity();
+    const span<const PointStats> points(cloud.points);
+    const auto ref = reference(points);
+
+    SECTION("Serially and on several threads") {
+        for (const unsigned threads : {1u, 4u}) {
+            INFO(threads);
+            const auto stats = CloudStatistics::compute(cloud, threads);
+            requireMatches(stats, ref);
+            REQUIRE(stats.nonFinite() == 2);
+        }
+    }
+
+    SECTION("Merging the statistics of parts gives those of the whole") {
+        CloudStatistics merged;
+        for (size_t first = 0; first < points.size(); first += 77777) {
+            merged.merge(CloudStatistics::compute(points.subspan(first, std::min<size_t>(77777, points.size() - first))));
+        }
+        requireMatches(merged, ref);
+        REQUIRE(merged.nonFinite() == 2);
+
+        CloudStatistics empty;
+        merged.merge(empty);
+        requireMatches(merged, ref);
+        empty.merge(merged);
+        requireMatches(empty, ref);
+    }
+
+    SECTION("Colors, classes and returns are counted for finite points") {
+        const auto stats = CloudStatistics::compute(cloud, 3);
+        REQUIRE(stats.hasColor());
+        REQUIRE(stats.hasClasses());
+        REQUIRE(stats.hasReturns());
+
+        array<uint64_t, 256> classes{}, green{};
+        array<uint64_t, 16> returns{};
+        double red = 0;
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            if (spatial::isFinite(cloud.points[i].position)) {
+                ++classes[cloud.points[i].classification];
+                ++green[cloud.points[i].color.g];
+                ++returns[cloud.points[i].returnNumber];
+                red += cloud.points[i].color.r;
+            }
+        }
+        REQUIRE(stats.classCounts() == classes);
+        REQUIRE(stats.colorHistogram(1) == green);
+        REQUIRE(stats.colorHistogram(2)[7] == stats.count());
+        REQUIRE(stats.returnCounts() == returns);
+        REQUIRE_THAT(stats.meanColor()[0], WithinRel(red / static_cast<double>(stats.count()), 1e-12));
+    }
+
+    SECTION("Density over the XY bounds") {
+        const auto stats = CloudStatistics::compute(cloud);
+        const double area = (ref.max[0] - ref.min[0]) * (ref.max[1] - ref.min[1]);
+        REQUIRE_THAT(stats.density(), WithinRel(static_cast<double>(ref.count) / area, 1e-5));
+    }
+}
+
+TEST_CASE("CloudStatistics of empty and attribute-less points", "[CloudStatistics]") {
+    CloudStatistics stats;
+    REQUIRE(stats.empty());
+    REQUIRE(stats.density() == 0.0);
+    REQUIRE(stats.bounds().first.x == 0.0f);
+    REQUIRE(stats.variance().x == 0.0f);
+
+    const vector<Point3D> points{{1, 2, 3}, {1, 4, 3}, {numeric_limits<float>::quiet_NaN(), 0, 0}};
+    stats.add(span<const Point3D>(points));
+    REQUIRE(stats.count() == 2);
+    REQUIRE(stats.nonFinite() == 1);
+    REQUIRE(!stats.hasColor());
+    REQUIRE(!stats.hasClasses());
+    REQUIRE(stats.centroid().y == 3.0f);
+    REQUIRE(stats.variance().y == 1.0f);
+    REQUIRE(stats.density() == 0.0);  // No extent in x
+}
+
+TEST_CASE("CloudStatistics reduces chunked readers in constant memory", "[CloudStatistics][file_io]") {
+    const auto source = makeCloud(120000);
+    PointCloudXYZRGB cloud;
+    for (const auto& point : source.points) {
+        cloud.push_back(PointXYZRGB(point.position, point.color));
+    }
+
+    SECTION("LAZ, with classes and returns") {
+        const string filename = "test_statistics.laz";
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        REQUIRE(LASProcessor().saveLAS(filename, header, cloud, 2));
+        auto [loadedHeader, loaded] = LASProcessor().loadLAS<PointStats>(filename, 2);
+        const auto expected = CloudStatistics::compute(loaded);
+
+        LASReader reader(filename);
+        const auto stats = CloudStatistics::compute<PointStats>(reader, 2, 10000);
+        REQUIRE(stats);
+        requireMatches(*stats, reference(span<const PointStats>(loaded.points)));
+        REQUIRE(stats->classCounts() == expected.classCounts());
+        REQUIRE(stats->classCounts()[1] == cloud.size());  // The writer stores every point as unclassified, return 1 of 1
+        REQUIRE(stats->returnCounts()[1] == cloud.size());
+        REQUIRE(stats->colorHistogram(0) == expected.colorHistogram(0));
+        filesystem::remove(filename);
+    }
+
+    SECTION("PCD, through the PointReader interface") {
+        const string filename = "test_statistics.pcd";
+        cloud.points[3].position.y = numeric_limits<float>::quiet_NaN();
+        REQUIRE(PCDProcessor().savePCD_BinaryCompressed(filename, PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed"), cloud));
+
+        PCDReader reader(filename);
+        const auto stats = CloudStatistics::compute(static_cast<io::PointReader&>(reader), 0, 4096);
+        REQUIRE(stats);
+        requireMatches(*stats, reference(span<const PointXYZRGB>(cloud.points)));
+        REQUIRE(stats->nonFinite() == 0);  // The reader drops the NaN point
+        REQUIRE(!stats->hasClasses());
+        filesystem::remove(filename);
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @brief Unit tests for the KD-tree nearest-neighbour search
+ */
+
+#include <catch2/catch_all.hpp>
+#include "spatial/KdTree.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::spatial;
+
+namespace {
+
+using Tree = KdTree<PointXYZRGB>;
+
+PointCloud<PointXYZRGB> randomCloud(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    PointCloud<PointXYZRGB> cloud(count);
+    for (size_t i = 0; i < count; ++i) {
+        cloud.push_back(PointXYZRGB(coord(rng), coord(rng), coord(rng), 0, 0, 0));
+    }
+    // Exact duplicates make ties that only the index can break
+    for (size_t i = 0; i < 50; ++i) {
+        cloud.push_back(cloud[i]);
+    }
+    return cloud;
+}
+
+vector<Tree::Neighbor> bruteForce(const PointCloud<PointXYZRGB>& cloud, const Point3D& query) {
+    vector<Tree::Neighbor> all;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        if (isFinite(cloud[i].position)) {
+            all.push_back({static_cast<uint32_t>(i), squaredDistance(query, cloud[i].position)});
+        }
+    }
+    sort(all.begin(), all.end());
+    return all;
+}
+
+bool sameNeighbors(const vector<Tree::Neighbor>& a, const vector<Tree::Neighbor>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(),
+                 [](const Tree::Neighbor& x, const Tree::Neighbor& y) { return x.index == y.index && x.squaredDistance == y.squaredDistance; });
+}
+
+}  // namespace
+
+TEST_CASE("KdTree k-nearest search matches a brute-force scan", "[KdTree]") {
+    const auto cloud = randomCloud(5000, 1);
+    for (unsigned threads : {1u, 4u, 0u}) {
+        Tree tree(cloud, threads);
+        REQUIRE(tree.size() == cloud.size());
+
+        mt19937 rng(2);
+        uniform_real_distribution<float> coord(-12.0f, 12.0f);
+        for (int q = 0; q < 100; ++q) {
+            const Point3D query = q % 2 == 0 ? Point3D{coord(rng), coord(rng), coord(rng)} : cloud[static_cast<size_t>(q)].position;
+            const auto expected = bruteForce(cloud, query);
+            for (size_t k : {size_t{1}, size_t{7}, size_t{40}}) {
+                REQUIRE(sameNeighbors(tree.knnSearch(query, k), vector<Tree::Neighbor>(expected.begin(), expected.begin() + static_cast<ptrdiff_t>(k))));
+            }
+        }
+    }
+}
+
+TEST_CASE("KdTree radius search matches a brute-force scan", "[KdTree]") {
+    const auto cloud = randomCloud(5000, 3);
+    Tree tree(cloud, 2);
+    for (size_t q = 0; q < 50; ++q) {
+        const Point3D query = cloud[q * 13].position;
+        for (float radius : {0.0f, 0.5f, 2.0f, 100.0f}) {
+            auto expected = bruteForce(cloud, query);
+            expected.erase(remove_if(expected.begin(), expected.end(), [&](const Tree::Neighbor& n) { return n.squaredDistance > radius * radius; }), expected.end());
+            REQUIRE(sameNeighbors(tree.radiusSearch(query, radius), expected));
+        }
+    }
+}
+
+TEST_CASE("KdTree batched queries give the same results on any thread count", "[KdTree]") {
+    const auto cloud = randomCloud(20000, 4);
+    Tree tree(cloud, 0);
+
+    vector<Point3D> queries;
+    for (size_t i = 0; i < 3000; ++i) {
+        queries.push_back(cloud[i * 5].position);
+    }
+    queries.push_back({numeric_limits<float>::quiet_NaN(), 0, 0});
+
+    const auto serial = tree.knnSearch(queries, 6, 1);
+    REQUIRE(serial.size() == queries.size() * 6);
+    for (size_t q = 0; q + 1 < queries.size(); q += 500) {
+        REQUIRE(sameNeighbors(vector<Tree::Neighbor>(serial.begin() + static_cast<ptrdiff_t>(q * 6), serial.begin() + static_cast<ptrdiff_t>(q * 6 + 6)), tree.knnSearch(queries[q], 6)));
+    }
+    REQUIRE(serial.back().index == Tree::NO_NEIGHBOR);
+    REQUIRE(sameNeighbors(tree.knnSearch(queries, 6, 4), serial));
+    REQUIRE(sameNeighbors(tree.knnSearch(queries, 6, 0), serial));
+
+    const auto lists = tree.radiusSearch(queries, 0.3f, 4);
+    REQUIRE(lists.size() == queries.size());
+    REQUIRE(lists.back().empty());
+    for (size_t q = 0; q + 1 < queries.size(); q += 250) {
+        REQUIRE(sameNeighbors(lists[q], tree.radiusSearch(queries[q], 0.3f)));
+    }
+}
+
+TEST_CASE("KdTree edge cases", "[KdTree]") {
+    PointCloud<Point3D> empty;
+    KdTree<Point3D> none(empty);
+    REQUIRE(none.empty());
+    REQUIRE(none.knnSearch({0, 0, 0}, 3).empty());
+    REQUIRE(none.radiusSearch({0, 0, 0}, 1.0f).empty());
+
+    PointCloud<Point3D> small;
+    small.push_back({0, 0, 0});
+    small.push_back({numeric_limits<float>::quiet_NaN(), 0, 0});
+    small.push_back({2, 0, 0});
+    KdTree<Point3D> tree(small);
+    REQUIRE(tree.size() == 2);
+
+    const auto nearest = tree.knnSearch({1.5f, 0, 0}, 10);
+    REQUIRE(nearest.size() == 2);
+    REQUIRE(nearest[0].index == 2);
+    REQUIRE(nearest[1].index == 0);
+    REQUIRE(tree.knnSearch({1.5f, 0, 0}, 0).empty());
+    REQUIRE(tree.radiusSearch({1, 0, 0}, 1.0f).size() == 2);
+    REQUIRE(tree.radiusSearch({1, 0, 0}, -1.0f).empty());
+}
@@ -0,0 +1,260 @@
+/**
+ * @brief Unit tests for seeking LAS reads and the sidecar spatial index
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASIndex.hpp"
+#include "LASProcessor.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+// Scan lines sweeping back and forth over a 400 x 300 area, the order an airborne survey is written in
+PointCloudXYZRGB makeSurvey(size_t lines, size_t pointsPerLine) {
+    PointCloudXYZRGB cloud;
+    for (size_t line = 0; line < lines; ++line) {
+        for (size_t i = 0; i < pointsPerLine; ++i) {
+            const size_t along = line % 2 == 0 ? i : pointsPerLine - 1 - i;
+            const float x = 400.0f * static_cast<float>(along) / static_cast<float>(pointsPerLine);
+            const float y = 300.0f * static_cast<float>(line) / static_cast<float>(lines);
+            cloud.push_back(PointXYZRGB(Point3D(x, y, static_cast<float>(i % 7)), RGB(static_cast<uint8_t>(line), static_cast<uint8_t>(i), 0)));
+        }
+    }
+    return cloud;
+}
+
+filesystem::path writeSurvey(const filesystem::path& file, const PointCloudXYZRGB& cloud, bool compressed) {
+    auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+    header.compressed = compressed;
+    LASProcessor processor;
+    REQUIRE(processor.saveLAS(file, header, cloud));
+    return file;
+}
+
+vector<PointXYZRGB> scan(const PointCloudXYZRGB& cloud, const LASIndex::Box& box) {
+    vector<PointXYZRGB> inside;
+    for (const auto& p : cloud) {
+        if (box.contains(p.position)) {
+            inside.push_back(p);
+        }
+    }
+    return inside;
+}
+
+bool samePoints(span<const PointXYZRGB> a, span<const PointXYZRGB> b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].position.x != b[i].position.x || a[i].position.y != b[i].position.y || a[i].position.z != b[i].position.z || a[i].color.r != b[i].color.r ||
+            a[i].color.g != b[i].color.g) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("LASReader seeks to any record", "[LASIndex][Seek]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_las_index_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto survey = makeSurvey(300, 400);
+
+    for (const bool compressed : {false, true}) {
+        INFO((compressed ? "LAZ" : "LAS"));
+        const auto file = writeSurvey(tempDir / (compressed ? "seek.laz" : "seek.las"), survey, compressed);
+        LASProcessor processor;
+        const auto [header, loaded] = processor.loadLAS(file);
+        REQUIRE(loaded.size() == survey.size());
+
+        LASReader reader(file);
+        REQUIRE(reader.is_open());
+        CHECK(reader.chunkSize() == (compressed ? codec::LAZCodec::DEFAULT_CHUNK_SIZE : 0));
+
+        // Forwards, backwards, within one LAZ chunk and across chunk boundaries
+        vector<PointXYZRGB> window(1000);
+        for (const uint64_t point : {uint64_t{70000}, uint64_t{0}, uint64_t{70500}, uint64_t{49990}, uint64_t{119000}, uint64_t{3}}) {
+            REQUIRE(reader.seek(point));
+            REQUIRE(reader.next(window) == window.size());
+            for (size_t i = 0; i < window.size(); ++i) {
+                REQUIRE(window[i].position.x == loaded[point + i].position.x);
+                REQUIRE(window[i].position.y == loaded[point + i].position.y);
+            }
+        }
+
+        // The last record, the end, and past the end
+        REQUIRE(reader.seek(survey.size() - 1));
+        CHECK(reader.next(window) == 1);
+        CHECK(window[0].position.x == loaded[survey.size() - 1].position.x);
+        REQUIRE(reader.seek(survey.size()));
+        CHECK(reader.next(window) == 0);
+        CHECK(reader.good());
+        CHECK_FALSE(reader.seek(survey.size() + 1));
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("LASIndex box queries match a full scan", "[LASIndex]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_las_index_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto survey = makeSurvey(300, 400);
+
+    for (const bool compressed : {false, true}) {
+        INFO((compressed ? "LAZ" : "LAS"));
+        const auto file = writeSurvey(tempDir / (compressed ? "survey.laz" : "survey.las"), survey, compressed);
+        LASProcessor processor;
+        const auto [header, loaded] = processor.loadLAS(file);
+
+        LASReader reader(file);
+        LASIndex index;
+        REQUIRE(index.build(reader, {.levels = 5}));
+        CHECK(index.levels() == 5);
+        CHECK(index.cellCount() == 32 * 24);  // Cells are square, so the 300 m side fills 24 of 32 rows
+
+        mt19937 rng(5);
+        uniform_real_distribution<double> x(-50.0, 450.0), y(-50.0, 350.0), size(0.0, 60.0);
+        for (int q = 0; q < 40; ++q) {
+            const double x0 = x(rng), y0 = y(rng);
+            const LASIndex::Box box{x0, y0, x0 + size(rng), y0 + size(rng)};
+            PointCloudXYZRGB found;
+            REQUIRE(index.read(reader, box, found));
+            REQUIRE(samePoints(found.points, scan(loaded, box)));
+            CHECK(found.width == found.size());
+        }
+
+        // A small box reads a small share of the file
+        uint64_t read = 0;
+        for (const auto& run : index.query({100, 100, 110, 110})) {
+            read += run.count;
+        }
+        CHECK(read > 0);
+        CHECK(read < survey.size() / 4);
+
+        // Boxes covering everything, nothing, or off the bounds
+        PointCloudXYZRGB found;
+        REQUIRE(index.read(reader, {-1e9, -1e9, 1e9, 1e9}, found));
+        CHECK(found.size() == survey.size());
+        REQUIRE(index.read(reader, {1000, 1000, 2000, 2000}, found));
+        CHECK(found.empty());
+        REQUIRE(index.read(reader, {10, 10, 0, 0}, found));
+        CHECK(found.empty());
+        CHECK(index.query({10, 10, 0, 0}).empty());
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("LASIndex chooses its depth and merges runs", "[LASIndex]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_las_index_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto survey = makeSurvey(300, 400);
+    const auto file = writeSurvey(tempDir / "depth.las", survey, false);
+
+    LASReader reader(file);
+    LASIndex index;
+    REQUIRE(index.build(reader));
+    CHECK(index.levels() == 1);  // 120000 points at about 50000 per cell
+
+    // Without merging every scan line crossing a cell is a run of its own; merging joins them
+    LASIndex exact, merged;
+    REQUIRE(exact.build(reader, {.levels = 4, .mergeGap = 1}));
+    REQUIRE(merged.build(reader, {.levels = 4, .mergeGap = 10000}));
+    CHECK(exact.intervalCount() >= 300 * 15);
+    CHECK(merged.intervalCount() < exact.intervalCount());
+    const auto runs = exact.query({0, 0, 500, 500});
+    REQUIRE(runs.size() == 1);
+    CHECK(runs[0].first == 0);
+    CHECK(runs[0].count == survey.size());
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("LASIndex files round trip and belong to one file", "[LASIndex][FileIO]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_las_index_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto survey = makeSurvey(100, 200);
+    const auto file = writeSurvey(tempDir / "tile.laz", survey, true);
+    CHECK(LASIndex::sidecarPath(file) == tempDir / "tile.laz.sfi");
+
+    LASReader reader(file);
+    LASIndex built;
+    REQUIRE(built.build(reader, {.levels = 3}));
+    REQUIRE(built.save(LASIndex::sidecarPath(file)));
+
+    LASIndex loaded;
+    REQUIRE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+    CHECK(loaded.levels() == built.levels());
+    CHECK(loaded.cellCount() == built.cellCount());
+    CHECK(loaded.intervalCount() == built.intervalCount());
+    const LASIndex::Box box{20, 30, 120, 90};
+    const auto expected = built.query(box);
+    const auto actual = loaded.query(box);
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        CHECK(actual[i].first == expected[i].first);
+        CHECK(actual[i].count == expected[i].count);
+    }
+
+    // loadBox answers from the index and from a plain scan alike
+    const auto [indexedHeader, indexed] = LASIndex::loadBox(file, box);
+    REQUIRE(indexedHeader.isValid());
+    filesystem::remove(LASIndex::sidecarPath(file));
+    const auto [scannedHeader, scanned] = LASIndex::loadBox(file, box);
+    REQUIRE(scannedHeader.isValid());
+    CHECK(!indexed.empty());
+    CHECK(samePoints(indexed.points, scanned.points));
+
+    SECTION("Index of another file is rejected") {
+        REQUIRE(built.save(LASIndex::sidecarPath(file)));
+        const auto other = writeSurvey(tempDir / "other.laz", makeSurvey(100, 201), true);
+        LASReader otherReader(other);
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), otherReader.header()));
+        CHECK(loaded.empty());
+        PointCloudXYZRGB found;
+        CHECK_FALSE(built.read(otherReader, box, found));
+    }
+
+    SECTION("Truncated and foreign files are rejected") {
+        REQUIRE(built.save(LASIndex::sidecarPath(file)));
+        filesystem::resize_file(LASIndex::sidecarPath(file), filesystem::file_size(LASIndex::sidecarPath(file)) - 8);
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+        {
+            ofstream(LASIndex::sidecarPath(file), ios::binary) << string(200, 'x');
+        }
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+        CHECK_FALSE(loaded.load(tempDir / "missing.sfi", reader.header()));
+    }
+
+    SECTION("Headers listing more cells or runs than the file holds are rejected before allocating") {
+        const auto corrupt = [&](streamoff offset, auto count) {
+            REQUIRE(built.save(LASIndex::sidecarPath(file)));
+            fstream index(LASIndex::sidecarPath(file), ios::binary | ios::in | ios::out);
+            index.seekp(offset);
+            index.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        };
+        corrupt(12, uint32_t{0xFFFFFFFF});  // Cells
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+        corrupt(32, uint64_t{1} << 60);  // Runs
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+        corrupt(32, static_cast<uint64_t>(built.intervalCount() + 1));
+        CHECK_FALSE(loaded.load(LASIndex::sidecarPath(file), reader.header()));
+        CHECK(loaded.empty());
+    }
+
+    filesystem::remove_all(tempDir);
+}
@@ -3,9 +3,12 @@
 
 #include "LASProcessor.hpp"
 #include "PointCloudTypes.hpp"
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <vector>
 
 using namespace scanforge;
 using Catch::Matchers::WithinAbs;
@@ -395,4 +398,465 @@ TEST_CASE("LASProcessor Point Record Length Calculation", "[LASProcessor][PointR
     REQUIRE(LASProcessor::getPointRecordLength(PointFormat::FORMAT_6) == 30);
     REQUIRE(LASProcessor::getPointRecordLength(PointFormat::FORMAT_7) == 36);
     REQUIRE(LASProcessor::getPointRecordLength(PointFormat::FORMAT_8) == 38);
-}
\ No newline at end of file
+}
+
+TEST_CASE("LASProcessor Record Layout", "[LASProcessor][RecordLayout]") {
+    using PointFormat = LASProcessor::PointFormat;
+    LASProcessor::LASHeader header{};
+
+    SECTION("RGB offsets follow the format core") {
+        header.pointDataRecordFormat = PointFormat::FORMAT_2;
+        header.pointDataRecordLength = 26;
+        REQUIRE(LASProcessor::createRecordLayout(header).rgbOffset == 20u);
+
+        header.pointDataRecordFormat = PointFormat::FORMAT_3;
+        header.pointDataRecordLength = 34;
+        REQUIRE(LASProcessor::createRecordLayout(header).rgbOffset == 28u);
+
+        header.pointDataRecordFormat = PointFormat::FORMAT_7;
+        header.pointDataRecordLength = 36;
+        REQUIRE(LASProcessor::createRecordLayout(header).rgbOffset == 30u);
+
+        header.pointDataRecordFormat = PointFormat::FORMAT_1;
+        header.pointDataRecordLength = 28;
+        REQUIRE_FALSE(LASProcessor::createRecordLayout(header).rgbOffset.has_value());
+    }
+
+    SECTION("Extra bytes widen the stride") {
+        header.pointDataRecordFormat = PointFormat::FORMAT_3;
+        header.pointDataRecordLength = 40;
+        auto layout = LASProcessor::createRecordLayout(header);
+        REQUIRE(layout.isValid());
+        REQUIRE(layout.stride == 40);
+    }
+
+    SECTION("Short records and unknown formats are rejected") {
+        header.pointDataRecordFormat = PointFormat::FORMAT_3;
+        header.pointDataRecordLength = 20;
+        REQUIRE_FALSE(LASProcessor::createRecordLayout(header).isValid());
+
+        header.pointDataRecordFormat = static_cast<PointFormat>(42);
+        header.pointDataRecordLength = 100;
+        REQUIRE_FALSE(LASProcessor::createRecordLayout(header).isValid());
+    }
+}
+
+TEST_CASE_METHOD(LASTestFixture, "LASProcessor Block Decoding", "[LASProcessor][BlockDecoding]") {
+    LASProcessor loader;
+
+    // Header-only file produced by the writer, raw records are appended by each section
+    auto writeRecords = [&](const fs::path& file, LASProcessor::PointFormat format, uint16_t recordLength, uint32_t count, const std::vector<uint8_t>& records) {
+        auto header = LASProcessor::createLASHeader(PointCloudXYZRGB{}, format);
+        header.pointDataRecordLength = recordLength;
+        header.legacyNumberOfPointRecords = count;
+        header.xScaleFactor = header.yScaleFactor = header.zScaleFactor = 0.001;
+        header.xOffset = 1000.0;
+        header.yOffset = -50.0;
+        header.zOffset = 0.0;
+        REQUIRE(loader.saveLAS(file, header, PointCloudXYZRGB{}));
+        // saveLAS stores the count it encoded, patch in the records appended below: the legacy
+        // count at offset 107, or the 64-bit count of a LAS 1.4 header at offset 247
+        std::fstream out(file, std::ios::binary | std::ios::in | std::ios::out);
+        if (header.versionMinor >= 4) {
+            const uint64_t extendedCount = count;
+            out.seekp(247);
+            out.write(reinterpret_cast<const char*>(&extendedCount), sizeof(extendedCount));
+        } else {
+            out.seekp(107);
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+        out.seekp(0, std::ios::end);
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+    };
+    auto put = [](std::vector<uint8_t>& records, size_t offset, auto value) { std::memcpy(records.data() + offset, &value, sizeof(value)); };
+
+    SECTION("Clouds spanning several read blocks decode every point exactly") {
+        // 2 MB blocks hold 61680 format 3 records
+        constexpr uint32_t count = 150000;
+        std::vector<uint8_t> records(size_t{count} * 34, 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            put(records, i * 34, static_cast<int32_t>(i) * 7 - 500000);
+            put(records, i * 34 + 4, static_cast<int32_t>(i));
+            put(records, i * 34 + 8, -static_cast<int32_t>(i % 1000));
+            put(records, i * 34 + 28, static_cast<uint16_t>((i % 256) << 8));
+        }
+        fs::path file = testDir / "blocks.las";
+        writeRecords(file, LASProcessor::PointFormat::FORMAT_3, 34, count, records);
+
+        auto [header, cloud] = loader.loadLAS(file);
+        REQUIRE(cloud.size() == count);
+        for (uint32_t i = 0; i < count; i += 997) {
+            REQUIRE(cloud.points[i].position.x == static_cast<float>((static_cast<int32_t>(i) * 7 - 500000) * 0.001 + 1000.0));
+            REQUIRE(cloud.points[i].position.y == static_cast<float>(static_cast<int32_t>(i) * 0.001 - 50.0));
+            REQUIRE(cloud.points[i].position.z == static_cast<float>(-static_cast<int32_t>(i % 1000) * 0.001));
+            REQUIRE(cloud.points[i].color.r == i % 256);
+        }
+        REQUIRE(cloud.points[count - 1].position.y == static_cast<float>((count - 1) * 0.001 - 50.0));
+    }
+
+    SECTION("Records with extra bytes and LAS 1.4 formats use the record length and format offsets") {
+        // Format 7 (36 bytes) plus 6 extra bytes per record
+        std::vector<uint8_t> records(3 * 42, 0xEE);
+        for (uint32_t i = 0; i < 3; ++i) {
+            put(records, i * 42, static_cast<int32_t>(i * 1000));
+            put(records, i * 42 + 4, static_cast<int32_t>(0));
+            put(records, i * 42 + 8, static_cast<int32_t>(0));
+            put(records, i * 42 + 30, static_cast<uint16_t>(10 << 8));
+            put(records, i * 42 + 32, static_cast<uint16_t>(20 << 8));
+            put(records, i * 42 + 34, static_cast<uint16_t>((30 + i) << 8));
+        }
+        fs::path file = testDir / "format7_extra.las";
+        writeRecords(file, LASProcessor::PointFormat::FORMAT_7, 42, 3, records);
+
+        auto [header, cloud] = loader.loadLAS(file);
+        REQUIRE(cloud.size() == 3);
+        REQUIRE_THAT(cloud.points[2].position.x, WithinAbs(1002.0f, 0.001f));
+        REQUIRE_THAT(cloud.points[2].position.y, WithinAbs(-50.0f, 0.001f));
+        REQUIRE(cloud.points[2].color.r == 10);
+        REQUIRE(cloud.points[2].color.g == 20);
+        REQUIRE(cloud.points[2].color.b == 32);
+    }
+
+    SECTION("Truncated point data fails") {
+        std::vector<uint8_t> records(10 * 34 - 5, 0);
+        fs::path file = testDir / "truncated.las";
+        writeRecords(file, LASProcessor::PointFormat::FORMAT_3, 34, 10, records);
+
+        auto [header, cloud] = loader.loadLAS(file);
+        REQUIRE(cloud.empty());
+    }
+}
+
+TEST_CASE_METHOD(LASTestFixture, "LASProcessor Multi-threaded Loading", "[LASProcessor][Threads]") {
+    LASProcessor loader;
+
+    PointCloudXYZRGB original;
+    for (int i = 0; i < 100003; ++i) {
+        original.points.push_back(PointXYZRGB(Point3D(static_cast<float>(i % 977), static_cast<float>(i / 977), static_cast<float>(i % 13)), RGB(static_cast<uint8_t>(i), 0, 0)));
+    }
+    fs::path file = testDir / "threads.las";
+    REQUIRE(loader.saveLAS(file, LASProcessor::createLASHeader(original, LASProcessor::PointFormat::FORMAT_3), original));
+
+    auto [serialHeader, serial] = loader.loadLAS(file);
+    REQUIRE(serial.size() == original.size());
+
+    SECTION("Any thread count yields the same cloud as the serial reader") {
+        for (unsigned threads : {2u, 3u, 7u, 0u}) {
+            auto [header, cloud] = loader.loadLAS(file, threads);
+            REQUIRE(header.isValid());
+            REQUIRE(cloud.size() == serial.size());
+            REQUIRE(cloud.width == serial.width);
+            bool identical = true;
+            for (size_t i = 0; i < cloud.size(); ++i) {
+                const auto& a = cloud.points[i];
+                const auto& b = serial.points[i];
+                identical = identical && a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z && a.color.r == b.color.r;
+            }
+            REQUIRE(identical);
+        }
+    }
+
+    SECTION("Truncated files fail with several threads too") {
+        fs::resize_file(file, fs::file_size(file) - 10);
+        auto [header, cloud] = loader.loadLAS(file, 4);
+        REQUIRE(cloud.empty());
+    }
+}
+
+TEST_CASE_METHOD(LASTestFixture, "LASProcessor Block Encoding", "[LASProcessor][BlockEncoding]") {
+    LASProcessor writer;
+    auto readFile = [](const fs::path& file) {
+        std::ifstream in(file, std::ios::binary);
+        std::vector<char> bytes(fs::file_size(file));
+        in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    };
+
+    // Spans several 2 MB write blocks, with a NaN that must stay out of the bounds
+    PointCloudXYZRGB original;
+    for (int i = 0; i < 150001; ++i) {
+        const float f = static_cast<float>(i);
+        original.points.push_back(PointXYZRGB(Point3D(f * 0.013f - 900.0f, -f * 0.001f, f * 0.0071f), RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 3)));
+    }
+    original.points[77].position.z = std::numeric_limits<float>::quiet_NaN();
+
+    SECTION("Parallel encoding writes the same bytes as a single thread") {
+        const auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        REQUIRE(writer.saveLAS(testDir / "serial.las", header, original));
+        REQUIRE(writer.saveLAS(testDir / "parallel.las", header, original, 4));
+        REQUIRE(readFile(testDir / "serial.las") == readFile(testDir / "parallel.las"));
+
+        auto [loadedHeader, cloud] = writer.loadLAS(testDir / "parallel.las");
+        REQUIRE(loadedHeader.getTotalPointCount() == original.size());
+        REQUIRE(cloud.size() == original.size());
+        REQUIRE(loadedHeader.minX == static_cast<double>(-900.0f));
+        REQUIRE(loadedHeader.maxX == static_cast<double>(150000.0f * 0.013f - 900.0f));
+        REQUIRE(loadedHeader.minY == static_cast<double>(-150000.0f * 0.001f));
+        REQUIRE(loadedHeader.maxZ == static_cast<double>(150000.0f * 0.0071f));
+        REQUIRE(cloud.points[150000].color.g == original.points[150000].color.g);
+    }
+
+    SECTION("A NaN at the start of an encoding batch leaves its other points in the bounds") {
+        PointCloudXYZRGB cloud;
+        for (int i = 0; i < 600; ++i) {
+            const float f = static_cast<float>(i);
+            cloud.push_back(PointXYZRGB(Point3D(f, -f, 2.0f * f), RGB(1, 2, 3)));
+        }
+        // Point 0 is the smallest in x and z, point 256 starts the second batch
+        cloud.points[0].position = Point3D(std::numeric_limits<float>::quiet_NaN(), 0.0f, std::numeric_limits<float>::quiet_NaN());
+        cloud.points[256].position.y = std::numeric_limits<float>::quiet_NaN();
+        cloud.points[599].position.x = std::numeric_limits<float>::quiet_NaN();
+
+        for (const bool compressed : {false, true}) {
+            INFO("compressed " << compressed);
+            auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+            header.compressed = compressed;
+            const fs::path file = testDir / (compressed ? "nan_first.laz" : "nan_first.las");
+            REQUIRE(writer.saveLAS(file, header, cloud, 2));
+
+            auto [loadedHeader, loaded] = writer.loadLAS(file);
+            REQUIRE(loadedHeader.minX == 1.0);
+            REQUIRE(loadedHeader.maxX == 598.0);
+            REQUIRE(loadedHeader.minY == -599.0);
+            REQUIRE(loadedHeader.maxY == 0.0);
+            REQUIRE(loadedHeader.minZ == 2.0);
+            REQUIRE(loadedHeader.maxZ == 1198.0);
+        }
+    }
+
+    SECTION("Coordinates are rounded to the nearest step and saturate") {
+        PointCloudXYZRGB cloud;
+        cloud.push_back(PointXYZRGB(Point3D(0.006f, -0.006f, 0.014f), RGB(1, 2, 3)));
+        cloud.push_back(PointXYZRGB(Point3D(1.0e12f, -1.0e12f, 0.0f), RGB(1, 2, 3)));
+        REQUIRE(writer.saveLAS(testDir / "rounding.las", LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3), cloud));
+
+        auto [header, loaded] = writer.loadLAS(testDir / "rounding.las");
+        REQUIRE(loaded.size() == 2);
+        REQUIRE_THAT(loaded.points[0].position.x, WithinAbs(0.01f, 1e-6f));
+        REQUIRE_THAT(loaded.points[0].position.y, WithinAbs(-0.01f, 1e-6f));
+        REQUIRE_THAT(loaded.points[0].position.z, WithinAbs(0.01f, 1e-6f));
+        REQUIRE_THAT(loaded.points[1].position.x, WithinAbs(2147483647 * 0.01, 1.0));
+        REQUIRE_THAT(loaded.points[1].position.y, WithinAbs(-2147483648.0 * 0.01, 1.0));
+    }
+
+    SECTION("LAS 1.4 formats place RGB and classification at their own offsets") {
+        const auto format7 = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_7);
+        REQUIRE(writer.saveLAS(testDir / "format7.las", format7, original));
+
+        const auto bytes = readFile(testDir / "format7.las");
+        REQUIRE(bytes.size() == format7.offsetToPointData + original.size() * 36);
+        const char* first = bytes.data() + format7.offsetToPointData;
+        REQUIRE(first[14] == 0x11);
+        REQUIRE(first[16] == 1);
+
+        auto [header, cloud] = writer.loadLAS(testDir / "format7.las");
+        REQUIRE(cloud.size() == original.size());
+        REQUIRE(header.getVersion() == "1.4");
+        REQUIRE(header.numberOfPointRecords == original.size());
+        REQUIRE(header.numberOfPointsByReturn[0] == original.size());  // Every point is return 1 of 1
+        REQUIRE(header.numberOfPointsByReturn[1] == 0);
+        REQUIRE(header.legacyNumberOfPointRecords == 0);
+        REQUIRE(header.legacyNumberOfPointsByReturn[0] == 0);
+        REQUIRE(cloud.points[1000].color.r == original.points[1000].color.r);
+        REQUIRE(cloud.points[1000].color.g == original.points[1000].color.g);
+        REQUIRE_THAT(cloud.points[1000].position.x, WithinAbs(original.points[1000].position.x, 0.005));
+    }
+}
+
+TEST_CASE_METHOD(LASTestFixture, "LASProcessor LAZ Compression", "[LASProcessor][LAZ]") {
+    LASProcessor processor;
+    auto readFile = [](const fs::path& file) {
+        std::ifstream in(file, std::ios::binary);
+        std::vector<char> bytes(fs::file_size(file));
+        in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    };
+    auto samePoints = [](const PointCloudXYZRGB& a, const PointCloudXYZRGB& b) {
+        bool identical = a.size() == b.size();
+        for (size_t i = 0; identical && i < a.size(); ++i) {
+            identical = a.points[i].position.x == b.points[i].position.x && a.points[i].position.y == b.points[i].position.y &&
+                        a.points[i].position.z == b.points[i].position.z && a.points[i].color.toPacked() == b.points[i].color.toPacked();
+        }
+        return identical;
+    };
+
+    // Three chunks of 50000 points, the last one partial
+    PointCloudXYZRGB original;
+    for (int i = 0; i < 120001; ++i) {
+        const float f = static_cast<float>(i);
+        original.points.push_back(PointXYZRGB(Point3D(f * 0.013f - 900.0f, static_cast<float>(i % 501) * 0.25f, f * 0.0071f), RGB(static_cast<uint8_t>(i / 7), static_cast<uint8_t>(i >> 8), 3)));
+    }
+
+    for (auto format : {LASProcessor::PointFormat::FORMAT_0, LASProcessor::PointFormat::FORMAT_3, LASProcessor::PointFormat::FORMAT_6, LASProcessor::PointFormat::FORMAT_8}) {
+        GIVEN("point format " + std::to_string(static_cast<int>(format))) {
+            auto header = LASProcessor::createLASHeader(format);
+            REQUIRE(processor.saveLAS(testDir / "plain.las", header, original));
+            header.compressed = true;
+            REQUIRE(processor.saveLAS(testDir / "serial.laz", header, original));
+            REQUIRE(processor.saveLAS(testDir / "parallel.laz", header, original, 3));
+
+            THEN("the LAZ file is smaller, flagged, and decodes to the same cloud as the LAS file") {
+                REQUIRE(fs::file_size(testDir / "serial.laz") < fs::file_size(testDir / "plain.las") / 2);
+                REQUIRE(readFile(testDir / "serial.laz") == readFile(testDir / "parallel.laz"));
+
+                const auto bytes = readFile(testDir / "serial.laz");
+                REQUIRE(static_cast<uint8_t>(bytes[104]) == (static_cast<uint8_t>(format) | 0x80));
+                uint16_t headerSize;
+                std::memcpy(&headerSize, bytes.data() + 94, sizeof(headerSize));
+                REQUIRE(std::string_view(bytes.data() + headerSize + 2) == "laszip encoded");
+
+                auto [plainHeader, plain] = processor.loadLAS(testDir / "plain.las");
+                for (unsigned threads : {1u, 2u, 0u}) {
+                    auto [lazHeader, cloud] = processor.loadLAS(testDir / "parallel.laz", threads);
+                    REQUIRE(lazHeader.compressed);
+                    REQUIRE(lazHeader.pointDataRecordFormat == format);
+                    REQUIRE(lazHeader.getTotalPointCount() == original.size());
+                    REQUIRE(lazHeader.maxX == plainHeader.maxX);
+                    REQUIRE(samePoints(cloud, plain));
+                }
+
+                auto [columnsHeader, columns] = processor.loadLASColumns(testDir / "serial.laz", 2);
+                REQUIRE(columns.size() == original.size());
+                REQUIRE(columns.x[100000] == plain.points[100000].position.x);
+                REQUIRE(columns.r[100000] == plain.points[100000].color.r);
+            }
+        }
+    }
+
+    SECTION("Wave packet formats cannot be compressed") {
+        for (const auto format : {LASProcessor::PointFormat::FORMAT_4, LASProcessor::PointFormat::FORMAT_9}) {
+            INFO("format " << static_cast<int>(format));
+            auto header = LASProcessor::createLASHeader(format);
+            header.compressed = true;
+            REQUIRE_FALSE(processor.saveLAS(testDir / "extended.laz", header, original));
+        }
+    }
+
+    SECTION("Empty clouds produce a valid LAZ file") {
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        REQUIRE(processor.saveLAS(testDir / "empty.laz", header, PointCloudXYZRGB{}));
+        auto [loadedHeader, cloud] = processor.loadLAS(testDir / "empty.laz");
+        REQUIRE(loadedHeader.isValid());
+        REQUIRE(loadedHeader.getTotalPointCount() == 0);
+        REQUIRE(cloud.empty());
+    }
+
+    SECTION("Corrupt or truncated LAZ files fail to load") {
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        const auto file = testDir / "damaged.laz";
+        REQUIRE(processor.saveLAS(file, header, original));
+        auto bytes = readFile(file);
+        const size_t pointer = std::get<0>(processor.loadLAS(file)).offsetToPointData;
+        int64_t tableOffset;
+        std::memcpy(&tableOffset, bytes.data() + pointer, sizeof(tableOffset));
+
+        WHEN("the chunk table offset points outside the file") {
+            const int64_t outside = int64_t{1} << 40;
+            std::memcpy(bytes.data() + pointer, &outside, sizeof(outside));
+        }
+
+        WHEN("the last chunk is cut short") {
+            // Drop bytes just before the chunk table and move its offset accordingly
+            bytes.erase(bytes.begin() + tableOffset - 2000, bytes.begin() + tableOffset);
+            const int64_t moved = tableOffset - 2000;
+            std::memcpy(bytes.data() + pointer, &moved, sizeof(moved));
+        }
+
+        std::ofstream(file, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        auto [loadedHeader, cloud] = processor.loadLAS(file, 2);
+        REQUIRE(loadedHeader.compressed);
+        REQUIRE(cloud.empty());
+    }
+}
+
+TEST_CASE_METHOD(LASTestFixture, "LASProcessor Typed Point Loading", "[LASProcessor][Schema]") {
+    LASProcessor processor;
+    PointCloudXYZRGB original;
+    for (int i = 0; i < 40000; ++i) {
+        original.points.push_back(PointXYZRGB(Point3D(static_cast<float>(i % 211), static_cast<float>(i / 211), static_cast<float>(i % 5)), RGB(static_cast<uint8_t>(i), 7, 9)));
+    }
+
+    // Give every record its own intensity, returns, class, GPS time and NIR, at the offsets of its format
+    auto patchAttributes = [&](const fs::path& file, const LASProcessor::LASHeader& header) {
+        const auto layout = LASProcessor::createRecordLayout(header);
+        std::fstream stream(file, std::ios::binary | std::ios::in | std::ios::out);
+        std::vector<char> record(layout.stride);
+        for (size_t i = 0; i < original.size(); ++i) {
+            const auto at = static_cast<std::streamoff>(header.offsetToPointData + i * layout.stride);
+            stream.seekg(at);
+            stream.read(record.data(), static_cast<std::streamsize>(record.size()));
+            const auto intensity = static_cast<uint16_t>(i * 3);
+            const double gpsTime = 1000.0 + static_cast<double>(i) * 0.5;
+            const auto nir = static_cast<uint16_t>(i + 1);
+            std::memcpy(record.data() + 12, &intensity, sizeof(intensity));
+            if (layout.extended) {
+                record[14] = static_cast<char>(0x32);  // Return 2 of 3
+                record[16] = static_cast<char>(i % 19);
+            } else {
+                record[14] = static_cast<char>(0x1A);  // Return 2 of 3
+                record[15] = static_cast<char>(0xE0 | (i % 19));  // Flags above the class must not leak into it
+            }
+            if (layout.gpsTimeOffset) {
+                std::memcpy(record.data() + *layout.gpsTimeOffset, &gpsTime, sizeof(gpsTime));
+            }
+            if (layout.nirOffset) {
+                std::memcpy(record.data() + *layout.nirOffset, &nir, sizeof(nir));
+            }
+            stream.seekp(at);
+            stream.write(record.data(), static_cast<std::streamsize>(record.size()));
+        }
+    };
+
+    for (const auto format : {LASProcessor::PointFormat::FORMAT_3, LASProcessor::PointFormat::FORMAT_8, LASProcessor::PointFormat::FORMAT_0}) {
+        const auto written = LASProcessor::createLASHeader(format);
+        const fs::path file = testDir / "typed.las";
+        REQUIRE(processor.saveLAS(file, written, original));
+        const auto header = std::get<0>(processor.loadLAS<Point3D>(file));
+        patchAttributes(file, header);
+
+        for (unsigned threads : {1u, 3u}) {
+            auto [lasHeader, cloud] = processor.loadLAS<PointLAS>(file, threads);
+            REQUIRE(cloud.size() == original.size());
+            bool matches = true;
+            for (size_t i = 0; i < cloud.size(); ++i) {
+                const auto& p = cloud.points[i];
+                matches = matches && p.position.x == static_cast<float>(i % 211) && p.intensity == static_cast<float>(static_cast<uint16_t>(i * 3)) && p.returnNumber == 2 &&
+                          p.numberOfReturns == 3 && p.classification == i % 19;
+                if (lasHeader.hasGPSTime()) {
+                    matches = matches && p.gpsTime == 1000.0 + static_cast<double>(i) * 0.5;
+                } else {
+                    matches = matches && p.gpsTime == 0.0;
+                }
+                if (lasHeader.hasRGB()) {
+                    matches = matches && p.color.r == original.points[i].color.r && p.color.g == 7;
+                } else {
+                    matches = matches && p.color.r == 255 && p.color.g == 255;
+                }
+                matches = matches && p.nearInfrared == (format == LASProcessor::PointFormat::FORMAT_8 ? static_cast<uint16_t>(i + 1) : 0);
+            }
+            REQUIRE(matches);
+        }
+
+        auto [xyzHeader, xyz] = processor.loadLAS<Point3D>(file, 2);
+        REQUIRE(xyz.size() == original.size());
+        REQUIRE(xyz.points[500].x == original.points[500].position.x);
+        auto [xyziHeader, xyzi] = processor.loadLAS<PointXYZI>(file);
+        REQUIRE(xyzi.points[500].intensity == 1500.0f);
+        auto [plainHeader, plain] = processor.loadLAS(file);
+        REQUIRE(plain.points[500].position.y == original.points[500].position.y);
+    }
+
+    SECTION("LAZ files decode typed points too") {
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        const fs::path file = testDir / "typed.laz";
+        REQUIRE(processor.saveLAS(file, header, original));
+        auto [lazHeader, cloud] = processor.loadLAS<PointXYZRGBClass>(file, 2);
+        REQUIRE(cloud.size() == original.size());
+        REQUIRE(cloud.points[1234].classification == 1);  // The writer marks points unclassified
+        REQUIRE(cloud.points[1234].color.r == original.points[1234].color.r);
+        REQUIRE(cloud.points[1234].position.z == original.points[1234].position.z);
+    }
+}
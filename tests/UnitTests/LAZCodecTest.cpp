@@ -0,0 +1,409 @@
+/**
+ * @brief Unit tests for the LASzip-compatible LAZCodec using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "codec/LAZCodec.hpp"
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace scanforge::codec;
+
+namespace {
+
+// Records of a LAS point format 0-3 plus extraBytes, with the attribute changes real scans show
+vector<uint8_t> makeRecords(uint8_t format, size_t extraBytes, size_t count) {
+    const auto parameters = LAZCodec::Parameters::forPointFormat(format, static_cast<uint16_t>((format == 0 ? 20 : format == 1 ? 28 : format == 2 ? 26 : 34) + extraBytes));
+    REQUIRE(parameters);
+    const size_t stride = parameters->recordLength();
+    vector<uint8_t> records(count * stride);
+
+    uint32_t seed = 12345;
+    auto random = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    auto put = [](uint8_t* at, auto value) { memcpy(at, &value, sizeof(value)); };
+
+    double gpsTime = 86400.25;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* record = records.data() + i * stride;
+        put(record, static_cast<int32_t>(i * 10 + random() % 7));
+        put(record + 4, static_cast<int32_t>(random() % 100000) - 50000);
+        put(record + 8, static_cast<int32_t>(i % 300));
+        put(record + 12, static_cast<uint16_t>(random()));
+        const uint32_t returns = 1 + random() % 7;
+        record[14] = static_cast<uint8_t>((1 + random() % returns) | (returns << 3) | ((random() & 1) << 6) | (random() % 50 == 0 ? 0x80 : 0));
+        record[15] = static_cast<uint8_t>(random() % 4);
+        record[16] = static_cast<uint8_t>(random() % 9);
+        record[17] = static_cast<uint8_t>(i / 1000);
+        put(record + 18, static_cast<uint16_t>(i / 5000));
+
+        size_t offset = 20;
+        if (format == 1 || format == 3) {
+            // Mostly regular pulses, with repeats, jumps beyond 32 bits and sign flips
+            if (random() % 3 != 0) {
+                gpsTime += 0.00001 * (random() % 5);
+            }
+            if (random() % 1000 == 0) {
+                gpsTime += 1.0e6;
+            }
+            if (random() % 777 == 0) {
+                gpsTime = -gpsTime;
+            }
+            put(record + offset, gpsTime);
+            offset += 8;
+        }
+        if (format == 2 || format == 3) {
+            const auto grey = static_cast<uint16_t>(random());
+            const bool isGrey = random() % 2 == 0;
+            put(record + offset, grey);
+            put(record + offset + 2, isGrey ? grey : static_cast<uint16_t>(random()));
+            put(record + offset + 4, isGrey ? grey : static_cast<uint16_t>(random()));
+            offset += 6;
+        }
+        for (; offset < stride; ++offset) {
+            record[offset] = static_cast<uint8_t>(random() % 3 + offset);
+        }
+    }
+    return records;
+}
+
+// Records of a LAS point format 6-8 plus extraBytes: up to 15 returns, four scanner channels visited in turn, negative scan angles
+vector<uint8_t> makeExtendedRecords(uint8_t format, size_t extraBytes, size_t count) {
+    const auto parameters = LAZCodec::Parameters::forPointFormat(format, static_cast<uint16_t>((format == 6 ? 30 : format == 7 ? 36 : 38) + extraBytes));
+    REQUIRE(parameters);
+    const size_t stride = parameters->recordLength();
+    vector<uint8_t> records(count * stride);
+
+    uint32_t seed = 54321;
+    auto random = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    auto put = [](uint8_t* at, auto value) { memcpy(at, &value, sizeof(value)); };
+
+    double gpsTime = 302400.5;
+    uint32_t returns = 1;
+    uint32_t returnNumber = 1;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* record = records.data() + i * stride;
+        // A pulse's returns share its GPS time; a new pulse starts after the last return
+        if (returnNumber >= returns) {
+            returns = 1 + random() % 15;
+            returnNumber = 1;
+            gpsTime += 0.000005 * (1 + random() % 3);
+        } else {
+            ++returnNumber;
+        }
+        const uint32_t channel = static_cast<uint32_t>(i / 700) % 4;
+        put(record, static_cast<int32_t>(i * 10 + random() % 7 + channel * 100000));
+        put(record + 4, static_cast<int32_t>(random() % 100000) - 50000);
+        put(record + 8, static_cast<int32_t>(i % 300) - static_cast<int32_t>(returnNumber * 40));
+        put(record + 12, static_cast<uint16_t>(random()));
+        record[14] = static_cast<uint8_t>(returnNumber | (returns << 4));
+        record[15] = static_cast<uint8_t>((random() % 40 == 0 ? 0x01 : 0) | (channel << 4) | ((i / 300) % 2 << 6) | (random() % 50 == 0 ? 0x80 : 0));
+        record[16] = static_cast<uint8_t>(random() % 9);
+        record[17] = static_cast<uint8_t>(i / 1000);
+        put(record + 18, static_cast<int16_t>(static_cast<int32_t>(i / 97 % 61) - 30));
+        put(record + 20, static_cast<uint16_t>(i / 5000 + channel));
+        put(record + 22, gpsTime);
+
+        size_t offset = 30;
+        if (format >= 7) {
+            const auto grey = static_cast<uint16_t>(random());
+            put(record + offset, grey);
+            put(record + offset + 2, static_cast<uint16_t>(grey + random() % 5));
+            put(record + offset + 4, static_cast<uint16_t>(grey - random() % 5));
+            offset += 6;
+        }
+        if (format == 8) {
+            put(record + offset, static_cast<uint16_t>(i % 3000 + (random() & 0x0100)));
+            offset += 2;
+        }
+        for (; offset < stride; ++offset) {
+            record[offset] = static_cast<uint8_t>(i % 5 == 0 ? random() : offset);
+        }
+    }
+    return records;
+}
+
+}  // namespace
+
+TEST_CASE("LAZ chunks round-trip every record byte", "[LAZCodec]") {
+    for (uint8_t format = 0; format <= 3; ++format) {
+        for (size_t extraBytes : {size_t{0}, size_t{5}}) {
+            GIVEN("point format " + to_string(format) + " with " + to_string(extraBytes) + " extra bytes") {
+                const auto parameters = LAZCodec::Parameters::forPointFormat(format, static_cast<uint16_t>(makeRecords(format, extraBytes, 1).size()));
+                REQUIRE(parameters);
+                REQUIRE(parameters->isSupported());
+                const auto records = makeRecords(format, extraBytes, 20000);
+
+                vector<uint8_t> chunk;
+                LAZCodec::compressChunk(records, *parameters, chunk);
+                vector<uint8_t> decoded(records.size());
+                REQUIRE(LAZCodec::decompressChunk(chunk, *parameters, decoded));
+
+                THEN("decompression restores the records and the chunk is smaller") {
+                    REQUIRE(decoded == records);
+                    REQUIRE(chunk.size() < records.size() / 2);
+                }
+            }
+        }
+    }
+
+    for (uint8_t format = 6; format <= 8; ++format) {
+        for (size_t extraBytes : {size_t{0}, size_t{3}}) {
+            GIVEN("layered point format " + to_string(format) + " with " + to_string(extraBytes) + " extra bytes") {
+                const auto parameters = LAZCodec::Parameters::forPointFormat(format, static_cast<uint16_t>(makeExtendedRecords(format, extraBytes, 1).size()));
+                REQUIRE(parameters);
+                REQUIRE(parameters->isSupported());
+                REQUIRE(parameters->isLayered());
+                const auto records = makeExtendedRecords(format, extraBytes, 20000);
+
+                vector<uint8_t> chunk;
+                LAZCodec::compressChunk(records, *parameters, chunk);
+                vector<uint8_t> decoded(records.size());
+                REQUIRE(LAZCodec::decompressChunk(chunk, *parameters, decoded));
+
+                THEN("decompression restores the records and the chunk is smaller") {
+                    REQUIRE(decoded == records);
+                    REQUIRE(chunk.size() < records.size() / 2);
+                }
+            }
+        }
+    }
+
+    SECTION("A single-point chunk holds the raw record and the coder's flush bytes") {
+        const auto parameters = LAZCodec::Parameters::forPointFormat(3, 34);
+        const auto records = makeRecords(3, 0, 1);
+        vector<uint8_t> chunk;
+        LAZCodec::compressChunk(records, *parameters, chunk);
+        REQUIRE(chunk.size() == 34 + 4);
+        REQUIRE(equal(records.begin(), records.end(), chunk.begin()));
+
+        vector<uint8_t> decoded(34);
+        REQUIRE(LAZCodec::decompressChunk(chunk, *parameters, decoded));
+        REQUIRE(decoded == records);
+    }
+
+    SECTION("Layers of attributes that never change are left out of layered chunks") {
+        const auto parameters = LAZCodec::Parameters::forPointFormat(7, 36);
+        auto records = makeExtendedRecords(7, 0, 1000);
+        for (size_t i = 1; i < 1000; ++i) {
+            // Keep the coordinates, returns, channel and GPS time of each point, the other attributes of the first
+            uint8_t* record = records.data() + i * 36;
+            memcpy(record + 12, records.data() + 12, 2);
+            record[15] = static_cast<uint8_t>((records[15] & 0xCF) | (record[15] & 0x30));
+            memcpy(record + 16, records.data() + 16, 6);
+            memcpy(record + 30, records.data() + 30, 6);
+        }
+
+        vector<uint8_t> chunk;
+        LAZCodec::compressChunk(records, *parameters, chunk);
+        REQUIRE(chunk.size() > 36 + 4 + 10 * 4);
+        uint32_t points;
+        memcpy(&points, chunk.data() + 36, sizeof(points));
+        REQUIRE(points == 1000);
+
+        // POINT14's nine layer sizes, then RGB14's one: only returns and x/y, z and GPS time are stored
+        array<uint32_t, 10> sizes;
+        memcpy(sizes.data(), chunk.data() + 40, sizeof(sizes));
+        REQUIRE(sizes[0] > 0);
+        REQUIRE(sizes[1] > 0);
+        for (size_t layer : {2u, 3u, 4u, 5u, 6u, 7u, 9u}) {
+            INFO("layer " << layer);
+            REQUIRE(sizes[layer] == 0);
+        }
+        REQUIRE(sizes[8] > 0);
+
+        vector<uint8_t> decoded(records.size());
+        REQUIRE(LAZCodec::decompressChunk(chunk, *parameters, decoded));
+        REQUIRE(decoded == records);
+
+        // The point count must match the records asked for
+        REQUIRE_FALSE(LAZCodec::decompressChunk(chunk, *parameters, span(decoded).first(999 * 36)));
+    }
+
+    SECTION("Truncated chunks are reported") {
+        const auto parameters = LAZCodec::Parameters::forPointFormat(1, 28);
+        const auto records = makeRecords(1, 0, 5000);
+        vector<uint8_t> chunk;
+        LAZCodec::compressChunk(records, *parameters, chunk);
+        chunk.resize(chunk.size() / 2);
+
+        vector<uint8_t> decoded(records.size());
+        REQUIRE_FALSE(LAZCodec::decompressChunk(chunk, *parameters, decoded));
+        REQUIRE_FALSE(LAZCodec::decompressChunk(span(chunk).first(10), *parameters, decoded));
+
+        const auto layered = LAZCodec::Parameters::forPointFormat(8, 38);
+        const auto extended = makeExtendedRecords(8, 0, 5000);
+        LAZCodec::compressChunk(extended, *layered, chunk);
+        decoded.resize(extended.size());
+        REQUIRE_FALSE(LAZCodec::decompressChunk(span(chunk).first(chunk.size() / 2), *layered, decoded));
+        REQUIRE_FALSE(LAZCodec::decompressChunk(span(chunk).first(50), *layered, decoded));
+    }
+}
+
+TEST_CASE("LAZ streams match bytes laid out from the LASzip format", "[LAZCodec]") {
+    // Format 7 with 2 extra bytes: x 1000, y -2000, z 300, intensity 77, return 1 of 2, channel 1, class 2,
+    // scan angle -15, point source 7, GPS time 150000.5, RGB 256/512/768, extra bytes AB CD
+    const vector<uint8_t> record{0xE8, 0x03, 0x00, 0x00, 0x30, 0xF8, 0xFF, 0xFF, 0x2C, 0x01, 0x00, 0x00, 0x4D, 0x00, 0x21, 0x10, 0x02, 0x00, 0xF1,
+                                 0xFF, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x84, 0x4F, 0x02, 0x41, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0xAB, 0xCD};
+    const auto parameters = LAZCodec::Parameters::forPointFormat(7, 38);
+    REQUIRE(parameters);
+
+    SECTION("The LASzip VLR of a layered file") {
+        const vector<uint8_t> payload{
+            0x03, 0x00, 0x00, 0x00,                          // Compressor 3 (layered chunked), coder 0 (arithmetic)
+            0x03, 0x04, 0x03, 0x00,                          // LASzip version 3.4 revision 3
+            0x00, 0x00, 0x00, 0x00, 0x50, 0xC3, 0x00, 0x00,  // No options, chunks of 50000 points
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // No special EVLRs
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0x03, 0x00,                                      // Three items: type, size and version each
+            0x0A, 0x00, 0x1E, 0x00, 0x03, 0x00,              // POINT14
+            0x0B, 0x00, 0x06, 0x00, 0x03, 0x00,              // RGB14
+            0x0E, 0x00, 0x02, 0x00, 0x03, 0x00};             // BYTE14
+        REQUIRE(parameters->serialize() == payload);
+        const auto parsed = LAZCodec::Parameters::parse(payload);
+        REQUIRE(parsed);
+        REQUIRE(parsed->isSupported());
+        REQUIRE(parsed->recordLength() == 38);
+    }
+
+    SECTION("A layered chunk of one point") {
+        // The raw record, the point count, then a size per layer: POINT14's nine, RGB14's one and one per extra byte.
+        // Only the returns and x/y layer and the z layer are stored, each as the 4 flush bytes of an empty coder
+        vector<uint8_t> expected = record;
+        expected.insert(expected.end(), {0x01, 0x00, 0x00, 0x00});                          // 1 point
+        expected.insert(expected.end(), {0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00});  // Returns and x/y, z
+        expected.insert(expected.end(), 7 * 4, uint8_t{0});                                 // Classification to GPS time
+        expected.insert(expected.end(), 4, uint8_t{0});                                     // RGB
+        expected.insert(expected.end(), 2 * 4, uint8_t{0});                                 // Extra bytes
+        expected.insert(expected.end(), {0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00});  // Returns and x/y, z
+
+        vector<uint8_t> chunk;
+        LAZCodec::compressChunk(record, *parameters, chunk);
+        REQUIRE(chunk == expected);
+
+        vector<uint8_t> decoded(record.size());
+        REQUIRE(LAZCodec::decompressChunk(expected, *parameters, decoded));
+        REQUIRE(decoded == record);
+    }
+
+    SECTION("A point-wise chunk of one point") {
+        // Format 1, from the first 20 bytes above and the GPS time: the raw record, then the 4 flush bytes of the one coder all items share
+        vector<uint8_t> format1(record.begin(), record.begin() + 20);
+        format1.insert(format1.end(), record.begin() + 22, record.begin() + 30);
+        vector<uint8_t> expected = format1;
+        expected.insert(expected.end(), {0x01, 0x00, 0x00, 0x00});
+
+        const auto pointwise = LAZCodec::Parameters::forPointFormat(1, 28);
+        vector<uint8_t> chunk;
+        LAZCodec::compressChunk(format1, *pointwise, chunk);
+        REQUIRE(chunk == expected);
+
+        vector<uint8_t> decoded(format1.size());
+        REQUIRE(LAZCodec::decompressChunk(expected, *pointwise, decoded));
+        REQUIRE(decoded == format1);
+    }
+}
+
+TEST_CASE("LAZ parameters describe the point format", "[LAZCodec]") {
+    SECTION("Items follow the format and collect extra bytes into one BYTE item") {
+        const auto parameters = LAZCodec::Parameters::forPointFormat(3, 40);
+        REQUIRE(parameters);
+        REQUIRE(parameters->items.size() == 4);
+        REQUIRE(parameters->items[1].type == static_cast<uint16_t>(LAZCodec::ItemType::GPSTIME11));
+        REQUIRE(parameters->items[3].type == static_cast<uint16_t>(LAZCodec::ItemType::BYTE));
+        REQUIRE(parameters->items[3].size == 6);
+        REQUIRE(parameters->recordLength() == 40);
+    }
+
+    SECTION("The VLR payload round-trips") {
+        auto parameters = *LAZCodec::Parameters::forPointFormat(2, 26);
+        parameters.chunkSize = 1234;
+        const auto payload = parameters.serialize();
+        REQUIRE(payload.size() == 34 + 6 * 2);
+
+        const auto parsed = LAZCodec::Parameters::parse(payload);
+        REQUIRE(parsed);
+        REQUIRE(parsed->chunkSize == 1234);
+        REQUIRE(parsed->numberOfSpecialEVLRs == -1);
+        REQUIRE(parsed->items.size() == 2);
+        REQUIRE(parsed->items[1].type == static_cast<uint16_t>(LAZCodec::ItemType::RGB12));
+        REQUIRE(parsed->isSupported());
+        REQUIRE_FALSE(LAZCodec::Parameters::parse(span(payload).first(40)));
+    }
+
+    SECTION("LAS 1.4 formats use the layered items, version 3") {
+        const auto parameters = LAZCodec::Parameters::forPointFormat(8, 41);
+        REQUIRE(parameters);
+        REQUIRE(parameters->compressor == LAZCodec::LAYERED_CHUNKED);
+        REQUIRE(parameters->items.size() == 3);
+        REQUIRE(parameters->items[0].type == static_cast<uint16_t>(LAZCodec::ItemType::POINT14));
+        REQUIRE(parameters->items[1].type == static_cast<uint16_t>(LAZCodec::ItemType::RGBNIR14));
+        REQUIRE(parameters->items[2].type == static_cast<uint16_t>(LAZCodec::ItemType::BYTE14));
+        REQUIRE(parameters->items[2].size == 3);
+        REQUIRE(parameters->items[2].version == 3);
+        REQUIRE(parameters->isSupported());
+    }
+
+    SECTION("Wave packet formats and mixed item versions are not supported") {
+        REQUIRE_FALSE(LAZCodec::Parameters::forPointFormat(4, 57));
+        REQUIRE_FALSE(LAZCodec::Parameters::forPointFormat(9, 59));
+        REQUIRE_FALSE(LAZCodec::Parameters::forPointFormat(6, 29));
+        REQUIRE_FALSE(LAZCodec::Parameters::forPointFormat(0, 19));
+
+        auto layered = *LAZCodec::Parameters::forPointFormat(0, 20);
+        layered.compressor = LAZCodec::LAYERED_CHUNKED;
+        REQUIRE_FALSE(layered.isSupported());
+
+        auto pointwise = *LAZCodec::Parameters::forPointFormat(6, 30);
+        pointwise.compressor = LAZCodec::POINTWISE_CHUNKED;
+        REQUIRE_FALSE(pointwise.isSupported());
+    }
+}
+
+TEST_CASE("LAZ chunk tables locate every chunk", "[LAZCodec]") {
+    const vector<uint64_t> bytes{1000, 2000, 1500, 70000, 3};
+    LAZCodec::Parameters parameters;
+    parameters.chunkSize = 10;
+
+    SECTION("Fixed-size chunks") {
+        vector<uint8_t> table;
+        LAZCodec::writeChunkTable(bytes, {}, table);
+        const auto chunks = LAZCodec::readChunkTable(table, parameters, 45, 100);
+        REQUIRE(chunks);
+        REQUIRE(chunks->size() == 5);
+        REQUIRE((*chunks)[3].bytes == 70000);
+        REQUIRE((*chunks)[3].firstPoint == 30);
+        REQUIRE((*chunks)[4].points == 5);
+        REQUIRE((*chunks)[4].offset == 100 + 1000 + 2000 + 1500 + 70000);
+
+        // The chunk count must match the point count
+        REQUIRE_FALSE(LAZCodec::readChunkTable(table, parameters, 51, 100));
+    }
+
+    SECTION("Variable-size chunks store their point counts") {
+        const vector<uint64_t> points{7, 7, 100, 1, 9};
+        vector<uint8_t> table;
+        LAZCodec::writeChunkTable(bytes, points, table);
+        parameters.chunkSize = LAZCodec::VARIABLE_CHUNK_SIZE;
+        const auto chunks = LAZCodec::readChunkTable(table, parameters, 124, 0);
+        REQUIRE(chunks);
+        REQUIRE((*chunks)[2].points == 100);
+        REQUIRE((*chunks)[4].firstPoint == 115);
+    }
+
+    SECTION("An empty file has an empty table") {
+        vector<uint8_t> table;
+        LAZCodec::writeChunkTable({}, {}, table);
+        REQUIRE(table.size() == 8);
+        const auto chunks = LAZCodec::readChunkTable(table, parameters, 0, 100);
+        REQUIRE(chunks);
+        REQUIRE(chunks->empty());
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * @brief Unit tests for the buffered LineReader using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "io/LineReader.hpp"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+vector<string> readLines(const string& text, size_t blockSize) {
+    istringstream stream(text);
+    io::LineReader lines(blockSize);
+    vector<string> result;
+    string_view line;
+    while (lines.next(stream, line)) {
+        result.emplace_back(line);
+    }
+    REQUIRE(lines.eof());
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("LineReader splits like std::getline", "[LineReader]") {
+    const string text = "first\nsecond line\r\n\nlonger than one block of eight bytes\nlast";
+
+    for (size_t blockSize : {size_t{1}, size_t{8}, io::LineReader::BLOCK_SIZE}) {
+        GIVEN("blocks of " + to_string(blockSize) + " bytes") {
+            const auto lines = readLines(text, blockSize);
+
+            THEN("the lines match getline, including the unterminated last one") {
+                istringstream stream(text);
+                vector<string> expected;
+                for (string line; getline(stream, line);) {
+                    expected.push_back(line);
+                }
+                REQUIRE(lines == expected);
+                REQUIRE(lines[1] == "second line\r");
+            }
+        }
+    }
+
+    GIVEN("an empty stream and a stream ending in a newline") {
+        THEN("no line and exactly one line are returned") {
+            REQUIRE(readLines("", 4).empty());
+            REQUIRE(readLines("only\n", 4) == vector<string>{"only"});
+        }
+    }
+}
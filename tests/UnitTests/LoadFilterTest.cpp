@@ -0,0 +1,350 @@
+/**
+ * @brief Unit tests for filters pushed into the LAS and PCD decode loops
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "io/LoadFilter.hpp"
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+// A 200 x 150 grid of points at heights 0-9, colored by their index
+PointCloudXYZRGB makeGrid(size_t count) {
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < count; ++i) {
+        const Point3D position(static_cast<float>(i % 200), static_cast<float>((i / 200) % 150), static_cast<float>(i % 10));
+        cloud.push_back(PointXYZRGB(position, RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i >> 16))));
+    }
+    return cloud;
+}
+
+bool samePoint(const PointXYZRGB& a, const PointXYZRGB& b) {
+    return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z && a.color.r == b.color.r && a.color.g == b.color.g &&
+           a.color.b == b.color.b;
+}
+
+bool samePoints(span<const PointXYZRGB> a, span<const PointXYZRGB> b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!samePoint(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// What a filter without a sample should keep, computed on the fully loaded cloud
+vector<PointXYZRGB> expected(const PointCloudXYZRGB& cloud, const io::LoadFilter& filter) {
+    vector<PointXYZRGB> kept;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        if (filter.keepsRecord(i) && filter.contains(cloud[i].position) && (!filter.predicate || filter.predicate(PointLAS(cloud[i].position)))) {
+            kept.push_back(cloud[i]);
+        }
+    }
+    return kept;
+}
+
+// True if every point of sample occurs in cloud, in the same order
+bool isOrderedSubset(span<const PointXYZRGB> sample, const PointCloudXYZRGB& cloud) {
+    size_t at = 0;
+    for (const auto& p : sample) {
+        while (at < cloud.size() && !samePoint(cloud[at], p)) {
+            ++at;
+        }
+        if (at++ == cloud.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("PointSelection merges parts in file order", "[LoadFilter]") {
+    io::LoadFilter filter;
+    filter.stride = 3;
+    io::PointSelection<Point3D> selection(filter);
+    auto decode = [](uint64_t index) {
+        return [index](auto& point) {
+            getPosition(point) = Point3D(static_cast<float>(index), 0, 0);
+            return index % 5 != 0;  // Every fifth record cannot be decoded
+        };
+    };
+
+    // Parts committed back to front
+    for (uint64_t first : {uint64_t{200}, uint64_t{100}, uint64_t{0}}) {
+        auto part = selection.part(first, 100);
+        for (uint64_t i = first; i < first + 100; ++i) {
+            selection.offer(part, i, decode(i));
+        }
+        selection.commit(std::move(part));
+    }
+    const auto points = selection.finish();
+
+    vector<float> indices;
+    for (const auto& p : points) {
+        indices.push_back(p.x);
+    }
+    vector<float> wanted;
+    for (uint64_t i = 0; i < 300; i += 3) {
+        if (i % 5 != 0) {
+            wanted.push_back(static_cast<float>(i));
+        }
+    }
+    CHECK(indices == wanted);
+    CHECK(selection.finish().empty());
+}
+
+TEST_CASE("PointSelection samples do not depend on the partition", "[LoadFilter]") {
+    io::LoadFilter filter;
+    filter.sampleSize = 500;
+    filter.seed = 42;
+
+    auto sample = [&](uint64_t records, uint64_t partSize) {
+        io::PointSelection<Point3D> selection(filter);
+        for (uint64_t first = 0; first < records; first += partSize) {
+            auto part = selection.part(first, static_cast<size_t>(partSize));
+            for (uint64_t i = first; i < std::min(records, first + partSize); ++i) {
+                selection.offer(part, i, [i](auto& point) {
+                    getPosition(point) = Point3D(static_cast<float>(i), 0, 0);
+                    return true;
+                });
+            }
+            selection.commit(std::move(part));
+        }
+        vector<float> indices;
+        for (const auto& p : selection.finish()) {
+            indices.push_back(p.x);
+        }
+        return indices;
+    };
+
+    const auto whole = sample(100000, 100000);
+    REQUIRE(whole.size() == 500);
+    CHECK(std::is_sorted(whole.begin(), whole.end()));
+    CHECK(std::adjacent_find(whole.begin(), whole.end()) == whole.end());
+    CHECK(sample(100000, 777) == whole);
+    CHECK(sample(100000, 10) == whole);
+
+    // Roughly uniform: the mean index sits near the middle of the file
+    double sum = 0;
+    for (float index : whole) {
+        sum += static_cast<double>(index);
+    }
+    CHECK(sum / 500.0 == Catch::Approx(50000.0).margin(5000.0));
+
+    // Fewer records than the sample size keeps all of them; another seed picks other points
+    CHECK(sample(300, 64).size() == 300);
+    filter.seed = 43;
+    CHECK(sample(100000, 100000) != whole);
+}
+
+TEST_CASE("Filtered LAS loads match filtering the full cloud", "[LoadFilter][LASProcessor]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_load_filter_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto grid = makeGrid(120000);
+
+    for (const bool compressed : {false, true}) {
+        INFO((compressed ? "LAZ" : "LAS"));
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = compressed;
+        const auto file = tempDir / (compressed ? "grid.laz" : "grid.las");
+        LASProcessor processor;
+        REQUIRE(processor.saveLAS(file, header, grid));
+        const auto [fullHeader, full] = processor.loadLAS(file);
+        REQUIRE(full.size() == grid.size());
+
+        io::LoadFilter stride;
+        stride.stride = 7;
+        io::LoadFilter box;
+        box.box = io::LoadFilter::Box{.minX = 20, .minY = 30, .minZ = 2, .maxX = 60.5, .maxY = 90, .maxZ = 6};
+        io::LoadFilter combined = box;
+        combined.stride = 3;
+        combined.predicate = [](const PointLAS& p) { return p.position.x < 40; };
+
+        for (const auto* filter : {&stride, &box, &combined}) {
+            const auto wanted = expected(full, *filter);
+            for (const unsigned threads : {1u, 4u}) {
+                INFO("threads " << threads);
+                const auto [loadedHeader, loaded] = processor.loadLAS(file, *filter, threads);
+                CHECK(loadedHeader.isValid());
+                CHECK(samePoints(loaded.points, wanted));
+                CHECK(loaded.width == loaded.size());
+                CHECK(loaded.height == 1);
+            }
+        }
+
+        SECTION("Samples are exact in size and the same on any number of threads") {
+            io::LoadFilter sample;
+            sample.sampleSize = 2000;
+            sample.seed = 7;
+            const auto [oneHeader, one] = processor.loadLAS(file, sample);
+            const auto [manyHeader, many] = processor.loadLAS(file, sample, 4);
+            REQUIRE(one.size() == 2000);
+            CHECK(samePoints(one.points, many.points));
+            CHECK(isOrderedSubset(one.points, full));
+
+            sample.box = box.box;
+            const auto [boxHeader, boxed] = processor.loadLAS(file, sample, 3);
+            CHECK(boxed.size() == std::min<size_t>(2000, expected(full, box).size()));
+            for (const auto& p : boxed) {
+                REQUIRE(box.contains(p.position));
+            }
+        }
+
+        SECTION("Predicates see the LAS attributes") {
+            // saveLAS writes every point as return 1 of 1 of class 1 (unclassified)
+            io::LoadFilter ground;
+            ground.predicate = io::classificationIn({2});
+            CHECK(std::get<1>(processor.loadLAS(file, ground)).empty());
+            io::LoadFilter unclassified;
+            unclassified.predicate = io::classificationIn({1, 2});
+            CHECK(std::get<1>(processor.loadLAS(file, unclassified, 2)).size() == grid.size());
+            io::LoadFilter last;
+            last.predicate = io::lastReturns();
+            last.stride = 10;
+            const auto [lastHeader, lastReturns] = processor.loadLAS<PointLAS>(file, last);
+            REQUIRE(lastReturns.size() == grid.size() / 10);
+            CHECK(lastReturns[3].classification == 1);
+            CHECK(lastReturns[3].returnNumber == 1);
+            CHECK(lastReturns[3].position.x == full[30].position.x);
+            CHECK(lastReturns[3].color.r == full[30].color.r);
+        }
+    }
+
+    SECTION("Invalid filters are rejected") {
+        LASProcessor processor;
+        io::LoadFilter zero;
+        zero.stride = 0;
+        const auto [header, cloud] = processor.loadLAS(tempDir / "grid.las", zero);
+        CHECK_FALSE(header.isValid());
+        CHECK(cloud.empty());
+        io::LoadFilter inverted;
+        inverted.box = io::LoadFilter::Box{.minX = 10, .maxX = 0};
+        CHECK_FALSE(std::get<0>(processor.loadLAS(tempDir / "grid.las", inverted)).isValid());
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("Filtered PCD loads match filtering the full cloud", "[LoadFilter][PCDLoader]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_load_filter_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    PCDProcessor processor;
+    const auto grid = makeGrid(120000);
+
+    io::LoadFilter stride;
+    stride.stride = 5;
+    io::LoadFilter box;
+    box.box = io::LoadFilter::Box{.minX = 10, .minY = 10, .maxX = 50, .maxY = 40};
+    io::LoadFilter combined = box;
+    combined.stride = 2;
+    combined.predicate = [](const PointLAS& p) { return p.position.z >= 5; };
+
+    for (const string dataType : {"ascii", "binary", "binary_compressed", "binary_compressed_chunked"}) {
+        INFO(dataType);
+        const auto file = (tempDir / ("grid_" + dataType + ".pcd")).string();
+        const auto header = PCDProcessor::createXYZRGBHeader(grid, dataType);
+        if (dataType == "binary_compressed_chunked") {
+            REQUIRE(processor.savePCD_BinaryCompressedChunked(file, header, grid, 2));
+        } else {
+            REQUIRE(processor.savePCD(file, header, grid));
+        }
+        const auto [fullHeader, full] = processor.loadPCD(file);
+        REQUIRE(full.size() == grid.size());
+
+        for (const auto* filter : {&stride, &box, &combined}) {
+            const auto wanted = expected(full, *filter);
+            for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+                for (const unsigned threads : {1u, 4u}) {
+                    const auto [loadedHeader, loaded] = processor.loadPCD(file, *filter, mode, threads);
+                    CHECK(samePoints(loaded.points, wanted));
+                    CHECK(loaded.width == loaded.size());
+                    CHECK(loaded.height == 1);
+                    CHECK(loaded.is_dense);
+                }
+            }
+        }
+
+        io::LoadFilter sample;
+        sample.sampleSize = 1000;
+        const auto [oneHeader, one] = processor.loadPCD(file, sample);
+        const auto [manyHeader, many] = processor.loadPCD(file, sample, PCDProcessor::LoadMode::MemoryMapped, 4);
+        REQUIRE(one.size() == 1000);
+        CHECK(samePoints(one.points, many.points));
+        CHECK(isOrderedSubset(one.points, full));
+
+        const auto [xyzHeader, xyz] = processor.loadPCD<Point3D>(file, stride);
+        REQUIRE(xyz.size() == grid.size() / 5);
+        CHECK(xyz[7].x == full[35].position.x);
+    }
+
+    SECTION("Binary files are read and filtered in blocks") {
+        // 300000 records of 16 bytes span three 2 MB read blocks; both non-finite points are in the box and on the stride
+        auto large = makeGrid(300000);
+        large.points[131075].position.x = numeric_limits<float>::quiet_NaN();
+        large.points[131082].position.z = numeric_limits<float>::infinity();
+        const auto file = (tempDir / "large.pcd").string();
+        REQUIRE(processor.savePCD(file, PCDProcessor::createXYZRGBHeader(large, "binary"), large));
+
+        const auto [mappedHeader, mapped] = processor.loadPCD(file, PCDProcessor::LoadMode::MemoryMapped);
+        const auto [streamHeader, streamed] = processor.loadPCD(file);
+        REQUIRE(streamed.size() == large.size() - 2);
+        CHECK_FALSE(streamed.is_dense);
+        CHECK(samePoints(streamed.points, mapped.points));
+
+        io::LoadFilter filter;
+        filter.stride = 7;
+        filter.box = io::LoadFilter::Box{.minX = 20, .minY = 10, .maxX = 120, .maxY = 90};
+        const auto [filteredHeader, filtered] = processor.loadPCD(file, filter);
+        auto wanted = expected(large, filter);
+        erase_if(wanted, [](const PointXYZRGB& p) { return !isfinite(p.position.z); });
+        CHECK(wanted.size() > 1000);
+        CHECK(samePoints(filtered.points, wanted));
+
+        filesystem::resize_file(file, filesystem::file_size(file) - 16);
+        const auto [truncatedHeader, truncated] = processor.loadPCD(file, filter);
+        CHECK(truncated.empty());
+    }
+
+    SECTION("Strides count ascii lines, dropped and past POINTS ones included") {
+        const auto file = (tempDir / "lines.pcd").string();
+        {
+            ofstream out(file, ios::binary);
+            out << "VERSION 0.7\nFIELDS x y z label\nSIZE 4 4 4 4\nTYPE F F F U\nCOUNT 1 1 1 1\nWIDTH 6\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS 6\nDATA ascii\n"
+                << "0 0 0 2\nnan 1 1 2\n2 0 0 6\n3 0 0 2\nbad\n5 0 0 2\n6 0 0 2\n";
+        }
+        io::LoadFilter filter;
+        filter.stride = 2;
+        for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            const auto [header, cloud] = processor.loadPCD<Point3D>(file, filter, mode);
+            REQUIRE(cloud.size() == 2);  // Lines 0, 2 and 4; line 4 is malformed, line 6 is past POINTS
+            CHECK(cloud[0].x == 0.0f);
+            CHECK(cloud[1].x == 2.0f);
+        }
+
+        io::LoadFilter ground;
+        ground.predicate = io::classificationIn({2});
+        const auto [header, cloud] = processor.loadPCD<Point3D>(file, ground, PCDProcessor::LoadMode::MemoryMapped);
+        REQUIRE(cloud.size() == 3);  // The NaN point and class 6 are dropped
+        CHECK(cloud[2].x == 5.0f);
+    }
+
+    filesystem::remove_all(tempDir);
+}
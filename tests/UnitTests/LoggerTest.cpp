@@ -0,0 +1,161 @@
+/**
+ * @brief Unit tests for the leveled, rate-limited and asynchronous logger using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "tooling/Logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace scanforge::tooling;
+
+namespace {
+
+/** @brief Sends the log to a temporary file for the lifetime of the capture */
+class LogCapture {
+   public:
+    LogCapture() : file_(tmpfile()) {
+        REQUIRE(file_ != nullptr);
+        Logger::setOutput(file_);
+    }
+
+    ~LogCapture() {
+        Logger::stopAsync();
+        Logger::setOutput(stdout);
+        Logger::setLevel(LogLevel::INFO);
+        fclose(file_);
+    }
+
+    vector<string> lines() {
+        Logger::flush();
+        rewind(file_);
+        string text;
+        char buffer[4096];
+        while (const size_t n = fread(buffer, 1, sizeof(buffer), file_)) {
+            text.append(buffer, n);
+        }
+        vector<string> result;
+        istringstream stream(text);
+        for (string line; getline(stream, line);) {
+            result.push_back(line);
+        }
+        return result;
+    }
+
+   private:
+    FILE* file_;
+};
+
+bool endsWith(const string& line, const string& suffix) {
+    return line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+TEST_CASE("Logger filters by level and formats its messages", "[Logger]") {
+    LogCapture capture;
+
+    Logger::setLevel(LogLevel::WARNING);
+    REQUIRE(Logger::enabled(LogLevel::ERROR));
+    REQUIRE(!Logger::enabled(LogLevel::INFO));
+    Log::info("Hidden {}", 1);
+    Log::warning("Shown {} of {}", 2, "three");
+    Log::error("Braces {{}} stay");
+
+    Logger::setLevel(LogLevel::DEBUG);
+    REQUIRE(Logger::enabled(LogLevel::DEBUG) == (Logger::MIN_LEVEL == LogLevel::DEBUG));
+    Log::debug("Debug {}", 4);
+
+    const auto lines = capture.lines();
+    REQUIRE(lines.size() == (Logger::MIN_LEVEL == LogLevel::DEBUG ? 3u : 2u));
+    REQUIRE(lines[0].find("[WARN] Shown 2 of three") != string::npos);
+    REQUIRE(endsWith(lines[1], "[ERROR] Braces {} stay"));
+    if constexpr (Logger::MIN_LEVEL == LogLevel::DEBUG) {
+        REQUIRE(endsWith(lines[2], "[DEBUG] Debug 4"));
+    }
+}
+
+TEST_CASE("RateLimit lets a burst through per period and counts the rest", "[Logger]") {
+    SECTION("Counting") {
+        RateLimit limit(3, chrono::hours(1));
+        uint64_t suppressed = 0;
+        int allowed = 0;
+        for (int i = 0; i < 10; ++i) {
+            allowed += limit.allow(suppressed) ? 1 : 0;
+        }
+        REQUIRE(allowed == 3);
+        REQUIRE(limit.suppressed() == 7);
+    }
+
+    SECTION("Logged messages note what was held back") {
+        LogCapture capture;
+        RateLimit limit(2, chrono::milliseconds(20));
+        for (int i = 0; i < 5; ++i) {
+            Log::warning(limit, "Record {} skipped", i);
+        }
+        this_thread::sleep_for(chrono::milliseconds(40));
+        Log::warning(limit, "Record {} skipped", 5);
+        REQUIRE(limit.suppressed() == 0);
+
+        const auto lines = capture.lines();
+        REQUIRE(lines.size() == 3);
+        REQUIRE(endsWith(lines[0], "Record 0 skipped"));
+        REQUIRE(endsWith(lines[1], "Record 1 skipped"));
+        REQUIRE(endsWith(lines[2], "Record 5 skipped (3 similar messages suppressed)"));
+    }
+}
+
+TEST_CASE("Asynchronous logging writes every message of every thread", "[Logger]") {
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 500;
+    LogCapture capture;
+
+    const auto run = [] {
+        vector<jthread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([t] {
+                for (int i = 0; i < MESSAGES; ++i) {
+                    Log::info("thread {} message {}", t, i);
+                }
+            });
+        }
+    };
+
+    SECTION("A ring large enough keeps each thread's order") {
+        const auto overflows = Logger::overflowCount();
+        Logger::startAsync(THREADS * MESSAGES);
+        run();
+        Log::info("last");
+        auto lines = capture.lines();  // flush() waits for the writer
+        REQUIRE(Logger::overflowCount() == overflows);
+        REQUIRE(lines.size() == THREADS * MESSAGES + 1);
+        REQUIRE(endsWith(lines.back(), "[INFO] last"));
+
+        vector<int> next(THREADS, 0);
+        for (size_t i = 0; i + 1 < lines.size(); ++i) {
+            int t = -1;
+            int message = -1;
+            const auto at = lines[i].find("thread ");
+            REQUIRE(at != string::npos);
+            REQUIRE(sscanf(lines[i].c_str() + at, "thread %d message %d", &t, &message) == 2);
+            REQUIRE(message == next[static_cast<size_t>(t)]++);
+        }
+
+        Logger::stopAsync();
+        Log::info("synchronous again");
+        lines = capture.lines();
+        REQUIRE(endsWith(lines.back(), "synchronous again"));
+    }
+
+    SECTION("A full ring writes synchronously instead of dropping") {
+        Logger::startAsync(8);
+        run();
+        Logger::stopAsync();
+        REQUIRE(capture.lines().size() == THREADS * MESSAGES);
+    }
+}
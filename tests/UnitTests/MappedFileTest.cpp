@@ -0,0 +1,197 @@
+/**
+ * @brief Unit tests for memory-mapped file access and mapped PCD loading using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "io/MappedFile.hpp"
+#include "PCDProcessor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+PointCloudXYZRGB makeMappedTestCloud() {
+    PointCloudXYZRGB cloud;
+    for (int i = 0; i < 100; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(f * 0.5f, -f, f * 2.0f, static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i), 7));
+    }
+    cloud.width = static_cast<uint32_t>(cloud.size());
+    cloud.height = 1;
+    return cloud;
+}
+
+}  // namespace
+
+TEST_CASE("MappedFile basic mapping", "[MappedFile][file_io]") {
+    GIVEN("a small file on disk") {
+        const string filename = "test_mapped_file.bin";
+        vector<uint8_t> content = {0x10, 0x20, 0x30, 0x40, 0x50};
+        {
+            ofstream out(filename, ios::binary);
+            out.write(reinterpret_cast<const char*>(content.data()), static_cast<streamsize>(content.size()));
+        }
+
+        WHEN("mapping it") {
+            io::MappedFile file(filename);
+
+            THEN("the mapped bytes match the file contents") {
+                REQUIRE(file.is_open());
+                REQUIRE(file.size() == content.size());
+                REQUIRE(vector<uint8_t>(file.data().begin(), file.data().end()) == content);
+            }
+
+            AND_WHEN("moving the mapping into another object") {
+                io::MappedFile moved = std::move(file);
+
+                THEN("the new owner exposes the data and the source is closed") {
+                    REQUIRE(moved.is_open());
+                    REQUIRE(moved.data()[4] == 0x50);
+                    REQUIRE_FALSE(file.is_open());
+                    REQUIRE(file.data().empty());
+                }
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("an empty file") {
+        const string filename = "test_mapped_empty.bin";
+        { ofstream out(filename, ios::binary); }
+
+        WHEN("mapping it") {
+            io::MappedFile file(filename);
+
+            THEN("it opens with an empty span") {
+                REQUIRE(file.is_open());
+                REQUIRE(file.data().empty());
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("a path that does not exist") {
+        WHEN("mapping it") {
+            io::MappedFile file("does_not_exist.bin");
+
+            THEN("the mapping is not open") {
+                REQUIRE_FALSE(file.is_open());
+            }
+        }
+    }
+}
+
+TEST_CASE("PCD memory-mapped loading", "[MappedFile][PCDProcessor]") {
+    GIVEN("a point cloud saved in every PCD variant") {
+        auto cloud = makeMappedTestCloud();
+        PCDProcessor processor;
+
+        for (const string format : {"ascii", "binary", "binary_compressed"}) {
+            const string filename = "test_mapped_" + format + ".pcd";
+            REQUIRE(processor.savePCD(filename, PCDProcessor::createXYZRGBHeader(cloud, format), cloud));
+
+            WHEN("loading " + format + " through the stream and the mapping") {
+                auto [streamHeader, streamCloud] = processor.loadPCD(filename);
+                auto [mappedHeader, mappedCloud] = processor.loadPCD(filename, PCDProcessor::LoadMode::MemoryMapped);
+
+                THEN("both paths produce the same points") {
+                    REQUIRE(mappedHeader.isValid());
+                    REQUIRE(mappedHeader.dataType == format);
+                    REQUIRE(mappedCloud.size() == streamCloud.size());
+                    REQUIRE(mappedCloud.size() == cloud.size());
+                    for (size_t i = 0; i < cloud.size(); ++i) {
+                        REQUIRE(mappedCloud[i].position.x == Catch::Approx(streamCloud[i].position.x));
+                        REQUIRE(mappedCloud[i].position.z == Catch::Approx(streamCloud[i].position.z));
+                        REQUIRE(mappedCloud[i].color.toPacked() == streamCloud[i].color.toPacked());
+                    }
+                }
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+}
+
+TEST_CASE("PCD mapped record view", "[MappedFile][PCDProcessor][view]") {
+    GIVEN("a binary and a binary_compressed PCD file") {
+        auto cloud = makeMappedTestCloud();
+        PCDProcessor processor;
+
+        for (const string format : {"binary", "binary_compressed"}) {
+            const string filename = "test_view_" + format + ".pcd";
+            REQUIRE(processor.savePCD(filename, PCDProcessor::createXYZRGBHeader(cloud, format), cloud));
+
+            WHEN("mapping the " + format + " file as a view") {
+                auto view = processor.mapPCD(filename);
+
+                THEN("records are exposed without building a cloud") {
+                    REQUIRE(view.has_value());
+                    REQUIRE(view->size() == cloud.size());
+                    REQUIRE(view->stride() == 16);
+                    REQUIRE(view->records().size() == cloud.size() * 16);
+                    REQUIRE(view->record(3).size() == 16);
+
+                    const size_t yIdx = view->header().getFieldIndex("y");
+                    const size_t rgbIdx = view->header().getFieldIndex("rgb");
+                    REQUIRE(view->field<float>(10, yIdx) == -10.0f);
+                    REQUIRE(view->field<uint32_t>(10, rgbIdx) == cloud[10].color.toPacked());
+                }
+
+                THEN("the bounding box matches the cloud's") {
+                    REQUIRE(view.has_value());
+                    auto [minPt, maxPt] = view->getBoundingBox();
+                    auto [expectedMin, expectedMax] = cloud.getBoundingBox();
+                    REQUIRE(minPt.x == expectedMin.x);
+                    REQUIRE(minPt.y == expectedMin.y);
+                    REQUIRE(maxPt.y == expectedMax.y);
+                    REQUIRE(maxPt.z == expectedMax.z);
+                }
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+
+    GIVEN("an ASCII PCD file") {
+        auto cloud = makeMappedTestCloud();
+        PCDProcessor processor;
+        const string filename = "test_view_ascii.pcd";
+        REQUIRE(processor.savePCD_ASCII(filename, PCDProcessor::createXYZRGBHeader(cloud, "ascii"), cloud));
+
+        WHEN("mapping it as a view") {
+            auto view = processor.mapPCD(filename);
+
+            THEN("mapping is refused since records are not binary") {
+                REQUIRE_FALSE(view.has_value());
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("a binary PCD file whose header has no width") {
+        PCDProcessor processor;
+        const string filename = "test_view_no_width.pcd";
+        {
+            ofstream file(filename, ios::binary);
+            file << "VERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\nWIDTH 0\nHEIGHT 1\nPOINTS 4\nDATA binary\n";
+            const vector<float> records(12, 1.0f);
+            file.write(reinterpret_cast<const char*>(records.data()), static_cast<streamsize>(records.size() * sizeof(float)));
+        }
+
+        THEN("mapping refuses it like loading does") {
+            REQUIRE_FALSE(processor.mapPCD(filename).has_value());
+            REQUIRE(get<1>(processor.loadPCD(filename)).empty());
+        }
+
+        filesystem::remove(filename);
+    }
+}
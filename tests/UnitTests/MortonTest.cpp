@@ -0,0 +1,117 @@
+/**
+ * @brief Unit tests for the Morton codes, the radix key sort and Morton reordering
+ */
+
+#include <catch2/catch_all.hpp>
+#include "codec/LZFCodec.hpp"
+#include "spatial/Morton.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::spatial;
+
+TEST_CASE("Morton codes interleave and restore coordinates", "[Morton]") {
+    STATIC_REQUIRE(morton::encode(1, 0, 0) == 1);
+    STATIC_REQUIRE(morton::encode(0, 1, 0) == 2);
+    STATIC_REQUIRE(morton::encode(0, 0, 1) == 4);
+    STATIC_REQUIRE(morton::encode(3, 0, 0) == 9);
+
+    mt19937 rng(7);
+    uniform_int_distribution<uint32_t> cell(0, morton::CELLS - 1);
+    for (int i = 0; i < 1000; ++i) {
+        const uint32_t x = cell(rng), y = cell(rng), z = cell(rng);
+        const auto decoded = morton::decode(morton::encode(x, y, z));
+        REQUIRE(decoded[0] == x);
+        REQUIRE(decoded[1] == y);
+        REQUIRE(decoded[2] == z);
+    }
+
+    const uint64_t top = morton::encode(morton::CELLS - 1, 0, morton::CELLS - 1);
+    REQUIRE(morton::octant(top, 1) == 5);
+    REQUIRE(morton::octant(top, morton::BITS) == 5);
+}
+
+TEST_CASE("sortByKey is a stable sort on any thread count", "[Morton]") {
+    mt19937_64 rng(3);
+    for (uint64_t range : {uint64_t{1000}, uint64_t{1} << 40, numeric_limits<uint64_t>::max()}) {
+        uniform_int_distribution<uint64_t> key(0, range);
+        for (size_t size : {size_t{0}, size_t{100}, size_t{300000}}) {
+            vector<KeyedIndex> entries(size);
+            for (size_t i = 0; i < size; ++i) {
+                // Indices out of order, so that stability is visible
+                entries[i] = {key(rng), static_cast<uint32_t>((i * 7919) % (size + 1))};
+            }
+            auto expected = entries;
+            stable_sort(expected.begin(), expected.end(), [](const KeyedIndex& a, const KeyedIndex& b) { return a.key < b.key; });
+
+            for (unsigned threads : {1u, 3u, 0u}) {
+                auto copy = entries;
+                sortByKey(copy, threads);
+                REQUIRE(equal(copy.begin(), copy.end(), expected.begin(), expected.end(),
+                              [](const KeyedIndex& a, const KeyedIndex& b) { return a.key == b.key && a.index == b.index; }));
+            }
+        }
+    }
+}
+
+TEST_CASE("sortMorton orders a cloud along the Z curve", "[Morton]") {
+    mt19937 rng(5);
+    uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    PointCloud<PointXYZRGB> cloud;
+    for (int i = 0; i < 200000; ++i) {
+        cloud.push_back(PointXYZRGB(coord(rng), coord(rng), coord(rng), static_cast<uint8_t>(i), 0, 0));
+    }
+    cloud[17].position.y = numeric_limits<float>::quiet_NaN();
+    cloud.width = 1000;
+    cloud.height = 200;
+
+    const auto order = mortonOrder(cloud, 4);
+    REQUIRE(order.size() == cloud.size());
+    REQUIRE(order.back() == 17);
+    auto seen = order;
+    sort(seen.begin(), seen.end());
+    for (size_t i = 0; i < seen.size(); ++i) {
+        REQUIRE(seen[i] == i);
+    }
+    REQUIRE(mortonOrder(cloud, 1) == order);
+
+    auto sorted = cloud;
+    REQUIRE(sortMorton(sorted, 0));
+    REQUIRE(sorted.width == cloud.size());
+    REQUIRE(sorted.height == 1);
+    for (size_t i = 0; i < order.size(); i += 1000) {
+        REQUIRE(sorted[i].color.r == cloud[order[i]].color.r);
+        REQUIRE(memcmp(&sorted[i].position, &cloud[order[i]].position, sizeof(Point3D)) == 0);
+    }
+
+    const auto [bounds, finite] = finiteBounds(cloud, 1);
+    REQUIRE(finite == cloud.size() - 1);
+    const auto grid = morton::Quantizer::cubeAround(bounds.first, bounds.second);
+    for (size_t i = 1; i < finite; ++i) {
+        REQUIRE(grid.encode(sorted[i - 1].position) <= grid.encode(sorted[i].position));
+    }
+}
+
+TEST_CASE("Morton order makes positions compress better", "[Morton]") {
+    // A smooth surface sampled in random order, as a scanner might report it
+    mt19937 rng(9);
+    uniform_real_distribution<float> coord(0.0f, 1.0f);
+    PointCloud<Point3D> cloud;
+    for (int i = 0; i < 100000; ++i) {
+        const float x = coord(rng), y = coord(rng);
+        cloud.push_back({x, y, 0.1f * x * y});
+    }
+    auto compressedSize = [](const PointCloud<Point3D>& c) {
+        vector<uint8_t> bytes(c.size() * sizeof(Point3D));
+        memcpy(bytes.data(), c.points.data(), bytes.size());
+        return codec::LZFCodec::compress(bytes).size();
+    };
+    const size_t unsorted = compressedSize(cloud);
+    REQUIRE(sortMorton(cloud));
+    REQUIRE(compressedSize(cloud) < unsorted);
+}
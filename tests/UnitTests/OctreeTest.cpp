@@ -0,0 +1,141 @@
+/**
+ * @brief Unit tests for the linear octree
+ */
+
+#include <catch2/catch_all.hpp>
+#include "spatial/Octree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::spatial;
+
+namespace {
+
+PointCloud<PointXYZRGB> randomCloud(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    PointCloud<PointXYZRGB> cloud(count);
+    for (size_t i = 0; i < count; ++i) {
+        cloud.push_back(PointXYZRGB(coord(rng), coord(rng), coord(rng) * 0.1f, 0, 0, 0));
+    }
+    // Duplicates pile up in one leaf at the deepest level
+    for (size_t i = 0; i < 200; ++i) {
+        cloud.push_back(PointXYZRGB(1.0f, 2.0f, 3.0f, 0, 0, 0));
+    }
+    return cloud;
+}
+
+vector<uint32_t> sorted(vector<uint32_t> indices) {
+    sort(indices.begin(), indices.end());
+    return indices;
+}
+
+vector<uint32_t> bruteForceBox(const PointCloud<PointXYZRGB>& cloud, const Point3D& min, const Point3D& max) {
+    vector<uint32_t> out;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        if (isFinite(cloud[i].position) && insideBox(cloud[i].position, min, max)) {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return out;
+}
+
+vector<uint32_t> bruteForceRadius(const PointCloud<PointXYZRGB>& cloud, const Point3D& center, float radius) {
+    vector<uint32_t> out;
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        if (isFinite(cloud[i].position) && squaredDistance(cloud[i].position, center) <= radius * radius) {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST_CASE("Octree layout", "[Octree]") {
+    const auto cloud = randomCloud(20000, 1);
+    Octree<PointXYZRGB> octree(cloud, 32, 4);
+
+    REQUIRE(octree.size() == cloud.size());
+    REQUIRE_FALSE(octree.nodes().empty());
+    REQUIRE(octree.depth() > 0);
+
+    const auto& root = octree.nodes()[0];
+    REQUIRE(root.first == 0);
+    REQUIRE(root.count == cloud.size());
+
+    auto indices = vector<uint32_t>(octree.indices().begin(), octree.indices().end());
+    sort(indices.begin(), indices.end());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        REQUIRE(indices[i] == i);
+    }
+
+    for (const auto& node : octree.nodes()) {
+        for (const auto& p : octree.positions(node)) {
+            REQUIRE(insideBox(p, node.min, node.max));
+        }
+        if (node.isLeaf()) {
+            REQUIRE((node.count <= 32 || node.depth == morton::BITS));
+            continue;
+        }
+        uint32_t next = node.first;
+        for (const auto& child : octree.children(node)) {
+            REQUIRE(child.first == next);
+            REQUIRE(child.depth == node.depth + 1);
+            next += child.count;
+        }
+        REQUIRE(next == node.first + node.count);
+    }
+}
+
+TEST_CASE("Octree queries match a brute-force scan", "[Octree]") {
+    const auto cloud = randomCloud(30000, 2);
+    for (unsigned threads : {1u, 4u, 0u}) {
+        Octree<PointXYZRGB> octree(cloud, Octree<PointXYZRGB>::DEFAULT_LEAF_SIZE, threads);
+
+        REQUIRE(sorted(octree.boxQuery({-10, -20, -1}, {15, 5, 2})) == bruteForceBox(cloud, {-10, -20, -1}, {15, 5, 2}));
+        REQUIRE(sorted(octree.boxQuery({-100, -100, -100}, {100, 100, 100})).size() == cloud.size());
+        REQUIRE(octree.boxQuery({60, 60, 60}, {70, 70, 70}).empty());
+        REQUIRE(octree.boxQuery({1, 2, 3}, {1, 2, 3}).size() >= 200);
+
+        for (float radius : {0.0f, 0.5f, 3.0f, 25.0f}) {
+            const Point3D center = cloud[123].position;
+            REQUIRE(sorted(octree.radiusQuery(center, radius)) == bruteForceRadius(cloud, center, radius));
+        }
+    }
+}
+
+TEST_CASE("Octree skips non-finite points", "[Octree]") {
+    auto cloud = randomCloud(1000, 5);
+    cloud[10].position.x = numeric_limits<float>::quiet_NaN();
+    cloud[20].position.z = numeric_limits<float>::infinity();
+
+    Octree<PointXYZRGB> octree(cloud, 16);
+    REQUIRE(octree.size() == cloud.size() - 2);
+    const auto all = sorted(octree.boxQuery({-1e9f, -1e9f, -1e9f}, {1e9f, 1e9f, 1e9f}));
+    REQUIRE(all == bruteForceBox(cloud, {-1e9f, -1e9f, -1e9f}, {1e9f, 1e9f, 1e9f}));
+    REQUIRE_FALSE(binary_search(all.begin(), all.end(), 10u));
+    REQUIRE_FALSE(binary_search(all.begin(), all.end(), 20u));
+}
+
+TEST_CASE("Octree of an empty or single-point cloud", "[Octree]") {
+    PointCloud<Point3D> empty;
+    Octree<Point3D> none(empty);
+    REQUIRE(none.empty());
+    REQUIRE(none.nodes().empty());
+    REQUIRE(none.boxQuery({-1, -1, -1}, {1, 1, 1}).empty());
+    REQUIRE(none.radiusQuery({0, 0, 0}, 10).empty());
+
+    PointCloud<Point3D> single;
+    single.push_back({0.5f, 0.5f, 0.5f});
+    Octree<Point3D> one(single);
+    REQUIRE(one.nodes().size() == 1);
+    REQUIRE(one.radiusQuery({0, 0, 0}, 1) == vector<uint32_t>{0});
+    REQUIRE(one.radiusQuery({0.5f, 0.5f, 0.5f}, -1).empty());  // Squared, -1 would reach the point
+    REQUIRE(one.radiusQuery({0.5f, 0.5f, 0.5f}, numeric_limits<float>::quiet_NaN()).empty());
+}
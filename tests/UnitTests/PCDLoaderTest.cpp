@@ -0,0 +1,701 @@
+/**
+ * @brief Unit tests for PCD loading internals (binary decode plan, compressed field order, ascii parsing) using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "PCDProcessor.hpp"
+#include "codec/LZFCodec.hpp"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+PCDProcessor::PCDHeader makeHeader(vector<string> fields, vector<uint32_t> sizes, vector<char> types, uint32_t points) {
+    PCDProcessor::PCDHeader header;
+    header.version = "0.7";
+    header.fields = std::move(fields);
+    header.sizes = std::move(sizes);
+    header.types = std::move(types);
+    header.counts.assign(header.fields.size(), 1);
+    header.width = points;
+    header.height = 1;
+    header.viewpoint = "0 0 0 1 0 0 0";
+    header.points = points;
+    header.dataType = "binary";
+    return header;
+}
+
+template <typename T>
+void append(vector<uint8_t>& bytes, T value) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+// Write a PCD header followed by a raw payload
+void writeRawPCD(const string& filename, const PCDProcessor::PCDHeader& header, const string& dataType, const vector<uint8_t>& payload) {
+    ofstream file(filename, ios::binary);
+    file << "VERSION 0.7\nFIELDS";
+    for (const auto& f : header.fields) file << " " << f;
+    file << "\nSIZE";
+    for (auto sz : header.sizes) file << " " << sz;
+    file << "\nTYPE";
+    for (auto t : header.types) file << " " << t;
+    file << "\nCOUNT";
+    for (auto c : header.counts) file << " " << c;
+    file << "\nWIDTH " << header.width << "\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS " << header.points << "\nDATA " << dataType << "\n";
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<streamsize>(payload.size()));
+}
+
+// Write a binary_compressed PCD from an uncompressed, column-major payload
+void writeRawCompressedPCD(const string& filename, const PCDProcessor::PCDHeader& header, const vector<uint8_t>& columns) {
+    auto compressed = codec::LZFCodec::compress(columns);
+    vector<uint8_t> payload;
+    append(payload, static_cast<uint32_t>(compressed.size()));
+    append(payload, static_cast<uint32_t>(columns.size()));
+    payload.insert(payload.end(), compressed.begin(), compressed.end());
+    writeRawPCD(filename, header, "binary_compressed", payload);
+}
+
+// Decompress the payload of a binary_compressed file written by ScanForge
+vector<uint8_t> readCompressedPayload(const string& filename) {
+    ifstream file(filename, ios::binary);
+    string content(filesystem::file_size(filename), '\0');
+    file.read(content.data(), static_cast<streamsize>(content.size()));
+    const string marker = "DATA binary_compressed\n";
+    auto pos = content.find(marker);
+    if (pos == string::npos) {
+        return {};
+    }
+    pos += marker.size();
+    uint32_t compressedSize = 0, uncompressedSize = 0;
+    memcpy(&compressedSize, content.data() + pos, sizeof(uint32_t));
+    memcpy(&uncompressedSize, content.data() + pos + sizeof(uint32_t), sizeof(uint32_t));
+    vector<uint8_t> compressed(content.begin() + static_cast<ptrdiff_t>(pos + 8), content.begin() + static_cast<ptrdiff_t>(pos + 8 + compressedSize));
+    vector<uint8_t> columns(uncompressedSize);
+    codec::LZFCodec::decompress(compressed, columns);
+    return columns;
+}
+
+// Write a PCD header followed by ascii lines
+void writeRawASCIIPCD(const string& filename, const PCDProcessor::PCDHeader& header, const string& lines) {
+    writeRawPCD(filename, header, "ascii", vector<uint8_t>(lines.begin(), lines.end()));
+}
+
+}  // namespace
+
+TEST_CASE("PCD decode plan layout detection", "[PCDLoader][decode]") {
+    GIVEN("the standard x y z rgb header") {
+        auto header = makeHeader({"x", "y", "z", "rgb"}, {4, 4, 4, 4}, {'F', 'F', 'F', 'U'}, 1);
+        auto plan = PCDProcessor::createDecodePlan(header);
+
+        THEN("the packed 16-byte fast path is selected") {
+            REQUIRE(plan.isValid());
+            REQUIRE(plan.layout == PCDProcessor::DecodePlan::Layout::XYZRGB);
+            REQUIRE(plan.stride == 16);
+            REQUIRE(plan.rgbOffset == 12u);
+        }
+    }
+
+    GIVEN("an XYZ-only header") {
+        auto header = makeHeader({"x", "y", "z"}, {4, 4, 4}, {'F', 'F', 'F'}, 1);
+        auto plan = PCDProcessor::createDecodePlan(header);
+
+        THEN("the packed 12-byte fast path is selected") {
+            REQUIRE(plan.layout == PCDProcessor::DecodePlan::Layout::XYZ);
+            REQUIRE(plan.stride == 12);
+            REQUIRE_FALSE(plan.rgbOffset.has_value());
+        }
+    }
+
+    GIVEN("a header with extra and reordered fields") {
+        auto header = makeHeader({"intensity", "rgb", "z", "y", "x", "ring"}, {4, 4, 4, 4, 4, 2}, {'F', 'U', 'F', 'F', 'F', 'U'}, 1);
+        auto plan = PCDProcessor::createDecodePlan(header);
+
+        THEN("the generic plan resolves every offset") {
+            REQUIRE(plan.layout == PCDProcessor::DecodePlan::Layout::Generic);
+            REQUIRE(plan.stride == 22);
+            REQUIRE(plan.xOffset == 16);
+            REQUIRE(plan.yOffset == 12);
+            REQUIRE(plan.zOffset == 8);
+            REQUIRE(plan.rgbOffset == 4u);
+        }
+    }
+
+    GIVEN("a header with double precision coordinates") {
+        auto header = makeHeader({"x", "y", "z"}, {8, 8, 8}, {'F', 'F', 'F'}, 1);
+
+        THEN("the plan is rejected rather than misreading the records") {
+            REQUIRE_FALSE(PCDProcessor::createDecodePlan(header).isValid());
+        }
+    }
+}
+
+TEST_CASE("PCD binary decoding drops non-finite points", "[PCDLoader][decode]") {
+    const float nan = numeric_limits<float>::quiet_NaN();
+    const float inf = numeric_limits<float>::infinity();
+    PCDProcessor processor;
+
+    GIVEN("an x y z rgb file whose invalid points land in every SIMD lane and in the scalar tail") {
+        // 11 points: two full blocks of four plus a tail of three
+        vector<Point3D> positions = {{0, 0, 0}, {nan, 1, 1}, {2, 2, 2}, {3, 3, 3}, {4, 4, 4}, {5, inf, 5}, {6, 6, -inf}, {7, 7, 7}, {8, 8, 8}, {9, 9, nan}, {10, 10, 10}};
+        PointCloudXYZRGB cloud;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            cloud.push_back(PointXYZRGB(positions[i], RGB(static_cast<uint8_t>(i), 0, 0)));
+        }
+        const string filename = "test_decode_nan.pcd";
+        REQUIRE(processor.savePCD_Binary(filename, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+
+        WHEN("loading it") {
+            auto [header, loaded] = processor.loadPCD(filename);
+
+            THEN("only finite points are kept, in order, and the cloud is marked non-dense") {
+                REQUIRE(header.isValid());
+                REQUIRE_FALSE(loaded.is_dense);
+                vector<float> xs;
+                for (const auto& p : loaded) {
+                    xs.push_back(p.position.x);
+                    REQUIRE(p.color.r == static_cast<uint8_t>(p.position.x));
+                }
+                REQUIRE(xs == vector<float>{0, 2, 3, 4, 7, 8, 10});
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("a generic layout file with interleaved extra fields") {
+        auto header = makeHeader({"intensity", "x", "y", "z", "rgb"}, {4, 4, 4, 4, 4}, {'F', 'F', 'F', 'F', 'U'}, 3);
+        vector<uint8_t> records;
+        for (int i = 0; i < 3; ++i) {
+            append(records, 99.0f);
+            append(records, i == 1 ? nan : static_cast<float>(i));
+            append(records, static_cast<float>(i) * 2.0f);
+            append(records, static_cast<float>(i) * 3.0f);
+            append(records, RGB(10, 20, static_cast<uint8_t>(i)).toPacked());
+        }
+        const string filename = "test_decode_generic.pcd";
+        writeRawPCD(filename, header, "binary", records);
+
+        WHEN("loading it") {
+            auto [loadedHeader, loaded] = processor.loadPCD(filename);
+
+            THEN("coordinates and colour come from the right offsets") {
+                REQUIRE(loadedHeader.isValid());
+                REQUIRE(loaded.size() == 2);
+                REQUIRE(loaded[1].position.x == 2.0f);
+                REQUIRE(loaded[1].position.y == 4.0f);
+                REQUIRE(loaded[1].position.z == 6.0f);
+                REQUIRE(loaded[1].color.g == 20);
+                REQUIRE(loaded[1].color.b == 2);
+                REQUIRE_FALSE(loaded.is_dense);
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+}
+
+TEST_CASE("PCD binary_compressed uses PCL column-major field order", "[PCDLoader][compressed]") {
+    PCDProcessor processor;
+
+    GIVEN("an x y z rgb cloud whose size exercises the SIMD blocks and the scalar tail") {
+        PointCloudXYZRGB cloud;
+        for (int i = 0; i < 21; ++i) {
+            const float f = static_cast<float>(i);
+            cloud.push_back(PointXYZRGB(Point3D(f, f + 0.25f, -f), RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(2 * i), 7)));
+        }
+        const string filename = "test_compressed_columns.pcd";
+        REQUIRE(processor.savePCD_BinaryCompressed(filename, PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed"), cloud));
+
+        WHEN("decompressing the written payload") {
+            auto columns = readCompressedPayload(filename);
+
+            THEN("each field is stored contiguously for all points") {
+                REQUIRE(columns.size() == cloud.size() * 16);
+                for (size_t i = 0; i < cloud.size(); ++i) {
+                    float x, y, z;
+                    uint32_t rgb;
+                    memcpy(&x, columns.data() + i * 4, 4);
+                    memcpy(&y, columns.data() + (cloud.size() + i) * 4, 4);
+                    memcpy(&z, columns.data() + (2 * cloud.size() + i) * 4, 4);
+                    memcpy(&rgb, columns.data() + (3 * cloud.size() + i) * 4, 4);
+                    REQUIRE(x == cloud[i].position.x);
+                    REQUIRE(y == cloud[i].position.y);
+                    REQUIRE(z == cloud[i].position.z);
+                    REQUIRE(rgb == cloud[i].color.toPacked());
+                }
+            }
+        }
+
+        WHEN("loading it back") {
+            auto [header, loaded] = processor.loadPCD(filename);
+
+            THEN("every point round-trips exactly") {
+                REQUIRE(header.isValid());
+                REQUIRE(loaded.size() == cloud.size());
+                for (size_t i = 0; i < cloud.size(); ++i) {
+                    REQUIRE(loaded[i].position.x == cloud[i].position.x);
+                    REQUIRE(loaded[i].position.y == cloud[i].position.y);
+                    REQUIRE(loaded[i].position.z == cloud[i].position.z);
+                    REQUIRE(loaded[i].color.toPacked() == cloud[i].color.toPacked());
+                }
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("a PCL file with mixed field widths") {
+        // x y z (4 bytes), ring (2 bytes), intensity (1 byte), normal (3 x 4 bytes)
+        auto header = makeHeader({"x", "y", "z", "ring", "intensity", "normal"}, {4, 4, 4, 2, 1, 4}, {'F', 'F', 'F', 'U', 'U', 'F'}, 5);
+        header.counts = {1, 1, 1, 1, 1, 3};
+        vector<uint8_t> columns;
+        for (int i = 0; i < 5; ++i) append(columns, static_cast<float>(i));
+        for (int i = 0; i < 5; ++i) append(columns, static_cast<float>(i) * 10.0f);
+        for (int i = 0; i < 5; ++i) append(columns, static_cast<float>(i) * 100.0f);
+        for (int i = 0; i < 5; ++i) append(columns, static_cast<uint16_t>(i));
+        for (int i = 0; i < 5; ++i) append(columns, static_cast<uint8_t>(i));
+        for (int i = 0; i < 15; ++i) append(columns, 1.0f);
+        const string filename = "test_compressed_generic.pcd";
+        writeRawCompressedPCD(filename, header, columns);
+
+        WHEN("loading it") {
+            auto [loadedHeader, loaded] = processor.loadPCD(filename);
+
+            THEN("coordinates are gathered from their columns") {
+                REQUIRE(loadedHeader.isValid());
+                REQUIRE(loaded.size() == 5);
+                for (size_t i = 0; i < loaded.size(); ++i) {
+                    const float f = static_cast<float>(i);
+                    REQUIRE(loaded[i].position.x == f);
+                    REQUIRE(loaded[i].position.y == f * 10.0f);
+                    REQUIRE(loaded[i].position.z == f * 100.0f);
+                }
+            }
+        }
+
+        WHEN("memory-mapping it") {
+            auto view = processor.mapPCD(filename);
+
+            THEN("the view exposes interleaved records") {
+                REQUIRE(view.has_value());
+                REQUIRE(view->stride() == 27);
+                REQUIRE(view->field<uint16_t>(3, 3) == 3);
+                REQUIRE(view->field<uint8_t>(4, 4) == 4);
+                REQUIRE(view->field<float>(2, 5, 2) == 1.0f);
+                REQUIRE(view->field<float>(4, 2) == 400.0f);
+            }
+        }
+
+        filesystem::remove(filename);
+    }
+
+    GIVEN("a payload whose size does not match the header") {
+        auto header = makeHeader({"x", "y", "z"}, {4, 4, 4}, {'F', 'F', 'F'}, 4);
+        vector<uint8_t> columns(3 * 4 * 3, 0);
+        const string filename = "test_compressed_short.pcd";
+        writeRawCompressedPCD(filename, header, columns);
+
+        THEN("loading fails instead of reading past the columns") {
+            auto [loadedHeader, loaded] = processor.loadPCD(filename);
+            REQUIRE(loaded.empty());
+        }
+
+        filesystem::remove(filename);
+    }
+}
+
+TEST_CASE("PCD binary_compressed_chunked blocks decode in parallel", "[PCDLoader][compressed]") {
+    PCDProcessor processor;
+    PointCloudXYZRGB cloud;
+    for (int i = 0; i < 150000; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(Point3D(f * 0.01f, static_cast<float>(i % 500), -f), RGB(static_cast<uint8_t>(i), 3, static_cast<uint8_t>(i >> 8))));
+    }
+    const auto header = PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed_chunked");
+    const string filename = "test_compressed_chunked.pcd";
+    const string parallelFile = "test_compressed_chunked_parallel.pcd";
+    REQUIRE(processor.savePCD_BinaryCompressedChunked(filename, header, cloud, 1, codec::LZFCodec::Level::Normal, 20000));
+    REQUIRE(processor.savePCD_BinaryCompressedChunked(parallelFile, header, cloud, 0, codec::LZFCodec::Level::Normal, 20000));
+
+    auto readFile = [](const string& path) {
+        ifstream file(path, ios::binary);
+        return vector<char>(istreambuf_iterator<char>(file), {});
+    };
+    auto sameCloud = [&cloud](const PointCloudXYZRGB& loaded) {
+        return loaded.size() == cloud.size() && ranges::equal(loaded.points, cloud.points, [](const PointXYZRGB& p, const PointXYZRGB& q) {
+                   return p.position.x == q.position.x && p.position.y == q.position.y && p.position.z == q.position.z && p.color.toPacked() == q.color.toPacked();
+               });
+    };
+
+    SECTION("Compression threads do not change the file") {
+        REQUIRE(readFile(filename) == readFile(parallelFile));
+    }
+
+    SECTION("Every load path restores the cloud") {
+        for (unsigned threads : {1u, 4u, 0u}) {
+            auto [streamHeader, streamed] = processor.loadPCD(filename, PCDProcessor::LoadMode::Stream, threads);
+            REQUIRE(streamHeader.dataType == "binary_compressed_chunked");
+            REQUIRE(sameCloud(streamed));
+            auto [mappedHeader, mapped] = processor.loadPCD(filename, PCDProcessor::LoadMode::MemoryMapped, threads);
+            REQUIRE(sameCloud(mapped));
+        }
+
+        auto view = processor.mapPCD(filename);
+        REQUIRE(view.has_value());
+        REQUIRE(view->size() == cloud.size());
+        REQUIRE(view->field<float>(123456, 2) == -123456.0f);
+    }
+
+    SECTION("The classic single-stream variant stays readable by PCL-style decoders") {
+        const string classic = "test_compressed_classic.pcd";
+        REQUIRE(processor.savePCD(classic, PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed"), cloud));
+        REQUIRE(readCompressedPayload(classic).size() == cloud.size() * 16);
+        filesystem::remove(classic);
+    }
+
+    SECTION("Corrupt block indexes are rejected") {
+        auto bytes = readFile(filename);
+        const auto payload = static_cast<size_t>(search(bytes.begin(), bytes.end(), "DATA binary_compressed_chunked\n", "DATA binary_compressed_chunked\n" + 31) - bytes.begin()) + 31;
+        uint64_t indexOffset = 0;
+        memcpy(&indexOffset, bytes.data() + payload, sizeof(indexOffset));
+        const string corrupt = "test_compressed_chunked_corrupt.pcd";
+        auto loadWith = [&](const vector<char>& content) {
+            ofstream(corrupt, ios::binary).write(content.data(), static_cast<streamsize>(content.size()));
+            auto [streamHeader, streamed] = processor.loadPCD(corrupt);
+            auto [mappedHeader, mapped] = processor.loadPCD(corrupt, PCDProcessor::LoadMode::MemoryMapped);
+            PCDReader reader(corrupt);
+            return !streamed.empty() || !mapped.empty() || reader.is_open();
+        };
+
+        auto truncated = bytes;
+        truncated.resize(truncated.size() - 4);
+        REQUIRE_FALSE(loadWith(truncated));
+
+        auto wrongCount = bytes;
+        wrongCount[payload + indexOffset + 4] = 3;  // 8 blocks of 20000 points expected
+        REQUIRE_FALSE(loadWith(wrongCount));
+
+        auto wrongOffset = bytes;
+        const uint64_t past = bytes.size();
+        memcpy(wrongOffset.data() + payload, &past, sizeof(past));
+        REQUIRE_FALSE(loadWith(wrongOffset));
+
+        auto damagedBlock = bytes;
+        damagedBlock.erase(damagedBlock.begin() + static_cast<ptrdiff_t>(payload + 100), damagedBlock.begin() + static_cast<ptrdiff_t>(payload + 200));
+        REQUIRE_FALSE(loadWith(damagedBlock));
+        filesystem::remove(corrupt);
+    }
+
+    SECTION("Blocks of any field layout decode from their columns, filtered or not") {
+        // intensity x y z ring: the generic layout, 18-byte records in blocks of 1000 points
+        constexpr uint32_t points = 4500;
+        constexpr uint32_t blockPoints = 1000;
+        auto generic = makeHeader({"intensity", "x", "y", "z", "ring"}, {4, 4, 4, 4, 2}, {'F', 'F', 'F', 'F', 'U'}, points);
+        vector<uint8_t> payload(sizeof(uint64_t));
+        vector<uint32_t> sizes;
+        for (uint32_t first = 0; first < points; first += blockPoints) {
+            const uint32_t n = min(blockPoints, points - first);
+            vector<uint8_t> columns;
+            auto column = [&](auto value) {
+                for (uint32_t i = first; i < first + n; ++i) {
+                    append(columns, value(i));
+                }
+            };
+            column([](uint32_t i) { return static_cast<float>(i) * 0.5f; });
+            column([](uint32_t i) { return i % 1500 == 999 ? numeric_limits<float>::quiet_NaN() : static_cast<float>(i); });
+            column([](uint32_t i) { return static_cast<float>(i % 100); });
+            column([](uint32_t i) { return -static_cast<float>(i); });
+            column([](uint32_t i) { return static_cast<uint16_t>(i % 16); });
+            const auto compressed = codec::LZFCodec::compress(columns);
+            payload.insert(payload.end(), compressed.begin(), compressed.end());
+            sizes.push_back(static_cast<uint32_t>(compressed.size()));
+        }
+        const uint64_t indexOffset = payload.size();
+        memcpy(payload.data(), &indexOffset, sizeof(indexOffset));
+        append(payload, blockPoints);
+        append(payload, static_cast<uint32_t>(sizes.size()));
+        for (const uint32_t size : sizes) {
+            append(payload, size);
+        }
+        const string genericFile = "test_compressed_chunked_generic.pcd";
+        writeRawPCD(genericFile, generic, "binary_compressed_chunked", payload);
+
+        io::LoadFilter stride;
+        stride.stride = 7;
+        for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            for (const unsigned threads : {1u, 3u}) {
+                auto [loadedHeader, loaded] = processor.loadPCD<PointXYZI>(genericFile, mode, threads);
+                REQUIRE(loaded.size() == points - 3);  // Points 999, 2499 and 3999 are NaN
+                REQUIRE_FALSE(loaded.is_dense);
+                for (size_t k = 0; k < loaded.size(); ++k) {
+                    const auto i = static_cast<uint32_t>(k + (k >= 999) + (k >= 2498) + (k >= 3997));
+                    REQUIRE(loaded[k].position.x == static_cast<float>(i));
+                    REQUIRE(loaded[k].position.z == -static_cast<float>(i));
+                    REQUIRE(loaded[k].intensity == static_cast<float>(i) * 0.5f);
+                }
+
+                auto [strideHeader, strided] = processor.loadPCD<PointXYZI>(genericFile, stride, mode, threads);
+                REQUIRE(strided.size() == (points + 6) / 7 - 1);  // 2499 is a multiple of 7 and NaN
+                for (size_t k = 0; k < strided.size(); ++k) {
+                    const auto i = static_cast<uint32_t>((k + (k >= 357)) * 7);
+                    REQUIRE(strided[k].position.y == static_cast<float>(i % 100));
+                }
+            }
+        }
+        filesystem::remove(genericFile);
+    }
+
+    SECTION("Streamed loads read the compressed blocks in batches") {
+        // Noise compresses poorly: about 19 MB of blocks, more than one read batch
+        mt19937 gen(3);
+        uniform_real_distribution<float> noise(-1000.0f, 1000.0f);
+        PointCloudXYZRGB large;
+        for (int i = 0; i < 1200000; ++i) {
+            large.push_back(PointXYZRGB(Point3D(noise(gen), noise(gen), noise(gen)), RGB(static_cast<uint8_t>(gen()), static_cast<uint8_t>(gen()), 9)));
+        }
+        large.points[1100000].position.y = numeric_limits<float>::infinity();
+        const string largeFile = "test_compressed_chunked_large.pcd";
+        REQUIRE(processor.savePCD_BinaryCompressedChunked(largeFile, PCDProcessor::createXYZRGBHeader(large, "binary_compressed_chunked"), large, 0));
+        REQUIRE(filesystem::file_size(largeFile) > (size_t{16} << 20));
+
+        for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            auto [largeHeader, loaded] = processor.loadPCD(largeFile, mode, 4);
+            REQUIRE(loaded.size() == large.size() - 1);
+            REQUIRE(loaded[1099999].position.x == large[1099999].position.x);
+            REQUIRE(loaded[1100000].position.x == large[1100001].position.x);
+            REQUIRE(loaded.points.back().color.toPacked() == large.points.back().color.toPacked());
+        }
+        filesystem::remove(largeFile);
+    }
+
+    filesystem::remove(filename);
+    filesystem::remove(parallelFile);
+}
+
+TEST_CASE("PCL binary_compressed sample decodes to real coordinates", "[PCDLoader][compressed]") {
+    const string filename = "tests/data/sample.pcd";
+    if (!filesystem::exists(filename)) {
+        SKIP("sample.pcd not available");
+    }
+
+    PCDProcessor processor;
+    auto [header, cloud] = processor.loadPCD(filename);
+
+    REQUIRE(header.dataType == "binary_compressed");
+    REQUIRE(cloud.size() == header.points);
+    auto [minPt, maxPt] = cloud.getBoundingBox();
+    // A stationary scan: every return lies within a few hundred metres of the sensor
+    REQUIRE(minPt.x > -500.0f);
+    REQUIRE(maxPt.x < 500.0f);
+    REQUIRE(minPt.z > -100.0f);
+    REQUIRE(maxPt.z < 100.0f);
+    REQUIRE(maxPt.x - minPt.x > 1.0f);
+}
+
+TEST_CASE("PCD ascii parser tolerates real-world lines", "[PCDLoader][ascii]") {
+    PCDProcessor processor;
+    const string filename = "test_ascii_parser.pcd";
+    auto header = makeHeader({"x", "y", "z", "rgb"}, {4, 4, 4, 4}, {'F', 'F', 'F', 'U'}, 7);
+
+    GIVEN("signs, exponents, tabs, CRLF endings, a NaN and malformed lines") {
+        writeRawASCIIPCD(filename, header,
+                         "1.5 -2 +3e2 16711680\r\n"
+                         "\t4\t5\t6\t65280   \n"
+                         "nan 1 1 255\n"
+                         "7 8\n"
+                         "abc 1 1 1\n"
+                         "\n"
+                         "-0.25 1e-3 9 0");
+
+        for (auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            auto [loadedHeader, cloud] = processor.loadPCD(filename, mode);
+
+            THEN("valid points are decoded and the rest skipped") {
+                REQUIRE(cloud.size() == 3);
+                REQUIRE_FALSE(cloud.is_dense);
+                REQUIRE(cloud[0].position.x == 1.5f);
+                REQUIRE(cloud[0].position.y == -2.0f);
+                REQUIRE(cloud[0].position.z == 300.0f);
+                REQUIRE(cloud[0].color.r == 255);
+                REQUIRE(cloud[1].position.z == 6.0f);
+                REQUIRE(cloud[1].color.g == 255);
+                REQUIRE(cloud[2].position.y == 0.001f);
+                REQUIRE(cloud[2].color.toPacked() == 0);
+            }
+        }
+    }
+
+    GIVEN("more lines than POINTS announces") {
+        header.points = 2;
+        writeRawASCIIPCD(filename, header, "1 1 1 0\n2 2 2 0\n3 3 3 0\n");
+        auto [loadedHeader, cloud] = processor.loadPCD(filename);
+
+        THEN("only the announced points are read") {
+            REQUIRE(cloud.size() == 2);
+            REQUIRE(cloud[1].position.x == 2.0f);
+        }
+    }
+
+    GIVEN("no rgb field") {
+        auto xyz = makeHeader({"x", "y", "z", "intensity"}, {4, 4, 4, 4}, {'F', 'F', 'F', 'F'}, 1);
+        writeRawASCIIPCD(filename, xyz, "1 2 3 0.5\n");
+        auto [loadedHeader, cloud] = processor.loadPCD(filename);
+
+        THEN("points default to white") {
+            REQUIRE(cloud.size() == 1);
+            REQUIRE(cloud[0].color.toPacked() == 0xFFFFFF);
+        }
+    }
+
+    filesystem::remove(filename);
+}
+
+TEST_CASE("PCD ascii payloads are parsed in parallel chunks", "[PCDLoader][ascii]") {
+    PCDProcessor processor;
+    const string filename = "test_ascii_parallel.pcd";
+    constexpr uint32_t points = 150000;  // Several MB of text, enough to split across threads
+    auto header = makeHeader({"x", "y", "z", "rgb"}, {4, 4, 4, 4}, {'F', 'F', 'F', 'U'}, points);
+
+    string lines;
+    for (uint32_t i = 0; i < points + 10; ++i) {
+        if (i == 777) {
+            lines += "inf 0 0 0\n";
+        } else {
+            lines += to_string(i) + ".25 " + to_string(i % 1000) + " -" + to_string(i) + "e-2 " + to_string(i % 0xFFFFFF) + "\n";
+        }
+    }
+    writeRawASCIIPCD(filename, header, lines);
+
+    auto [singleHeader, single] = processor.loadPCD(filename);
+    REQUIRE(single.size() == points - 1);
+
+    for (auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+        WHEN("loading with four threads") {
+            auto [parallelHeader, parallel] = processor.loadPCD(filename, mode, 4);
+
+            THEN("the result equals the single-threaded parse, in order") {
+                REQUIRE(parallel.size() == single.size());
+                REQUIRE_FALSE(parallel.is_dense);
+                for (size_t i = 0; i < single.size(); i += 101) {
+                    REQUIRE(parallel[i].position.x == single[i].position.x);
+                    REQUIRE(parallel[i].position.z == single[i].position.z);
+                    REQUIRE(parallel[i].color.toPacked() == single[i].color.toPacked());
+                }
+                REQUIRE(parallel.points.back().position.x == static_cast<float>(points - 1) + 0.25f);
+            }
+        }
+    }
+
+    WHEN("reading through a PCDReader in small chunks") {
+        PCDReader reader(filename);
+        vector<PointXYZRGB> chunk(4099);
+        size_t total = 0;
+        while (size_t n = reader.next(chunk)) {
+            REQUIRE(chunk[0].position.x == single[total].position.x);
+            total += n;
+        }
+
+        THEN("every point arrives") {
+            REQUIRE(reader.good());
+            REQUIRE(total == single.size());
+        }
+    }
+
+    filesystem::remove(filename);
+}
+
+TEST_CASE("PCD typed point loading reads the fields a point type asks for", "[PCDLoader][Schema]") {
+    PCDProcessor processor;
+    const string filename = "test_typed_fields.pcd";
+    auto header = makeHeader({"x", "y", "z", "intensity", "label", "gps_time", "rgb"}, {4, 4, 4, 4, 4, 8, 4}, {'F', 'F', 'F', 'F', 'U', 'F', 'U'}, 3);
+
+    const auto expectPoints = [](const PointCloud<PointLAS>& cloud) {
+        REQUIRE(cloud.size() == 3);
+        CHECK(cloud[0].position.x == 1.0f);
+        CHECK(cloud[0].intensity == 100.0f);
+        CHECK(cloud[0].classification == 2);
+        CHECK(cloud[0].gpsTime == 1000.5);
+        CHECK(cloud[0].color.r == 255);
+        CHECK(cloud[0].color.g == 0);
+        CHECK(cloud[1].classification == 255);  // 300 saturates
+        CHECK(cloud[1].color.g == 255);
+        CHECK(cloud[2].intensity == 0.5f);
+        CHECK(cloud[2].gpsTime == -2.0);
+        // Fields a PCD file cannot hold keep their defaults
+        CHECK(cloud[0].returnNumber == 0);
+        CHECK(cloud[0].nearInfrared == 0);
+    };
+
+    SECTION("binary") {
+        vector<uint8_t> payload;
+        const float positions[3] = {1.0f, 2.0f, 3.0f};
+        const float intensities[3] = {100.0f, 7.0f, 0.5f};
+        const uint32_t labels[3] = {2, 300, 6};
+        const double times[3] = {1000.5, 0.0, -2.0};
+        const uint32_t colors[3] = {0xFF0000, 0x00FF00, 0x0000FF};
+        for (int i = 0; i < 3; ++i) {
+            append(payload, positions[i]);
+            append(payload, 0.0f);
+            append(payload, 0.0f);
+            append(payload, intensities[i]);
+            append(payload, labels[i]);
+            append(payload, times[i]);
+            append(payload, colors[i]);
+        }
+        writeRawPCD(filename, header, "binary", payload);
+
+        for (auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            auto [loadedHeader, cloud] = processor.loadPCD<PointLAS>(filename, mode);
+            expectPoints(cloud);
+
+            auto [intensityHeader, intensityCloud] = processor.loadPCD<PointXYZI>(filename, mode);
+            REQUIRE(intensityCloud.size() == 3);
+            CHECK(intensityCloud[1].intensity == 7.0f);
+            CHECK(intensityCloud[1].position.x == 2.0f);
+
+            auto [xyzHeader, xyzCloud] = processor.loadPCD<Point3D>(filename, mode);
+            REQUIRE(xyzCloud.size() == 3);
+            CHECK(xyzCloud[2].x == 3.0f);
+        }
+    }
+
+    SECTION("ascii") {
+        header.dataType = "ascii";
+        writeRawASCIIPCD(filename, header,
+                         "1 0 0 100 2 1000.5 16711680\n"
+                         "2 0 0 7 300 0 65280\n"
+                         "3 0 0 0.5 6 -2 255\n");
+        for (auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            auto [loadedHeader, cloud] = processor.loadPCD<PointLAS>(filename, mode);
+            expectPoints(cloud);
+        }
+    }
+
+    SECTION("classification is read when there is no label") {
+        auto plain = makeHeader({"x", "y", "z", "classification"}, {4, 4, 4, 1}, {'F', 'F', 'F', 'U'}, 1);
+        vector<uint8_t> payload;
+        append(payload, 1.0f);
+        append(payload, 2.0f);
+        append(payload, 3.0f);
+        append(payload, uint8_t{9});
+        writeRawPCD(filename, plain, "binary", payload);
+
+        auto [loadedHeader, cloud] = processor.loadPCD<PointXYZRGBClass>(filename);
+        REQUIRE(cloud.size() == 1);
+        CHECK(cloud[0].classification == 9);
+        CHECK(cloud[0].color.r == 255);  // No color field: white, as for XYZRGB
+        CHECK(cloud[0].position.z == 3.0f);
+    }
+
+    filesystem::remove(filename);
+}
@@ -6,7 +6,9 @@
 #include "PCDProcessor.hpp"
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <sstream>
+#include <string>
 
 using namespace std;
 using namespace scanforge;
@@ -285,4 +287,69 @@ TEST_CASE("PCD format compatibility", "[PCDWriter][compatibility]") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("PCD writers flush large clouds in blocks", "[PCDWriter][buffered]") {
+    // Enough points for several write blocks, with values that need every significant digit
+    PointCloudXYZRGB pointCloud;
+    for (uint32_t i = 0; i < 120000; ++i) {
+        const float f = static_cast<float>(i);
+        pointCloud.push_back(PointXYZRGB(Point3D(f / 3.0f, -f * 1.0e-7f, numeric_limits<float>::min() * f), RGB(static_cast<uint8_t>(i), 7, static_cast<uint8_t>(i >> 8))));
+    }
+    pointCloud.points[1].position = Point3D(numeric_limits<float>::max(), numeric_limits<float>::lowest(), -numeric_limits<float>::denorm_min());
+    pointCloud.width = static_cast<uint32_t>(pointCloud.size());
+    pointCloud.height = 1;
+    PCDProcessor processor;
+
+    for (const string dataType : {"ascii", "binary", "binary_compressed"}) {
+        GIVEN("a " + dataType + " file") {
+            const string filename = "test_buffered_" + dataType + ".pcd";
+            REQUIRE(processor.savePCD(filename, PCDProcessor::createXYZRGBHeader(pointCloud, dataType), pointCloud));
+            auto [header, loaded] = processor.loadPCD(filename);
+
+            THEN("every point reads back bit-exact") {
+                REQUIRE(loaded.size() == pointCloud.size());
+                size_t mismatches = 0;
+                for (size_t i = 0; i < pointCloud.size(); ++i) {
+                    const auto& a = loaded[i];
+                    const auto& b = pointCloud[i];
+                    mismatches += a.position.x != b.position.x || a.position.y != b.position.y || a.position.z != b.position.z || a.color.toPacked() != b.color.toPacked();
+                }
+                REQUIRE(mismatches == 0);
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+
+    GIVEN("a header with fields the writer does not know") {
+        auto header = PCDProcessor::createXYZRGBHeader(pointCloud, "ascii");
+        header.fields.push_back("intensity");
+        header.sizes.push_back(4);
+        header.types.push_back('F');
+        header.counts.push_back(1);
+
+        THEN("ascii lines carry a 0 and binary records zero bytes for them") {
+            auto readFile = [](const string& filename) {
+                ifstream file(filename, ios::binary);
+                string content(filesystem::file_size(filename), '\0');
+                file.read(content.data(), static_cast<streamsize>(content.size()));
+                return content;
+            };
+
+            PointCloudXYZRGB head;
+            head.points.assign(pointCloud.points.begin(), pointCloud.points.begin() + 3);
+            header.points = header.width = 3;
+            REQUIRE(processor.savePCD("test_unknown_field.pcd", header, head));
+            const string text = readFile("test_unknown_field.pcd");
+            REQUIRE(text.contains("\nDATA ascii\n0 -0 0 1792 0\n"));
+
+            header.dataType = "binary";
+            REQUIRE(processor.savePCD("test_unknown_field.pcd", header, head));
+            const string binary = readFile("test_unknown_field.pcd");
+            REQUIRE(binary.ends_with(string(4, '\0')));
+            REQUIRE(binary.size() - binary.find("DATA binary\n") - 12 == 3 * 20);
+            filesystem::remove("test_unknown_field.pcd");
+        }
+    }
+}
@@ -0,0 +1,314 @@
+/**
+ * @brief Unit tests for the structure-of-arrays point cloud and its SIMD kernels using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "PointCloudSoA.hpp"
+#include "io/PointStream.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using Catch::Approx;
+
+namespace {
+
+// 1003 points: odd size so every kernel runs its scalar tail
+PointCloudXYZRGB makeCloud(size_t count = 1003) {
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(Point3D(f * 0.25f - 50.0f, std::sin(f) * 10.0f, 1000.0f - f), RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(i * 7), 42)));
+    }
+    cloud.width = static_cast<uint32_t>(count);
+    cloud.height = 1;
+    return cloud;
+}
+
+}  // namespace
+
+TEST_CASE("PointCloudSoA converts to and from PointCloudXYZRGB", "[PointCloudSoA]") {
+    GIVEN("an interleaved cloud") {
+        const auto cloud = makeCloud();
+        PointCloudSoA columns(cloud);
+
+        THEN("the columns hold every point, aligned for SIMD") {
+            REQUIRE(columns.size() == cloud.size());
+            REQUIRE(columns.width == cloud.width);
+            REQUIRE(reinterpret_cast<uintptr_t>(columns.x.data()) % 64 == 0);
+            REQUIRE(reinterpret_cast<uintptr_t>(columns.b.data()) % 64 == 0);
+            REQUIRE(columns[500].position.y == cloud[500].position.y);
+            REQUIRE(columns[500].color.g == cloud[500].color.g);
+        }
+
+        THEN("toAoS restores the original points") {
+            const auto back = columns.toAoS();
+            REQUIRE(back.size() == cloud.size());
+            for (size_t i = 0; i < cloud.size(); ++i) {
+                REQUIRE(back[i].position.x == cloud[i].position.x);
+                REQUIRE(back[i].position.z == cloud[i].position.z);
+                REQUIRE(back[i].color.toPacked() == cloud[i].color.toPacked());
+            }
+        }
+    }
+}
+
+TEST_CASE("PointCloudSoA bounds and centroid match the scalar results", "[PointCloudSoA]") {
+    auto cloud = makeCloud();
+    cloud.points[10].position.y = numeric_limits<float>::quiet_NaN();
+    PointCloudSoA columns(cloud);
+
+    GIVEN("a cloud with a NaN coordinate") {
+        THEN("the bounding box equals PointCloud::getBoundingBox") {
+            const auto [expectedMin, expectedMax] = cloud.getBoundingBox();
+            const auto [minPt, maxPt] = columns.getBoundingBox();
+            REQUIRE(minPt.x == expectedMin.x);
+            REQUIRE(minPt.y == expectedMin.y);
+            REQUIRE(minPt.z == expectedMin.z);
+            REQUIRE(maxPt.x == expectedMax.x);
+            REQUIRE(maxPt.y == expectedMax.y);
+            REQUIRE(maxPt.z == expectedMax.z);
+        }
+    }
+
+    GIVEN("NaN in the first point and across the first SIMD vector") {
+        // Finite-only reference, since PointCloud::getBoundingBox starts from the first point
+        auto finiteBounds = [](const PointCloudXYZRGB& points) {
+            Point3D lo(numeric_limits<float>::infinity(), numeric_limits<float>::infinity(), numeric_limits<float>::infinity());
+            Point3D hi = lo * -1.0f;
+            for (const auto& point : points) {
+                const Point3D& p = point.position;
+                if (!std::isnan(p.x)) {
+                    lo.x = std::min(lo.x, p.x);
+                    hi.x = std::max(hi.x, p.x);
+                }
+                if (!std::isnan(p.y)) {
+                    lo.y = std::min(lo.y, p.y);
+                    hi.y = std::max(hi.y, p.y);
+                }
+                lo.z = std::min(lo.z, p.z);
+                hi.z = std::max(hi.z, p.z);
+            }
+            return std::pair{lo, hi};
+        };
+        for (size_t lane = 0; lane < 8; ++lane) {
+            auto poisoned = makeCloud();
+            poisoned.points[lane].position.x = numeric_limits<float>::quiet_NaN();
+            poisoned.points[0].position.y = numeric_limits<float>::quiet_NaN();
+            THEN("the bounds skip the NaN in lane " + to_string(lane)) {
+                const auto [expectedMin, expectedMax] = finiteBounds(poisoned);
+                const auto [minPt, maxPt] = PointCloudSoA(poisoned).getBoundingBox();
+                REQUIRE(minPt.x == expectedMin.x);
+                REQUIRE(maxPt.x == expectedMax.x);
+                REQUIRE(minPt.y == expectedMin.y);
+                REQUIRE(maxPt.y == expectedMax.y);
+                REQUIRE(minPt.z == expectedMin.z);
+                REQUIRE(maxPt.z == expectedMax.z);
+            }
+        }
+    }
+
+    GIVEN("an axis that is NaN everywhere") {
+        auto poisoned = makeCloud();
+        for (auto& point : poisoned.points) {
+            point.position.y = numeric_limits<float>::quiet_NaN();
+        }
+        THEN("that axis has the empty range +inf to -inf and the others are unaffected") {
+            const auto [expectedMin, expectedMax] = makeCloud().getBoundingBox();
+            const auto [minPt, maxPt] = PointCloudSoA(poisoned).getBoundingBox();
+            REQUIRE(minPt.y == numeric_limits<float>::infinity());
+            REQUIRE(maxPt.y == -numeric_limits<float>::infinity());
+            REQUIRE(minPt.x == expectedMin.x);
+            REQUIRE(maxPt.z == expectedMax.z);
+        }
+    }
+
+    GIVEN("finite coordinates") {
+        columns.set(10, makeCloud()[10]);
+
+        THEN("the centroid equals the double-precision mean") {
+            double sx = 0.0, sz = 0.0;
+            for (size_t i = 0; i < columns.size(); ++i) {
+                sx += static_cast<double>(columns.x[i]);
+                sz += static_cast<double>(columns.z[i]);
+            }
+            const auto centroid = columns.getCentroid();
+            REQUIRE(centroid.x == Approx(sx / 1003.0));
+            REQUIRE(centroid.z == Approx(sz / 1003.0));
+        }
+    }
+
+    GIVEN("an empty cloud") {
+        PointCloudSoA empty;
+        THEN("bounds and centroid are zero") {
+            REQUIRE(empty.getBoundingBox().first.x == 0.0f);
+            REQUIRE(empty.getCentroid().z == 0.0f);
+        }
+    }
+}
+
+TEST_CASE("simd::minMax ignores NaN at any position", "[PointCloudSoA][simd]") {
+    constexpr float NaN = numeric_limits<float>::quiet_NaN();
+    for (const size_t count : {size_t{1}, size_t{3}, size_t{4}, size_t{5}, size_t{8}, size_t{9}, size_t{17}}) {
+        for (size_t at = 0; at < count; ++at) {
+            vector<float> values(count);
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = static_cast<float>(i) - 2.5f;
+            }
+            values[at] = NaN;
+            float lo = 0, hi = 0;
+            simd::minMax(values.data(), count, lo, hi);
+            INFO("count " << count << ", NaN at " << at);
+            if (count == 1) {
+                REQUIRE(lo == numeric_limits<float>::infinity());
+                REQUIRE(hi == -numeric_limits<float>::infinity());
+            } else {
+                REQUIRE(lo == (at == 0 ? -1.5f : -2.5f));
+                REQUIRE(hi == (at == count - 1 ? static_cast<float>(count) - 4.5f : static_cast<float>(count) - 3.5f));
+            }
+        }
+    }
+
+    vector<float> nans(13, NaN);
+    float lo = 0, hi = 0;
+    simd::minMax(nans.data(), nans.size(), lo, hi);
+    REQUIRE(lo == numeric_limits<float>::infinity());
+    REQUIRE(hi == -numeric_limits<float>::infinity());
+}
+
+TEST_CASE("simd reductions follow one summation order on every instruction set", "[PointCloudSoA][simd]") {
+    // Values whose sum depends on the order: large and tiny magnitudes mixed
+    vector<float> values(1003);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = (i % 3 == 0 ? 1.0e7f : 1.0f / 3.0f) * (i % 2 == 0 ? 1.0f : -0.999f) + static_cast<float>(i) * 1.0e-3f;
+    }
+    const double mean = 12.375;
+
+    // The documented order: eight partial sums by index modulo 8, then a sequential tail
+    const auto reference = [&](size_t count, bool squared) {
+        const auto term = [&](size_t i) {
+            const double v = static_cast<double>(values[i]);
+            return squared ? (v - mean) * (v - mean) : v;
+        };
+        double lanes[8] = {};
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            for (size_t k = 0; k < 8; ++k) {
+                lanes[k] += term(i + k);
+            }
+        }
+        double total = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+        for (; i < count; ++i) {
+            total += term(i);
+        }
+        return total;
+    };
+
+    for (const size_t count : {size_t{0}, size_t{3}, size_t{4}, size_t{7}, size_t{8}, size_t{12}, size_t{17}, size_t{1003}}) {
+        INFO("count " << count);
+        REQUIRE(simd::sum(values.data(), count) == reference(count, false));
+        REQUIRE(simd::sumSquaredDeviations(values.data(), count, mean) == reference(count, true));
+    }
+}
+
+TEST_CASE("PointCloudSoA transform and crop", "[PointCloudSoA]") {
+    const auto cloud = makeCloud();
+    PointCloudSoA columns(cloud);
+
+    WHEN("applying a rotation about z and a translation") {
+        columns.transform({0, -1, 0, 5,  //
+                           1, 0, 0, -2,  //
+                           0, 0, 1, 0.5f});
+
+        THEN("every point is mapped the same way") {
+            for (size_t i = 0; i < cloud.size(); ++i) {
+                const auto& p = cloud[i].position;
+                REQUIRE(columns.x[i] == -p.y + 5.0f);
+                REQUIRE(columns.y[i] == p.x - 2.0f);
+                REQUIRE(columns.z[i] == p.z + 0.5f);
+            }
+        }
+    }
+
+    WHEN("cropping to a box") {
+        const size_t kept = columns.cropBox(Point3D(-40.0f, -5.0f, 0.0f), Point3D(100.0f, 5.0f, 990.0f));
+
+        THEN("exactly the points inside remain, in order") {
+            size_t expected = 0;
+            for (const auto& point : cloud) {
+                const auto& p = point.position;
+                if (p.x >= -40.0f && p.x <= 100.0f && p.y >= -5.0f && p.y <= 5.0f && p.z >= 0.0f && p.z <= 990.0f) {
+                    REQUIRE(columns.x[expected] == p.x);
+                    REQUIRE(columns.r[expected] == point.color.r);
+                    ++expected;
+                }
+            }
+            REQUIRE(kept == expected);
+            REQUIRE(columns.size() == expected);
+            REQUIRE(columns.width == expected);
+        }
+    }
+}
+
+TEST_CASE("Loaders decode directly into columns", "[PointCloudSoA][IO]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_soa_tests";
+    filesystem::create_directories(tempDir);
+    const auto cloud = makeCloud(40000);
+
+    GIVEN("a LAS file") {
+        LASProcessor processor;
+        const auto filename = tempDir / "columns.las";
+        REQUIRE(processor.saveLAS(filename, LASProcessor::createLASHeader(cloud), cloud));
+        auto [expectedHeader, expected] = processor.loadLAS(filename);
+
+        for (unsigned threads : {1u, 3u}) {
+            WHEN("loading columns with " + to_string(threads) + " threads") {
+                auto [header, columns] = processor.loadLASColumns(filename, threads);
+
+                THEN("the columns equal the interleaved load") {
+                    REQUIRE(header.getTotalPointCount() == expected.size());
+                    REQUIRE(columns.size() == expected.size());
+                    for (size_t i = 0; i < expected.size(); i += 97) {
+                        REQUIRE(columns.x[i] == expected[i].position.x);
+                        REQUIRE(columns.y[i] == expected[i].position.y);
+                        REQUIRE(columns.z[i] == expected[i].position.z);
+                        REQUIRE(columns.g[i] == expected[i].color.g);
+                    }
+                }
+            }
+        }
+
+        WHEN("the file is truncated") {
+            filesystem::resize_file(filename, filesystem::file_size(filename) - 10);
+            auto [header, columns] = processor.loadLASColumns(filename);
+            THEN("no columns are returned") {
+                REQUIRE(columns.empty());
+            }
+        }
+    }
+
+    GIVEN("a PCD file read through a chunked reader") {
+        PCDProcessor pcd;
+        const string filename = (tempDir / "columns.pcd").string();
+        REQUIRE(pcd.savePCD_Binary(filename, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+        PCDReader reader(filename);
+        PointCloudSoA columns;
+
+        THEN("readColumns fills every column") {
+            REQUIRE(io::readColumns(reader, columns, 1000));
+            REQUIRE(columns.size() == cloud.size());
+            REQUIRE(columns.x[39999] == cloud[39999].position.x);
+            REQUIRE(columns.r[1234] == cloud[1234].color.r);
+        }
+    }
+
+    filesystem::remove_all(tempDir);
+}
@@ -441,3 +441,46 @@ TEST_CASE("PointCloud realistic scenarios", "[PointCloudTypes]") {
         REQUIRE(hasVariedColors);
     }
 }
+
+TEST_CASE("Composed point schemas", "[PointCloudTypes][Schema]") {
+    STATIC_REQUIRE(HasIntensity<PointXYZI>);
+    STATIC_REQUIRE(!HasColor<PointXYZI>);
+    STATIC_REQUIRE(HasColor<PointXYZRGB>);
+    STATIC_REQUIRE(HasColor<PointXYZRGBClass>);
+    STATIC_REQUIRE(HasClassification<PointXYZRGBClass>);
+    STATIC_REQUIRE(!HasGpsTime<PointXYZRGBClass>);
+    STATIC_REQUIRE(HasReturns<PointLAS>);
+    STATIC_REQUIRE(HasGpsTime<PointLAS>);
+    STATIC_REQUIRE(HasNearInfrared<PointLAS>);
+    STATIC_REQUIRE(!HasIntensity<Point3D>);
+    STATIC_REQUIRE(sizeof(PointXYZI) == sizeof(Point3D) + sizeof(float));
+
+    SECTION("Fields start at their defaults") {
+        PointLAS point(Point3D(1.0f, 2.0f, 3.0f));
+        REQUIRE(point.position.y == 2.0f);
+        REQUIRE(point.color.r == 255);
+        REQUIRE(point.intensity == 0.0f);
+        REQUIRE(point.classification == 0);
+        REQUIRE(point.returnNumber == 0);
+        REQUIRE(point.numberOfReturns == 0);
+        REQUIRE(point.gpsTime == 0.0);
+        REQUIRE(point.nearInfrared == 0);
+    }
+
+    SECTION("Clouds of composed points have positions and bounds") {
+        PointCloud<PointXYZI> cloud;
+        for (int i = 0; i < 4; ++i) {
+            PointXYZI point(Point3D(static_cast<float>(i), static_cast<float>(-i), 1.0f));
+            point.intensity = static_cast<float>(i) * 10.0f;
+            cloud.push_back(point);
+        }
+        getPosition(cloud[0]).z = 5.0f;
+
+        auto [minPt, maxPt] = cloud.getBoundingBox();
+        REQUIRE(minPt.x == 0.0f);
+        REQUIRE(minPt.y == -3.0f);
+        REQUIRE(maxPt.x == 3.0f);
+        REQUIRE(maxPt.z == 5.0f);
+        REQUIRE(cloud[3].intensity == 30.0f);
+    }
+}
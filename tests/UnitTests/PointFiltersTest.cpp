@@ -0,0 +1,105 @@
+/**
+ * @brief Unit tests for the voxel downsampling and statistical outlier filters
+ */
+
+#include <catch2/catch_all.hpp>
+#include "filters/PointFilters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::filters;
+
+TEST_CASE("voxelDownsample keeps one centroid per voxel", "[PointFilters]") {
+    PointCloud<PointXYZRGB> cloud;
+    cloud.push_back(PointXYZRGB(0.1f, 0.1f, 0.1f, 10, 20, 30));
+    cloud.push_back(PointXYZRGB(0.3f, 0.5f, 0.9f, 20, 30, 41));
+    cloud.push_back(PointXYZRGB(1.5f, 0.5f, 0.5f, 200, 0, 0));
+    cloud.push_back(PointXYZRGB(numeric_limits<float>::quiet_NaN(), 0, 0, 0, 0, 0));
+
+    PointCloud<PointXYZRGB> output;
+    REQUIRE(voxelDownsample(cloud, output, 1.0f));
+    REQUIRE(output.size() == 2);
+    REQUIRE(output.width == 2);
+    REQUIRE(output.height == 1);
+    REQUIRE(output.is_dense);
+
+    const auto first = find_if(output.begin(), output.end(), [](const PointXYZRGB& p) { return p.position.x < 1; });
+    REQUIRE(first != output.end());
+    REQUIRE(first->position.x == Catch::Approx(0.2f));
+    REQUIRE(first->position.y == Catch::Approx(0.3f));
+    REQUIRE(first->position.z == Catch::Approx(0.5f));
+    REQUIRE(first->color.r == 15);
+    REQUIRE(first->color.g == 25);
+    REQUIRE(first->color.b == 36);
+
+    REQUIRE_FALSE(voxelDownsample(cloud, output, 0.0f));
+}
+
+TEST_CASE("voxelDownsample is independent of the thread count and may run in place", "[PointFilters]") {
+    mt19937 rng(1);
+    uniform_real_distribution<float> coord(0.0f, 10.0f);
+    PointCloud<Point3D> cloud;
+    for (int i = 0; i < 100000; ++i) {
+        cloud.push_back({coord(rng), coord(rng), coord(rng)});
+    }
+
+    PointCloud<Point3D> serial, parallel;
+    REQUIRE(voxelDownsample(cloud, serial, 0.5f, 1));
+    REQUIRE(voxelDownsample(cloud, parallel, 0.5f, 4));
+    REQUIRE(serial.size() == 8000);
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        REQUIRE(parallel[i].x == serial[i].x);
+        REQUIRE(parallel[i].y == serial[i].y);
+        REQUIRE(parallel[i].z == serial[i].z);
+    }
+
+    REQUIRE(voxelDownsample(cloud, cloud, 0.5f, 0));
+    REQUIRE(cloud.size() == serial.size());
+}
+
+TEST_CASE("removeStatisticalOutliers drops isolated points", "[PointFilters]") {
+    mt19937 rng(2);
+    normal_distribution<float> coord(0.0f, 1.0f);
+    PointCloud<PointXYZRGB> cloud;
+    for (int i = 0; i < 5000; ++i) {
+        cloud.push_back(PointXYZRGB(coord(rng), coord(rng), coord(rng), 1, 2, 3));
+    }
+    const vector<Point3D> outliers = {{40, 0, 0}, {0, -35, 0}, {20, 20, 20}};
+    for (const auto& p : outliers) {
+        cloud.push_back(PointXYZRGB(p, RGB(9, 9, 9)));
+    }
+    cloud.push_back(PointXYZRGB(numeric_limits<float>::infinity(), 0, 0, 0, 0, 0));
+
+    PointCloud<PointXYZRGB> serial;
+    REQUIRE(removeStatisticalOutliers(cloud, serial, 8, 2.0, 1));
+    REQUIRE(serial.size() < cloud.size() - outliers.size());
+    REQUIRE(serial.size() > 4500);
+    REQUIRE(none_of(serial.begin(), serial.end(), [](const PointXYZRGB& p) { return p.color.r == 9 || !isfinite(p.position.x); }));
+    REQUIRE(serial.width == serial.size());
+
+    PointCloud<PointXYZRGB> parallel;
+    REQUIRE(removeStatisticalOutliers(cloud, parallel, 8, 2.0, 0));
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        REQUIRE(parallel[i].position.x == serial[i].position.x);
+    }
+
+    REQUIRE_FALSE(removeStatisticalOutliers(cloud, parallel, 0));
+}
+
+TEST_CASE("removeStatisticalOutliers on tiny clouds", "[PointFilters]") {
+    PointCloud<Point3D> cloud;
+    PointCloud<Point3D> output;
+    REQUIRE(removeStatisticalOutliers(cloud, output));
+    REQUIRE(output.empty());
+
+    cloud.push_back({1, 2, 3});
+    REQUIRE(removeStatisticalOutliers(cloud, output));
+    REQUIRE(output.size() == 1);
+}
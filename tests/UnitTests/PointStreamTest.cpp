@@ -0,0 +1,336 @@
+/**
+ * @brief Unit tests for the chunked point readers and writers using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "io/PointStream.hpp"
+#include "tooling/BoundedQueue.hpp"
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+PointCloudXYZRGB makeCloud(size_t count) {
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(Point3D(f * 0.5f, -f, f + 100.0f), RGB(static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3), 9)));
+    }
+    return cloud;
+}
+
+// Drain a reader through windows of chunkSize points
+vector<PointXYZRGB> readAll(io::PointReader& reader, size_t chunkSize) {
+    vector<PointXYZRGB> points;
+    REQUIRE(io::forEachChunk(reader, chunkSize, [&points](span<const PointXYZRGB> chunk) {
+        points.insert(points.end(), chunk.begin(), chunk.end());
+        return true;
+    }));
+    return points;
+}
+
+bool samePoints(span<const PointXYZRGB> a, span<const PointXYZRGB> b) {
+    return ranges::equal(a, b, [](const PointXYZRGB& p, const PointXYZRGB& q) {
+        return p.position.x == q.position.x && p.position.y == q.position.y && p.position.z == q.position.z && p.color.toPacked() == q.color.toPacked();
+    });
+}
+
+}  // namespace
+
+TEST_CASE("PCD chunked reader matches loadPCD", "[PointStream][PCD]") {
+    PCDProcessor processor;
+    auto cloud = makeCloud(1000);
+    cloud.points[17].position.x = numeric_limits<float>::quiet_NaN();
+
+    for (const string dataType : {"ascii", "binary", "binary_compressed", "binary_compressed_chunked"}) {
+        GIVEN("a " + dataType + " file") {
+            const string filename = "test_stream_" + dataType + ".pcd";
+            REQUIRE(processor.savePCD(filename, PCDProcessor::createXYZRGBHeader(cloud, dataType), cloud));
+            auto [header, loaded] = processor.loadPCD(filename);
+
+            WHEN("reading it through windows smaller than the file") {
+                PCDReader reader(filename);
+                REQUIRE(reader.is_open());
+                REQUIRE(reader.size() == 1000);
+                auto points = readAll(reader, 96);
+
+                THEN("the points equal the fully loaded cloud, with the invalid point dropped") {
+                    REQUIRE(points.size() == 999);
+                    REQUIRE(samePoints(points, loaded.points));
+                    REQUIRE_FALSE(reader.dense());
+                }
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+}
+
+TEST_CASE("PCD chunked writer patches the header counts", "[PointStream][PCD]") {
+    PCDProcessor processor;
+    auto cloud = makeCloud(777);
+
+    for (const string dataType : {"ascii", "binary", "binary_compressed", "binary_compressed_chunked"}) {
+        GIVEN("a " + dataType + " writer fed in uneven chunks") {
+            const string filename = "test_stream_writer_" + dataType + ".pcd";
+            {
+                PCDWriter writer(filename, PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, dataType));
+                REQUIRE(writer.is_open());
+                span<const PointXYZRGB> all(cloud.points);
+                REQUIRE(writer.write(all.first(100)));
+                REQUIRE(writer.write(all.subspan(100, 1)));
+                REQUIRE(writer.write(all.subspan(101)));
+                REQUIRE(writer.count() == 777);
+                REQUIRE(writer.close());
+            }
+
+            THEN("loadPCD sees every point and the final WIDTH and POINTS") {
+                auto [header, loaded] = processor.loadPCD(filename);
+                REQUIRE(header.points == 777);
+                REQUIRE(header.width == 777);
+                REQUIRE(header.height == 1);
+                REQUIRE(header.dataType == dataType);
+                REQUIRE(loaded.size() == 777);
+                REQUIRE(samePoints(loaded.points, cloud.points));
+            }
+
+            filesystem::remove(filename);
+        }
+    }
+
+    GIVEN("a binary_compressed_chunked writer fed across block boundaries") {
+        const size_t blockPoints = PCDProcessor::COMPRESSED_BLOCK_POINTS;
+        auto large = makeCloud(2 * blockPoints + 123);
+        const string filename = "test_stream_writer_blocks.pcd";
+        {
+            PCDWriter writer(filename, PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, "binary_compressed_chunked"));
+            span<const PointXYZRGB> all(large.points);
+            REQUIRE(writer.write(all.first(blockPoints - 1)));
+            REQUIRE(writer.write(all.subspan(blockPoints - 1, 2)));
+            REQUIRE(writer.write(all.subspan(blockPoints + 1)));
+            REQUIRE(writer.close());
+        }
+
+        THEN("the blocks match a one-shot save and stream back in order") {
+            const string reference = "test_stream_writer_blocks_reference.pcd";
+            REQUIRE(processor.savePCD_BinaryCompressedChunked(reference, PCDProcessor::createXYZRGBHeader(large, "binary_compressed_chunked"), large, 4));
+            auto [header, loaded] = processor.loadPCD(reference, PCDProcessor::LoadMode::Stream, 4);
+            REQUIRE(samePoints(loaded.points, large.points));
+
+            PCDReader reader(filename);
+            REQUIRE(reader.is_open());
+            auto points = readAll(reader, 10000);
+            REQUIRE(samePoints(points, large.points));
+            REQUIRE(reader.dense());
+            filesystem::remove(reference);
+        }
+
+        filesystem::remove(filename);
+    }
+}
+
+TEST_CASE("LAS chunked reader and writer", "[PointStream][LAS]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_stream_tests";
+    filesystem::create_directories(tempDir);
+    LASProcessor processor;
+    auto cloud = makeCloud(5000);
+
+    GIVEN("a LAS file written by saveLAS") {
+        const auto filename = tempDir / "batch.las";
+        REQUIRE(processor.saveLAS(filename, LASProcessor::createLASHeader(cloud), cloud));
+        auto [header, loaded] = processor.loadLAS(filename);
+
+        WHEN("reading it in chunks") {
+            LASReader reader(filename);
+            REQUIRE(reader.is_open());
+            REQUIRE(reader.size() == 5000);
+            auto points = readAll(reader, 777);
+
+            THEN("the points equal the fully loaded cloud") {
+                REQUIRE(reader.good());
+                REQUIRE(samePoints(points, loaded.points));
+            }
+        }
+
+        WHEN("the file is truncated") {
+            filesystem::resize_file(filename, filesystem::file_size(filename) - 100);
+            LASReader reader(filename);
+            vector<PointXYZRGB> chunk(4096);
+            REQUIRE(reader.next(chunk) == 4096);
+
+            THEN("the short chunk reports an error") {
+                REQUIRE(reader.next(chunk) == 0);
+                REQUIRE_FALSE(reader.good());
+            }
+        }
+    }
+
+    GIVEN("a streaming LAS writer") {
+        const auto filename = tempDir / "streamed.las";
+        LASWriter writer(filename, LASProcessor::createLASHeader(PointCloudXYZRGB{}));
+        REQUIRE(writer.is_open());
+        span<const PointXYZRGB> all(cloud.points);
+        REQUIRE(writer.write(all.first(1234)));
+        REQUIRE(writer.write(all.subspan(1234)));
+        REQUIRE(writer.close());
+
+        THEN("the header carries the point count and the bounding box") {
+            auto [header, loaded] = processor.loadLAS(filename);
+            REQUIRE(header.getTotalPointCount() == 5000);
+            REQUIRE(header.minX == 0.0);
+            REQUIRE(header.maxX == 2499.5);
+            REQUIRE(header.minY == -4999.0);
+            REQUIRE(header.maxZ == 5099.0);
+            REQUIRE(loaded.size() == 5000);
+            REQUIRE(loaded.points[4999].position.y == Catch::Approx(-4999.0f));
+        }
+    }
+
+    GIVEN("a streaming LAS 1.4 writer") {
+        const auto filename = tempDir / "streamed14.las";
+        LASWriter writer(filename, LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_7));
+        REQUIRE(writer.is_open());
+        span<const PointXYZRGB> all(cloud.points);
+        REQUIRE(writer.write(all.first(4321)));
+        REQUIRE(writer.write(all.subspan(4321)));
+        REQUIRE(writer.close());
+
+        THEN("the 64-bit point count and the points by return are patched, the legacy counts left zero") {
+            auto [header, loaded] = processor.loadLAS(filename);
+            REQUIRE(header.versionMinor == 4);
+            REQUIRE(header.headerSize == 375);
+            REQUIRE(header.numberOfPointRecords == 5000);
+            REQUIRE(header.numberOfPointsByReturn[0] == 5000);
+            REQUIRE(all_of(header.numberOfPointsByReturn.begin() + 1, header.numberOfPointsByReturn.end(), [](uint64_t count) { return count == 0; }));
+            REQUIRE(header.legacyNumberOfPointRecords == 0);
+            REQUIRE(header.legacyNumberOfPointsByReturn == array<uint32_t, 5>{});
+            REQUIRE(loaded.size() == 5000);
+            REQUIRE(loaded.points[4999].position.y == Catch::Approx(-4999.0f));
+        }
+    }
+
+    GIVEN("a LAZ file written in chunks that straddle its LASzip chunks") {
+        const auto filename = tempDir / "streamed.laz";
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        auto large = makeCloud(120001);
+        {
+            LASWriter writer(filename, header);
+            REQUIRE(writer.is_open());
+            span<const PointXYZRGB> all(large.points);
+            REQUIRE(writer.write(all.first(49999)));
+            REQUIRE(writer.write(all.subspan(49999, 2)));
+            REQUIRE(writer.write(all.subspan(50001)));
+            REQUIRE(writer.close());
+        }
+        auto [loadedHeader, loaded] = processor.loadLAS(filename);
+
+        THEN("loadLAS and the chunked reader see every point") {
+            REQUIRE(loadedHeader.compressed);
+            REQUIRE(loadedHeader.getTotalPointCount() == 120001);
+            REQUIRE(loadedHeader.maxX == 60000.0);
+            REQUIRE(loaded.size() == 120001);
+            REQUIRE(loaded.points[120000].position.z == Catch::Approx(120100.0f));
+
+            LASReader reader(filename);
+            REQUIRE(reader.is_open());
+            auto points = readAll(reader, 7777);
+            REQUIRE(reader.good());
+            REQUIRE(samePoints(points, loaded.points));
+        }
+    }
+
+    GIVEN("a PCD source converted to LAS with copyPoints") {
+        PCDProcessor pcd;
+        const string source = "test_stream_copy.pcd";
+        REQUIRE(pcd.savePCD_Binary(source, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+        const auto target = tempDir / "copied.las";
+
+        PCDReader reader(source);
+        LASWriter writer(target, LASProcessor::createLASHeader(PointCloudXYZRGB{}));
+        REQUIRE(io::copyPoints(reader, writer, 1000));
+
+        THEN("the LAS file holds the same points") {
+            auto [header, loaded] = processor.loadLAS(target);
+            REQUIRE(loaded.size() == cloud.size());
+            REQUIRE(loaded.points[123].position.x == Catch::Approx(cloud.points[123].position.x).margin(0.01));
+            REQUIRE(loaded.points[123].color.r == cloud.points[123].color.r);
+        }
+
+        filesystem::remove(source);
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("Bounded queue hands items across threads in order", "[PointStream][Pipeline]") {
+    tooling::BoundedQueue<int> queue(2);
+
+    GIVEN("a producer pushing more items than the capacity") {
+        std::jthread producer([&queue] {
+            for (int i = 0; i < 100; ++i) {
+                queue.push(i);
+            }
+            queue.close();
+        });
+
+        THEN("the consumer sees every item once, then the end") {
+            vector<int> received;
+            while (auto item = queue.pop()) {
+                received.push_back(*item);
+            }
+            REQUIRE(received.size() == 100);
+            REQUIRE(ranges::is_sorted(received));
+            REQUIRE_FALSE(queue.push(1));
+        }
+    }
+}
+
+TEST_CASE("Pipelined transcoding overlaps reading and writing", "[PointStream][Pipeline]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_pipe_tests";
+    filesystem::create_directories(tempDir);
+    auto cloud = makeCloud(10007);
+    PCDProcessor pcd;
+    const string source = (tempDir / "source.pcd").string();
+    REQUIRE(pcd.savePCD_Binary(source, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+
+    GIVEN("a PCD reader and a LAS writer") {
+        PCDReader reader(source);
+        const auto target = tempDir / "piped.las";
+        LASWriter writer(target, LASProcessor::createLASHeader(PointCloudXYZRGB{}));
+
+        WHEN("piping with small chunks and a shallow queue") {
+            REQUIRE(io::pipePoints(reader, writer, 333, 2));
+
+            THEN("every point arrives in order") {
+                LASProcessor las;
+                auto [header, loaded] = las.loadLAS(target);
+                REQUIRE(header.getTotalPointCount() == cloud.size());
+                REQUIRE(loaded.size() == cloud.size());
+                REQUIRE(loaded.points[10006].position.z == Catch::Approx(cloud.points[10006].position.z).margin(0.01));
+                REQUIRE(loaded.points[5000].color.r == cloud.points[5000].color.r);
+            }
+        }
+    }
+
+    GIVEN("a writer that cannot be opened") {
+        PCDReader reader(source);
+        PCDWriter writer((tempDir / "missing_dir" / "x.pcd"), PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, "binary"));
+
+        THEN("piping fails without hanging") {
+            REQUIRE_FALSE(io::pipePoints(reader, writer, 100, 2));
+        }
+    }
+
+    filesystem::remove_all(tempDir);
+}
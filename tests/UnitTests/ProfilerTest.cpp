@@ -0,0 +1,229 @@
+/**
+ * @brief Unit tests for the stage timers and counters and the processor stages reporting to them using Catch2
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "TestClouds.hpp"
+#include "tooling/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::tooling;
+
+namespace {
+
+const Profiler::Stage* findStage(const Profiler::Report& report, const string& name) {
+    const auto it = ranges::find(report.stages, name, &Profiler::Stage::name);
+    return it == report.stages.end() ? nullptr : &*it;
+}
+
+void busyWait(chrono::microseconds duration) {
+    const auto end = chrono::steady_clock::now() + duration;
+    while (chrono::steady_clock::now() < end) {
+    }
+}
+
+void profiledStep(unsigned nested) {
+    SCANFORGE_PROFILE_SCOPE("test.outer");
+    busyWait(chrono::microseconds(200));
+    for (unsigned i = 0; i < nested; ++i) {
+        SCANFORGE_PROFILE_SCOPE("test.inner");
+        busyWait(chrono::microseconds(100));
+    }
+    SCANFORGE_PROFILE_COUNT(PointsDecoded, 10);
+}
+
+}  // namespace
+
+TEST_CASE("Profiler JSON escapes stage names", "[Profiler]") {
+    Profiler::Report report;
+    report.stages.push_back({"say \"hi\"\\now\n", 1, 5});
+    ostringstream json;
+    report.writeJSON(json);
+    REQUIRE(json.str().find("{\"name\": \"say \\\"hi\\\"\\\\now\\u000a\", \"calls\": 1, \"total_ns\": 5}") != string::npos);
+}
+
+TEST_CASE("Profiler times nested scopes per thread and adds up counters", "[Profiler]") {
+    auto& profiler = Profiler::instance();
+    profiler.enable(false);
+    profiledStep(1);
+    profiler.enable(true);
+    REQUIRE(profiler.report().stages.empty());  // Nothing was recorded while disabled, and enable() reset the rest
+
+    SECTION("Stages, counters and busy time") {
+        profiledStep(3);
+        profiledStep(2);
+        const auto report = profiler.report();
+        if constexpr (!Profiler::COMPILED_IN) {
+            REQUIRE(report.stages.empty());
+            REQUIRE(report.counter(Counter::PointsDecoded) == 0);
+        } else {
+            const auto* outer = findStage(report, "test.outer");
+            const auto* inner = findStage(report, "test.inner");
+            REQUIRE(outer);
+            REQUIRE(inner);
+            REQUIRE(outer->calls == 2);
+            REQUIRE(inner->calls == 5);
+            REQUIRE(inner->nanoseconds >= 500'000);
+            REQUIRE(outer->nanoseconds >= inner->nanoseconds + 400'000);  // Nested stages are included
+            REQUIRE(report.counter(Counter::PointsDecoded) == 20);
+            REQUIRE(report.wallNanoseconds >= outer->nanoseconds);
+
+            // Busy time counts the outer scopes only
+            REQUIRE(report.threads.size() == 1);
+            REQUIRE(report.threads[0].nanoseconds == outer->nanoseconds);
+
+            ostringstream table;
+            report.printTable(table);
+            REQUIRE(table.str().find("test.inner") != string::npos);
+            REQUIRE(table.str().find("points_decoded") != string::npos);
+
+            ostringstream json;
+            report.writeJSON(json);
+            REQUIRE(json.str().find("{\"name\": \"test.outer\", \"calls\": 2, ") != string::npos);
+            REQUIRE(json.str().find("\"points_decoded\": 20") != string::npos);
+            REQUIRE(json.str().find("\"compression_ratio\": null") != string::npos);
+        }
+    }
+
+    SECTION("Threads keep their own times, and reset() clears them") {
+        profiledStep(0);  // The main thread holds a slot of its own from here on
+        vector<jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([] {
+                for (int i = 0; i < 10; ++i) {
+                    profiledStep(1);
+                }
+            });
+        }
+        threads.clear();
+
+        auto report = profiler.report();
+        if constexpr (Profiler::COMPILED_IN) {
+            REQUIRE(findStage(report, "test.outer")->calls == 41);
+            REQUIRE(findStage(report, "test.inner")->calls == 40);
+            REQUIRE(report.counter(Counter::PointsDecoded) == 410);
+            REQUIRE(report.threads.size() >= 2);
+            REQUIRE(report.threads.size() <= 5);
+            uint64_t busy = 0;
+            for (const auto& thread : report.threads) {
+                busy += thread.nanoseconds;
+            }
+            REQUIRE(busy == findStage(report, "test.outer")->nanoseconds);
+        }
+
+        profiler.reset();
+        report = profiler.report();
+        REQUIRE(report.stages.empty());
+        REQUIRE(report.threads.empty());
+        REQUIRE(report.counter(Counter::PointsDecoded) == 0);
+    }
+    profiler.enable(false);
+}
+
+TEST_CASE("Loaders and savers report their stages and counters", "[Profiler][file_io]") {
+    if constexpr (!Profiler::COMPILED_IN) {
+        SUCCEED("Profiling is compiled out");
+        return;
+    }
+    auto cloud = test::makeRampCloud(20000);
+    cloud.points[7].position.y = numeric_limits<float>::quiet_NaN();
+    cloud.points[9].position.z = numeric_limits<float>::infinity();
+    const string pcdFile = "test_profiler.pcd";
+    const string lazFile = "test_profiler.laz";
+    auto& profiler = Profiler::instance();
+
+    SECTION("binary_compressed PCD") {
+        profiler.enable(true);
+        REQUIRE(PCDProcessor().savePCD_BinaryCompressed(pcdFile, PCDProcessor::createXYZRGBHeader(cloud, "binary_compressed"), cloud));
+        auto report = profiler.report();
+        REQUIRE(report.counter(Counter::PointsEncoded) == cloud.size());
+        REQUIRE(report.counter(Counter::UncompressedBytes) == cloud.size() * 16);
+        REQUIRE(report.counter(Counter::BytesWritten) == 8 + report.counter(Counter::CompressedBytes));
+        REQUIRE(report.compressionRatio() > 1.0);
+        for (const auto* stage : {"pcd.encode", "pcd.transpose", "pcd.compress", "pcd.write"}) {
+            INFO(stage);
+            REQUIRE(findStage(report, stage));
+        }
+
+        for (const auto mode : {PCDProcessor::LoadMode::Stream, PCDProcessor::LoadMode::MemoryMapped}) {
+            profiler.reset();
+            const auto [header, loaded] = PCDProcessor().loadPCD(pcdFile, mode);
+            REQUIRE(loaded.size() == cloud.size() - 2);
+            report = profiler.report();
+            REQUIRE(report.counter(Counter::PointsDecoded) == loaded.size());
+            REQUIRE(report.counter(Counter::PointsDropped) == 2);
+            REQUIRE(report.counter(Counter::UncompressedBytes) == cloud.size() * 16);
+            REQUIRE(report.counter(Counter::BytesRead) > report.counter(Counter::CompressedBytes));
+            for (const auto* stage : {"pcd.header", "pcd.decompress", "pcd.transpose", "pcd.decode"}) {
+                INFO(stage);
+                REQUIRE(findStage(report, stage));
+            }
+            REQUIRE((findStage(report, "pcd.read") != nullptr) == (mode == PCDProcessor::LoadMode::Stream));
+        }
+
+        profiler.reset();
+        PCDReader reader(pcdFile);
+        vector<PointXYZRGB> window(4096);
+        size_t read = 0;
+        while (const size_t n = reader.next(window)) {
+            read += n;
+        }
+        REQUIRE(read == cloud.size() - 2);
+        report = profiler.report();
+        REQUIRE(report.counter(Counter::PointsDecoded) == read);
+        REQUIRE(report.counter(Counter::PointsDropped) == 2);
+    }
+
+    SECTION("ascii PCD") {
+        REQUIRE(PCDProcessor().savePCD_ASCII(pcdFile, PCDProcessor::createXYZRGBHeader(cloud, "ascii"), cloud));
+        profiler.enable(true);
+        const auto [header, loaded] = PCDProcessor().loadPCD(pcdFile);
+        const auto report = profiler.report();
+        REQUIRE(report.counter(Counter::PointsDecoded) == cloud.size() - 2);
+        REQUIRE(report.counter(Counter::PointsDropped) == 2);
+        REQUIRE(report.counter(Counter::BytesRead) > 0);
+        REQUIRE(report.counter(Counter::BytesRead) < filesystem::file_size(pcdFile));  // The header is not counted
+        REQUIRE(findStage(report, "pcd.parse"));
+    }
+
+    SECTION("LAZ") {
+        cloud = test::makeRampCloud(120000);
+        auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+        header.compressed = true;
+        profiler.enable(true);
+        REQUIRE(LASProcessor().saveLAS(lazFile, header, cloud, 2));
+        auto report = profiler.report();
+        REQUIRE(report.counter(Counter::PointsEncoded) == cloud.size());
+        REQUIRE(report.counter(Counter::UncompressedBytes) == cloud.size() * 34);
+        REQUIRE(findStage(report, "las.encode"));
+        REQUIRE(findStage(report, "laz.compress")->calls == 3);  // Chunks of 50000 points
+
+        for (const unsigned threads : {1u, 3u}) {
+            profiler.reset();
+            const auto [loadedHeader, loaded] = LASProcessor().loadLAS(lazFile, threads);
+            REQUIRE(loaded.size() == cloud.size());
+            report = profiler.report();
+            REQUIRE(report.counter(Counter::PointsDecoded) == cloud.size());
+            REQUIRE(report.counter(Counter::BytesRead) == filesystem::file_size(lazFile));
+            REQUIRE(report.counter(Counter::UncompressedBytes) == cloud.size() * 34);
+            REQUIRE(findStage(report, "las.header"));
+            REQUIRE(findStage(report, "laz.decompress")->calls == 3);
+            REQUIRE(findStage(report, "las.decode")->calls == 3);
+        }
+    }
+    profiler.enable(false);
+    filesystem::remove(pcdFile);
+    filesystem::remove(lazFile);
+}
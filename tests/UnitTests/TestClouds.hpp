@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * @brief Point clouds shared by the unit tests
+ */
+
+#include "PointCloudTypes.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace scanforge::test {
+
+/** @brief Points along a line, x = i/2, y = -i, z = i/4, with red and green counting up */
+inline PointCloudXYZRGB makeRampCloud(size_t count) {
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(f * 0.5f, -f, f * 0.25f, static_cast<uint8_t>(i), static_cast<uint8_t>(i / 3), 200));
+    }
+    return cloud;
+}
+
+}  // namespace scanforge::test
@@ -0,0 +1,229 @@
+/**
+ * @brief Unit tests for the work-stealing thread pool and the pool-aware parallel helpers
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "tooling/Parallel.hpp"
+#include "tooling/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::tooling;
+
+namespace {
+
+// Records the threads that ran some work, and how many ran it at once
+struct ThreadCensus {
+    mutex guard;
+    set<thread::id> threads;
+    atomic<unsigned> inside{0};
+    atomic<unsigned> peak{0};
+
+    void enter() {
+        {
+            lock_guard lock(guard);
+            threads.insert(this_thread::get_id());
+        }
+        const unsigned now = ++inside;
+        unsigned seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+    }
+
+    void leave() { --inside; }
+};
+
+}  // namespace
+
+TEST_CASE("ThreadPool runs every task of a group", "[ThreadPool]") {
+    ThreadPool pool(4);
+    CHECK(pool.size() == 4);
+    CHECK(ThreadPool::current() == nullptr);
+
+    // Catch assertions are not thread safe: tasks record and the test thread checks
+    vector<int> done(1000, 0);
+    atomic<int> onPool{0};
+    TaskGroup group(pool);
+    for (size_t i = 0; i < done.size(); ++i) {
+        group.run([&done, &onPool, &pool, i] {
+            onPool += ThreadPool::current() == &pool ? 1 : 0;
+            done[i] = 1;
+        });
+    }
+    group.wait();
+    CHECK(accumulate(done.begin(), done.end(), 0) == 1000);
+    CHECK(onPool == 1000);
+
+    // Destroying a pool runs the tasks still queued
+    atomic<int> later{0};
+    {
+        ThreadPool drained(2);
+        for (int i = 0; i < 100; ++i) {
+            drained.submit([&later] { ++later; });
+        }
+    }
+    CHECK(later == 100);
+}
+
+TEST_CASE("Parallel helpers inside a pool stay on its threads", "[ThreadPool][Parallel]") {
+    ThreadPool pool(3);
+    ThreadCensus census;
+    atomic<size_t> items{0};
+    atomic<int> wrongCounts{0};
+
+    // Every task splits its own work further, as a file decoding in parallel would
+    {
+        TaskGroup files(pool);
+        for (int file = 0; file < 8; ++file) {
+            files.run([&] {
+                wrongCounts += availableThreads(0) == 3 && availableThreads(5) == 5 ? 0 : 1;
+                parallelSlices(10000, availableThreads(0) * 4, [&](size_t, size_t count) {
+                    census.enter();
+                    items += count;
+                    this_thread::sleep_for(chrono::microseconds(200));
+                    census.leave();
+                });
+            });
+        }
+    }
+    CHECK(items == 8 * 10000);
+    CHECK(wrongCounts == 0);
+    CHECK(census.threads.size() <= 3);
+    CHECK(census.peak <= 3);
+
+    // The helpers give the same results inside and outside a pool
+    auto run = [] {
+        vector<int> squares(64);
+        parallelFor(squares.size(), [&squares](size_t i) { squares[i] = static_cast<int>(i * i); });
+        atomic<int> workers{0};
+        runWorkers(4, [&workers] { ++workers; });
+        int left = 0, right = 0;
+        parallelInvoke([&left] { left = 1; }, [&right] { right = 2; });
+        return accumulate(squares.begin(), squares.end(), 0) + workers * 1000 + left * 100000 + right * 1000000;
+    };
+    int inside = 0;
+    {
+        TaskGroup group(pool);
+        group.run([&] { inside = run(); });
+    }
+    CHECK(inside == run());
+    CHECK(availableThreads(0) == max(1u, thread::hardware_concurrency()));
+}
+
+TEST_CASE("A task submitted from outside reaches an idle worker while another waits in a nested wait", "[ThreadPool]") {
+    ThreadPool pool(3);
+    atomic<bool> nestedRunning{false};
+    atomic<bool> outsideRan{false};
+    atomic<bool> sawOutside{false};
+
+    TaskGroup group(pool);
+    // Keeps one worker busy until the waiter below sleeps, so that worker goes idle after it
+    group.run([] { this_thread::sleep_for(chrono::milliseconds(100)); });
+    group.run([&] {
+        TaskGroup nested(pool);
+        nested.run([&] {
+            nestedRunning = true;
+            const auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+            while (!outsideRan && chrono::steady_clock::now() < deadline) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            sawOutside = outsideRan.load();
+        });
+        while (!nestedRunning) {  // Let another worker take the nested task, so this one sleeps in wait()
+            this_thread::yield();
+        }
+        nested.wait();  // Never takes tasks of the shared queue
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(200));
+    jthread([&] { pool.submit([&] { outsideRan = true; }); }).join();
+    group.wait();
+    CHECK(sawOutside);
+    CHECK(outsideRan);
+}
+
+TEST_CASE("ConcurrencyLimit caps sections without starving the pool", "[ThreadPool]") {
+    ThreadPool pool(4);
+    ConcurrencyLimit io(pool, 2);
+    ThreadCensus limited;
+    atomic<size_t> work{0};
+
+    // Tasks holding a slot wait for nested work, while the tasks waiting for a slot help with it
+    {
+        TaskGroup files(pool);
+        for (int file = 0; file < 12; ++file) {
+            files.run([&] {
+                {
+                    auto slot = io.acquire();
+                    limited.enter();
+                    parallelSlices(4000, 4, [&](size_t, size_t count) {
+                        work += count;
+                        this_thread::sleep_for(chrono::microseconds(100));
+                    });
+                    limited.leave();
+                }
+                parallelSlices(4000, 4, [&](size_t, size_t count) { work += count; });
+            });
+        }
+    }
+    CHECK(work == 12 * 8000);
+    CHECK(limited.peak <= 2);
+    CHECK(limited.peak >= 1);
+
+    // Outside the pool acquire() blocks until a slot is free
+    auto first = io.acquire();
+    auto second = io.acquire();
+    atomic<bool> entered{false};
+    jthread waiter([&] {
+        auto third = io.acquire();
+        entered = true;
+    });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    CHECK_FALSE(entered);
+    { auto released = std::move(first); }
+    waiter.join();
+    CHECK(entered);
+}
+
+TEST_CASE("Files load and save in parallel on one pool", "[ThreadPool][LAS]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_thread_pool_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < 60000; ++i) {
+        const float f = static_cast<float>(i);
+        cloud.push_back(PointXYZRGB(Point3D(f * 0.01f, f * 0.02f, 1.0f), RGB(static_cast<uint8_t>(i), 2, 3)));
+    }
+    const auto header = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+
+    ThreadPool pool(3);
+    vector<size_t> loaded(6, 0);
+    atomic<int> failedSaves{0};
+    {
+        TaskGroup files(pool);
+        for (size_t f = 0; f < loaded.size(); ++f) {
+            files.run([&, f] {
+                auto fileHeader = header;
+                fileHeader.compressed = f % 2 == 1;
+                const auto path = tempDir / ("file" + to_string(f) + (fileHeader.compressed ? ".laz" : ".las"));
+                LASProcessor processor;
+                failedSaves += processor.saveLAS(path, fileHeader, cloud, 0) ? 0 : 1;
+                loaded[f] = get<1>(processor.loadLAS(path, 0)).size();
+            });
+        }
+    }
+    CHECK(failedSaves == 0);
+    CHECK(all_of(loaded.begin(), loaded.end(), [&](size_t n) { return n == cloud.size(); }));
+
+    filesystem::remove_all(tempDir);
+}
@@ -0,0 +1,214 @@
+/**
+ * @brief Unit tests for the out-of-core tiler
+ */
+
+#include <catch2/catch_all.hpp>
+#include "LASProcessor.hpp"
+#include "PCDProcessor.hpp"
+#include "io/Tiler.hpp"
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+
+namespace {
+
+PointCloudXYZRGB makeCloud(size_t count) {
+    mt19937 rng(11);
+    uniform_real_distribution<float> xy(-1500.0f, 2500.0f);
+    PointCloudXYZRGB cloud;
+    for (size_t i = 0; i < count; ++i) {
+        cloud.push_back(PointXYZRGB(Point3D(xy(rng), xy(rng), static_cast<float>(i % 100)), RGB(static_cast<uint8_t>(i), 0, 0)));
+    }
+    return cloud;
+}
+
+map<pair<int64_t, int64_t>, size_t> expectedCounts(const PointCloudXYZRGB& cloud, double size) {
+    map<pair<int64_t, int64_t>, size_t> counts;
+    for (const auto& p : cloud) {
+        if (isfinite(p.position.x) && isfinite(p.position.y)) {
+            ++counts[{static_cast<int64_t>(floor(static_cast<double>(p.position.x) / size)), static_cast<int64_t>(floor(static_cast<double>(p.position.y) / size))}];
+        }
+    }
+    return counts;
+}
+
+io::Tiler::WriterFactory pcdFactory() {
+    return [](const filesystem::path& path) -> unique_ptr<io::PointWriter> {
+        auto writer = make_unique<PCDWriter>(path, PCDProcessor::createXYZRGBHeader(PointCloudXYZRGB{}, "binary"));
+        if (!writer->is_open()) {
+            return nullptr;
+        }
+        return writer;
+    };
+}
+
+// Forwards to a tile writer and tracks how many writers are alive at once
+class CountingWriter : public io::PointWriter {
+   public:
+    CountingWriter(unique_ptr<io::PointWriter> inner, atomic<size_t>& live, atomic<size_t>& peak) : inner_(std::move(inner)), live_(live) {
+        const size_t now = ++live_;
+        for (size_t seen = peak.load(); now > seen && !peak.compare_exchange_weak(seen, now);) {
+        }
+    }
+    ~CountingWriter() override { --live_; }
+
+    bool write(span<const PointXYZRGB> points) override { return inner_->write(points); }
+    bool close() override { return inner_->close(); }
+
+   private:
+    unique_ptr<io::PointWriter> inner_;
+    atomic<size_t>& live_;
+};
+
+}  // namespace
+
+TEST_CASE("Tiler routes every point to its tile", "[Tiler]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_tiler_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    auto cloud = makeCloud(50000);
+    cloud.points[7].position.x = numeric_limits<float>::quiet_NaN();
+    PCDProcessor pcd;
+    const string source = (tempDir / "source.pcd").string();
+    REQUIRE(pcd.savePCD_Binary(source, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+    const auto expected = expectedCounts(cloud, 1000.0);
+    REQUIRE(expected.size() == 25);
+
+    for (const auto& [maxOpenFiles, threads] : {pair<size_t, unsigned>{64, 1}, pair<size_t, unsigned>{3, 4}, pair<size_t, unsigned>{1, 0}}) {
+        const auto outputDir = tempDir / ("tiles_" + to_string(maxOpenFiles));
+        PCDReader reader(source);
+        io::Tiler tiler({.tileSize = 1000.0, .maxOpenFiles = maxOpenFiles, .bufferPoints = 4000, .chunkSize = 1500, .extension = "pcd", .threads = threads}, pcdFactory());
+        REQUIRE(tiler.run(reader, outputDir));
+
+        const auto tiles = tiler.tiles();
+        REQUIRE(tiles.size() == expected.size());
+        size_t total = 0;
+        for (const auto& tile : tiles) {
+            REQUIRE(tile.points == expected.at({tile.column, tile.row}));
+            REQUIRE(tile.minX == static_cast<double>(tile.column) * 1000.0);
+            REQUIRE(filesystem::exists(tile.path));
+            REQUIRE_FALSE(filesystem::exists(tile.path.string() + ".spill"));
+
+            auto [header, loaded] = pcd.loadPCD(tile.path.string());
+            REQUIRE(loaded.size() == tile.points);
+            for (const auto& p : loaded) {
+                REQUIRE(static_cast<double>(p.position.x) >= tile.minX);
+                REQUIRE(static_cast<double>(p.position.x) < tile.minX + 1000.0);
+                REQUIRE(static_cast<double>(p.position.y) >= tile.minY);
+                REQUIRE(static_cast<double>(p.position.y) < tile.minY + 1000.0);
+            }
+            total += loaded.size();
+        }
+        REQUIRE(total == cloud.size() - 1);
+        REQUIRE(filesystem::exists(outputDir / "tile_-2000_1000.pcd"));
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("Tiler keeps part of its file budget for spill files", "[Tiler]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_tiler_budget_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto cloud = makeCloud(20000);
+    PCDProcessor pcd;
+    const string source = (tempDir / "source.pcd").string();
+    REQUIRE(pcd.savePCD_Binary(source, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+
+    // Four files on four threads: two tile writers, and two spill files appended or encoded at once
+    atomic<size_t> live{0}, peak{0};
+    const auto factory = pcdFactory();
+    PCDReader reader(source);
+    io::Tiler tiler({.tileSize = 1000.0, .maxOpenFiles = 4, .bufferPoints = 3000, .chunkSize = 1000, .extension = "pcd", .threads = 4},
+                    [&](const filesystem::path& path) -> unique_ptr<io::PointWriter> {
+                        auto writer = factory(path);
+                        return writer ? make_unique<CountingWriter>(std::move(writer), live, peak) : nullptr;
+                    });
+    REQUIRE(tiler.run(reader, tempDir / "tiles"));
+    REQUIRE(tiler.tiles().size() == 25);
+    REQUIRE(peak == 2);
+    REQUIRE(live == 0);
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("Tiler writes LAZ tiles and keeps point order within a tile", "[Tiler]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_tiler_laz_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto cloud = makeCloud(20000);
+    const auto source = tempDir / "source.las";
+    LASProcessor las;
+    REQUIRE(las.saveLAS(source.string(), LASProcessor::createLASHeader(cloud), cloud));
+
+    LASReader reader(source);
+    const auto& header = reader.header();
+    auto outputHeader = LASProcessor::createLASHeader(LASProcessor::PointFormat::FORMAT_3);
+    outputHeader.compressed = true;
+    io::Tiler tiler({.tileSize = 2000.0, .bounds = io::Tiler::Bounds{header.minX, header.minY, header.maxX, header.maxY}, .maxOpenFiles = 2, .bufferPoints = 5000,
+                     .extension = "laz", .threads = 2},
+                    [&](const filesystem::path& path) -> unique_ptr<io::PointWriter> {
+                        auto writer = make_unique<LASWriter>(path, outputHeader);
+                        if (!writer->is_open()) {
+                            return nullptr;
+                        }
+                        return writer;
+                    });
+    REQUIRE(tiler.run(reader, tempDir / "tiles"));
+
+    const auto expected = expectedCounts(cloud, 2000.0);
+    REQUIRE(tiler.tiles().size() == expected.size());
+    for (const auto& tile : tiler.tiles()) {
+        auto [tileHeader, loaded] = las.loadLAS(tile.path.string());
+        REQUIRE(tileHeader.compressed);
+        REQUIRE(loaded.size() == expected.at({tile.column, tile.row}));
+
+        // Points of a tile keep their input order; the red channel is the input index mod 256
+        vector<uint8_t> reds;
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            const auto& p = cloud[i].position;
+            if (floor(static_cast<double>(p.x) / 2000.0) == static_cast<double>(tile.column) && floor(static_cast<double>(p.y) / 2000.0) == static_cast<double>(tile.row)) {
+                reds.push_back(cloud[i].color.r);
+            }
+        }
+        REQUIRE(reds.size() == loaded.size());
+        for (size_t i = 0; i < reds.size(); ++i) {
+            REQUIRE(loaded[i].color.r == reds[i]);
+        }
+    }
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST_CASE("Tiler reports writer failures and invalid options", "[Tiler]") {
+    const auto tempDir = filesystem::temp_directory_path() / "scanforge_tiler_fail_tests";
+    filesystem::remove_all(tempDir);
+    filesystem::create_directories(tempDir);
+    const auto cloud = makeCloud(5000);
+    PCDProcessor pcd;
+    const string source = (tempDir / "source.pcd").string();
+    REQUIRE(pcd.savePCD_Binary(source, PCDProcessor::createXYZRGBHeader(cloud, "binary"), cloud));
+
+    {
+        PCDReader reader(source);
+        io::Tiler tiler({.tileSize = 1000.0, .extension = "pcd"}, [](const filesystem::path&) -> unique_ptr<io::PointWriter> { return nullptr; });
+        REQUIRE_FALSE(tiler.run(reader, tempDir / "tiles"));
+    }
+    {
+        PCDReader reader(source);
+        io::Tiler tiler({.tileSize = 0.0}, pcdFactory());
+        REQUIRE_FALSE(tiler.run(reader, tempDir / "tiles"));
+    }
+
+    filesystem::remove_all(tempDir);
+}
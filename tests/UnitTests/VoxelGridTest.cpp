@@ -0,0 +1,127 @@
+/**
+ * @brief Unit tests for the hashed voxel grid
+ */
+
+#include <catch2/catch_all.hpp>
+#include "spatial/VoxelGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace scanforge;
+using namespace scanforge::spatial;
+
+namespace {
+
+PointCloud<Point3D> randomCloud(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<float> coord(-20.0f, 20.0f);
+    PointCloud<Point3D> cloud(count);
+    for (size_t i = 0; i < count; ++i) {
+        cloud.push_back({coord(rng), coord(rng), coord(rng)});
+    }
+    return cloud;
+}
+
+vector<uint32_t> sorted(vector<uint32_t> indices) {
+    sort(indices.begin(), indices.end());
+    return indices;
+}
+
+}  // namespace
+
+TEST_CASE("VoxelGrid groups points by voxel", "[VoxelGrid]") {
+    const auto cloud = randomCloud(20000, 1);
+    VoxelGrid<Point3D> grid(cloud, 1.5f, 4);
+
+    REQUIRE(grid.size() == cloud.size());
+    REQUIRE(grid.voxelSize() == 1.5f);
+
+    size_t total = 0;
+    for (const auto& voxel : grid.voxels()) {
+        REQUIRE(voxel.count > 0);
+        REQUIRE(voxel.first == total);
+        total += voxel.count;
+        for (uint32_t index : grid.indices(voxel)) {
+            REQUIRE(static_cast<int64_t>(floor(static_cast<double>(cloud[index].x) / 1.5)) == voxel.x);
+            REQUIRE(static_cast<int64_t>(floor(static_cast<double>(cloud[index].y) / 1.5)) == voxel.y);
+            REQUIRE(static_cast<int64_t>(floor(static_cast<double>(cloud[index].z) / 1.5)) == voxel.z);
+        }
+        REQUIRE(grid.find(voxel.x, voxel.y, voxel.z) == &voxel);
+    }
+    REQUIRE(total == cloud.size());
+
+    for (size_t i = 0; i < cloud.size(); i += 97) {
+        const auto* voxel = grid.find(cloud[i]);
+        REQUIRE(voxel != nullptr);
+        const auto range = grid.indices(*voxel);
+        REQUIRE(find(range.begin(), range.end(), i) != range.end());
+    }
+    REQUIRE(grid.find(Point3D{100, 100, 100}) == nullptr);
+    REQUIRE(grid.find(Point3D{numeric_limits<float>::quiet_NaN(), 0, 0}) == nullptr);
+}
+
+TEST_CASE("VoxelGrid queries match a brute-force scan", "[VoxelGrid]") {
+    const auto cloud = randomCloud(30000, 2);
+    for (unsigned threads : {1u, 4u, 0u}) {
+        for (float size : {0.3f, 2.0f, 50.0f}) {
+            VoxelGrid<Point3D> grid(cloud, size, threads);
+
+            for (const auto& [min, max] : {pair<Point3D, Point3D>{{-5, -7, 0}, {3, 4, 12}}, pair<Point3D, Point3D>{{-100, -100, -100}, {100, 100, 100}},
+                                           pair<Point3D, Point3D>{{1, 1, 1}, {1.2f, 1.2f, 1.2f}}}) {
+                vector<uint32_t> expected;
+                for (size_t i = 0; i < cloud.size(); ++i) {
+                    if (insideBox(cloud[i], min, max)) {
+                        expected.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                REQUIRE(sorted(grid.boxQuery(min, max)) == expected);
+            }
+
+            for (float radius : {0.0f, 0.7f, 4.0f}) {
+                const Point3D center = cloud[77];
+                vector<uint32_t> expected;
+                for (size_t i = 0; i < cloud.size(); ++i) {
+                    if (squaredDistance(cloud[i], center) <= radius * radius) {
+                        expected.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                REQUIRE(sorted(grid.radiusQuery(center, radius)) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("VoxelGrid handles negative coordinates and voxel borders", "[VoxelGrid]") {
+    PointCloud<Point3D> cloud;
+    cloud.push_back({-0.5f, 0, 0});
+    cloud.push_back({0, 0, 0});
+    cloud.push_back({1, 0, 0});
+    cloud.push_back({numeric_limits<float>::quiet_NaN(), 0, 0});
+
+    VoxelGrid<Point3D> grid(cloud, 1.0f);
+    REQUIRE(grid.size() == 3);
+    REQUIRE(grid.voxels().size() == 3);
+    REQUIRE(grid.find(-1, 0, 0) != nullptr);
+    REQUIRE(grid.find(int64_t{0}, 0, 0)->count == 1);
+    REQUIRE(grid.find(1, 0, 0) != nullptr);
+    REQUIRE(sorted(grid.boxQuery({-1, -1, -1}, {0, 1, 1})) == vector<uint32_t>{0, 1});
+}
+
+TEST_CASE("VoxelGrid rejects invalid voxel sizes", "[VoxelGrid]") {
+    const auto cloud = randomCloud(100, 3);
+    VoxelGrid<Point3D> grid;
+    REQUIRE_FALSE(grid.build(cloud, 0.0f));
+    REQUIRE_FALSE(grid.build(cloud, -1.0f));
+    REQUIRE_FALSE(grid.build(cloud, numeric_limits<float>::quiet_NaN()));
+    REQUIRE_FALSE(grid.build(cloud, 1e-6f));
+    REQUIRE(grid.empty());
+
+    PointCloud<Point3D> empty;
+    REQUIRE(grid.build(empty, 1.0f));
+    REQUIRE(grid.voxels().empty());
+    REQUIRE(grid.boxQuery({-1, -1, -1}, {1, 1, 1}).empty());
+}